@@ -0,0 +1,40 @@
+########################################################################
+# Tries to find the local liburing installation.
+#
+# Once done the following variables will be defined:
+#
+#   liburing_FOUND
+#   liburing_INCLUDE_DIR
+#   liburing_LIBRARY
+#
+# Furthermore an imported "liburing::liburing" target is created.
+#
+
+find_package(PkgConfig QUIET)
+if (PKG_CONFIG_FOUND)
+    pkg_check_modules(liburing_PKG QUIET liburing)
+endif()
+
+find_path(liburing_INCLUDE_DIR liburing.h
+    HINTS ${liburing_PKG_INCLUDE_DIRS}
+)
+
+find_library(liburing_LIBRARY
+    NAMES uring
+    HINTS ${liburing_PKG_LIBRARY_DIRS}
+)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(liburing
+    REQUIRED_VARS liburing_LIBRARY liburing_INCLUDE_DIR
+)
+
+mark_as_advanced(liburing_INCLUDE_DIR liburing_LIBRARY)
+
+if (liburing_FOUND AND NOT TARGET liburing::liburing)
+    add_library(liburing::liburing UNKNOWN IMPORTED)
+    set_target_properties(liburing::liburing PROPERTIES
+        IMPORTED_LOCATION "${liburing_LIBRARY}"
+        INTERFACE_INCLUDE_DIRECTORIES "${liburing_INCLUDE_DIR}"
+    )
+endif()
@@ -25,6 +25,7 @@ object GeneratedFiles {
     SessionNonceMode,
     HandshakeEphemeral,
     SessionCryptoMode,
+    SessionCompressionMode,
     HandshakeMode,
     HandshakeError,
     HandshakeKDF,
@@ -33,6 +33,7 @@ object Includes {
 
   val msgPrinter = crypto("IMessagePrinter", true)
   val enumField = crypto("EnumField", true)
+  val optionalEnumField = crypto("OptionalEnumField", true)
   val integerField = crypto("IntegerField", true)
   val seqField = crypto("SeqByteField", true)
   val seqStructField = crypto("SeqStructField", true)
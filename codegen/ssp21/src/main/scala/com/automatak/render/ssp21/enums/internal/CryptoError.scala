@@ -40,6 +40,7 @@ object CryptoError extends EnumModel {
     EnumValue("clock_rollback", 14, "A rollback of the monotonic clock was detected"),
     EnumValue("aead_encrypt_fail", 15, "AEAD encryption failed in the underlying implementation"),
     EnumValue("aead_decrypt_fail", 16, "AEAD authentication failed in the underlying implementation"),
+    EnumValue("bad_compressed_data", 17, "Authenticated user data could not be decompressed"),
   )
 
 }
@@ -39,6 +39,7 @@ object HandshakeError extends EnumModel {
     EnumValue("authentication_error", 11, "The responder was unable to authenticate the initiator"),
     EnumValue("no_prior_handshake_begin", 12, "The initiator requested handshake auth, but no prior handshake begin was received"),
     EnumValue("key_not_found", 13, "In QKD mode, the requested key id was not found"),
+    EnumValue("unsupported_compression_mode", 14, "The requested session compression mode is not supported"),
     EnumValue("unknown", 255, "A error code for any unforeseen condition or implementation specific error"),
     noneValue
   )
@@ -0,0 +1,33 @@
+/**
+ * License TBD
+ */
+/**
+  * License TBD
+  */
+package com.automatak.render.ssp21.enums.ssp21
+
+import com.automatak.render._
+
+object SessionCompressionMode extends EnumModel {
+
+  override def name: String = "SessionCompressionMode"
+
+  override def underscoredName: String = "session_compression_mode"
+
+  override def comments: List[String] = List("Specifies how user data is compressed before it is encrypted")
+
+  override def nonDefaultValues: List[EnumValue] = codes
+
+  override def defaultValue: Option[EnumValue] = Some(EnumValue.undefined(255))
+
+  val none = EnumValue("none", 0, "User data is sent as is")
+
+  private val codes = List(
+    none,
+    EnumValue("lz_scada", 1, "LZ77 with a 1KB window, primed with a dictionary of common SCADA protocol headers"),
+  )
+
+}
+
+
+
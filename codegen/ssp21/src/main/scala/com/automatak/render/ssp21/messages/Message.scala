@@ -75,6 +75,17 @@ sealed case class Enum(model: EnumModel) extends Field {
   def fixedSize: Option[Int] = Some(1)
 }
 
+// only valid as the last field of a message, omitted from the wire when it has the absent value
+sealed case class OptionalEnum(model: EnumModel, absent: EnumValue) extends Field {
+  def name: String = model.underscoredName
+
+  def cpp = OptionalEnumFieldGenerator(model, absent)
+
+  def minSizeBytes: Int = 0
+
+  def fixedSize: Option[Int] = None
+}
+
 sealed case class SeqOfByte(name: String) extends Field {
   def cpp = SeqOfByteFieldGenerator
 
@@ -49,7 +49,8 @@ object RequestHandshakeBegin extends Message {
     StructField("constraints", SessionConstraints),
     Enum(HandshakeMode),
     CommonFields.modeEphemeral,
-    CommonFields.modeData
+    CommonFields.modeData,
+    OptionalEnum(SessionCompressionMode, SessionCompressionMode.none)
   )
 
 }
@@ -3,7 +3,7 @@
  */
 package com.automatak.render.ssp21.messages.generators
 
-import com.automatak.render.EnumModel
+import com.automatak.render.{EnumModel, EnumValue}
 import com.automatak.render.ssp21.messages.{Bitfield, Struct, StructField}
 import com.automatak.render.ssp21.{Include, Includes}
 
@@ -99,6 +99,17 @@ case class EnumFieldGenerator(enum: EnumModel) extends FieldGenerator with PassB
   def defaultValue: Option[String] = None
 }
 
+case class OptionalEnumFieldGenerator(enum: EnumModel, absent: EnumValue) extends FieldGenerator with PassByValue {
+
+  override def includes = Set(Includes.enum(enum.name, true), Includes.optionalEnumField)
+
+  override def cppType: String = "OptionalEnumField<%s, %s::%s>".format(enum.specName, enum.name, absent.name)
+
+  override def paramType: String = enum.name
+
+  def defaultValue: Option[String] = None
+}
+
 object SeqOfByteFieldGenerator extends FieldGenerator with PassByConstRef {
   override def includes = Set(Includes.seqField)
 
@@ -0,0 +1,74 @@
+#include "FlightDump.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+using namespace ssp21;
+
+namespace {
+const char dump_magic[8] = { 'S', 'S', 'P', '2', '1', 'F', 'L', 'T' };
+
+struct FileCloser {
+    void operator()(FILE* file) const
+    {
+        fclose(file);
+    }
+};
+}
+
+FlightDump::FlightDump(const std::string& path)
+    : header{}
+{
+    const std::unique_ptr<FILE, FileCloser> file(fopen(path.c_str(), "rb"));
+    if (!file) {
+        throw std::runtime_error("unable to open " + path + ": " + strerror(errno));
+    }
+
+    if (fread(&this->header, sizeof(this->header), 1, file.get()) != 1 || memcmp(this->header.magic, dump_magic, sizeof(dump_magic)) != 0) {
+        throw std::runtime_error("not a flight recorder dump: " + path);
+    }
+
+    if (this->header.version != FlightRecorder::dump_version) {
+        throw std::runtime_error("not a version " + std::to_string(FlightRecorder::dump_version) + " flight recorder dump: " + path);
+    }
+
+    // the ticks are calibrated against the steady clock between the first event and the dump
+    if (this->header.dump_ticks > this->header.start_ticks && this->header.dump_ns > this->header.start_ns) {
+        this->ns_per_tick = static_cast<double>(this->header.dump_ns - this->header.start_ns) / static_cast<double>(this->header.dump_ticks - this->header.start_ticks);
+    }
+
+    for (uint32_t i = 0; i < this->header.num_rings; ++i) {
+        FlightRecorder::RingHeader ring{};
+        if (fread(&ring, sizeof(ring), 1, file.get()) != 1 || ring.num_events > FlightRecorder::ring_size) {
+            throw std::runtime_error("truncated flight recorder dump: " + path);
+        }
+
+        std::vector<FlightEvent> events(ring.num_events);
+        if (fread(events.data(), sizeof(FlightEvent), events.size(), file.get()) != events.size()) {
+            throw std::runtime_error("truncated flight recorder dump: " + path);
+        }
+
+        for (const auto& event : events) {
+            this->timeline.push_back(Entry{ this->to_wall_ns(event.ticks), i, event });
+        }
+
+        this->rings.push_back(ring);
+    }
+
+    // each ring is already in order
+    std::stable_sort(this->timeline.begin(), this->timeline.end(), [](const Entry& lhs, const Entry& rhs) {
+        return lhs.event.ticks < rhs.event.ticks;
+    });
+}
+
+uint64_t FlightDump::to_wall_ns(uint64_t ticks) const
+{
+    // events can't be newer than the dump, count backwards from its wall clock time
+    const auto ticks_before_dump = (this->header.dump_ticks > ticks) ? this->header.dump_ticks - ticks : 0;
+    const auto ns_before_dump = static_cast<uint64_t>(static_cast<double>(ticks_before_dump) * this->ns_per_tick);
+    return (this->header.dump_wall_ns > ns_before_dump) ? this->header.dump_wall_ns - ns_before_dump : 0;
+}
@@ -0,0 +1,51 @@
+#ifndef SSP21FLIGHTDECODER_FLIGHTDUMP_H
+#define SSP21FLIGHTDECODER_FLIGHTDUMP_H
+
+#include <ssp21/util/FlightRecorder.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Reads a flight recorder dump and merges the rings of all threads into one timeline.
+ */
+class FlightDump {
+public:
+    struct Entry {
+        // wall clock time of the event, nanoseconds since the UNIX epoch
+        uint64_t wall_ns;
+        // index of the ring, i.e. the thread, that recorded the event
+        uint32_t ring;
+        ssp21::FlightEvent event;
+    };
+
+    // throws std::runtime_error if the file can't be read or isn't a dump
+    explicit FlightDump(const std::string& path);
+
+    const ssp21::FlightRecorder::DumpHeader& get_header() const
+    {
+        return this->header;
+    }
+
+    const std::vector<ssp21::FlightRecorder::RingHeader>& get_rings() const
+    {
+        return this->rings;
+    }
+
+    // ordered by time, oldest first
+    const std::vector<Entry>& get_timeline() const
+    {
+        return this->timeline;
+    }
+
+private:
+    uint64_t to_wall_ns(uint64_t ticks) const;
+
+    ssp21::FlightRecorder::DumpHeader header;
+    std::vector<ssp21::FlightRecorder::RingHeader> rings;
+    std::vector<Entry> timeline;
+    double ns_per_tick = 1.0;
+};
+
+#endif
@@ -0,0 +1,195 @@
+/**
+ * Renders a flight recorder dump written by the proxy as one timeline across all threads.
+ *
+ * Every line shows the wall clock time of the event, the time since the previous line, the thread
+ * and the layer or socket that recorded it.
+ */
+
+#include "FlightDump.h"
+
+#include "crypto/Initiator.h"
+#include "crypto/gen/Function.h"
+
+#include <ssp21/crypto/gen/CryptoError.h>
+#include <ssp21/crypto/gen/ParseError.h>
+
+#include <argagg/argagg.hpp>
+
+#include <cinttypes>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace ssp21;
+
+namespace {
+const char* get_state_name(uint32_t value)
+{
+    switch (static_cast<Initiator::IHandshakeState::Enum>(value)) {
+    case (Initiator::IHandshakeState::Enum::idle):
+        return "idle";
+    case (Initiator::IHandshakeState::Enum::wait_for_begin_reply):
+        return "wait_for_begin_reply";
+    case (Initiator::IHandshakeState::Enum::wait_for_auth_reply):
+        return "wait_for_auth_reply";
+    case (Initiator::IHandshakeState::Enum::wait_for_retry):
+        return "wait_for_retry";
+    case (Initiator::IHandshakeState::Enum::bad_configuration):
+        return "bad_configuration";
+    default:
+        return "unknown";
+    }
+}
+
+const char* get_function_name(uint16_t code)
+{
+    return FunctionSpec::to_string(FunctionSpec::from_type(static_cast<uint8_t>(code)));
+}
+
+const char* get_side_name(uint16_t code)
+{
+    return (code == 0) ? "ssp21" : "plaintext";
+}
+
+std::string describe(const FlightEvent& event)
+{
+    char text[160];
+
+    switch (static_cast<FlightEventType>(event.type)) {
+    case (FlightEventType::initiator_state):
+        snprintf(text, sizeof(text), "initiator %s -> %s", get_state_name(event.value), get_state_name(event.code));
+        break;
+    case (FlightEventType::crypto_rx_message):
+        snprintf(text, sizeof(text), "rx %s (length = %" PRIu32 ")", get_function_name(event.code), event.value);
+        break;
+    case (FlightEventType::crypto_rx_parse_error):
+        snprintf(text, sizeof(text), "rx %s failed to parse: %s", get_function_name(event.code), ParseErrorSpec::to_string(static_cast<ParseError>(event.value)));
+        break;
+    case (FlightEventType::crypto_rx_unsupported):
+        snprintf(text, sizeof(text), "rx unsupported function: %u", static_cast<unsigned>(event.code));
+        break;
+    case (FlightEventType::crypto_rx_session_data):
+        snprintf(text, sizeof(text), "rx session data (nonce = %" PRIu32 ", payload = %" PRIu64 ")", event.value, event.extra);
+        break;
+    case (FlightEventType::crypto_rx_session_error):
+        snprintf(text, sizeof(text), "rx session data rejected: %s", CryptoErrorSpec::to_string(static_cast<CryptoError>(event.code)));
+        break;
+    case (FlightEventType::crypto_tx_session_data):
+        snprintf(text, sizeof(text), "tx session data (nonce = %" PRIu32 ", frame = %" PRIu64 ")", event.value, event.extra);
+        break;
+    case (FlightEventType::crypto_tx_session_error):
+        snprintf(text, sizeof(text), "tx session message not formatted: %s", CryptoErrorSpec::to_string(static_cast<CryptoError>(event.code)));
+        break;
+    case (FlightEventType::crypto_tx_session_auth):
+        snprintf(text, sizeof(text), "tx session auth (frame = %" PRIu64 ")%s", event.extra, event.value ? "" : ", lower layer busy");
+        break;
+    case (FlightEventType::crypto_lower_close):
+        snprintf(text, sizeof(text), "crypto layer closed from below");
+        break;
+    case (FlightEventType::socket_rx):
+        snprintf(text, sizeof(text), "%s socket rx (%" PRIu32 " bytes)", get_side_name(event.code), event.value);
+        break;
+    case (FlightEventType::socket_tx):
+        snprintf(text, sizeof(text), "%s socket tx complete", get_side_name(event.code));
+        break;
+    case (FlightEventType::socket_error):
+        snprintf(text, sizeof(text), "%s socket error", get_side_name(event.code));
+        break;
+    case (FlightEventType::session_error):
+        snprintf(text, sizeof(text), "session %" PRIu64 " closed on error", event.extra);
+        break;
+    case (FlightEventType::handler_heap_allocation):
+        snprintf(text, sizeof(text), "asio handler allocated %" PRIu32 " bytes from the heap", event.value);
+        break;
+    default:
+        snprintf(text, sizeof(text), "unknown event type %u", static_cast<unsigned>(event.type));
+        break;
+    }
+
+    return text;
+}
+
+void print_time(uint64_t wall_ns)
+{
+    const auto seconds = static_cast<time_t>(wall_ns / 1000000000);
+    struct tm utc {
+    };
+    gmtime_r(&seconds, &utc);
+
+    char text[32];
+    strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &utc);
+    printf("%s.%06" PRIu64, text, (wall_ns % 1000000000) / 1000);
+}
+}
+
+int main(int argc, char* argv[])
+{
+    argagg::parser parser{ {
+        { "help", { "-h", "--help" }, "shows this help message", 0 },
+        { "source", { "-s", "--source" }, "only show the events of this source, e.g. 0x7f3a5c001230", 1 },
+        { "last", { "-l", "--last" }, "only show this many of the most recent events", 1 },
+    } };
+
+    try {
+        const auto results = parser.parse(argc, argv);
+
+        if (results.has_option("help")) {
+            std::cout << "usage: flight-decoder [options] <dump file>" << std::endl
+                      << std::endl
+                      << parser << std::endl;
+            return 0;
+        }
+
+        if (results.pos.size() != 1) {
+            throw std::runtime_error("expected the path of a single dump file");
+        }
+
+        const bool filter_source = results.has_option("source");
+        const auto source = filter_source ? std::stoull(results["source"].as<std::string>(), nullptr, 16) : 0;
+
+        const FlightDump dump(results.pos.front());
+
+        std::vector<FlightDump::Entry> entries;
+        for (const auto& entry : dump.get_timeline()) {
+            if (!filter_source || entry.event.source == source) {
+                entries.push_back(entry);
+            }
+        }
+
+        if (results.has_option("last")) {
+            const auto last = results["last"].as<size_t>();
+            if (entries.size() > last) {
+                entries.erase(entries.begin(), entries.end() - last);
+            }
+        }
+
+        printf("%u thread(s), %zu event(s) shown, dumped at ", dump.get_header().num_rings, entries.size());
+        print_time(dump.get_header().dump_wall_ns);
+        printf(" UTC\n\n");
+
+        for (size_t i = 0; i < dump.get_rings().size(); ++i) {
+            printf("T%-3zu thread %016" PRIx64 ", %u event(s)\n", i, dump.get_rings()[i].thread_id, dump.get_rings()[i].num_events);
+        }
+        printf("\n");
+
+        uint64_t previous = entries.empty() ? 0 : entries.front().wall_ns;
+        for (const auto& entry : entries) {
+            print_time(entry.wall_ns);
+            printf(" %+12.3f us  T%-3u %016" PRIx64 "  %s\n",
+                   static_cast<double>(entry.wall_ns - previous) / 1000.0,
+                   entry.ring,
+                   entry.event.source,
+                   describe(entry.event).c_str());
+            previous = entry.wall_ns;
+        }
+
+        return 0;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl
+                  << std::endl;
+        std::cout << parser << std::endl;
+        return -1;
+    }
+}
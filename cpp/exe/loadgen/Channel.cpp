@@ -0,0 +1,82 @@
+#include "Channel.h"
+
+void Channel::start(const Handler& handler)
+{
+    this->handler = handler;
+    this->start_impl();
+}
+
+void Channel::write(const ssp21::seq32_t& data)
+{
+    if (this->is_closed)
+        return;
+
+    const auto bytes = static_cast<const uint8_t*>(data);
+    this->pending.insert(this->pending.end(), bytes, bytes + data.length());
+    this->try_write();
+}
+
+void Channel::close()
+{
+    this->is_released = true;
+
+    if (this->is_closed)
+        return;
+
+    this->is_closed = true;
+    this->close_impl();
+}
+
+void Channel::on_write_complete()
+{
+    if (this->is_writing) {
+        this->is_writing = false;
+        this->in_flight.clear();
+    }
+
+    this->try_write();
+}
+
+void Channel::notify_open()
+{
+    if (!this->is_released && this->handler.on_open)
+        this->handler.on_open();
+}
+
+void Channel::notify_rx(const ssp21::seq32_t& data)
+{
+    if (!this->is_released && this->handler.on_rx)
+        this->handler.on_rx(data);
+}
+
+void Channel::notify_close()
+{
+    if (this->is_closed)
+        return;
+
+    this->is_closed = true;
+
+    const auto self = this->shared_from_this();
+    this->executor->post([self]() {
+        if (!self->is_released) {
+            self->is_released = true;
+            if (self->handler.on_close)
+                self->handler.on_close();
+        }
+    });
+}
+
+void Channel::try_write()
+{
+    if (this->is_closed || this->is_writing || this->pending.empty())
+        return;
+
+    // everything written while the previous data was in flight goes out at once
+    this->in_flight.swap(this->pending);
+
+    if (this->start_write(ssp21::seq32_t(this->in_flight.data(), static_cast<uint32_t>(this->in_flight.size())))) {
+        this->is_writing = true;
+    } else {
+        this->in_flight.swap(this->pending);
+    }
+}
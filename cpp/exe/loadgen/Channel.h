@@ -0,0 +1,91 @@
+#ifndef SSP21LOADGEN_CHANNEL_H
+#define SSP21LOADGEN_CHANNEL_H
+
+#include <exe4cpp/IExecutor.h>
+#include <ser4cpp/util/Uncopyable.h>
+#include <ssp21/util/SequenceTypes.h>
+
+#include <asio.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * A byte stream between a client or echo server and whatever carries its data, either a plain
+ * TCP socket or an SSP21 stack.
+ *
+ * Writes are copied and coalesced, so a caller may write at any time after the channel opens.
+ * The channel keeps itself alive while operations are outstanding and may be released by its
+ * owner at any time.
+ */
+class Channel : public std::enable_shared_from_this<Channel>, private ser4cpp::Uncopyable {
+
+public:
+    struct Handler {
+        // data may be written from now on
+        std::function<void()> on_open;
+        // the data is only valid for the duration of the call
+        std::function<void(const ssp21::seq32_t&)> on_rx;
+        // the far end or an error closed the channel
+        std::function<void()> on_close;
+    };
+
+    explicit Channel(const std::shared_ptr<exe4cpp::IExecutor>& executor)
+        : executor(executor)
+    {
+    }
+
+    virtual ~Channel() = default;
+
+    void start(const Handler& handler);
+
+    void write(const ssp21::seq32_t& data);
+
+    // close the channel without notifying the handler, which is never invoked again
+    void close();
+
+protected:
+    virtual void start_impl() = 0;
+
+    virtual void close_impl() = 0;
+
+    // hand the data to the transport, returns false if it can't take any right now
+    virtual bool start_write(const ssp21::seq32_t& data) = 0;
+
+    // the transport is done with the data given to start_write() or is ready for some
+    void on_write_complete();
+
+    void notify_open();
+
+    void notify_rx(const ssp21::seq32_t& data);
+
+    // the close handler runs from the executor so that the owner may release the channel there
+    void notify_close();
+
+    bool get_is_closed() const
+    {
+        return this->is_closed;
+    }
+
+    const std::shared_ptr<exe4cpp::IExecutor> executor;
+
+private:
+    void try_write();
+
+    Handler handler;
+
+    bool is_closed = false;
+    // the handler is detached
+    bool is_released = false;
+
+    // data lent to the transport, and data written since
+    std::vector<uint8_t> in_flight;
+    std::vector<uint8_t> pending;
+    bool is_writing = false;
+};
+
+// wraps a connected socket in the channel the run is configured for
+using channel_factory_t = std::function<std::shared_ptr<Channel>(asio::ip::tcp::socket socket)>;
+
+#endif
@@ -0,0 +1,237 @@
+#include "Client.h"
+
+namespace {
+// before connecting again after a failed connect or a connection closed by the far end
+const std::chrono::milliseconds reconnect_delay(1000);
+
+uint32_t get_window(const LoadConfig& config)
+{
+    switch (config.pattern) {
+    case (Pattern::bulk):
+        return config.window;
+    case (Pattern::bursty):
+        return config.burst_size;
+    default:
+        return 1;
+    }
+}
+
+uint32_t get_burst_size(const LoadConfig& config)
+{
+    switch (config.pattern) {
+    case (Pattern::bulk):
+        return 0;
+    case (Pattern::bursty):
+        return config.burst_size;
+    default:
+        return 1;
+    }
+}
+
+uint64_t to_ns(const std::chrono::steady_clock::duration& duration)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+}
+
+Client::Client(
+    const LoadConfig& config,
+    const std::shared_ptr<exe4cpp::BasicExecutor>& executor,
+    const asio::ip::tcp::endpoint& endpoint,
+    const channel_factory_t& channel_factory,
+    Statistics& statistics)
+    : config(config)
+    , executor(executor)
+    , endpoint(endpoint)
+    , channel_factory(channel_factory)
+    , statistics(statistics)
+    , window(get_window(config))
+    , burst_size(get_burst_size(config))
+    , message(config.message_size)
+{
+}
+
+void Client::start()
+{
+    this->connect();
+}
+
+void Client::stop()
+{
+    this->is_stopped = true;
+    this->timer.cancel();
+}
+
+void Client::connect()
+{
+    const auto generation = ++this->generation;
+
+    this->timer.cancel();
+    this->is_session_established = false;
+    this->is_paused = false;
+    this->tx_offset = 0;
+    this->rx_offset = 0;
+    this->num_sent = 0;
+    this->num_echoed = 0;
+    this->num_sent_in_burst = 0;
+    this->send_times.clear();
+
+    this->connect_start = clock_t::now();
+
+    // won't need this once C++XX has move capture
+    const auto socket = std::make_shared<asio::ip::tcp::socket>(*this->executor->get_service());
+
+    socket->async_connect(this->endpoint, [this, socket, generation](const std::error_code& ec) {
+        if (generation != this->generation || this->is_stopped)
+            return;
+
+        if (ec) {
+            ++this->statistics.num_connect_failures;
+            this->schedule_connect(reconnect_delay);
+            return;
+        }
+
+        std::error_code option_ec;
+        socket->set_option(asio::ip::tcp::no_delay(true), option_ec);
+
+        ++this->statistics.num_connects;
+
+        this->channel = this->channel_factory(std::move(*socket));
+        this->channel->start(Channel::Handler{
+            [this, generation]() {
+                if (generation == this->generation)
+                    this->on_open();
+            },
+            [this, generation](const ssp21::seq32_t& data) {
+                if (generation == this->generation)
+                    this->on_rx(data);
+            },
+            [this, generation]() {
+                if (generation == this->generation)
+                    this->on_close();
+            } });
+    });
+}
+
+void Client::schedule_connect(const std::chrono::milliseconds& delay)
+{
+    this->timer = exe4cpp::Timer(this->executor->start(delay, [this]() { this->connect(); }));
+}
+
+void Client::on_open()
+{
+    if (this->config.target == Target::in_process) {
+        this->on_handshake();
+    }
+
+    this->send_messages();
+}
+
+void Client::on_rx(const ssp21::seq32_t& data)
+{
+    const auto now = clock_t::now();
+
+    const auto bytes = static_cast<const uint8_t*>(data);
+    for (uint32_t i = 0; i < data.length(); ++i) {
+        if (bytes[i] != get_payload_byte(this->rx_offset + i)) {
+            ++this->statistics.num_corrupt_bytes;
+        }
+    }
+    this->rx_offset += data.length();
+
+    // a message is complete when the last of its bytes comes back
+    while (!this->send_times.empty() && this->rx_offset >= (this->num_echoed + 1) * this->config.message_size) {
+        this->statistics.latency.record(to_ns(now - this->send_times.front()));
+        this->send_times.pop_front();
+        ++this->num_echoed;
+        ++this->statistics.num_messages;
+        this->statistics.num_bytes += this->config.message_size;
+    }
+
+    if (!this->is_session_established && this->num_echoed > 0) {
+        this->on_handshake();
+    }
+
+    if (this->config.messages_per_connection > 0 && this->num_echoed >= this->config.messages_per_connection) {
+        this->reconnect();
+        return;
+    }
+
+    this->send_messages();
+}
+
+void Client::on_close()
+{
+    ++this->statistics.num_disconnects;
+    this->channel.reset();
+
+    if (!this->is_stopped) {
+        this->schedule_connect(reconnect_delay);
+    }
+}
+
+void Client::on_handshake()
+{
+    this->is_session_established = true;
+    ++this->statistics.num_handshakes;
+    this->statistics.handshake_time.record(to_ns(clock_t::now() - this->connect_start));
+}
+
+void Client::send_messages()
+{
+    if (this->is_stopped || this->is_paused || !this->channel)
+        return;
+
+    while (true) {
+        const auto num_outstanding = this->num_sent - this->num_echoed;
+
+        if (this->burst_size > 0 && this->num_sent_in_burst == this->burst_size) {
+            // the next burst begins once this one has been echoed
+            if (num_outstanding > 0)
+                return;
+
+            this->num_sent_in_burst = 0;
+
+            if (this->config.interval.count() > 0) {
+                this->is_paused = true;
+                this->timer = exe4cpp::Timer(this->executor->start(this->config.interval, [this]() {
+                    this->is_paused = false;
+                    this->send_messages();
+                }));
+                return;
+            }
+        }
+
+        if (num_outstanding >= this->window)
+            return;
+
+        if (this->config.messages_per_connection > 0 && this->num_sent >= this->config.messages_per_connection)
+            return;
+
+        this->send_message();
+    }
+}
+
+void Client::send_message()
+{
+    for (uint32_t i = 0; i < this->config.message_size; ++i) {
+        this->message[i] = get_payload_byte(this->tx_offset + i);
+    }
+
+    this->tx_offset += this->config.message_size;
+    this->send_times.push_back(clock_t::now());
+    ++this->num_sent;
+    ++this->num_sent_in_burst;
+
+    this->channel->write(ssp21::seq32_t(this->message.data(), this->config.message_size));
+}
+
+void Client::reconnect()
+{
+    this->channel->close();
+    this->channel.reset();
+
+    if (!this->is_stopped) {
+        this->connect();
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef SSP21LOADGEN_CLIENT_H
+#define SSP21LOADGEN_CLIENT_H
+
+#include "Channel.h"
+#include "LoadConfig.h"
+#include "Statistics.h"
+
+#include <exe4cpp/Timer.h>
+#include <exe4cpp/asio/BasicExecutor.h>
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <asio.hpp>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * One client connection that sends messages according to the traffic pattern and measures how
+ * long each takes to be echoed back.
+ *
+ * Every pattern is a sequence of bursts: up to burst_size messages are sent with at most window
+ * of them outstanding, and once the whole burst has been echoed the client pauses for the
+ * interval. Poll is a burst of one, bursty pauses after each burst, and bulk is one endless burst.
+ *
+ * The payload is a known function of its offset in the stream, so the echo is verified byte for
+ * byte without keeping a copy of what was sent.
+ */
+class Client final : private ser4cpp::Uncopyable {
+
+public:
+    Client(
+        const LoadConfig& config,
+        const std::shared_ptr<exe4cpp::BasicExecutor>& executor,
+        const asio::ip::tcp::endpoint& endpoint,
+        const channel_factory_t& channel_factory,
+        Statistics& statistics);
+
+    void start();
+
+    // stop sending, the connection stays open
+    void stop();
+
+private:
+    using clock_t = std::chrono::steady_clock;
+
+    void connect();
+
+    void schedule_connect(const std::chrono::milliseconds& delay);
+
+    void on_open();
+
+    void on_rx(const ssp21::seq32_t& data);
+
+    void on_close();
+
+    void on_handshake();
+
+    void send_messages();
+
+    void send_message();
+
+    void reconnect();
+
+    static uint8_t get_payload_byte(uint64_t offset)
+    {
+        return static_cast<uint8_t>(offset % 251);
+    }
+
+    const LoadConfig& config;
+    const std::shared_ptr<exe4cpp::BasicExecutor> executor;
+    const asio::ip::tcp::endpoint endpoint;
+    const channel_factory_t channel_factory;
+    Statistics& statistics;
+
+    // derived from the pattern, 0 is an endless burst
+    const uint32_t window;
+    const uint32_t burst_size;
+
+    bool is_stopped = false;
+    // incremented for every connection so that callbacks of an earlier one are ignored
+    uint64_t generation = 0;
+    std::shared_ptr<Channel> channel;
+    exe4cpp::Timer timer;
+
+    // state of the current connection
+    clock_t::time_point connect_start;
+    bool is_session_established = false;
+    bool is_paused = false;
+    uint64_t tx_offset = 0;
+    uint64_t rx_offset = 0;
+    uint64_t num_sent = 0;
+    uint64_t num_echoed = 0;
+    uint32_t num_sent_in_burst = 0;
+    std::deque<clock_t::time_point> send_times;
+    std::vector<uint8_t> message;
+};
+
+#endif
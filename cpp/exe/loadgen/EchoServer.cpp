@@ -0,0 +1,59 @@
+#include "EchoServer.h"
+
+#include "tcp/ReusePortOption.h"
+
+EchoServer::EchoServer(asio::io_service& service, const asio::ip::tcp::endpoint& endpoint, bool reuse_port, const channel_factory_t& channel_factory)
+    : channel_factory(channel_factory)
+    , acceptor(service)
+    , socket(service)
+{
+    this->acceptor.open(endpoint.protocol());
+    this->acceptor.set_option(asio::ip::tcp::acceptor::reuse_address(true));
+    if (reuse_port) {
+        this->acceptor.set_option(ReusePortOption(true));
+    }
+    this->acceptor.bind(endpoint);
+    this->acceptor.listen();
+}
+
+void EchoServer::start()
+{
+    this->accept_next();
+}
+
+void EchoServer::stop()
+{
+    std::error_code ec;
+    this->acceptor.close(ec);
+
+    for (auto& channel : this->channels) {
+        channel.second->close();
+    }
+    this->channels.clear();
+}
+
+void EchoServer::accept_next()
+{
+    this->acceptor.async_accept(this->socket, [this](const std::error_code& ec) {
+        if (ec) {
+            if (this->acceptor.is_open()) {
+                this->accept_next();
+            }
+            return;
+        }
+
+        std::error_code option_ec;
+        this->socket.set_option(asio::ip::tcp::no_delay(true), option_ec);
+
+        const auto channel = this->channel_factory(std::move(this->socket));
+        const auto key = channel.get();
+        this->channels.emplace(key, channel);
+
+        channel->start(Channel::Handler{
+            []() {},
+            [key](const ssp21::seq32_t& data) { key->write(data); },
+            [this, key]() { this->channels.erase(key); } });
+
+        this->accept_next();
+    });
+}
@@ -0,0 +1,44 @@
+#ifndef SSP21LOADGEN_ECHOSERVER_H
+#define SSP21LOADGEN_ECHOSERVER_H
+
+#include "Channel.h"
+
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <asio.hpp>
+
+#include <map>
+#include <memory>
+
+/**
+ * Accepts connections and writes back everything it receives on them
+ */
+class EchoServer final : private ser4cpp::Uncopyable {
+
+public:
+    /**
+     * With reuse_port several servers, one per worker, may listen on the same endpoint and the
+     * kernel spreads the connections across them.
+     */
+    EchoServer(asio::io_service& service, const asio::ip::tcp::endpoint& endpoint, bool reuse_port, const channel_factory_t& channel_factory);
+
+    void start();
+
+    void stop();
+
+    asio::ip::tcp::endpoint get_endpoint() const
+    {
+        return this->acceptor.local_endpoint();
+    }
+
+private:
+    void accept_next();
+
+    const channel_factory_t channel_factory;
+    asio::ip::tcp::acceptor acceptor;
+    asio::ip::tcp::socket socket;
+
+    std::map<Channel*, std::shared_ptr<Channel>> channels;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef SSP21LOADGEN_LOADCONFIG_H
+#define SSP21LOADGEN_LOADCONFIG_H
+
+#include <asio.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+enum class Target {
+    // in-process initiator and responder stacks talk over loopback TCP. A handshake is counted
+    // when the initiator reports the session open.
+    in_process,
+    // a pair of external proxies sit between the plaintext clients and echo servers. The proxies
+    // can't be observed, so a handshake is counted when the first echo on a connection returns.
+    proxy
+};
+
+enum class SecurityMode {
+    shared_secret,
+    preshared_public_key
+};
+
+enum class Pattern {
+    // one message outstanding, optionally pausing between a response and the next request
+    poll,
+    // a fixed window of messages kept outstanding without pause
+    bulk,
+    // a burst of messages sent back-to-back, then a pause once all of them have been echoed
+    bursty
+};
+
+/**
+ * Settings of a load generator run, filled in from the command line
+ */
+struct LoadConfig {
+
+    Target target = Target::in_process;
+    Pattern pattern = Pattern::poll;
+
+    uint32_t num_connections = 1;
+    uint16_t num_threads = 1;
+
+    // size of every message, the echo servers send each one back unchanged
+    uint32_t message_size = 64;
+    // messages kept outstanding per connection (bulk)
+    uint32_t window = 16;
+    // messages per burst (bursty)
+    uint32_t burst_size = 32;
+    // pause after a response (poll) or after a complete burst (bursty)
+    std::chrono::milliseconds interval{ 0 };
+
+    // connections are closed and opened again after this many messages, 0 keeps them open
+    uint64_t messages_per_connection = 0;
+
+    // statistics are only collected after the warmup
+    std::chrono::seconds warmup{ 0 };
+    std::chrono::seconds duration{ 10 };
+
+    // in-process stacks
+    SecurityMode security_mode = SecurityMode::shared_secret;
+    bool aes_gcm = false;
+
+    // proxy target: the plaintext endpoint of the initiator proxy, and where the echo servers
+    // listen for connections from the responder proxy
+    asio::ip::tcp::endpoint proxy_endpoint;
+    asio::ip::tcp::endpoint echo_endpoint;
+};
+
+#endif
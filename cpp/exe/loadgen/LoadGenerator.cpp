@@ -0,0 +1,178 @@
+#include "LoadGenerator.h"
+
+#include "StackChannel.h"
+#include "TcpChannel.h"
+
+#include <ssp21/crypto/Crypto.h>
+#include <ssp21/stack/Factory.h>
+
+#include <future>
+
+using namespace ssp21;
+
+namespace {
+// runs the action on the thread of the executor and waits for its result
+template <class Action>
+auto run_on_worker(const std::shared_ptr<exe4cpp::BasicExecutor>& executor, Action action) -> decltype(action())
+{
+    const auto task = std::make_shared<std::packaged_task<decltype(action())()>>(std::move(action));
+    auto result = task->get_future();
+    executor->post([task]() { (*task)(); });
+    return result.get();
+}
+
+std::unique_ptr<StaticKeys> create_static_keys()
+{
+    KeyPair pair;
+    Crypto::gen_keypair_x25519(pair);
+    return std::make_unique<StaticKeys>(std::make_shared<const PublicKey>(pair.public_key), std::make_shared<const PrivateKey>(pair.private_key));
+}
+}
+
+LoadGenerator::LoadGenerator(const LoadConfig& config)
+    : config(config)
+{
+    if (config.target == Target::in_process) {
+        if (config.security_mode == SecurityMode::shared_secret) {
+            const auto key = std::make_shared<SymmetricKey>();
+            Crypto::gen_random(key->as_wseq().take(consts::crypto::symmetric_key_length));
+            key->set_length(BufferLength::length_32);
+            this->shared_secret = key;
+        } else {
+            this->initiator_keys = create_static_keys();
+            this->responder_keys = create_static_keys();
+        }
+    }
+
+    for (uint16_t i = 0; i < config.num_threads; ++i) {
+        this->create_worker(i);
+    }
+}
+
+LoadGenerator::~LoadGenerator()
+{
+    this->stop();
+}
+
+LoadGenerator::Result LoadGenerator::run()
+{
+    // nothing runs yet, so the workers are set up from this thread
+    for (auto& worker : this->workers) {
+        worker->server->start();
+        for (auto& client : worker->clients) {
+            client->start();
+        }
+    }
+
+    for (auto& worker : this->workers) {
+        const auto service = worker->executor->get_service();
+        worker->work = std::make_unique<asio::io_service::work>(*service);
+        worker->thread = std::thread([service]() { service->run(); });
+    }
+
+    this->is_running = true;
+
+    if (this->config.warmup.count() > 0) {
+        std::this_thread::sleep_for(this->config.warmup);
+        for (auto& worker : this->workers) {
+            const auto w = worker.get();
+            run_on_worker(w->executor, [w]() { w->statistics = Statistics(); });
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(this->config.duration);
+
+    Result result{ Statistics(), std::chrono::steady_clock::now() - start };
+
+    for (auto& worker : this->workers) {
+        const auto w = worker.get();
+        result.statistics.merge(run_on_worker(w->executor, [w]() {
+            for (auto& client : w->clients) {
+                client->stop();
+            }
+            return w->statistics;
+        }));
+    }
+
+    this->stop();
+
+    return result;
+}
+
+void LoadGenerator::create_worker(uint16_t index)
+{
+    auto worker = std::make_unique<Worker>();
+    worker->executor = exe4cpp::BasicExecutor::create(std::make_shared<asio::io_service>());
+    auto& service = *worker->executor->get_service();
+
+    asio::ip::tcp::endpoint connect_endpoint;
+
+    if (this->config.target == Target::in_process) {
+        // each worker has a responder of its own on an ephemeral port
+        worker->server = std::make_unique<EchoServer>(service, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0), false, this->get_channel_factory(worker->executor, false));
+        connect_endpoint = worker->server->get_endpoint();
+    } else {
+        worker->server = std::make_unique<EchoServer>(service, this->config.echo_endpoint, this->config.num_threads > 1, this->get_channel_factory(worker->executor, false));
+        connect_endpoint = this->config.proxy_endpoint;
+    }
+
+    // the first workers take one more client each when the connections don't divide evenly
+    const auto num_clients = this->config.num_connections / this->config.num_threads + ((index < this->config.num_connections % this->config.num_threads) ? 1 : 0);
+
+    const auto client_factory = this->get_channel_factory(worker->executor, true);
+    for (uint32_t i = 0; i < num_clients; ++i) {
+        worker->clients.push_back(std::make_unique<Client>(this->config, worker->executor, connect_endpoint, client_factory, worker->statistics));
+    }
+
+    this->workers.push_back(std::move(worker));
+}
+
+channel_factory_t LoadGenerator::get_channel_factory(const std::shared_ptr<exe4cpp::BasicExecutor>& executor, bool is_initiator) const
+{
+    if (this->config.target == Target::proxy) {
+        return [executor](asio::ip::tcp::socket socket) -> std::shared_ptr<Channel> {
+            return std::make_shared<TcpChannel>(executor, std::move(socket));
+        };
+    }
+
+    return [this, executor, is_initiator](asio::ip::tcp::socket socket) -> std::shared_ptr<Channel> {
+        return std::make_shared<StackChannel>(executor, std::move(socket), this->create_stack(executor, is_initiator));
+    };
+}
+
+std::shared_ptr<IStack> LoadGenerator::create_stack(const std::shared_ptr<exe4cpp::BasicExecutor>& executor, bool is_initiator) const
+{
+    CryptoSuite suite{};
+    suite.session_crypto_mode = this->config.aes_gcm ? SessionCryptoMode::aes_256_gcm : SessionCryptoMode::hmac_sha256_16;
+
+    // the link-layer frames the session messages in the TCP stream, as in the proxy
+    if (is_initiator) {
+        if (this->config.security_mode == SecurityMode::shared_secret) {
+            return initiator::factory::shared_secret_mode(Addresses(1, 10), InitiatorConfig(), log4cpp::Logger::empty(), executor, suite, this->shared_secret);
+        }
+        return initiator::factory::preshared_public_key_mode(Addresses(1, 10), InitiatorConfig(), log4cpp::Logger::empty(), executor, suite, *this->initiator_keys, this->responder_keys->public_key);
+    }
+
+    if (this->config.security_mode == SecurityMode::shared_secret) {
+        return responder::factory::shared_secret_mode(Addresses(10, 1), ResponderConfig(), log4cpp::Logger::empty(), executor, this->shared_secret);
+    }
+    return responder::factory::preshared_public_key_mode(Addresses(10, 1), ResponderConfig(), log4cpp::Logger::empty(), executor, *this->responder_keys, this->initiator_keys->public_key);
+}
+
+void LoadGenerator::stop()
+{
+    if (!this->is_running)
+        return;
+
+    this->is_running = false;
+
+    for (auto& worker : this->workers) {
+        worker->work.reset();
+        worker->executor->get_service()->stop();
+    }
+
+    for (auto& worker : this->workers) {
+        worker->thread.join();
+    }
+}
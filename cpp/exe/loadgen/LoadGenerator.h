@@ -0,0 +1,76 @@
+#ifndef SSP21LOADGEN_LOADGENERATOR_H
+#define SSP21LOADGEN_LOADGENERATOR_H
+
+#include "Client.h"
+#include "EchoServer.h"
+#include "LoadConfig.h"
+#include "Statistics.h"
+
+#include <ssp21/crypto/BufferTypes.h>
+#include <ssp21/crypto/StaticKeys.h>
+#include <ssp21/stack/IStack.h>
+
+#include <exe4cpp/asio/BasicExecutor.h>
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <asio.hpp>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * Runs the clients and echo servers of a load test on a set of single-threaded workers.
+ *
+ * Every worker has its own io context, echo server and share of the clients, and a client only
+ * ever talks to the echo server of its own worker when the stacks are in-process. Statistics are
+ * kept per worker and merged at the end, so nothing is shared between the threads while the
+ * test runs.
+ */
+class LoadGenerator final : private ser4cpp::Uncopyable {
+
+    struct Worker {
+        std::shared_ptr<exe4cpp::BasicExecutor> executor;
+        std::unique_ptr<EchoServer> server;
+        std::vector<std::unique_ptr<Client>> clients;
+        Statistics statistics;
+        std::unique_ptr<asio::io_service::work> work;
+        std::thread thread;
+    };
+
+public:
+    struct Result {
+        Statistics statistics;
+        // the measured period, without the warmup
+        std::chrono::steady_clock::duration elapsed;
+    };
+
+    explicit LoadGenerator(const LoadConfig& config);
+
+    ~LoadGenerator();
+
+    // blocks for the warmup and the duration of the test
+    Result run();
+
+private:
+    void create_worker(uint16_t index);
+
+    channel_factory_t get_channel_factory(const std::shared_ptr<exe4cpp::BasicExecutor>& executor, bool is_initiator) const;
+
+    std::shared_ptr<ssp21::IStack> create_stack(const std::shared_ptr<exe4cpp::BasicExecutor>& executor, bool is_initiator) const;
+
+    void stop();
+
+    const LoadConfig config;
+
+    // in-process stacks
+    std::shared_ptr<const ssp21::SymmetricKey> shared_secret;
+    std::unique_ptr<ssp21::StaticKeys> initiator_keys;
+    std::unique_ptr<ssp21::StaticKeys> responder_keys;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    bool is_running = false;
+};
+
+#endif
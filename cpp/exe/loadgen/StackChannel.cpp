@@ -0,0 +1,67 @@
+#include "StackChannel.h"
+
+StackChannel::StackChannel(const std::shared_ptr<exe4cpp::IExecutor>& executor, asio::ip::tcp::socket socket, const std::shared_ptr<ssp21::IStack>& stack)
+    : Channel(executor)
+    , lower(log4cpp::Logger::empty())
+    , socket(log4cpp::Logger::empty(), lower, socket)
+    , stack(stack)
+{
+}
+
+void StackChannel::start_impl()
+{
+    this->stack->bind(this->lower, *this);
+    this->lower.open(this->socket, *this->stack);
+}
+
+void StackChannel::close_impl()
+{
+    this->lower.close();
+    this->release_when_inactive();
+}
+
+bool StackChannel::start_write(const ssp21::seq32_t& data)
+{
+    // the stack fragments data larger than a session message
+    return this->stack->start_tx_from_upper(data);
+}
+
+void StackChannel::release_when_inactive()
+{
+    if (this->is_releasing)
+        return;
+
+    this->is_releasing = true;
+
+    const auto self = this->shared_from_this();
+    const auto executor = this->executor;
+
+    // invoked from a completion handler of the socket, so the last reference is dropped later
+    this->socket.on_inactive([self, executor]() {
+        executor->post([self]() {});
+    });
+}
+
+void StackChannel::on_lower_open_impl()
+{
+    this->notify_open();
+}
+
+void StackChannel::on_lower_close_impl()
+{
+    this->socket.try_close_socket();
+    this->notify_close();
+    this->release_when_inactive();
+}
+
+void StackChannel::on_lower_tx_ready_impl()
+{
+    this->on_write_complete();
+}
+
+void StackChannel::on_lower_rx_ready_impl()
+{
+    for (auto data = this->stack->start_rx_from_upper(); data.is_not_empty() && !this->get_is_closed(); data = this->stack->start_rx_from_upper()) {
+        this->notify_rx(data);
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef SSP21LOADGEN_STACKCHANNEL_H
+#define SSP21LOADGEN_STACKCHANNEL_H
+
+#include "Channel.h"
+
+#include "AsioLowerLayer.h"
+#include "tcp/AsioTcpSocketWrapper.h"
+
+#include <ssp21/stack/IStack.h>
+
+/**
+ * Channel through an SSP21 stack whose lower layer is a TCP socket, wired the way the proxy wires
+ * its sessions. It opens once the stack has established a session.
+ */
+class StackChannel final : public Channel, private ssp21::IUpperLayer {
+
+public:
+    StackChannel(const std::shared_ptr<exe4cpp::IExecutor>& executor, asio::ip::tcp::socket socket, const std::shared_ptr<ssp21::IStack>& stack);
+
+private:
+    void start_impl() override;
+
+    void close_impl() override;
+
+    bool start_write(const ssp21::seq32_t& data) override;
+
+    // the socket completes its outstanding operations after it closes, keep it until then
+    void release_when_inactive();
+
+    // --- IUpperLayer ---
+
+    void on_lower_open_impl() override;
+
+    void on_lower_close_impl() override;
+
+    void on_lower_tx_ready_impl() override;
+
+    void on_lower_rx_ready_impl() override;
+
+    AsioLowerLayer lower;
+    AsioTcpSocketWrapper socket;
+    const std::shared_ptr<ssp21::IStack> stack;
+    bool is_releasing = false;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef SSP21LOADGEN_STATISTICS_H
+#define SSP21LOADGEN_STATISTICS_H
+
+#include "Histogram.h"
+
+#include <cstdint>
+
+/**
+ * What the clients of one worker observed, only touched on the thread of that worker
+ */
+struct Statistics {
+
+    void merge(const Statistics& other)
+    {
+        this->num_connects += other.num_connects;
+        this->num_connect_failures += other.num_connect_failures;
+        this->num_handshakes += other.num_handshakes;
+        this->num_disconnects += other.num_disconnects;
+        this->num_messages += other.num_messages;
+        this->num_bytes += other.num_bytes;
+        this->num_corrupt_bytes += other.num_corrupt_bytes;
+        this->latency.merge(other.latency);
+        this->handshake_time.merge(other.handshake_time);
+    }
+
+    // TCP connections established by the clients
+    uint64_t num_connects = 0;
+    uint64_t num_connect_failures = 0;
+    // sessions established, see LoadConfig::Target for how they are detected
+    uint64_t num_handshakes = 0;
+    // connections closed by the far end or an error rather than by the client
+    uint64_t num_disconnects = 0;
+
+    // messages echoed back in full, and their payload bytes
+    uint64_t num_messages = 0;
+    uint64_t num_bytes = 0;
+    // echoed bytes that differ from what was sent
+    uint64_t num_corrupt_bytes = 0;
+
+    // from sending a message until the last byte of its echo arrives
+    Histogram latency;
+    // from starting the TCP connect until the session is established
+    Histogram handshake_time;
+};
+
+#endif
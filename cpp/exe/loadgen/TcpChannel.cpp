@@ -0,0 +1,65 @@
+#include "TcpChannel.h"
+
+namespace {
+const size_t rx_buffer_size = 64 * 1024;
+}
+
+TcpChannel::TcpChannel(const std::shared_ptr<exe4cpp::IExecutor>& executor, asio::ip::tcp::socket socket)
+    : Channel(executor)
+    , socket(std::move(socket))
+    , rx_buffer(rx_buffer_size)
+{
+}
+
+void TcpChannel::start_impl()
+{
+    this->notify_open();
+    this->start_read();
+}
+
+void TcpChannel::close_impl()
+{
+    std::error_code ec;
+    this->socket.close(ec);
+}
+
+bool TcpChannel::start_write(const ssp21::seq32_t& data)
+{
+    const auto self = this->shared_from_this();
+    asio::async_write(this->socket, asio::buffer(data, data.length()), [self, this](const std::error_code& ec, size_t) {
+        if (ec) {
+            this->on_error();
+        } else {
+            this->on_write_complete();
+        }
+    });
+
+    return true;
+}
+
+void TcpChannel::start_read()
+{
+    if (this->get_is_closed())
+        return;
+
+    const auto self = this->shared_from_this();
+    this->socket.async_read_some(asio::buffer(this->rx_buffer), [self, this](const std::error_code& ec, size_t num_rx) {
+        if (ec) {
+            this->on_error();
+            return;
+        }
+
+        this->notify_rx(ssp21::seq32_t(this->rx_buffer.data(), static_cast<uint32_t>(num_rx)));
+        this->start_read();
+    });
+}
+
+void TcpChannel::on_error()
+{
+    if (this->get_is_closed())
+        return;
+
+    std::error_code ec;
+    this->socket.close(ec);
+    this->notify_close();
+}
@@ -0,0 +1,33 @@
+#ifndef SSP21LOADGEN_TCPCHANNEL_H
+#define SSP21LOADGEN_TCPCHANNEL_H
+
+#include "Channel.h"
+
+#include <asio.hpp>
+
+#include <vector>
+
+/**
+ * Plaintext channel over a connected TCP socket, open as soon as it starts
+ */
+class TcpChannel final : public Channel {
+
+public:
+    TcpChannel(const std::shared_ptr<exe4cpp::IExecutor>& executor, asio::ip::tcp::socket socket);
+
+private:
+    void start_impl() override;
+
+    void close_impl() override;
+
+    bool start_write(const ssp21::seq32_t& data) override;
+
+    void start_read();
+
+    void on_error();
+
+    asio::ip::tcp::socket socket;
+    std::vector<uint8_t> rx_buffer;
+};
+
+#endif
@@ -0,0 +1,237 @@
+/**
+ * Load generator for sizing SSP21 proxies.
+ *
+ * Plaintext clients send messages to echo servers on the same machine, either through a pair of
+ * proxies started separately, or through initiator and responder stacks created in this process
+ * and connected over loopback TCP. It reports the connection and handshake rates, the throughput
+ * and the round trip latency of the messages.
+ *
+ * To measure proxies, point the plaintext listen endpoint of the initiator proxy at the responder
+ * proxy, and the plaintext connect endpoint of the responder proxy at the --echo endpoint.
+ */
+
+#include "LoadConfig.h"
+#include "LoadGenerator.h"
+
+#include <sodium/Backend.h>
+
+#include <argagg/argagg.hpp>
+
+#include <sys/resource.h>
+
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+Target get_target(const std::string& value)
+{
+    if (value == "in-process")
+        return Target::in_process;
+    if (value == "proxy")
+        return Target::proxy;
+    throw std::runtime_error("unknown target: " + value);
+}
+
+Pattern get_pattern(const std::string& value)
+{
+    if (value == "poll")
+        return Pattern::poll;
+    if (value == "bulk")
+        return Pattern::bulk;
+    if (value == "bursty")
+        return Pattern::bursty;
+    throw std::runtime_error("unknown traffic pattern: " + value);
+}
+
+SecurityMode get_security_mode(const std::string& value)
+{
+    if (value == "shared-secret")
+        return SecurityMode::shared_secret;
+    if (value == "public-key")
+        return SecurityMode::preshared_public_key;
+    throw std::runtime_error("unknown security mode: " + value);
+}
+
+const char* get_pattern_name(Pattern pattern)
+{
+    switch (pattern) {
+    case (Pattern::bulk):
+        return "bulk";
+    case (Pattern::bursty):
+        return "bursty";
+    default:
+        return "poll";
+    }
+}
+
+// <address>:<port>
+asio::ip::tcp::endpoint get_endpoint(const std::string& value)
+{
+    const auto separator = value.rfind(':');
+    if (separator == std::string::npos) {
+        throw std::runtime_error("endpoint must be <address>:<port>: " + value);
+    }
+
+    return asio::ip::tcp::endpoint(asio::ip::address::from_string(value.substr(0, separator)), static_cast<uint16_t>(std::stoul(value.substr(separator + 1))));
+}
+
+LoadConfig get_config(const argagg::parser_results& results)
+{
+    LoadConfig config;
+
+    if (results.has_option("target"))
+        config.target = get_target(results["target"].as<std::string>());
+    if (results.has_option("pattern"))
+        config.pattern = get_pattern(results["pattern"].as<std::string>());
+    if (results.has_option("connections"))
+        config.num_connections = results["connections"].as<uint32_t>();
+    if (results.has_option("threads"))
+        config.num_threads = results["threads"].as<uint16_t>();
+    if (results.has_option("size"))
+        config.message_size = results["size"].as<uint32_t>();
+    if (results.has_option("window"))
+        config.window = results["window"].as<uint32_t>();
+    if (results.has_option("burst"))
+        config.burst_size = results["burst"].as<uint32_t>();
+    if (results.has_option("interval"))
+        config.interval = std::chrono::milliseconds(results["interval"].as<uint32_t>());
+    if (results.has_option("reconnect"))
+        config.messages_per_connection = results["reconnect"].as<uint64_t>();
+    if (results.has_option("warmup"))
+        config.warmup = std::chrono::seconds(results["warmup"].as<uint32_t>());
+    if (results.has_option("duration"))
+        config.duration = std::chrono::seconds(results["duration"].as<uint32_t>());
+    if (results.has_option("security"))
+        config.security_mode = get_security_mode(results["security"].as<std::string>());
+    config.aes_gcm = results.has_option("gcm");
+
+    if (config.num_connections == 0 || config.num_threads == 0 || config.message_size == 0 || config.window == 0 || config.burst_size == 0) {
+        throw std::runtime_error("connections, threads, size, window and burst must be greater than zero");
+    }
+
+    if (config.target == Target::proxy) {
+        if (!results.has_option("proxy") || !results.has_option("echo")) {
+            throw std::runtime_error("the proxy target requires --proxy and --echo");
+        }
+        config.proxy_endpoint = get_endpoint(results["proxy"].as<std::string>());
+        config.echo_endpoint = get_endpoint(results["echo"].as<std::string>());
+    }
+
+    return config;
+}
+
+// every connection needs a descriptor for the client and one for the echo server, twice that in-process
+void raise_file_limit()
+{
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+double per_second(uint64_t count, double seconds)
+{
+    return (seconds > 0) ? static_cast<double>(count) / seconds : 0.0;
+}
+
+double to_us(uint64_t ns)
+{
+    return static_cast<double>(ns) / 1000.0;
+}
+
+void print_report(const LoadConfig& config, const LoadGenerator::Result& result)
+{
+    const auto& stats = result.statistics;
+    const auto seconds = std::chrono::duration<double>(result.elapsed).count();
+
+    printf("\n%s, %s pattern, %u connections on %u threads, %u byte messages, %.1f s measured\n\n",
+           (config.target == Target::proxy) ? "proxy pair" : "in-process stacks",
+           get_pattern_name(config.pattern),
+           config.num_connections,
+           config.num_threads,
+           config.message_size,
+           seconds);
+
+    printf("connections   %12llu  %12.1f /s  %llu failed, %llu closed by the far end\n",
+           static_cast<unsigned long long>(stats.num_connects),
+           per_second(stats.num_connects, seconds),
+           static_cast<unsigned long long>(stats.num_connect_failures),
+           static_cast<unsigned long long>(stats.num_disconnects));
+
+    printf("handshakes    %12llu  %12.1f /s  p50 %.1f us, p99 %.1f us from connect%s\n",
+           static_cast<unsigned long long>(stats.num_handshakes),
+           per_second(stats.num_handshakes, seconds),
+           to_us(stats.handshake_time.get_percentile(0.50)),
+           to_us(stats.handshake_time.get_percentile(0.99)),
+           (config.target == Target::proxy) ? " to first echo" : "");
+
+    printf("messages      %12llu  %12.1f /s  %.2f MB/s each way\n",
+           static_cast<unsigned long long>(stats.num_messages),
+           per_second(stats.num_messages, seconds),
+           per_second(stats.num_bytes, seconds) / 1e6);
+
+    printf("latency us    p50 %.1f  p99 %.1f  p999 %.1f  max %.1f\n",
+           to_us(stats.latency.get_percentile(0.50)),
+           to_us(stats.latency.get_percentile(0.99)),
+           to_us(stats.latency.get_percentile(0.999)),
+           to_us(stats.latency.get_max()));
+
+    if (stats.num_corrupt_bytes > 0) {
+        printf("\n%llu echoed bytes differ from what was sent\n", static_cast<unsigned long long>(stats.num_corrupt_bytes));
+    }
+
+    printf("\n");
+}
+}
+
+int main(int argc, char* argv[])
+{
+    argagg::parser parser{ {
+        { "help", { "-h", "--help" }, "shows this help message", 0 },
+        { "target", { "-t", "--target" }, "in-process (default) or proxy", 1 },
+        { "pattern", { "-p", "--pattern" }, "poll (default), bulk or bursty", 1 },
+        { "connections", { "-c", "--connections" }, "number of client connections - defaults to 1", 1 },
+        { "threads", { "-n", "--threads" }, "number of worker threads - defaults to 1", 1 },
+        { "size", { "-s", "--size" }, "message size in bytes - defaults to 64", 1 },
+        { "window", { "-w", "--window" }, "messages outstanding per connection (bulk) - defaults to 16", 1 },
+        { "burst", { "-b", "--burst" }, "messages per burst (bursty) - defaults to 32", 1 },
+        { "interval", { "-i", "--interval" }, "milliseconds to pause after a response (poll) or a burst (bursty) - defaults to 0", 1 },
+        { "reconnect", { "-r", "--reconnect" }, "reconnect after this many messages per connection - defaults to never", 1 },
+        { "warmup", { "--warmup" }, "seconds to run before measuring - defaults to 0", 1 },
+        { "duration", { "-d", "--duration" }, "seconds to measure - defaults to 10", 1 },
+        { "security", { "--security" }, "shared-secret (default) or public-key, in-process only", 1 },
+        { "gcm", { "--gcm" }, "use AES-256-GCM session messages instead of HMAC-SHA256, in-process only", 0 },
+        { "proxy", { "--proxy" }, "plaintext endpoint of the initiator proxy, <address>:<port>", 1 },
+        { "echo", { "--echo" }, "endpoint the echo servers listen on for the responder proxy, <address>:<port>", 1 },
+    } };
+
+    try {
+        const auto results = parser.parse(argc, argv);
+
+        if (results.has_option("help")) {
+            std::cout << parser << std::endl;
+            return 0;
+        }
+
+        const auto config = get_config(results);
+
+        ssp21::sodium::initialize();
+        raise_file_limit();
+
+        LoadGenerator generator(config);
+        const auto result = generator.run();
+
+        print_report(config, result);
+
+        return (result.statistics.num_corrupt_bytes > 0) ? -1 : 0;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl
+                  << std::endl;
+        std::cout << parser << std::endl;
+        return -1;
+    }
+}
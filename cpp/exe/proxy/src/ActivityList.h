@@ -0,0 +1,154 @@
+#ifndef SSP21PROXY_ACTIVITYLIST_H
+#define SSP21PROXY_ACTIVITYLIST_H
+
+#include <exe4cpp/IExecutor.h>
+#include <exe4cpp/Typedefs.h>
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <cstddef>
+#include <memory>
+
+class ActivityList;
+
+/**
+ * Intrusive member of an ActivityList, embedded in whatever is being tracked
+ */
+class ActivityNode : private ser4cpp::Uncopyable {
+    friend class ActivityList;
+
+public:
+    ActivityNode() = default;
+
+    inline ~ActivityNode();
+
+    // records activity now and moves the node to the front of its list in O(1)
+    inline void touch();
+
+    exe4cpp::steady_time_t get_last_activity() const
+    {
+        return this->last_activity;
+    }
+
+private:
+    ActivityList* list = nullptr;
+    ActivityNode* prev = nullptr;
+    ActivityNode* next = nullptr;
+    exe4cpp::steady_time_t last_activity;
+};
+
+/**
+ * Doubly-linked list of nodes ordered from the most to the least recently active.
+ *
+ * Nothing is allocated: insertion, removal and touching a node are constant time, and the least
+ * recently active node is always at the back. Activity is timed with the clock of the executor.
+ */
+class ActivityList : private ser4cpp::Uncopyable {
+
+public:
+    explicit ActivityList(const std::shared_ptr<exe4cpp::IExecutor>& executor)
+        : executor(executor)
+    {
+    }
+
+    ~ActivityList()
+    {
+        while (this->tail) {
+            this->remove(*this->tail);
+        }
+    }
+
+    void push_front(ActivityNode& node)
+    {
+        if (node.list) {
+            node.list->remove(node);
+        }
+
+        node.list = this;
+        node.last_activity = this->executor->get_time();
+        this->link_front(node);
+        ++this->count;
+    }
+
+    void remove(ActivityNode& node)
+    {
+        if (node.list != this)
+            return;
+
+        this->unlink(node);
+        node.list = nullptr;
+        --this->count;
+    }
+
+    void touch(ActivityNode& node)
+    {
+        node.last_activity = this->executor->get_time();
+
+        if (this->head == &node)
+            return;
+
+        this->unlink(node);
+        this->link_front(node);
+    }
+
+    ActivityNode* least_recent() const
+    {
+        return this->tail;
+    }
+
+    size_t size() const
+    {
+        return this->count;
+    }
+
+private:
+    void link_front(ActivityNode& node)
+    {
+        node.prev = nullptr;
+        node.next = this->head;
+        if (this->head) {
+            this->head->prev = &node;
+        } else {
+            this->tail = &node;
+        }
+        this->head = &node;
+    }
+
+    void unlink(ActivityNode& node)
+    {
+        if (node.prev) {
+            node.prev->next = node.next;
+        } else {
+            this->head = node.next;
+        }
+
+        if (node.next) {
+            node.next->prev = node.prev;
+        } else {
+            this->tail = node.prev;
+        }
+
+        node.prev = nullptr;
+        node.next = nullptr;
+    }
+
+    const std::shared_ptr<exe4cpp::IExecutor> executor;
+    ActivityNode* head = nullptr;
+    ActivityNode* tail = nullptr;
+    size_t count = 0;
+};
+
+ActivityNode::~ActivityNode()
+{
+    if (this->list) {
+        this->list->remove(*this);
+    }
+}
+
+void ActivityNode::touch()
+{
+    if (this->list) {
+        this->list->touch(*this);
+    }
+}
+
+#endif
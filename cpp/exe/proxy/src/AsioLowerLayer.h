@@ -3,9 +3,11 @@
 
 #include "IAsioLayer.h"
 #include "IAsioSocketWrapper.h"
+#include "LatencyTrace.h"
 
 #include <ssp21/stack/ILowerLayer.h>
 #include <ssp21/stack/IUpperLayer.h>
+#include <ssp21/util/FlightRecorder.h>
 
 #include <log4cpp/LogMacros.h>
 
@@ -27,6 +29,12 @@ public:
         this->upper->on_lower_open();
     }
 
+    // optional, must outlive the layer
+    void set_latency_trace(LatencyTrace* trace)
+    {
+        this->latency_trace = trace;
+    }
+
     bool close()
     {
         this->socket->try_close_socket();
@@ -38,6 +46,9 @@ private:
 
     bool start_tx_from_upper(const ssp21::seq32_t& data) override
     {
+        if (this->latency_trace)
+            this->latency_trace->on_tx_frame();
+
         return this->socket->start_tx_to_socket(data);
     }
 
@@ -53,8 +64,12 @@ private:
 
     ssp21::seq32_t start_rx_from_upper_impl() override
     {
-        if (this->unread_data.is_empty())
+        if (this->unread_data.is_empty()) {
+            // the socket may hand over data it already buffered before this call returns
+            this->is_upper_reading = true;
             this->socket->start_rx_from_socket();
+            this->is_upper_reading = false;
+        }
 
         return this->unread_data;
     }
@@ -64,17 +79,29 @@ public:
 
     void on_rx_complete(const ssp21::seq32_t& data) override
     {
+        ssp21::FlightRecorder::record(ssp21::FlightEventType::socket_rx, this, socket_side, data.length());
+        if (this->latency_trace)
+            this->latency_trace->on_ssp21_rx();
+
         this->unread_data = data;
-        this->upper->on_lower_rx_ready();
+
+        // the upper layer is already waiting on the return value of start_rx_from_upper()
+        if (!this->is_upper_reading)
+            this->upper->on_lower_rx_ready();
     }
 
     void on_rx_or_tx_error() override
     {
+        ssp21::FlightRecorder::record(ssp21::FlightEventType::socket_error, this, socket_side);
         this->upper->on_lower_close();
     }
 
     void on_tx_complete() override
     {
+        ssp21::FlightRecorder::record(ssp21::FlightEventType::socket_tx, this, socket_side);
+        if (this->latency_trace)
+            this->latency_trace->on_tx_frame_written();
+
         this->upper->on_lower_tx_ready();
     }
 
@@ -84,9 +111,13 @@ public:
     }
 
 private:
+    static const uint16_t socket_side = 0;
+
     IAsioSocketWrapper* socket = nullptr;
     ssp21::IUpperLayer* upper = nullptr;
+    LatencyTrace* latency_trace = nullptr;
     ssp21::seq32_t unread_data;
+    bool is_upper_reading = false;
 };
 
 #endif
@@ -1,58 +1,234 @@
 #ifndef SSP21PROXY_ASIOUPPERLAYER_H
 #define SSP21PROXY_ASIOUPPERLAYER_H
 
+#include <ssp21/link/LinkConstants.h>
 #include <ssp21/stack/ILowerLayer.h>
+#include <ssp21/stack/IUpperLayer.h>
+#include <ssp21/stack/LogLevels.h>
+#include <ssp21/util/FlightRecorder.h>
+
+#include <log4cpp/LogMacros.h>
+#include <log4cpp/Logger.h>
+#include <ser4cpp/container/Buffer.h>
 
 #include "IAsioLayer.h"
+#include "IAsioSocketWrapper.h"
+#include "LatencyTrace.h"
+#include "PlaintextQueueConfig.h"
+#include "framing/MessageAssembler.h"
 
+#include <cstring>
 #include <functional>
+#include <limits>
+#include <vector>
 
+/**
+ * Moves plaintext between the raw socket and the crypto layer.
+ *
+ * Socket reads are cut into messages by the configured framing and the messages are copied into
+ * a bounded queue so that the next socket read is in flight while the crypto layer encrypts and
+ * transmits the message at the head of the queue. A partial message waits for the rest of its bytes.
+ */
 class AsioUpperLayer final : public ssp21::IUpperLayer, public IAsioLayer {
 
 public:
-    AsioUpperLayer(const log4cpp::Logger& logger)
+    AsioUpperLayer(const log4cpp::Logger& logger, const PlaintextQueueConfig& config = PlaintextQueueConfig())
+        : logger(logger)
+        , high_watermark(config.high_watermark)
+        , low_watermark(config.low_watermark)
+        , queue_buffer(config.depth * ssp21::consts::link::max_frame_size)
+        , queue_lengths(config.depth, 0)
+        , assembler(config.framing)
     {
     }
 
-    void bind(IAsioSocketWrapper& socket, ssp21::ILowerLayer& crypto_layer, const std::function<void()>& error_handler)
+    void bind(ssp21::ILowerLayer& crypto_layer, const std::function<void()>& error_handler)
     {
-        this->socket = &socket;
         this->crypto_layer = &crypto_layer;
         this->error_handler = error_handler;
     }
 
+    // optional, must outlive the layer
+    void set_latency_trace(LatencyTrace* trace)
+    {
+        this->latency_trace = trace;
+    }
+
+    /**
+     * The socket may be attached after the crypto layer has opened, e.g. to a pre-established
+     * session. Until then, decrypted data waits in the crypto layer.
+     *
+     * The socket is read right away. Until the session opens, the chunks wait in the queue unless
+     * the crypto layer accepts them as early data.
+     */
+    void attach_socket(IAsioSocketWrapper& socket)
+    {
+        this->socket = &socket;
+
+        this->start_socket_rx();
+        if (this->is_open()) {
+            this->try_read_from_crypto();
+        }
+    }
+
 private:
     void try_read_from_crypto()
     {
+        if (!this->socket)
+            return;
+
         const auto data = this->crypto_layer->start_rx_from_upper();
-        if (data.is_not_empty())
+        if (data.is_not_empty()) {
+            if (this->latency_trace)
+                this->latency_trace->on_rx_decrypted();
+
             this->socket->start_tx_to_socket(data);
+        }
+    }
+
+    // --- plaintext queue ---
+
+    uint32_t get_depth() const
+    {
+        return static_cast<uint32_t>(this->queue_lengths.size());
+    }
+
+    ssp21::seq32_t get_queue_head() const
+    {
+        return this->queue_buffer.as_rslice().skip(this->queue_head * ssp21::consts::link::max_frame_size).take(this->queue_lengths[this->queue_head]);
+    }
+
+    void start_socket_rx()
+    {
+        if (this->socket && !this->is_rx_paused && this->queue_count < this->get_depth() && this->assembler.can_accept())
+            this->socket->start_rx_from_socket();
+    }
+
+    void try_write_to_crypto()
+    {
+        if (this->is_head_in_crypto || this->queue_count == 0)
+            return;
+
+        // the crypto layer may hand the first frame to the lower layer before this call returns
+        if (this->queue_head == this->traced_slot)
+            this->latency_trace->on_tx_to_crypto();
+
+        // the crypto layer holds onto the chunk until it calls on_lower_tx_ready()
+        this->is_head_in_crypto = this->crypto_layer->start_tx_from_upper(this->get_queue_head());
+    }
+
+    void pop_queue_head()
+    {
+        if (this->queue_head == this->traced_slot) {
+            this->latency_trace->on_tx_done();
+            this->traced_slot = no_traced_slot;
+        }
+
+        this->queue_head = (this->queue_head + 1) % this->get_depth();
+        --this->queue_count;
+
+        if (this->is_rx_paused && this->queue_count <= this->low_watermark) {
+            FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "plaintext queue at low watermark (%u), resuming socket rx", this->queue_count);
+            this->is_rx_paused = false;
+        }
+    }
+
+    // move the complete messages held by the assembler into the free queue slots
+    bool queue_messages()
+    {
+        while (this->queue_count < this->get_depth()) {
+            ssp21::seq32_t message;
+            const auto result = this->assembler.next(message);
+
+            if (result == FramingResult::need_more) {
+                return true;
+            }
+
+            if (result == FramingResult::invalid) {
+                SIMPLE_LOG_BLOCK(this->logger, ssp21::levels::warn, "invalid message header in plaintext stream, closing session");
+                this->clear_queue();
+                this->error_handler();
+                return false;
+            }
+
+            const auto index = (this->queue_head + this->queue_count) % this->get_depth();
+            auto dest = this->queue_buffer.as_wslice().skip(index * ssp21::consts::link::max_frame_size);
+            memcpy(dest, message, message.length());
+            this->queue_lengths[index] = message.length();
+            ++this->queue_count;
+            this->assembler.pop(message.length());
+
+            if (this->latency_trace && this->latency_trace->on_plaintext_rx())
+                this->traced_slot = index;
+
+            if (!this->is_rx_paused && this->queue_count >= this->high_watermark) {
+                FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "plaintext queue at high watermark (%u), pausing socket rx", this->queue_count);
+                this->is_rx_paused = true;
+            }
+        }
+
+        return true;
+    }
+
+    void clear_queue()
+    {
+        this->assembler.clear();
+        this->queue_head = 0;
+        this->queue_count = 0;
+        this->is_head_in_crypto = false;
+        this->is_rx_paused = false;
+
+        if (this->traced_slot != no_traced_slot) {
+            this->latency_trace->cancel_tx();
+            this->traced_slot = no_traced_slot;
+        }
     }
 
     // --- IUpperLayer ---
 
     void on_lower_open_impl() override
     {
-        this->socket->start_rx_from_socket();
+        // chunks read before the session opened
+        this->try_write_to_crypto();
+        this->start_socket_rx();
     }
 
     void on_lower_close_impl() override
     {
-        this->socket->try_close_socket();
+        this->clear_queue();
+        if (this->socket) {
+            this->socket->try_close_socket();
+        }
         this->error_handler();
     }
 
+    void on_lower_tx_dropped_impl() override
+    {
+        // the responder may have delivered the early data, the client has to find out by reconnecting
+        SIMPLE_LOG_BLOCK(this->logger, ssp21::levels::warn, "handshake carrying early data failed, closing the plaintext connection");
+        this->on_lower_close_impl();
+    }
+
     void on_lower_tx_ready_impl() override
     {
-        // read more data from the socket
-        this->socket->start_rx_from_socket();
+        // the chunk at the head of the queue has been completely transmitted
+        if (this->is_head_in_crypto) {
+            this->is_head_in_crypto = false;
+            this->pop_queue_head();
+        }
+
+        if (!this->queue_messages())
+            return;
+
+        this->try_write_to_crypto();
+        this->start_socket_rx();
     }
 
     void on_lower_rx_ready_impl() override
     {
         // crypto layer has data to be read
         // try to read it if we're not already transmitting
-        if (!this->socket->get_is_tx_active())
+        if (this->socket && !this->socket->get_is_tx_active())
             this->try_read_from_crypto();
     }
 
@@ -61,12 +237,30 @@ public:
 
     void on_rx_complete(const ssp21::seq32_t& data) override
     {
-        // when we receive socket data, try writing it to the crypto layer
-        this->crypto_layer->start_tx_from_upper(data);
+        ssp21::FlightRecorder::record(ssp21::FlightEventType::socket_rx, this, socket_side, data.length());
+
+        // copy the data so the socket can reuse its buffer for the next read
+        if (!this->assembler.append(data)) {
+            // skipping bytes of a stream would splice the messages around them
+            SIMPLE_LOG_BLOCK(this->logger, ssp21::levels::warn, "plaintext queue overflow, closing session");
+            this->clear_queue();
+            this->error_handler();
+            return;
+        }
+
+        if (!this->queue_messages())
+            return;
+
+        this->try_write_to_crypto();
+        this->start_socket_rx();
     }
 
     void on_tx_complete() override
     {
+        ssp21::FlightRecorder::record(ssp21::FlightEventType::socket_tx, this, socket_side);
+        if (this->latency_trace)
+            this->latency_trace->on_plaintext_written();
+
         // when we successfully transmit to the socket,
         // try to read more data from the crypto layer
         this->try_read_from_crypto();
@@ -74,18 +268,40 @@ public:
 
     void on_rx_or_tx_error() override
     {
+        ssp21::FlightRecorder::record(ssp21::FlightEventType::socket_error, this, socket_side);
         this->error_handler();
     }
 
     bool is_active() const override
     {
-        return this->socket->is_active();
+        return this->socket && this->socket->is_active();
     }
 
 private:
+    static const uint16_t socket_side = 1;
+    static const uint32_t no_traced_slot = std::numeric_limits<uint32_t>::max();
+
+    log4cpp::Logger logger;
     ssp21::ILowerLayer* crypto_layer = nullptr;
     IAsioSocketWrapper* socket = nullptr;
     std::function<void()> error_handler = nullptr;
+    LatencyTrace* latency_trace = nullptr;
+
+    const uint32_t high_watermark;
+    const uint32_t low_watermark;
+
+    // ring of chunks waiting to be encrypted, starting at queue_head
+    ser4cpp::Buffer queue_buffer;
+    std::vector<uint32_t> queue_lengths;
+    uint32_t queue_head = 0;
+    uint32_t queue_count = 0;
+    bool is_head_in_crypto = false;
+    bool is_rx_paused = false;
+    // the queue slot of the chunk being traced
+    uint32_t traced_slot = no_traced_slot;
+
+    // socket data that hasn't been cut into messages yet
+    MessageAssembler assembler;
 };
 
 #endif
@@ -0,0 +1,91 @@
+#ifndef SSP21PROXY_CLOSEMETRICS_H
+#define SSP21PROXY_CLOSEMETRICS_H
+
+#include <exe4cpp/Typedefs.h>
+#include <log4cpp/LogMacros.h>
+#include <log4cpp/Logger.h>
+#include <ssp21/stack/LogLevels.h>
+
+#include <chrono>
+
+/**
+ * Time it takes sessions to release their sockets after shutdown is requested, and how many
+ * sessions were closed by the proxy itself to enforce a limit
+ */
+class CloseMetrics {
+
+public:
+    enum class Eviction : uint8_t {
+        // no activity for longer than the idle timeout
+        idle,
+        // least recently active session closed to make room for a new one
+        capacity
+    };
+
+    CloseMetrics(const log4cpp::Logger& logger)
+        : logger(logger)
+    {
+    }
+
+    void record(const exe4cpp::duration_t& time_to_close, bool deadline_exceeded)
+    {
+        ++this->num_closed;
+        if (deadline_exceeded) {
+            ++this->num_deadline_exceeded;
+        }
+
+        this->total_time_to_close += time_to_close;
+        if (time_to_close > this->max_time_to_close) {
+            this->max_time_to_close = time_to_close;
+        }
+
+        FORMAT_LOG_BLOCK(
+            this->logger,
+            ssp21::levels::metric,
+            "session closed in %lld us (closed: %llu, mean: %lld us, max: %lld us, deadline exceeded: %llu, evicted idle: %llu, evicted at capacity: %llu)",
+            to_micros(time_to_close),
+            static_cast<unsigned long long>(this->num_closed),
+            to_micros(this->total_time_to_close / this->num_closed),
+            to_micros(this->max_time_to_close),
+            static_cast<unsigned long long>(this->num_deadline_exceeded),
+            static_cast<unsigned long long>(this->num_evicted_idle),
+            static_cast<unsigned long long>(this->num_evicted_capacity));
+    }
+
+    // counted when the session is shut down, its close is recorded once the sockets are released
+    void record_eviction(Eviction reason)
+    {
+        if (reason == Eviction::idle) {
+            ++this->num_evicted_idle;
+        } else {
+            ++this->num_evicted_capacity;
+        }
+    }
+
+    uint64_t get_num_evicted_idle() const
+    {
+        return this->num_evicted_idle;
+    }
+
+    uint64_t get_num_evicted_capacity() const
+    {
+        return this->num_evicted_capacity;
+    }
+
+private:
+    static long long to_micros(const exe4cpp::duration_t& duration)
+    {
+        return static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    }
+
+    log4cpp::Logger logger;
+
+    uint64_t num_closed = 0;
+    uint64_t num_deadline_exceeded = 0;
+    uint64_t num_evicted_idle = 0;
+    uint64_t num_evicted_capacity = 0;
+    exe4cpp::duration_t total_time_to_close = exe4cpp::duration_t::zero();
+    exe4cpp::duration_t max_time_to_close = exe4cpp::duration_t::zero();
+};
+
+#endif
@@ -3,19 +3,27 @@
 
 #include "StackConfigReader.h"
 
+#include "LatencyTracingConfig.h"
 #include "LogConfig.h"
+#include "PlaintextQueueConfig.h"
 #include "YAMLHelpers.h"
+#include "serial/SerialProxySession.h"
 #include "tcp/TcpProxySession.h"
+#include "udp/UdpPeerProxySession.h"
 #include "udp/UdpProxySession.h"
 
 #include <ssp21/util/Exception.h>
 
+#include <algorithm>
+
 using namespace ssp21;
 
 namespace config {
 enum class TransportType {
     TCP,
-    UDP
+    UDP,
+    UDP_PEERS,
+    SERIAL
 };
 
 TransportType get_transport_type(const YAML::Node& node)
@@ -30,10 +38,42 @@ TransportType get_transport_type(const YAML::Node& node)
         return TransportType::UDP;
     }
 
+    if (type == "udp_peers") {
+        return TransportType::UDP_PEERS;
+    }
+
+    if (type == "serial") {
+        return TransportType::SERIAL;
+    }
+
     throw yaml::YAMLException(node.Mark(), "Unknown transport type: ", type);
 }
 
-proxy_session_factory_t get_session_factory(const YAML::Node& node)
+log4cpp::Logger get_session_logger(const log4cpp::Logger& logger, const LogConfig& logging, const WorkerAssignment& worker)
+{
+    const auto session_logger = logger.detach(logging.id, logging.levels);
+
+    // replicated sessions need distinct ids per worker
+    return worker.is_shared() ? session_logger.detach_and_append("-w", worker.index) : session_logger;
+}
+
+std::string get_restart_signature(const YAML::Node& node)
+{
+    // the transport and link-layer shape the sockets and layers of a running session
+    std::string signature = yaml::require_string(yaml::require(node, "security"), "mode");
+    for (const auto key : { "link_layer", "plaintext_queue", "plaintext_framing", "latency_tracing", "transport" }) {
+        const auto child = node[key];
+        signature += "\n";
+        signature += key;
+        signature += ":\n";
+        if (child) {
+            signature += YAML::Dump(child);
+        }
+    }
+    return signature;
+}
+
+ProxySessionFactory get_session_factory(const YAML::Node& node)
 {
     // read the logging parameters
     const LogConfig logging(node);
@@ -41,32 +81,101 @@ proxy_session_factory_t get_session_factory(const YAML::Node& node)
     // read the SSP21 parameters before we even bother with the transport
     const auto factory = config::get_stack_factory(node);
 
+    const PlaintextQueueConfig queue_config(node);
+
+    const LatencyTracingConfig tracing_config(node);
+
     // the yaml node under which
     const auto transport = yaml::require(node, "transport");
 
     const auto type = get_transport_type(transport);
 
+    const auto signature = get_restart_signature(node);
+
     if (type == TransportType::TCP) {
         if (!factory.get_uses_link_layer()) {
             throw yaml::YAMLException(transport, "TCP transport may only be used inconjunction with the SSP21 link-layer");
         }
 
         TcpConfig config(transport);
-        return [=](const log4cpp::Logger& logger, std::shared_ptr<exe4cpp::BasicExecutor> executor) {
-            return std::make_unique<TcpProxySession>(
-                config,
-                factory,
-                executor,
-                logger.detach(logging.id, logging.levels));
+        if (config.warm_pool_size > 0 && factory.get_type() != StackType::initiator) {
+            throw yaml::YAMLException(transport, "warm_pool_size may only be used with an initiator");
+        }
+
+        // one instance per worker, but never more instances than sessions allowed
+        return ProxySessionFactory{
+            std::max<uint32_t>(config.max_sessions, 1),
+            [=](const log4cpp::Logger& logger, std::shared_ptr<exe4cpp::BasicExecutor> executor, const WorkerAssignment& worker) {
+                return std::make_unique<TcpProxySession>(
+                    config,
+                    factory,
+                    queue_config,
+                    tracing_config,
+                    executor,
+                    get_session_logger(logger, logging, worker),
+                    worker);
+            },
+            logging.id,
+            logging.levels,
+            signature,
+            factory
+        };
+    } else if (type == TransportType::SERIAL) {
+        // a serial device can only be opened once
+        SerialConfig config(transport);
+        return ProxySessionFactory{
+            1,
+            [=](const log4cpp::Logger& logger, std::shared_ptr<exe4cpp::BasicExecutor> executor, const WorkerAssignment& worker) {
+                return std::make_unique<SerialProxySession>(
+                    config,
+                    factory,
+                    queue_config,
+                    tracing_config,
+                    executor,
+                    get_session_logger(logger, logging, worker));
+            },
+            logging.id,
+            logging.levels,
+            signature,
+            factory
+        };
+    } else if (type == TransportType::UDP_PEERS) {
+        // the shared secure socket is bound to a fixed endpoint, so only one worker can own it
+        UdpPeersConfig config(transport);
+        return ProxySessionFactory{
+            1,
+            [=](const log4cpp::Logger& logger, std::shared_ptr<exe4cpp::BasicExecutor> executor, const WorkerAssignment& worker) {
+                return std::make_unique<UdpPeerProxySession>(
+                    config,
+                    factory,
+                    queue_config,
+                    tracing_config,
+                    executor,
+                    get_session_logger(logger, logging, worker));
+            },
+            logging.id,
+            logging.levels,
+            signature,
+            factory
         };
     } else {
+        // the UDP sockets are bound to fixed endpoints, so only one worker can own them
         UdpConfig config(transport);
-        return [=](const log4cpp::Logger& logger, std::shared_ptr<exe4cpp::BasicExecutor> executor) {
-            return std::make_unique<UdpProxySession>(
-                config,
-                factory,
-                executor,
-                logger.detach(logging.id, logging.levels));
+        return ProxySessionFactory{
+            1,
+            [=](const log4cpp::Logger& logger, std::shared_ptr<exe4cpp::BasicExecutor> executor, const WorkerAssignment& worker) {
+                return std::make_unique<UdpProxySession>(
+                    config,
+                    factory,
+                    queue_config,
+                    tracing_config,
+                    executor,
+                    get_session_logger(logger, logging, worker));
+            },
+            logging.id,
+            logging.levels,
+            signature,
+            factory
         };
     }
 }
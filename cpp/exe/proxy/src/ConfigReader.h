@@ -6,7 +6,7 @@
 #include <yaml-cpp/yaml.h>
 
 namespace config {
-proxy_session_factory_t get_session_factory(const YAML::Node& node);
+ProxySessionFactory get_session_factory(const YAML::Node& node);
 }
 
 #endif
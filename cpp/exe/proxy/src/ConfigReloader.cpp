@@ -0,0 +1,274 @@
+#include "ConfigReloader.h"
+
+#include "ProxyConfig.h"
+
+#include <log4cpp/LogMacros.h>
+#include <ssp21/stack/LogLevels.h>
+#include <ssp21/util/Exception.h>
+
+#include <algorithm>
+#include <csignal>
+#include <future>
+#include <set>
+#include <stdexcept>
+
+using namespace ssp21;
+
+namespace {
+// runs the action on the thread of the executor and waits for it, exceptions are rethrown to the caller
+template <class Action>
+auto run_on_worker(const std::shared_ptr<exe4cpp::BasicExecutor>& executor, Action action) -> decltype(action())
+{
+    const auto task = std::make_shared<std::packaged_task<decltype(action())()>>(std::move(action));
+    auto result = task->get_future();
+    executor->post([task]() { (*task)(); });
+    return result.get();
+}
+}
+
+const std::chrono::seconds ConfigReloader::release_period(10);
+
+ConfigReloader::ConfigReloader(const std::string& config_file_path, const log4cpp::Logger& logger, const WorkerPool& workers)
+    : config_file_path(config_file_path)
+    , read_sessions([config_file_path]() { return config::read_sessions(config_file_path); })
+    , logger(logger)
+    , workers(workers)
+    , signal_service(std::make_shared<asio::io_service>())
+    , executor(exe4cpp::BasicExecutor::create(this->signal_service))
+    , signals(*this->signal_service)
+{
+}
+
+ConfigReloader::ConfigReloader(const session_reader_t& read_sessions, const log4cpp::Logger& logger, const WorkerPool& workers, const std::shared_ptr<exe4cpp::IExecutor>& executor)
+    : read_sessions(read_sessions)
+    , logger(logger)
+    , workers(workers)
+    , signal_service(std::make_shared<asio::io_service>())
+    , executor(executor)
+    , signals(*this->signal_service)
+{
+}
+
+ConfigReloader::~ConfigReloader()
+{
+    this->signal_service->stop();
+    if (this->signal_thread.joinable()) {
+        this->signal_thread.join();
+    }
+
+    // a pending timer holds on to the executor of the signal thread, which holds on to its io context
+    this->release_timer.cancel();
+    this->signal_service->restart();
+    this->signal_service->poll();
+}
+
+void ConfigReloader::start()
+{
+    // QKD sources run their own reader threads and their key stores are synchronized, so any worker can own them
+    this->start(config::read(this->config_file_path, this->workers.get(0), this->logger));
+
+    this->signals.add(SIGHUP);
+    this->wait_for_signal();
+    this->signal_thread = std::thread([this]() { this->signal_service->run(); });
+}
+
+void ConfigReloader::start(const std::vector<ProxySessionFactory>& factories)
+{
+    if (factories.empty()) {
+        throw std::logic_error("no proxy sessions were specified");
+    }
+
+    check_unique_ids(factories);
+
+    // initialize all the proxies. might throw on bad configuration.
+    for (auto& factory : factories) {
+        this->launch(factory);
+    }
+
+    for (size_t i = 0; i < this->workers.size(); ++i) {
+        this->keep_alive.push_back(std::make_unique<asio::io_service::work>(*this->workers.get(i)->get_service()));
+    }
+
+    this->is_started = true;
+}
+
+void ConfigReloader::wait_for_signal()
+{
+    this->signals.async_wait([this](const std::error_code& ec, int) {
+        if (ec)
+            return;
+
+        FORMAT_LOG_BLOCK(this->logger, levels::event, "reloading configuration from %s", this->config_file_path.c_str());
+        this->reload();
+        this->wait_for_signal();
+    });
+}
+
+void ConfigReloader::reload()
+{
+    std::vector<ProxySessionFactory> factories;
+    try {
+        factories = this->read_sessions();
+        check_unique_ids(factories);
+    } catch (const std::exception& ex) {
+        FORMAT_LOG_BLOCK(this->logger, levels::error, "configuration not reloaded, running sessions are unchanged: %s", ex.what());
+        return;
+    }
+
+    // drain first so that a restarted session can bind the same endpoints again
+    for (auto iter = this->sessions.begin(); iter != this->sessions.end();) {
+        const auto& id = iter->first;
+        const auto next = std::find_if(factories.begin(), factories.end(), [&id](const ProxySessionFactory& factory) {
+            return factory.id == id;
+        });
+
+        if (next == factories.end() || next->restart_signature != iter->second.factory.restart_signature) {
+            if (next == factories.end()) {
+                FORMAT_LOG_BLOCK(this->logger, levels::info, "session %s was removed, draining", id.c_str());
+            } else {
+                FORMAT_LOG_BLOCK(this->logger, levels::info, "configuration of session %s changed, restarting", id.c_str());
+            }
+            this->retire(iter->second);
+            iter = this->sessions.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    uint32_t num_started = 0;
+    uint32_t num_updated = 0;
+    uint32_t num_failed = 0;
+
+    for (const auto& factory : factories) {
+        const auto iter = this->sessions.find(factory.id);
+        if (iter != this->sessions.end()) {
+            this->update(iter->second, factory);
+            ++num_updated;
+            continue;
+        }
+
+        try {
+            this->launch(factory);
+            ++num_started;
+        } catch (const std::exception& ex) {
+            FORMAT_LOG_BLOCK(this->logger, levels::error, "unable to start session %s: %s", factory.id.c_str(), ex.what());
+            ++num_failed;
+        }
+    }
+
+    this->release_drained();
+
+    FORMAT_LOG_BLOCK(
+        this->logger,
+        levels::event,
+        "configuration reloaded: %u started, %u updated in place, %u failed to start, %u draining",
+        num_started,
+        num_updated,
+        num_failed,
+        static_cast<uint32_t>(this->retired.size()));
+
+    this->start_release_timer();
+}
+
+void ConfigReloader::launch(const ProxySessionFactory& factory)
+{
+    RunningSession running{ factory, {} };
+
+    try {
+        const auto num_instances = std::min<size_t>(factory.max_instances, this->workers.size());
+        if (num_instances > 1) {
+            for (size_t i = 0; i < num_instances; ++i) {
+                running.instances.push_back(Instance{ this->workers.get(i), this->create_on_worker(factory, i, WorkerAssignment{ i, num_instances }) });
+            }
+        } else {
+            running.instances.push_back(Instance{ this->workers.get(this->next_worker), this->create_on_worker(factory, this->next_worker, WorkerAssignment{ this->next_worker, 1 }) });
+            this->next_worker = (this->next_worker + 1) % this->workers.size();
+        }
+    } catch (...) {
+        // instances already running on other workers have to be released there
+        if (this->is_started) {
+            this->retire(running);
+        }
+        throw;
+    }
+
+    this->sessions.emplace(factory.id, std::move(running));
+}
+
+void ConfigReloader::retire(RunningSession& running)
+{
+    for (auto& instance : running.instances) {
+        run_on_worker(instance.executor, [&instance]() { instance.session->drain(); });
+        this->retired.push_back(std::move(instance));
+    }
+
+    running.instances.clear();
+}
+
+void ConfigReloader::update(RunningSession& running, const ProxySessionFactory& factory)
+{
+    // the factory carries key material read again from disk, established sessions keep what they have
+    for (auto& instance : running.instances) {
+        run_on_worker(instance.executor, [&instance, &factory]() {
+            instance.session->set_log_levels(factory.levels);
+            instance.session->set_stack_factory(factory.stack_factory);
+        });
+    }
+
+    running.factory = factory;
+}
+
+void ConfigReloader::release_drained()
+{
+    for (auto iter = this->retired.begin(); iter != this->retired.end();) {
+        auto& instance = *iter;
+
+        const auto released = run_on_worker(instance.executor, [&instance]() {
+            if (!instance.session->is_drained()) {
+                return false;
+            }
+
+            // released on its own worker, where its sockets and timers live
+            instance.session.reset();
+            return true;
+        });
+
+        iter = released ? this->retired.erase(iter) : std::next(iter);
+    }
+}
+
+void ConfigReloader::start_release_timer()
+{
+    if (this->retired.empty())
+        return;
+
+    this->release_timer.cancel();
+    this->release_timer = this->executor->start(release_period, [this]() {
+        this->release_drained();
+        this->start_release_timer();
+    });
+}
+
+std::unique_ptr<IProxySession> ConfigReloader::create_on_worker(const ProxySessionFactory& factory, size_t worker, const WorkerAssignment& assignment)
+{
+    const auto& executor = this->workers.get(worker);
+
+    auto create = [this, &factory, &executor, &assignment]() {
+        auto session = factory.create(this->logger, executor, assignment);
+        session->start();
+        return session;
+    };
+
+    // until the workers run, nothing else touches the sessions
+    return this->is_started ? run_on_worker(executor, create) : create();
+}
+
+void ConfigReloader::check_unique_ids(const std::vector<ProxySessionFactory>& factories)
+{
+    std::set<std::string> ids;
+    for (const auto& factory : factories) {
+        if (!ids.insert(factory.id).second) {
+            throw Exception("Duplicate session id: ", factory.id);
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#ifndef SSP21PROXY_CONFIGRELOADER_H
+#define SSP21PROXY_CONFIGRELOADER_H
+
+#include "IProxySession.h"
+#include "ProxySessionFactory.h"
+#include "WorkerPool.h"
+
+#include <exe4cpp/Timer.h>
+#include <exe4cpp/asio/BasicExecutor.h>
+#include <log4cpp/Logger.h>
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <asio.hpp>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Owns the running proxy sessions and applies changes to the configuration file when the process
+ * receives SIGHUP, without disturbing the sessions that didn't change.
+ *
+ * Sessions are matched by id. New sessions are started, removed sessions are drained, and
+ * sessions whose transport, link-layer, plaintext queue, latency tracing or security mode changed are drained and
+ * started again. Every other session keeps running; its log levels are applied in place and the
+ * re-read security settings and key material are used for stacks it creates from then on.
+ *
+ * Only the sessions are reloaded. The logging backend, worker threads and QKD sources are read
+ * once at startup, and sessions may only refer to QKD sources that existed then.
+ *
+ * A reload is read and applied on a dedicated thread, waiting on the worker of each session in
+ * turn. A configuration that fails to parse, or that repeats a session id, leaves the running
+ * sessions untouched.
+ */
+class ConfigReloader final : private ser4cpp::Uncopyable {
+
+    struct Instance {
+        std::shared_ptr<exe4cpp::BasicExecutor> executor;
+        std::unique_ptr<IProxySession> session;
+    };
+
+    struct RunningSession {
+        ProxySessionFactory factory;
+        std::vector<Instance> instances;
+    };
+
+public:
+    // reads the sessions of the configuration, throws if it can't be parsed
+    using session_reader_t = std::function<std::vector<ProxySessionFactory>()>;
+
+    // how often retired sessions are checked until they have all drained
+    static const std::chrono::seconds release_period;
+
+    ConfigReloader(const std::string& config_file_path, const log4cpp::Logger& logger, const WorkerPool& workers);
+
+    /**
+     * Reads the sessions with the supplied function and checks retired sessions on the supplied
+     * executor. Nothing listens for SIGHUP, reload() is only called by the owner.
+     */
+    ConfigReloader(const session_reader_t& read_sessions, const log4cpp::Logger& logger, const WorkerPool& workers, const std::shared_ptr<exe4cpp::IExecutor>& executor);
+
+    ~ConfigReloader();
+
+    /**
+     * Create and start the configured sessions, then begin listening for SIGHUP.
+     *
+     * Called before the workers run. Throws on configuration errors.
+     */
+    void start();
+
+    // create and start the sessions, called before the workers run
+    void start(const std::vector<ProxySessionFactory>& factories);
+
+    // read the sessions again and apply the differences, called on the thread of the executor
+    void reload();
+
+private:
+    void wait_for_signal();
+
+    void launch(const ProxySessionFactory& factory);
+
+    void retire(RunningSession& running);
+
+    void update(RunningSession& running, const ProxySessionFactory& factory);
+
+    // releases the retired sessions that have finished draining
+    void release_drained();
+
+    void start_release_timer();
+
+    std::unique_ptr<IProxySession> create_on_worker(const ProxySessionFactory& factory, size_t worker, const WorkerAssignment& assignment);
+
+    static void check_unique_ids(const std::vector<ProxySessionFactory>& factories);
+
+    const std::string config_file_path;
+    const session_reader_t read_sessions;
+    log4cpp::Logger logger;
+    const WorkerPool& workers;
+
+    // set once the workers may be running, after which sessions are only touched on their worker
+    bool is_started = false;
+    // sessions that can't be replicated are spread across the workers
+    size_t next_worker = 0;
+
+    std::map<std::string, RunningSession> sessions;
+    std::vector<Instance> retired;
+
+    // the workers keep running while every session is removed, a later reload may add some
+    std::vector<std::unique_ptr<asio::io_service::work>> keep_alive;
+
+    const std::shared_ptr<asio::io_service> signal_service;
+    // runs reloads and the release timer, on the signal thread unless one was supplied
+    const std::shared_ptr<exe4cpp::IExecutor> executor;
+    asio::signal_set signals;
+    exe4cpp::Timer release_timer;
+    std::thread signal_thread;
+};
+
+#endif
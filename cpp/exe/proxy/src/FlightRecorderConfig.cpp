@@ -0,0 +1,11 @@
+#include "FlightRecorderConfig.h"
+
+#include "YAMLHelpers.h"
+
+FlightRecorderConfig::FlightRecorderConfig(const YAML::Node& root)
+    : enabled(yaml::optional_bool(root["flight_recorder"], "enabled", true))
+    , dump_directory(yaml::optional_string(root["flight_recorder"], "dump_directory", "."))
+    , dump_on_session_error(yaml::optional_bool(root["flight_recorder"], "dump_on_session_error", true))
+    , min_error_dump_interval(yaml::optional_duration(root["flight_recorder"], "min_error_dump_interval", std::chrono::seconds(60)))
+{
+}
@@ -0,0 +1,28 @@
+#ifndef SSP21PROXY_FLIGHTRECORDERCONFIG_H
+#define SSP21PROXY_FLIGHTRECORDERCONFIG_H
+
+#include <exe4cpp/Typedefs.h>
+#include <yaml-cpp/yaml.h>
+
+#include <string>
+
+/**
+ * Settings of the in-process flight recorder, read from the optional top-level 'flight_recorder' node
+ */
+struct FlightRecorderConfig {
+    explicit FlightRecorderConfig(const YAML::Node& root);
+
+    // record events at all, a disabled recorder still answers SIGUSR1 with an empty dump
+    const bool enabled;
+
+    // where dumps are written, named after the process id
+    const std::string dump_directory;
+
+    // dump when a session closes because of an error
+    const bool dump_on_session_error;
+
+    // a burst of session errors only produces one dump per interval
+    const exe4cpp::duration_t min_error_dump_interval;
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include "FlightRecorderDumper.h"
+
+#include <log4cpp/LogMacros.h>
+#include <ssp21/stack/LogLevels.h>
+#include <ssp21/util/FlightRecorder.h>
+
+#include <chrono>
+#include <csignal>
+
+#include <unistd.h>
+
+using namespace ssp21;
+
+namespace {
+int64_t steady_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+std::atomic<FlightRecorderDumper*> FlightRecorderDumper::instance{ nullptr };
+
+FlightRecorderDumper::FlightRecorderDumper(const FlightRecorderConfig& config, const log4cpp::Logger& logger)
+    : config(config)
+    , logger(logger)
+    , keep_alive(service)
+    , signals(service, SIGUSR1)
+{
+    FlightRecorder::set_enabled(config.enabled);
+}
+
+FlightRecorderDumper::~FlightRecorderDumper()
+{
+    instance.store(nullptr);
+
+    this->service.stop();
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+}
+
+void FlightRecorderDumper::start()
+{
+    instance.store(this);
+
+    this->wait_for_signal();
+    this->thread = std::thread([this]() { this->service.run(); });
+}
+
+void FlightRecorderDumper::on_session_error()
+{
+    const auto dumper = instance.load();
+    if (!dumper || !dumper->config.dump_on_session_error) {
+        return;
+    }
+
+    const auto now = steady_ns();
+    auto last = dumper->last_error_dump.load();
+    if (last != 0 && (now - last) < std::chrono::duration_cast<std::chrono::nanoseconds>(dumper->config.min_error_dump_interval).count()) {
+        return;
+    }
+
+    // only one of the workers that race here gets to request the dump
+    if (!dumper->last_error_dump.compare_exchange_strong(last, now)) {
+        return;
+    }
+
+    dumper->service.post([dumper]() { dumper->dump("error"); });
+}
+
+void FlightRecorderDumper::wait_for_signal()
+{
+    this->signals.async_wait([this](const std::error_code& ec, int) {
+        if (ec)
+            return;
+
+        this->dump(std::to_string(++this->num_signal_dumps));
+        this->wait_for_signal();
+    });
+}
+
+void FlightRecorderDumper::dump(const std::string& suffix)
+{
+    const auto path = this->config.dump_directory + "/ssp21-flight-" + std::to_string(getpid()) + "-" + suffix + ".bin";
+
+    if (FlightRecorder::dump(path)) {
+        FORMAT_LOG_BLOCK(this->logger, levels::event, "flight recorder written to %s", path.c_str());
+    } else {
+        FORMAT_LOG_BLOCK(this->logger, levels::error, "unable to write the flight recorder to %s", path.c_str());
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef SSP21PROXY_FLIGHTRECORDERDUMPER_H
+#define SSP21PROXY_FLIGHTRECORDERDUMPER_H
+
+#include "FlightRecorderConfig.h"
+
+#include <log4cpp/Logger.h>
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <asio.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+/**
+ * Writes the flight recorder to disk when the process receives SIGUSR1 or when a session closes
+ * because of an error.
+ *
+ * Dumps requested by a signal are numbered, ssp21-flight-<pid>-<n>.bin, while error dumps overwrite
+ * ssp21-flight-<pid>-error.bin so that a flapping session can't fill the disk. Files are written on
+ * a dedicated thread, the workers only post the request.
+ *
+ * Only one dumper exists per process, it's constructed before and destroyed after the sessions.
+ */
+class FlightRecorderDumper final : private ser4cpp::Uncopyable {
+
+public:
+    FlightRecorderDumper(const FlightRecorderConfig& config, const log4cpp::Logger& logger);
+
+    ~FlightRecorderDumper();
+
+    // begin listening for SIGUSR1
+    void start();
+
+    // may be called from any thread, rate limited by min_error_dump_interval
+    static void on_session_error();
+
+private:
+    void wait_for_signal();
+
+    void dump(const std::string& suffix);
+
+    static std::atomic<FlightRecorderDumper*> instance;
+
+    const FlightRecorderConfig config;
+    log4cpp::Logger logger;
+
+    // steady clock nanoseconds of the last error dump, zero before the first
+    std::atomic<int64_t> last_error_dump{ 0 };
+    uint32_t num_signal_dumps = 0;
+
+    asio::io_service service;
+    asio::io_service::work keep_alive;
+    asio::signal_set signals;
+    std::thread thread;
+};
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef SSP21PROXY_HANDLERMEMORY_H
+#define SSP21PROXY_HANDLERMEMORY_H
+
+#include <ser4cpp/util/Uncopyable.h>
+#include <ssp21/util/FlightRecorder.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Fixed block of memory reused by a single outstanding asio operation.
+ *
+ * Each socket wrapper has at most one read and one write in flight, so giving each
+ * direction its own block means completion handlers never touch the heap. Requests
+ * that don't fit fall back to the global allocator; each one is counted and recorded
+ * in the flight recorder, since it means the data path allocates after all.
+ */
+class HandlerMemory final : private ser4cpp::Uncopyable {
+
+public:
+    HandlerMemory() = default;
+
+    void* allocate(std::size_t size)
+    {
+        if (!this->in_use && size <= sizeof(this->storage)) {
+            this->in_use = true;
+            return &this->storage;
+        }
+
+        num_heap_allocations().fetch_add(1, std::memory_order_relaxed);
+        ssp21::FlightRecorder::record(ssp21::FlightEventType::handler_heap_allocation, this, 0, static_cast<uint32_t>(size));
+        return ::operator new(size);
+    }
+
+    void deallocate(void* pointer)
+    {
+        if (pointer == &this->storage) {
+            this->in_use = false;
+        } else {
+            ::operator delete(pointer);
+        }
+    }
+
+    // requests that fell back to the global allocator, summed over every block in the process
+    static uint64_t get_num_heap_allocations()
+    {
+        return num_heap_allocations().load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::size_t storage_size = 1024;
+
+    static std::atomic<uint64_t>& num_heap_allocations()
+    {
+        static std::atomic<uint64_t> count{ 0 };
+        return count;
+    }
+
+    typename std::aligned_storage<storage_size>::type storage;
+    bool in_use = false;
+};
+
+/**
+ * Standard allocator adapter over HandlerMemory, found by asio via the handler's get_allocator()
+ */
+template <class T>
+class HandlerAllocator {
+
+    template <class U>
+    friend class HandlerAllocator;
+
+public:
+    using value_type = T;
+
+    explicit HandlerAllocator(HandlerMemory& memory)
+        : memory(memory)
+    {
+    }
+
+    template <class U>
+    HandlerAllocator(const HandlerAllocator<U>& other) noexcept
+        : memory(other.memory)
+    {
+    }
+
+    bool operator==(const HandlerAllocator& other) const noexcept
+    {
+        return &this->memory == &other.memory;
+    }
+
+    bool operator!=(const HandlerAllocator& other) const noexcept
+    {
+        return &this->memory != &other.memory;
+    }
+
+    T* allocate(std::size_t n) const
+    {
+        return static_cast<T*>(this->memory.allocate(sizeof(T) * n));
+    }
+
+    void deallocate(T* pointer, std::size_t /*n*/) const
+    {
+        this->memory.deallocate(pointer);
+    }
+
+private:
+    HandlerMemory& memory;
+};
+
+/**
+ * Wraps a completion handler so that asio allocates its operation state from a HandlerMemory block
+ */
+template <class Handler>
+class CustomAllocHandler {
+
+public:
+    using allocator_type = HandlerAllocator<Handler>;
+
+    CustomAllocHandler(HandlerMemory& memory, Handler handler)
+        : memory(memory)
+        , handler(std::move(handler))
+    {
+    }
+
+    allocator_type get_allocator() const noexcept
+    {
+        return allocator_type(this->memory);
+    }
+
+    template <class... Args>
+    void operator()(Args&&... args)
+    {
+        this->handler(std::forward<Args>(args)...);
+    }
+
+    // hooks used by asio versions that predate associated allocators
+    friend void* asio_handler_allocate(std::size_t size, CustomAllocHandler<Handler>* self)
+    {
+        return self->memory.allocate(size);
+    }
+
+    friend void asio_handler_deallocate(void* pointer, std::size_t /*size*/, CustomAllocHandler<Handler>* self)
+    {
+        self->memory.deallocate(pointer);
+    }
+
+private:
+    HandlerMemory& memory;
+    Handler handler;
+};
+
+template <class Handler>
+inline CustomAllocHandler<Handler> make_custom_alloc_handler(HandlerMemory& memory, Handler handler)
+{
+    return CustomAllocHandler<Handler>(memory, std::move(handler));
+}
+
+#endif
@@ -0,0 +1,71 @@
+#include "Histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+void Histogram::record(uint64_t value_ns)
+{
+    ++this->buckets[get_bucket(value_ns)];
+    ++this->count;
+    this->max = std::max(this->max, value_ns);
+}
+
+void Histogram::merge(const Histogram& other)
+{
+    for (uint32_t i = 0; i < num_buckets; ++i) {
+        this->buckets[i] += other.buckets[i];
+    }
+    this->count += other.count;
+    this->max = std::max(this->max, other.max);
+}
+
+void Histogram::clear()
+{
+    this->buckets.fill(0);
+    this->count = 0;
+    this->max = 0;
+}
+
+uint64_t Histogram::get_percentile(double fraction) const
+{
+    if (this->count == 0)
+        return 0;
+
+    const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(this->count))));
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < num_buckets; ++i) {
+        seen += this->buckets[i];
+        if (seen >= rank) {
+            return std::min(get_value(i), this->max);
+        }
+    }
+
+    return this->max;
+}
+
+uint32_t Histogram::get_bucket(uint64_t value)
+{
+    if (value < 2 * num_sub_buckets)
+        return static_cast<uint32_t>(value);
+
+    // position of the most significant bit
+    uint32_t msb = 0;
+    for (auto v = value; v > 1; v >>= 1) {
+        ++msb;
+    }
+
+    // keep the top sub_bucket_bits + 1 bits of the value
+    const auto shift = msb - sub_bucket_bits;
+    return shift * num_sub_buckets + static_cast<uint32_t>(value >> shift);
+}
+
+uint64_t Histogram::get_value(uint32_t bucket)
+{
+    if (bucket < 2 * num_sub_buckets)
+        return bucket;
+
+    const auto shift = bucket / num_sub_buckets - 1;
+    const auto low = static_cast<uint64_t>(bucket - shift * num_sub_buckets) << shift;
+    return low + ((static_cast<uint64_t>(1) << shift) / 2);
+}
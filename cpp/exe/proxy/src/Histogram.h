@@ -0,0 +1,50 @@
+#ifndef SSP21PROXY_HISTOGRAM_H
+#define SSP21PROXY_HISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+
+/**
+ * Fixed size histogram of durations in nanoseconds.
+ *
+ * Values below 32 ns get a bucket each, above that every power of two is split into 16 buckets,
+ * so a percentile is reported within about 6% of the recorded value no matter how long the run.
+ */
+class Histogram {
+
+public:
+    void record(uint64_t value_ns);
+
+    void merge(const Histogram& other);
+
+    void clear();
+
+    uint64_t get_count() const
+    {
+        return this->count;
+    }
+
+    uint64_t get_max() const
+    {
+        return this->max;
+    }
+
+    // the value below which the given fraction (0.0 to 1.0) of the recorded values fall
+    uint64_t get_percentile(double fraction) const;
+
+private:
+    static const uint32_t sub_bucket_bits = 4;
+    static const uint32_t num_sub_buckets = 1 << sub_bucket_bits;
+    static const uint32_t num_buckets = (65 - sub_bucket_bits) * num_sub_buckets;
+
+    static uint32_t get_bucket(uint64_t value);
+
+    // the midpoint of the values that fall into the bucket
+    static uint64_t get_value(uint32_t bucket);
+
+    std::array<uint64_t, num_buckets> buckets{};
+    uint64_t count = 0;
+    uint64_t max = 0;
+};
+
+#endif
@@ -3,11 +3,17 @@
 
 #include <ssp21/util/SequenceTypes.h>
 
+#include "ActivityList.h"
+
+#include <functional>
+
 class IAsioSocketWrapper
 {
 
 public:
 
+    using inactive_handler_t = std::function<void()>;
+
     virtual ~IAsioSocketWrapper() = default;
 
     virtual bool start_rx_from_socket() = 0;
@@ -21,6 +27,49 @@ public:
     {
         return this->get_is_rx_active() || this->get_is_tx_active();
     }
+
+    /**
+     * Invoke a handler once, as soon as no operation is outstanding on the socket.
+     *
+     * The handler is invoked from within a completion handler of the wrapper, so it
+     * must not destroy the wrapper synchronously.
+     */
+    void on_inactive(const inactive_handler_t& handler)
+    {
+        this->inactive_handler = handler;
+        this->notify_if_inactive();
+    }
+
+    // completed reads and writes touch the node, nullptr detaches the socket from it
+    void set_activity_node(ActivityNode* node)
+    {
+        this->activity_node = node;
+    }
+
+protected:
+
+    // implementations call this when data was read or written
+    void record_activity()
+    {
+        if (this->activity_node) {
+            this->activity_node->touch();
+        }
+    }
+
+    // implementations call this after every completion
+    void notify_if_inactive()
+    {
+        if (this->inactive_handler && !this->is_active()) {
+            const auto handler = std::move(this->inactive_handler);
+            this->inactive_handler = nullptr;
+            handler();
+        }
+    }
+
+private:
+
+    inactive_handler_t inactive_handler;
+    ActivityNode* activity_node = nullptr;
 };
 
 #endif
@@ -1,10 +1,33 @@
 #ifndef SSP21PROXY_IPROXYSESSION_H
 #define SSP21PROXY_IPROXYSESSION_H
 
+#include "StackFactory.h"
+
+#include <log4cpp/LogLevels.h>
+
+/**
+ * A configured proxy session and the connections it serves.
+ *
+ * Every method is called on the thread of the executor the session was created with.
+ */
 class IProxySession {
 public:
     virtual ~IProxySession() = default;
     virtual void start() = 0;
+
+    /**
+     * Stop taking on new connections. Connections that are already established keep running until
+     * they close on their own, unless they depend on something the session is releasing.
+     */
+    virtual void drain() = 0;
+
+    // true once drain() has completed and nothing outstanding refers to the session
+    virtual bool is_drained() const = 0;
+
+    virtual void set_log_levels(log4cpp::LogLevels levels) = 0;
+
+    // stacks created from now on, i.e. for future handshakes on new connections, use this factory
+    virtual void set_stack_factory(const StackFactory& factory) = 0;
 };
 
 #endif
@@ -0,0 +1,42 @@
+#include "IoBackend.h"
+
+#include "YAMLHelpers.h"
+#include "uring/IoUringService.h"
+
+IoBackend read_io_backend(const YAML::Node& transport)
+{
+    const auto name = yaml::optional_string(transport, "io_backend", get_io_backend_name(IoBackend::asio));
+
+    if (name == get_io_backend_name(IoBackend::asio)) {
+        return IoBackend::asio;
+    }
+
+    if (name == get_io_backend_name(IoBackend::io_uring)) {
+        return IoBackend::io_uring;
+    }
+
+    throw yaml::YAMLException(transport.Mark(), "unknown io_backend: ", name);
+}
+
+const char* get_io_backend_name(IoBackend backend)
+{
+    switch (backend) {
+    case (IoBackend::io_uring):
+        return "io_uring";
+    default:
+        return "asio";
+    }
+}
+
+bool is_io_backend_available(IoBackend backend)
+{
+    if (backend != IoBackend::io_uring) {
+        return true;
+    }
+
+#ifdef SSP21PROXY_IO_URING
+    return IoUringService::is_supported();
+#else
+    return false;
+#endif
+}
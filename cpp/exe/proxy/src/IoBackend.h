@@ -0,0 +1,28 @@
+#ifndef SSP21PROXY_IOBACKEND_H
+#define SSP21PROXY_IOBACKEND_H
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstdint>
+
+/**
+ * Mechanism used by the socket wrappers of a transport to perform I/O.
+ *
+ * 'asio' uses the asio reactor (epoll on Linux). 'io_uring' submits reads and writes to a
+ * ring shared by every socket of a worker, and falls back to 'asio' when the proxy was built
+ * without liburing or the running kernel lacks the required features.
+ */
+enum class IoBackend : uint8_t {
+    asio,
+    io_uring
+};
+
+// reads the optional 'io_backend' key of a transport node
+IoBackend read_io_backend(const YAML::Node& transport);
+
+const char* get_io_backend_name(IoBackend backend);
+
+// false if the proxy was built without the backend or the kernel doesn't support it
+bool is_io_backend_available(IoBackend backend);
+
+#endif
@@ -0,0 +1,113 @@
+#include "LatencyStats.h"
+
+#include <log4cpp/LogMacros.h>
+#include <ssp21/stack/LogLevels.h>
+
+#include <mutex>
+
+using namespace ssp21;
+
+namespace {
+// every session on every worker merges into this when it reports
+struct Aggregate {
+    std::mutex mutex;
+    std::array<Histogram, LatencyStats::num_stages> histograms;
+    std::chrono::steady_clock::time_point last_report = std::chrono::steady_clock::now();
+};
+
+Aggregate& get_aggregate()
+{
+    static Aggregate aggregate;
+    return aggregate;
+}
+}
+
+LatencyStats::LatencyStats(const LatencyTracingConfig& config, const log4cpp::Logger& logger)
+    : sample_every(config.sample_every)
+    , report_interval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(config.report_interval))
+    , logger(logger)
+    , last_report(std::chrono::steady_clock::now())
+{
+}
+
+void LatencyStats::record(LatencyStage stage, const std::chrono::steady_clock::duration& duration)
+{
+    const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    this->histograms[static_cast<size_t>(stage)].record(nanoseconds > 0 ? static_cast<uint64_t>(nanoseconds) : 0);
+
+    // reported from the next sample once the interval elapses, an idle session doesn't need a timer
+    const auto now = std::chrono::steady_clock::now();
+    if (now - this->last_report >= this->report_interval) {
+        this->report(now);
+    }
+}
+
+const char* LatencyStats::get_stage_name(LatencyStage stage)
+{
+    switch (stage) {
+    case (LatencyStage::tx_queue):
+        return "tx queue";
+    case (LatencyStage::tx_encrypt):
+        return "tx encrypt";
+    case (LatencyStage::tx_write):
+        return "tx write";
+    case (LatencyStage::tx_total):
+        return "tx total";
+    case (LatencyStage::rx_decrypt):
+        return "rx decrypt";
+    case (LatencyStage::rx_write):
+        return "rx write";
+    case (LatencyStage::rx_total):
+        return "rx total";
+    default:
+        return "unknown";
+    }
+}
+
+void LatencyStats::report(const std::chrono::steady_clock::time_point& now)
+{
+    this->last_report = now;
+    log(this->logger, "", this->histograms);
+
+    auto& aggregate = get_aggregate();
+    {
+        std::lock_guard<std::mutex> lock(aggregate.mutex);
+
+        for (size_t i = 0; i < num_stages; ++i) {
+            aggregate.histograms[i].merge(this->histograms[i]);
+        }
+
+        if (now - aggregate.last_report >= this->report_interval) {
+            aggregate.last_report = now;
+            log(this->logger, "all sessions ", aggregate.histograms);
+            for (auto& histogram : aggregate.histograms) {
+                histogram.clear();
+            }
+        }
+    }
+
+    for (auto& histogram : this->histograms) {
+        histogram.clear();
+    }
+}
+
+void LatencyStats::log(log4cpp::Logger& logger, const char* prefix, const histograms_t& histograms)
+{
+    for (size_t i = 0; i < num_stages; ++i) {
+        const auto& histogram = histograms[i];
+        if (histogram.get_count() == 0) {
+            continue;
+        }
+
+        FORMAT_LOG_BLOCK(
+            logger,
+            levels::metric,
+            "%slatency %s: %llu samples, p50: %.1f us, p99: %.1f us, max: %.1f us",
+            prefix,
+            get_stage_name(static_cast<LatencyStage>(i)),
+            static_cast<unsigned long long>(histogram.get_count()),
+            static_cast<double>(histogram.get_percentile(0.5)) / 1000.0,
+            static_cast<double>(histogram.get_percentile(0.99)) / 1000.0,
+            static_cast<double>(histogram.get_max()) / 1000.0);
+    }
+}
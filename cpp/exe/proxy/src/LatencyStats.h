@@ -0,0 +1,81 @@
+#ifndef SSP21PROXY_LATENCYSTATS_H
+#define SSP21PROXY_LATENCYSTATS_H
+
+#include "Histogram.h"
+#include "LatencyTracingConfig.h"
+
+#include <log4cpp/Logger.h>
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * The stages a traced message passes through.
+ *
+ * tx is plaintext to SSP21: read from the plaintext socket, queued, encrypted into a frame and
+ * written to the SSP21 socket. rx is the reverse, from reading a frame to writing the plaintext.
+ */
+enum class LatencyStage : uint8_t {
+    // from the plaintext socket read until the crypto layer accepts the chunk
+    tx_queue,
+    // from the crypto layer accepting the chunk until it hands a frame to the socket
+    tx_encrypt,
+    // from handing the frame to the socket until the write completes
+    tx_write,
+    // from the plaintext socket read until the whole chunk is written
+    tx_total,
+    // from the SSP21 socket read until the plaintext is read from the crypto layer
+    rx_decrypt,
+    // from reading the plaintext until the write to the plaintext socket completes
+    rx_write,
+    // from the SSP21 socket read until the plaintext is written
+    rx_total
+};
+
+/**
+ * Latency histograms of the sampled messages of one proxy session, shared by all of its connections.
+ *
+ * Only touched on the worker of the session. The histograms are logged and cleared once per report
+ * interval, and merged into a process-wide aggregate that is logged at the same interval.
+ */
+class LatencyStats final : private ser4cpp::Uncopyable {
+
+public:
+    static const size_t num_stages = static_cast<size_t>(LatencyStage::rx_total) + 1;
+
+    LatencyStats(const LatencyTracingConfig& config, const log4cpp::Logger& logger);
+
+    inline bool sample_tx()
+    {
+        return (++this->num_tx % this->sample_every) == 0;
+    }
+
+    inline bool sample_rx()
+    {
+        return (++this->num_rx % this->sample_every) == 0;
+    }
+
+    void record(LatencyStage stage, const std::chrono::steady_clock::duration& duration);
+
+    static const char* get_stage_name(LatencyStage stage);
+
+private:
+    using histograms_t = std::array<Histogram, num_stages>;
+
+    void report(const std::chrono::steady_clock::time_point& now);
+
+    static void log(log4cpp::Logger& logger, const char* prefix, const histograms_t& histograms);
+
+    const uint32_t sample_every;
+    const std::chrono::steady_clock::duration report_interval;
+    log4cpp::Logger logger;
+
+    uint64_t num_tx = 0;
+    uint64_t num_rx = 0;
+    std::chrono::steady_clock::time_point last_report;
+    histograms_t histograms;
+};
+
+#endif
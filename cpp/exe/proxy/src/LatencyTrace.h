@@ -0,0 +1,142 @@
+#ifndef SSP21PROXY_LATENCYTRACE_H
+#define SSP21PROXY_LATENCYTRACE_H
+
+#include "LatencyStats.h"
+
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <chrono>
+#include <memory>
+
+/**
+ * Timestamps the sampled messages of one connection as the asio layers move them between the
+ * sockets and the stack.
+ *
+ * At most one message per direction is traced at a time, so no state travels with the messages.
+ * The layers report every step and the trace ignores the steps of messages it isn't following.
+ * Other frames written while a chunk is encrypted, e.g. during a renegotiation, are counted towards
+ * that chunk.
+ */
+class LatencyTrace final : private ser4cpp::Uncopyable {
+
+    using clock_t = std::chrono::steady_clock;
+
+public:
+    explicit LatencyTrace(const std::shared_ptr<LatencyStats>& stats)
+        : stats(stats)
+    {
+    }
+
+    // --- plaintext to SSP21 ---
+
+    // a chunk was read from the plaintext socket, returns true if it is traced
+    bool on_plaintext_rx()
+    {
+        if (this->tx.phase != Phase::idle || !this->stats->sample_tx()) {
+            return false;
+        }
+
+        this->tx.phase = Phase::queued;
+        this->tx.start = this->tx.last = clock_t::now();
+        return true;
+    }
+
+    // the traced chunk is offered to the crypto layer, which may only accept it on a later try
+    void on_tx_to_crypto()
+    {
+        if (this->tx.phase == Phase::queued || this->tx.phase == Phase::in_crypto) {
+            this->tx.phase = Phase::in_crypto;
+            this->tx.last = clock_t::now();
+        }
+    }
+
+    void on_tx_frame()
+    {
+        if (this->tx.phase == Phase::in_crypto) {
+            const auto now = clock_t::now();
+            // the queue stage ends with the offer the crypto layer accepted
+            this->stats->record(LatencyStage::tx_queue, this->tx.last - this->tx.start);
+            this->stats->record(LatencyStage::tx_encrypt, now - this->tx.last);
+            this->tx.phase = Phase::written;
+            this->tx.last = now;
+        }
+    }
+
+    void on_tx_frame_written()
+    {
+        if (this->tx.phase == Phase::written && this->tx.last != clock_t::time_point()) {
+            this->stats->record(LatencyStage::tx_write, clock_t::now() - this->tx.last);
+            // only the first frame of a chunk is timed on its own
+            this->tx.last = clock_t::time_point();
+        }
+    }
+
+    // the crypto layer has transmitted all of the traced chunk
+    void on_tx_done()
+    {
+        if (this->tx.phase != Phase::idle) {
+            this->stats->record(LatencyStage::tx_total, clock_t::now() - this->tx.start);
+            this->tx.phase = Phase::idle;
+        }
+    }
+
+    void cancel_tx()
+    {
+        this->tx.phase = Phase::idle;
+    }
+
+    // --- SSP21 to plaintext ---
+
+    void on_ssp21_rx()
+    {
+        // a read that didn't produce plaintext, e.g. a handshake message, restarts the trace
+        if (this->rx.phase == Phase::queued || (this->rx.phase == Phase::idle && this->stats->sample_rx())) {
+            this->rx.phase = Phase::queued;
+            this->rx.start = this->rx.last = clock_t::now();
+        }
+    }
+
+    void on_rx_decrypted()
+    {
+        if (this->rx.phase == Phase::queued) {
+            const auto now = clock_t::now();
+            this->stats->record(LatencyStage::rx_decrypt, now - this->rx.start);
+            this->rx.phase = Phase::written;
+            this->rx.last = now;
+        }
+    }
+
+    void on_plaintext_written()
+    {
+        if (this->rx.phase == Phase::written) {
+            const auto now = clock_t::now();
+            this->stats->record(LatencyStage::rx_write, now - this->rx.last);
+            this->stats->record(LatencyStage::rx_total, now - this->rx.start);
+            this->rx.phase = Phase::idle;
+        }
+    }
+
+private:
+    enum class Phase : uint8_t {
+        idle,
+        // read, waiting for the crypto layer
+        queued,
+        // tx only, offered to the crypto layer
+        in_crypto,
+        // handed to the socket that writes it out
+        written
+    };
+
+    struct Message {
+        Phase phase = Phase::idle;
+        clock_t::time_point start;
+        // time of the previous step
+        clock_t::time_point last;
+    };
+
+    const std::shared_ptr<LatencyStats> stats;
+    Message tx;
+    Message rx;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#include "LatencyTracingConfig.h"
+
+#include "YAMLHelpers.h"
+
+LatencyTracingConfig::LatencyTracingConfig()
+    : enabled(false)
+    , sample_every(default_sample_every)
+    , report_interval(std::chrono::seconds(60))
+{
+}
+
+LatencyTracingConfig::LatencyTracingConfig(const YAML::Node& session)
+    : enabled(static_cast<bool>(session["latency_tracing"]))
+    , sample_every(yaml::optional_integer<uint32_t>(session["latency_tracing"], "sample_every", default_sample_every))
+    , report_interval(yaml::optional_duration(session["latency_tracing"], "report_interval", std::chrono::seconds(60)))
+{
+    if (this->sample_every == 0) {
+        throw yaml::YAMLException(session.Mark(), "latency_tracing.sample_every must be greater than zero");
+    }
+
+    if (this->report_interval <= exe4cpp::duration_t::zero()) {
+        throw yaml::YAMLException(session.Mark(), "latency_tracing.report_interval must be greater than zero");
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef SSP21PROXY_LATENCYTRACINGCONFIG_H
+#define SSP21PROXY_LATENCYTRACINGCONFIG_H
+
+#include <exe4cpp/Typedefs.h>
+#include <yaml-cpp/yaml.h>
+
+#include <cstdint>
+
+/**
+ * Optional sampling of the time messages spend in each stage of the proxy.
+ *
+ * One in sample_every messages in each direction is timestamped as it moves between the sockets
+ * and the stack, the others cost a counter increment.
+ */
+struct LatencyTracingConfig {
+    static const uint32_t default_sample_every = 100;
+
+    // tracing disabled
+    LatencyTracingConfig();
+
+    // reads the optional 'latency_tracing' node of a session
+    LatencyTracingConfig(const YAML::Node& session);
+
+    const bool enabled;
+    // 1 traces every message
+    const uint32_t sample_every;
+    // how often the histograms are logged and cleared
+    const exe4cpp::duration_t report_interval;
+};
+
+#endif
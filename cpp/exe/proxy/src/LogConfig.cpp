@@ -2,12 +2,14 @@
 
 #include "YAMLHelpers.h"
 
+#include "log/ProxyLogLevels.h"
+
 #include <ssp21/stack/LogLevels.h>
 
-log4cpp::LogLevels get_log_levels(const YAML::Node& node)
+log4cpp::LogLevels get_log_levels(const YAML::Node& node, const std::string& flags)
 {
     log4cpp::LogLevels levels;
-    for (auto flag : yaml::require_string(node, "levels")) {
+    for (auto flag : flags) {
         switch (flag) {
         case ('v'):
             levels |= log4cpp::LogLevels(ssp21::levels::event.value);
@@ -33,6 +35,9 @@ log4cpp::LogLevels get_log_levels(const YAML::Node& node)
         case ('m'):
             levels |= log4cpp::LogLevels(ssp21::levels::metric.value);
             break;
+        case ('x'):
+            levels |= log4cpp::LogLevels(proxy_levels::rx_bytes.value);
+            break;
         default:
             throw yaml::YAMLException(node, "unknown log level: ", flag);
         }
@@ -42,6 +47,6 @@ log4cpp::LogLevels get_log_levels(const YAML::Node& node)
 
 LogConfig::LogConfig(const YAML::Node& node)
     : id(yaml::require_string(node, "id"))
-    , levels(get_log_levels(node))
+    , levels(get_log_levels(node, yaml::require_string(node, "levels")))
 {
 }
@@ -5,6 +5,11 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include <string>
+
+// parses level flags such as "vewi", the node locates errors
+log4cpp::LogLevels get_log_levels(const YAML::Node& node, const std::string& flags);
+
 class LogConfig {
 public:
     LogConfig(const YAML::Node& node);
@@ -0,0 +1,29 @@
+#include "PlaintextQueueConfig.h"
+
+#include "YAMLHelpers.h"
+
+PlaintextQueueConfig::PlaintextQueueConfig()
+    : depth(default_depth)
+    , high_watermark(default_depth)
+    , low_watermark(default_depth / 2)
+{
+}
+
+PlaintextQueueConfig::PlaintextQueueConfig(const YAML::Node& session)
+    : depth(yaml::optional_integer<uint16_t>(session["plaintext_queue"], "depth", default_depth))
+    , high_watermark(yaml::optional_integer<uint16_t>(session["plaintext_queue"], "high_watermark", depth))
+    , low_watermark(yaml::optional_integer<uint16_t>(session["plaintext_queue"], "low_watermark", high_watermark / 2))
+    , framing(session)
+{
+    if (this->depth == 0 || this->depth > max_depth) {
+        throw yaml::YAMLException(session.Mark(), "plaintext_queue.depth must be between 1 and ", max_depth);
+    }
+
+    if (this->high_watermark == 0 || this->high_watermark > this->depth) {
+        throw yaml::YAMLException(session.Mark(), "plaintext_queue.high_watermark must be between 1 and the queue depth");
+    }
+
+    if (this->low_watermark >= this->high_watermark) {
+        throw yaml::YAMLException(session.Mark(), "plaintext_queue.low_watermark must be less than the high watermark");
+    }
+}
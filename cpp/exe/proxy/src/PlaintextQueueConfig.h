@@ -0,0 +1,32 @@
+#ifndef SSP21PROXY_PLAINTEXTQUEUECONFIG_H
+#define SSP21PROXY_PLAINTEXTQUEUECONFIG_H
+
+#include <yaml-cpp/yaml.h>
+
+#include "framing/FramingConfig.h"
+
+#include <cstdint>
+
+/**
+ * Sizing of the queue of plaintext messages read from the raw socket and waiting to be encrypted,
+ * and how the socket data is cut into those messages.
+ *
+ * Reading from the socket stops once high_watermark messages are queued and resumes once the
+ * queue drains to low_watermark.
+ */
+struct PlaintextQueueConfig {
+    static const uint16_t default_depth = 4;
+    static const uint16_t max_depth = 64;
+
+    PlaintextQueueConfig();
+
+    // reads the optional 'plaintext_queue' and 'plaintext_framing' nodes of a session
+    PlaintextQueueConfig(const YAML::Node& session);
+
+    const uint16_t depth;
+    const uint16_t high_watermark;
+    const uint16_t low_watermark;
+    const FramingConfig framing;
+};
+
+#endif
@@ -8,25 +8,59 @@
 
 namespace config {
 
-std::vector<proxy_session_factory_t> read(const std::string& file_path, const std::shared_ptr<exe4cpp::BasicExecutor>& executor, const log4cpp::Logger& logger)
+std::vector<ProxySessionFactory> get_session_factories(const YAML::Node& root)
 {
-    const YAML::Node root = YAML::LoadFile(file_path);
+    std::vector<ProxySessionFactory> factories;
 
     yaml::foreach (
-        yaml::require(root, "qkd_sources"),
+        yaml::require(root, "sessions"),
         [&](const YAML::Node& node) {
-            QKDSourceRegistry::configure_qkd_source(node, executor, logger);
+            factories.push_back(config::get_session_factory(node));
         });
 
-    std::vector<proxy_session_factory_t> factories;
+    return factories;
+}
+
+LogBackendConfig read_log_backend(const std::string& file_path)
+{
+    const YAML::Node root = YAML::LoadFile(file_path);
+
+    const auto node = root["logging"];
+
+    return node ? LogBackendConfig(node) : LogBackendConfig();
+}
+
+WorkerConfig read_worker_config(const std::string& file_path)
+{
+    return WorkerConfig(YAML::LoadFile(file_path));
+}
+
+FlightRecorderConfig read_flight_recorder(const std::string& file_path)
+{
+    return FlightRecorderConfig(YAML::LoadFile(file_path));
+}
+
+std::vector<ProxySessionFactory> read(const std::string& file_path, const std::shared_ptr<exe4cpp::BasicExecutor>& executor, const log4cpp::Logger& logger)
+{
+    const YAML::Node root = YAML::LoadFile(file_path);
 
     yaml::foreach (
-        yaml::require(root, "sessions"),
+        yaml::require(root, "qkd_sources"),
         [&](const YAML::Node& node) {
-            factories.push_back(config::get_session_factory(node));
+            QKDSourceRegistry::configure_qkd_source(node, executor, logger);
         });
 
+    const auto factories = get_session_factories(root);
+
+    // a reload may only reuse the subscribers bound here
+    QKDSourceRegistry::seal();
+
     return factories;
 }
 
+std::vector<ProxySessionFactory> read_sessions(const std::string& file_path)
+{
+    return get_session_factories(YAML::LoadFile(file_path));
+}
+
 }
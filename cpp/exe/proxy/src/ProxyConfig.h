@@ -1,7 +1,10 @@
 #ifndef SSP21PROXY_PROXYCONFIG_H
 #define SSP21PROXY_PROXYCONFIG_H
 
+#include "FlightRecorderConfig.h"
 #include "ProxySessionFactory.h"
+#include "WorkerConfig.h"
+#include "log/LogBackendConfig.h"
 
 #include "ser4cpp/util/Uncopyable.h"
 
@@ -13,7 +16,16 @@
 
 namespace config {
 
-std::vector<proxy_session_factory_t> read(const std::string& file_path, const std::shared_ptr<exe4cpp::BasicExecutor>& executor, const log4cpp::Logger& logger);
+LogBackendConfig read_log_backend(const std::string& file_path);
+
+WorkerConfig read_worker_config(const std::string& file_path);
+
+FlightRecorderConfig read_flight_recorder(const std::string& file_path);
+
+std::vector<ProxySessionFactory> read(const std::string& file_path, const std::shared_ptr<exe4cpp::BasicExecutor>& executor, const log4cpp::Logger& logger);
+
+// reads only the sessions, they may refer to the QKD sources configured by read()
+std::vector<ProxySessionFactory> read_sessions(const std::string& file_path);
 
 }
 
@@ -2,12 +2,47 @@
 #define SSP21PROXY_PROXYSESSIONFACTORY_H
 
 #include "IProxySession.h"
+#include "StackFactory.h"
 
 #include <exe4cpp/asio/BasicExecutor.h>
 #include <log4cpp/Logger.h>
 
 #include <functional>
+#include <string>
 
-using proxy_session_factory_t = std::function<std::unique_ptr<IProxySession>(const log4cpp::Logger& logger, std::shared_ptr<exe4cpp::BasicExecutor> executor)>;
+/**
+ * Identifies the worker thread on which a proxy session instance runs
+ */
+struct WorkerAssignment {
+    size_t index;
+    size_t count;
+
+    // true when other instances of the same session are listening on the same port
+    bool is_shared() const
+    {
+        return count > 1;
+    }
+
+    // this instance's part of a limit that applies to all the instances together
+    uint32_t share_of(uint32_t total) const
+    {
+        return static_cast<uint32_t>(total / count + ((index < total % count) ? 1 : 0));
+    }
+};
+
+using proxy_session_factory_t = std::function<std::unique_ptr<IProxySession>(const log4cpp::Logger& logger, std::shared_ptr<exe4cpp::BasicExecutor> executor, const WorkerAssignment& worker)>;
+
+struct ProxySessionFactory {
+    // instances to run, each on its own worker thread, sessions that can't be replicated have exactly one
+    uint32_t max_instances;
+    proxy_session_factory_t create;
+
+    // identifies the session across configuration reloads
+    std::string id;
+    log4cpp::LogLevels levels;
+    // settings that a running session can't change, a reload that changes them restarts the session
+    std::string restart_signature;
+    StackFactory stack_factory;
+};
 
 #endif
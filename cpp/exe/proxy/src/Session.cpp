@@ -1,3 +1,19 @@
 #include "Session.h"
 
+#include "FlightRecorderDumper.h"
+
 #include <log4cpp/LogMacros.h>
+#include <ssp21/util/FlightRecorder.h>
+
+const exe4cpp::duration_t Session::close_deadline = std::chrono::seconds(5);
+
+void Session::on_error()
+{
+    // closing the lower layer during shutdown reports back through the same path
+    if (!this->is_shutting_down) {
+        ssp21::FlightRecorder::record(ssp21::FlightEventType::session_error, this, 0, 0, this->id);
+        FlightRecorderDumper::on_session_error();
+    }
+
+    this->error_handler();
+}
@@ -3,8 +3,10 @@
 
 #include "AsioLowerLayer.h"
 #include "AsioUpperLayer.h"
+#include "LatencyTrace.h"
 
 #include <exe4cpp/IExecutor.h>
+#include <exe4cpp/Timer.h>
 #include <ssp21/stack/IStack.h>
 
 #include <functional>
@@ -12,6 +14,9 @@
 
 using session_error_handler_t = std::function<void()>;
 
+// invoked once both sockets are released, with the time it took and whether the deadline forced it
+using session_close_handler_t = std::function<void(const exe4cpp::duration_t& time_to_close, bool deadline_exceeded)>;
+
 class Session : public std::enable_shared_from_this<Session> {
 
 public:
@@ -58,39 +63,204 @@ public:
     void start()
     {
         stack->bind(*(lower_layer), *(upper_layer));
-        upper_layer->bind(*upper_socket, *stack, error_handler);
+        upper_layer->bind(*stack, [this]() { this->on_error(); });
+        if (upper_socket) {
+            upper_layer->attach_socket(*upper_socket);
+        }
         lower_layer->open(*lower_socket, *stack);
     }
 
-    void shutdown()
+    // time the sampled messages of this session into the stats, call before start()
+    void trace_latency(const std::shared_ptr<LatencyStats>& stats)
+    {
+        this->latency_trace = std::make_unique<LatencyTrace>(stats);
+        this->lower_layer->set_latency_trace(this->latency_trace.get());
+        this->upper_layer->set_latency_trace(this->latency_trace.get());
+    }
+
+    // SSP21 session is established and data can be exchanged
+    bool is_established() const
+    {
+        return this->upper_layer->is_open();
+    }
+
+    AsioUpperLayer& get_upper_layer()
     {
+        return *this->upper_layer;
+    }
+
+    // gives a session that was started without a plaintext socket, e.g. from the warm pool, its socket
+    void attach_upper_socket(std::unique_ptr<IAsioSocketWrapper> socket)
+    {
+        this->upper_socket = std::move(socket);
+        this->upper_socket->set_activity_node(this->activity_node);
+        this->upper_layer->attach_socket(*this->upper_socket);
+    }
+
+    // reads and writes on either socket touch the node until the session is shut down
+    void track_activity(ActivityNode& node)
+    {
+        this->set_activity_node(&node);
+    }
+
+    /**
+     * Close both sockets and keep the session alive until their outstanding operations complete.
+     *
+     * If the sockets haven't gone quiet by the close deadline they are closed again, which forces
+     * any remaining operations to abort.
+     */
+    void shutdown(const session_close_handler_t& close_handler)
+    {
+        if (this->is_shutting_down) {
+            return;
+        }
+
+        this->is_shutting_down = true;
+        this->close_handler = close_handler;
+
+        // the owner of the node may release it as soon as this returns
+        this->set_activity_node(nullptr);
+        this->shutdown_start = this->executor->get_time();
+
         lower_layer->close(); // start the shutdown bottom to top
-        this->check_for_close(this->shared_from_this());
+
+        const auto self = this->shared_from_this();
+
+        this->close_deadline_timer = exe4cpp::Timer(this->executor->start(close_deadline, [self]() {
+            self->on_close_deadline();
+        }));
+
+        this->watch_sockets();
     }
 
 private:
-    void check_for_close(const std::shared_ptr<Session>& self)
+    static const exe4cpp::duration_t close_deadline;
+
+    // records the error for the flight recorder before notifying the owner
+    void on_error();
+
+    void set_activity_node(ActivityNode* node)
     {
-        if (!self->is_shutdown()) {
-            self->executor->post([self]() {
-                self->check_for_close(self);
-            });
+        this->activity_node = node;
+        this->lower_socket->set_activity_node(node);
+        if (this->upper_socket) {
+            this->upper_socket->set_activity_node(node);
         }
     }
 
-    inline bool is_shutdown() const
+    /**
+     * Wait for the sockets that still have outstanding operations and check again once the last of
+     * them completes. A socket that is already idle isn't watched, it would report back at once.
+     */
+    void watch_sockets()
     {
-        return !(this->lower_layer->is_active() || this->upper_layer->is_active());
+        this->watch_socket(*this->lower_socket, this->is_lower_socket_watched);
+        if (this->upper_socket) {
+            this->watch_socket(*this->upper_socket, this->is_upper_socket_watched);
+        }
+
+        if (!this->is_lower_socket_watched && !this->is_upper_socket_watched) {
+            this->post_check_for_close();
+        }
+    }
+
+    void watch_socket(IAsioSocketWrapper& socket, bool& is_watched)
+    {
+        if (is_watched || !socket.is_active()) {
+            return;
+        }
+
+        is_watched = true;
+
+        const auto self = this->shared_from_this();
+        socket.on_inactive([self, &is_watched]() {
+            is_watched = false;
+            if (!self->is_lower_socket_watched && !self->is_upper_socket_watched) {
+                self->post_check_for_close();
+            }
+        });
+    }
+
+    // the wrappers invoke the inactive handlers from their completion handlers, so the session can't be released there
+    void post_check_for_close()
+    {
+        const auto self = this->shared_from_this();
+        this->executor->post([self]() { self->check_for_close(); });
+    }
+
+    void check_for_close()
+    {
+        if (this->is_closed) {
+            return;
+        }
+
+        if (this->is_active()) {
+            // a layer started another operation in the meantime
+            this->watch_sockets();
+            return;
+        }
+
+        this->is_closed = true;
+        this->close_deadline_timer.cancel();
+
+        if (this->close_handler) {
+            this->close_handler(this->executor->get_time() - this->shutdown_start, this->is_deadline_exceeded);
+        }
+
+        // release the references to this session held by the callbacks
+        this->close_handler = nullptr;
+        this->is_lower_socket_watched = false;
+        this->is_upper_socket_watched = false;
+        this->lower_socket->on_inactive(nullptr);
+        if (this->upper_socket) {
+            this->upper_socket->on_inactive(nullptr);
+        }
+    }
+
+    void on_close_deadline()
+    {
+        if (this->is_closed) {
+            return;
+        }
+
+        this->is_deadline_exceeded = true;
+
+        // closing the sockets again aborts whatever is still outstanding
+        this->lower_socket->try_close_socket();
+        if (this->upper_socket) {
+            this->upper_socket->try_close_socket();
+        }
+
+        this->watch_sockets();
+    }
+
+    inline bool is_active() const
+    {
+        return this->lower_layer->is_active() || this->upper_layer->is_active();
     }
 
     const uint64_t id;
     const session_error_handler_t error_handler;
+    // declared before the layers that point to it
+    std::unique_ptr<LatencyTrace> latency_trace;
     const std::shared_ptr<exe4cpp::IExecutor> executor;
     const std::unique_ptr<IAsioSocketWrapper> lower_socket;
     const std::unique_ptr<AsioLowerLayer> lower_layer;
-    const std::unique_ptr<IAsioSocketWrapper> upper_socket;
+    // null until attached for sessions started without a plaintext socket
+    std::unique_ptr<IAsioSocketWrapper> upper_socket;
     const std::unique_ptr<AsioUpperLayer> upper_layer;
     const std::shared_ptr<ssp21::IStack> stack;
+    ActivityNode* activity_node = nullptr;
+
+    // shutdown state
+    bool is_shutting_down = false;
+    bool is_closed = false;
+    bool is_deadline_exceeded = false;
+    exe4cpp::steady_time_t shutdown_start;
+    exe4cpp::Timer close_deadline_timer;
+    session_close_handler_t close_handler;
+    bool is_lower_socket_watched = false;
+    bool is_upper_socket_watched = false;
 };
 
 #endif
@@ -18,6 +18,7 @@
 
 #include "StackConfigReader.h"
 #include "YAMLHelpers.h"
+#include "capture/CaptureConfig.h"
 #include "qkd/QKDSourceRegistry.h"
 
 using namespace ssp21;
@@ -128,6 +129,8 @@ ssp21::CryptoLayerConfig get_crypto_layer_config(const YAML::Node& node)
     ssp21::CryptoLayerConfig config;
 
     config.max_payload_size = yaml::optional_integer<uint16_t>(node, "max_payload_size", config.max_payload_size);
+    config.max_rx_queue_count = yaml::optional_integer<uint16_t>(node, "max_rx_queue_count", config.max_rx_queue_count);
+    config.max_rx_queue_bytes = yaml::optional_integer<uint32_t>(node, "max_rx_queue_bytes", config.max_rx_queue_bytes);
 
     return config;
 }
@@ -148,7 +151,13 @@ ssp21::InitiatorConfig::Params get_initiator_params(const YAML::Node& handshake,
     config.nonce_renegotiation_trigger_value = yaml::optional_integer<uint16_t>(session, "nonce_renegotiation_trigger_value", config.nonce_renegotiation_trigger_value);
     config.response_timeout = yaml::optional_duration(handshake, "response_timeout", config.response_timeout);
     config.retry_timeout = yaml::optional_duration(handshake, "retry_timeout", config.retry_timeout);
+    // without a maximum the timeout stays fixed, as it was before backoff was configurable
+    config.max_retry_timeout = yaml::optional_duration(handshake, "max_retry_timeout", config.retry_timeout);
+    config.retry_jitter = yaml::optional_bool(handshake, "retry_jitter", config.retry_jitter);
     config.session_time_renegotiation_trigger_ms = get_optional_ms_from_duration(session, "session_time_renegotiation_trigger_ms", config.session_time_renegotiation_trigger_ms);
+    config.session_time_renegotiation_spread_ms = get_optional_ms_from_duration(session, "session_time_renegotiation_spread", config.session_time_renegotiation_spread_ms);
+    config.nonce_renegotiation_spread = yaml::optional_integer<uint16_t>(session, "nonce_renegotiation_spread", config.nonce_renegotiation_spread);
+    config.max_early_data_size = yaml::optional_integer<uint16_t>(handshake, "max_early_data_size", config.max_early_data_size);
 
     return config;
 }
@@ -166,17 +175,6 @@ ssp21::InitiatorConfig get_initiator_config(const YAML::Node& handshake, const Y
     return config;
 }
 
-ssp21::ResponderConfig get_responder_config(const YAML::Node& session)
-{
-    // all of the configuration here is optional and uses the defaults if not present
-    ssp21::ResponderConfig config;
-
-    config.config = get_crypto_layer_config(session);
-    config.session = get_session_config(session);
-
-    return config;
-}
-
 ssp21::StaticKeys get_local_static_keys(const YAML::Node& node)
 {
     return ssp21::StaticKeys(
@@ -199,15 +197,70 @@ ssp21::SessionCryptoMode get_session_crypto_mode(const YAML::Node& node)
     throw ssp21::Exception("Unknown session mode: ", mode);
 }
 
+ssp21::SessionCompressionMode get_session_compression_mode(const std::string& mode)
+{
+    if (mode == "none") {
+        return ssp21::SessionCompressionMode::none;
+    }
+
+    if (mode == "lz_scada") {
+        return ssp21::SessionCompressionMode::lz_scada;
+    }
+
+    throw ssp21::Exception("Unknown session compression mode: ", mode);
+}
+
+ssp21::SessionCompressionMode get_session_compression_mode(const YAML::Node& node)
+{
+    return get_session_compression_mode(yaml::optional_string(node, "session_compression_mode", "none"));
+}
+
+std::vector<ssp21::SessionCompressionMode> get_allowed_session_compression_modes(const YAML::Node& node)
+{
+    std::vector<ssp21::SessionCompressionMode> modes;
+
+    const auto list = node["allowed_session_compression_modes"];
+    if (list) {
+        yaml::foreach (list, [&modes](const YAML::Node& mode) {
+            modes.push_back(get_session_compression_mode(mode.as<std::string>()));
+        });
+    }
+
+    return modes;
+}
+
 ssp21::CryptoSuite get_crypto_suite(const YAML::Node& node)
 {
     const auto algorithms = yaml::require(node, "algorithms");
 
     CryptoSuite suite{};
     suite.session_crypto_mode = get_session_crypto_mode(algorithms);
+    suite.session_compression_mode = get_session_compression_mode(algorithms);
     return suite;
 }
 
+ssp21::ResponderConfig get_responder_config(const YAML::Node& handshake, const YAML::Node& session)
+{
+    // all of the configuration here is optional and uses the defaults if not present
+    ssp21::ResponderConfig config;
+
+    config.config = get_crypto_layer_config(session);
+    config.session = get_session_config(session);
+    // without the list, initiators that ask for compression are refused
+    config.allowed_compression_modes = get_allowed_session_compression_modes(handshake);
+
+    return config;
+}
+
+// the keys handler differs for every stack, so it's set on a copy of the configuration
+template <class Config>
+Config with_session_keys(const Config& config, const session_keys_handler_t& on_session_keys)
+{
+    Config copy(config);
+    copy.session.on_session_keys = on_session_keys;
+    return copy;
+}
+
 stack_factory_t get_initiator_shared_secret_factory(const YAML::Node& node, const ssp21::InitiatorConfig& initiator_config, const ssp21::Addresses* addresses)
 {
     const auto shared_secret = get_shared_secret(node);
@@ -216,19 +269,19 @@ stack_factory_t get_initiator_shared_secret_factory(const YAML::Node& node, cons
 
     if (addresses) {
         const auto addresses_copy = *addresses;
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return initiator::factory::shared_secret_mode(
                 addresses_copy,
-                initiator_config,
+                with_session_keys(initiator_config, on_session_keys),
                 logger,
                 executor,
                 suite,
                 shared_secret);
         };
     } else {
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return initiator::factory::shared_secret_mode(
-                initiator_config,
+                with_session_keys(initiator_config, on_session_keys),
                 logger,
                 executor,
                 suite,
@@ -246,19 +299,19 @@ stack_factory_t get_initiator_qkd_factory(const YAML::Node& node, const ssp21::I
     if (addresses) {
         const auto addresses_copy = *addresses;
 
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return initiator::factory::qkd_mode(
                 addresses_copy,
-                initiator_config,
+                with_session_keys(initiator_config, on_session_keys),
                 logger,
                 executor,
                 suite,
                 key_source);
         };
     } else {
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return initiator::factory::qkd_mode(
-                initiator_config,
+                with_session_keys(initiator_config, on_session_keys),
                 logger,
                 executor,
                 suite,
@@ -275,10 +328,10 @@ stack_factory_t get_initiator_preshared_public_key_factory(const YAML::Node& nod
 
     if (addresses) {
         const auto addresses_copy = *addresses;
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return initiator::factory::preshared_public_key_mode(
                 addresses_copy,
-                initiator_config,
+                with_session_keys(initiator_config, on_session_keys),
                 logger,
                 executor,
                 suite,
@@ -286,9 +339,9 @@ stack_factory_t get_initiator_preshared_public_key_factory(const YAML::Node& nod
                 remote_public_key);
         };
     } else {
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return initiator::factory::preshared_public_key_mode(
-                initiator_config,
+                with_session_keys(initiator_config, on_session_keys),
                 logger,
                 executor,
                 suite,
@@ -307,10 +360,10 @@ stack_factory_t get_initiator_certificate_mode_factory(const YAML::Node& node, c
 
     if (addresses) {
         const auto addresses_copy = *addresses;
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return initiator::factory::certificate_public_key_mode(
                 addresses_copy,
-                initiator_config,
+                with_session_keys(initiator_config, on_session_keys),
                 logger,
                 executor,
                 CryptoSuite(), // TODO: default
@@ -319,9 +372,9 @@ stack_factory_t get_initiator_certificate_mode_factory(const YAML::Node& node, c
                 local_cert_data);
         };
     } else {
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return initiator::factory::certificate_public_key_mode(
-                initiator_config,
+                with_session_keys(initiator_config, on_session_keys),
                 logger,
                 executor,
                 CryptoSuite(), // TODO: default
@@ -360,18 +413,18 @@ stack_factory_t get_responder_shared_secret_factory(const YAML::Node& node, cons
 
     if (addresses) {
         const auto addresses_copy = *addresses;
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return responder::factory::shared_secret_mode(
                 addresses_copy,
-                config,
+                with_session_keys(config, on_session_keys),
                 logger,
                 executor,
                 shared_secret);
         };
     } else {
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return responder::factory::shared_secret_mode(
-                config,
+                with_session_keys(config, on_session_keys),
                 logger,
                 executor,
                 shared_secret);
@@ -385,18 +438,18 @@ stack_factory_t get_responder_qkd_factory(const YAML::Node& node, const Responde
 
     if (addresses) {
         const auto addresses_copy = *addresses;
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return responder::factory::qkd_mode(
                 addresses_copy,
-                config,
+                with_session_keys(config, on_session_keys),
                 logger,
                 executor,
                 key_lookup);
         };
     } else {
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return responder::factory::qkd_mode(
-                config,
+                with_session_keys(config, on_session_keys),
                 logger,
                 executor,
                 key_lookup);
@@ -411,19 +464,19 @@ stack_factory_t get_responder_preshared_public_key_factory(const YAML::Node& nod
 
     if (addresses) {
         const auto addresses_copy = *addresses;
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return responder::factory::preshared_public_key_mode(
                 addresses_copy,
-                config,
+                with_session_keys(config, on_session_keys),
                 logger,
                 executor,
                 local_keys,
                 remote_public_key);
         };
     } else {
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return responder::factory::preshared_public_key_mode(
-                config,
+                with_session_keys(config, on_session_keys),
                 logger,
                 executor,
                 local_keys,
@@ -440,10 +493,10 @@ stack_factory_t get_responder_certificate_mode_factory(const YAML::Node& node, c
 
     if (addresses) {
         const auto addresses_copy = *addresses;
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return responder::factory::certificate_public_key_mode(
                 addresses_copy,
-                config,
+                with_session_keys(config, on_session_keys),
                 logger,
                 executor,
                 local_keys,
@@ -451,9 +504,9 @@ stack_factory_t get_responder_certificate_mode_factory(const YAML::Node& node, c
                 local_cert_data);
         };
     } else {
-        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor) {
+        return [=](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& executor, const session_keys_handler_t& on_session_keys) {
             return responder::factory::certificate_public_key_mode(
-                config,
+                with_session_keys(config, on_session_keys),
                 logger,
                 executor,
                 local_keys,
@@ -466,7 +519,7 @@ stack_factory_t get_responder_certificate_mode_factory(const YAML::Node& node, c
 stack_factory_t get_responder_factory(const YAML::Node& node, const ssp21::Addresses* addresses)
 {
     const auto handshake = yaml::require(node, "handshake");
-    const auto config = get_responder_config(yaml::require(node, "session"));
+    const auto config = get_responder_config(handshake, yaml::require(node, "session"));
     const auto mode = get_handshake_mode(handshake);
 
     switch (mode) {
@@ -490,18 +543,21 @@ StackFactory get_stack_factory(const YAML::Node& node)
     const auto security = yaml::require(node, "security");
     const auto stack_type = get_stack_type(security);
 
+    const CaptureConfig capture_config(node);
+    const auto capture = capture_config.enabled ? CaptureFile::open(capture_config) : nullptr;
+
     if (yaml::require_bool(link_layer, "enabled")) {
         const auto addresses = get_addresses(yaml::require(link_layer, "address"));
         if (stack_type == StackType::initiator) {
-            return StackFactory(true, stack_type, get_initiator_factory(security, &addresses));
+            return StackFactory(true, stack_type, get_initiator_factory(security, &addresses), capture, capture_config.include_session_keys);
         } else {
-            return StackFactory(true, stack_type, get_responder_factory(security, &addresses));
+            return StackFactory(true, stack_type, get_responder_factory(security, &addresses), capture, capture_config.include_session_keys);
         }
     } else {
         if (stack_type == StackType::initiator) {
-            return StackFactory(false, stack_type, get_initiator_factory(security, nullptr));
+            return StackFactory(false, stack_type, get_initiator_factory(security, nullptr), capture, capture_config.include_session_keys);
         } else {
-            return StackFactory(false, stack_type, get_responder_factory(security, nullptr));
+            return StackFactory(false, stack_type, get_responder_factory(security, nullptr), capture, capture_config.include_session_keys);
         }
     }
 }
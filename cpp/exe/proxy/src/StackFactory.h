@@ -3,16 +3,21 @@
 
 #include <exe4cpp/IExecutor.h>
 #include <log4cpp/Logger.h>
+#include <ssp21/crypto/CryptoLayerConfig.h>
 #include <ssp21/stack/IStack.h>
 #include <yaml-cpp/yaml.h>
 
+#include "capture/CaptureFile.h"
+#include "capture/CapturingStack.h"
+
 #include <functional>
 #include <memory>
 
-// abstracts the creation of responder or initiator
+// abstracts the creation of responder or initiator, the keys handler may be empty
 using stack_factory_t = std::function<std::shared_ptr<ssp21::IStack>(
     const log4cpp::Logger& logger,
-    const std::shared_ptr<exe4cpp::IExecutor>& exe)>;
+    const std::shared_ptr<exe4cpp::IExecutor>& exe,
+    const ssp21::session_keys_handler_t& on_session_keys)>;
 
 enum class StackType {
     initiator,
@@ -21,16 +26,35 @@ enum class StackType {
 
 class StackFactory {
 public:
-    StackFactory(bool uses_link_layer, StackType type, stack_factory_t impl)
+    StackFactory(bool uses_link_layer, StackType type, stack_factory_t impl, std::shared_ptr<CaptureFile> capture = nullptr, bool capture_keys = false)
         : uses_link_layer(uses_link_layer)
         , type(type)
         , impl(impl)
+        , capture(capture)
+        , capture_keys(capture_keys)
     {
     }
 
     std::shared_ptr<ssp21::IStack> create_stack(const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& exe)
     {
-        return impl(logger, exe);
+        if (!this->capture) {
+            return impl(logger, exe, nullptr);
+        }
+
+        const auto session = std::make_shared<SessionCapture>(
+            this->capture,
+            logger,
+            (this->type == StackType::initiator) ? capture::StackKind::initiator : capture::StackKind::responder,
+            this->uses_link_layer);
+
+        ssp21::session_keys_handler_t on_session_keys;
+        if (this->capture_keys) {
+            on_session_keys = [session](const ssp21::seq32_t& rx_key, const ssp21::seq32_t& tx_key) {
+                session->record_keys(rx_key, tx_key);
+            };
+        }
+
+        return std::make_shared<CapturingStack>(session, impl(logger, exe, on_session_keys));
     }
 
     StackType get_type() const
@@ -47,6 +71,9 @@ private:
     bool uses_link_layer;
     StackType type;
     stack_factory_t impl;
+    // null unless the traffic of the stacks is recorded
+    std::shared_ptr<CaptureFile> capture;
+    bool capture_keys;
 };
 
 #endif
@@ -0,0 +1,26 @@
+#include "WorkerConfig.h"
+
+#include "YAMLHelpers.h"
+
+uint16_t get_worker_threads(const YAML::Node& root)
+{
+    const auto value = yaml::optional_integer<uint16_t>(root, "worker_threads", 1);
+
+    if (value == 0) {
+        throw yaml::YAMLException(root["worker_threads"].Mark(), "worker_threads must be greater than zero");
+    }
+
+    return value;
+}
+
+bool get_pin_worker_threads(const YAML::Node& root)
+{
+    const auto node = root["pin_worker_threads"];
+    return node ? node.as<bool>() : false;
+}
+
+WorkerConfig::WorkerConfig(const YAML::Node& root)
+    : worker_threads(get_worker_threads(root))
+    , pin_worker_threads(get_pin_worker_threads(root))
+{
+}
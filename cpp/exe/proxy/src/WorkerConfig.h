@@ -0,0 +1,21 @@
+#ifndef SSP21PROXY_WORKERCONFIG_H
+#define SSP21PROXY_WORKERCONFIG_H
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstdint>
+
+/**
+ * Threading settings read from the top-level of the configuration file
+ */
+struct WorkerConfig {
+    explicit WorkerConfig(const YAML::Node& root);
+
+    // number of threads, each with its own executor and io context
+    const uint16_t worker_threads;
+
+    // pin worker N to CPU (N % number of CPUs)
+    const bool pin_worker_threads;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "WorkerPool.h"
+
+#include <log4cpp/LogMacros.h>
+#include <ssp21/stack/LogLevels.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+
+WorkerPool::WorkerPool(const WorkerConfig& config, const log4cpp::Logger& logger)
+    : pin_worker_threads(config.pin_worker_threads)
+    , logger(logger)
+{
+    for (uint16_t i = 0; i < config.worker_threads; ++i) {
+        this->executors.push_back(exe4cpp::BasicExecutor::create(std::make_shared<asio::io_service>()));
+    }
+}
+
+void WorkerPool::run()
+{
+    std::vector<std::thread> threads;
+
+    for (size_t i = 1; i < this->executors.size(); ++i) {
+        threads.emplace_back([this, i]() { this->run_worker(i); });
+    }
+
+    this->run_worker(0);
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::run_worker(size_t index)
+{
+    if (this->pin_worker_threads) {
+        const auto num_cpus = std::thread::hardware_concurrency();
+        const auto cpu = static_cast<int>(index % (num_cpus == 0 ? 1 : num_cpus));
+
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpu, &cpu_set);
+
+        const auto err = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        if (err) {
+            FORMAT_LOG_BLOCK(this->logger, ssp21::levels::warn, "unable to pin worker %u to cpu %d: %d", static_cast<uint32_t>(index), cpu, err);
+        } else {
+            FORMAT_LOG_BLOCK(this->logger, ssp21::levels::info, "pinned worker %u to cpu %d", static_cast<uint32_t>(index), cpu);
+        }
+    }
+
+    FORMAT_LOG_BLOCK(this->logger, ssp21::levels::event, "worker %u begin io_context::run()", static_cast<uint32_t>(index));
+    this->executors[index]->get_service()->run();
+    FORMAT_LOG_BLOCK(this->logger, ssp21::levels::event, "worker %u end io_context::run()", static_cast<uint32_t>(index));
+}
@@ -0,0 +1,50 @@
+#ifndef SSP21PROXY_WORKERPOOL_H
+#define SSP21PROXY_WORKERPOOL_H
+
+#include "WorkerConfig.h"
+
+#include <exe4cpp/asio/BasicExecutor.h>
+#include <log4cpp/Logger.h>
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <memory>
+#include <vector>
+
+/**
+ * A set of single-threaded executors, each with its own io context.
+ *
+ * Nothing is shared between workers, so a session and everything it owns
+ * stays on the thread of the executor it was created on.
+ */
+class WorkerPool final : private ser4cpp::Uncopyable {
+
+public:
+    WorkerPool(const WorkerConfig& config, const log4cpp::Logger& logger);
+
+    size_t size() const
+    {
+        return this->executors.size();
+    }
+
+    const std::shared_ptr<exe4cpp::BasicExecutor>& get(size_t index) const
+    {
+        return this->executors[index];
+    }
+
+    /**
+     * Run every io context until they all run out of work.
+     *
+     * Worker zero runs on the calling thread.
+     */
+    void run();
+
+private:
+    void run_worker(size_t index);
+
+    const bool pin_worker_threads;
+    log4cpp::Logger logger;
+
+    std::vector<std::shared_ptr<exe4cpp::BasicExecutor>> executors;
+};
+
+#endif
@@ -71,6 +71,15 @@ bool require_bool(const YAML::Node& node, const std::string& key)
     return require(node, key).as<bool>();
 }
 
+bool optional_bool(const YAML::Node& node, const std::string& key, bool default_value)
+{
+    if (!node || !node[key]) {
+        return default_value;
+    }
+
+    return node[key].as<bool>();
+}
+
 std::string require_string(const YAML::Node& node, const std::string& key)
 {
     const auto subnode = require(node, key);
@@ -32,6 +32,8 @@ YAML::Node require(const YAML::Node& node, const std::string& key);
 
 bool require_bool(const YAML::Node& node, const std::string& key);
 
+bool optional_bool(const YAML::Node& node, const std::string& key, bool default_value);
+
 std::string require_string(const YAML::Node& node, const std::string& key);
 
 std::string optional_string(const YAML::Node& node, const std::string& key, const std::string& default_value);
@@ -0,0 +1,21 @@
+#include "CaptureConfig.h"
+
+#include "YAMLHelpers.h"
+
+CaptureConfig::CaptureConfig()
+    : enabled(false)
+    , include_session_keys(false)
+    , max_file_size(0)
+{
+}
+
+CaptureConfig::CaptureConfig(const YAML::Node& session)
+    : enabled(static_cast<bool>(session["capture"]))
+    , path(enabled ? yaml::require_string(session["capture"], "path") : "")
+    , include_session_keys(yaml::optional_bool(session["capture"], "include_session_keys", false))
+    , max_file_size(static_cast<uint64_t>(yaml::optional_integer<uint32_t>(session["capture"], "max_file_size_mb", default_max_file_size_mb)) * 1024 * 1024)
+{
+    if (this->enabled && this->max_file_size == 0) {
+        throw yaml::YAMLException(session.Mark(), "capture.max_file_size_mb must be greater than zero");
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef SSP21PROXY_CAPTURECONFIG_H
+#define SSP21PROXY_CAPTURECONFIG_H
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Optional recording of the secure side of a session into a frame capture file.
+ *
+ * The session keys are only written to the file if include_session_keys is set. Anyone who can
+ * read such a file can decrypt and forge the captured traffic until the sessions are renegotiated.
+ */
+struct CaptureConfig {
+    static const uint32_t default_max_file_size_mb = 1024;
+
+    // capture disabled
+    CaptureConfig();
+
+    // reads the optional 'capture' node of a session
+    CaptureConfig(const YAML::Node& session);
+
+    const bool enabled;
+    const std::string path;
+    const bool include_session_keys;
+    // nothing more is recorded once the file reaches this size
+    const uint64_t max_file_size;
+};
+
+#endif
@@ -0,0 +1,153 @@
+#include "CaptureFile.h"
+
+#include <ssp21/util/Exception.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+using namespace ssp21;
+
+std::map<std::string, std::weak_ptr<CaptureFile>> CaptureFile::files;
+const std::chrono::steady_clock::duration CaptureFile::flush_interval = std::chrono::seconds(1);
+
+std::shared_ptr<CaptureFile> CaptureFile::open(const CaptureConfig& config)
+{
+    // the size limit of a file stays the one it was first opened with
+    auto file = files[config.path].lock();
+    if (!file) {
+        file = std::make_shared<CaptureFile>(config.path, config.max_file_size);
+        files[config.path] = file;
+    }
+    return file;
+}
+
+CaptureFile::CaptureFile(const std::string& path, uint64_t max_file_size)
+    : path(path)
+    , max_file_size(max_file_size)
+    , last_flush(std::chrono::steady_clock::now())
+{
+    // the file may contain session keys
+    this->fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (this->fd < 0) {
+        throw Exception("unable to open capture file ", path, ": ", strerror(errno));
+    }
+
+    struct stat info {
+    };
+    if (fstat(this->fd, &info) != 0) {
+        const auto error = errno;
+        ::close(this->fd);
+        throw Exception("unable to read the size of capture file ", path, ": ", strerror(error));
+    }
+
+    this->buffer.reserve(buffer_size);
+    this->file_size = static_cast<uint64_t>(info.st_size);
+
+    capture::FileHeader header{};
+
+    if (this->file_size == 0) {
+        memcpy(header.magic, capture::file_magic, sizeof(header.magic));
+        header.version = capture::file_version;
+        header.header_size = sizeof(capture::FileHeader);
+        const auto bytes = reinterpret_cast<const uint8_t*>(&header);
+        this->buffer.insert(this->buffer.end(), bytes, bytes + sizeof(header));
+        this->file_size = sizeof(header);
+        this->flush_buffer();
+    } else if (pread(this->fd, &header, sizeof(header), 0) != sizeof(header) || memcmp(header.magic, capture::file_magic, sizeof(header.magic)) != 0 || header.version != capture::file_version) {
+        // never append records to something else
+        ::close(this->fd);
+        throw Exception("not a version ", capture::file_version, " capture file: ", path);
+    }
+}
+
+CaptureFile::~CaptureFile()
+{
+    this->flush();
+    ::close(this->fd);
+}
+
+bool CaptureFile::write(capture::RecordType type, uint64_t session_id, std::initializer_list<seq32_t> data)
+{
+    const auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch());
+
+    uint32_t length = 0;
+    for (const auto& item : data) {
+        length += item.length();
+    }
+
+    const auto padded_length = capture::get_padded_length(length);
+    const auto record_size = sizeof(capture::RecordHeader) + padded_length;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    if (this->is_stopped) {
+        return false;
+    }
+
+    if (this->file_size + record_size > this->max_file_size) {
+        this->is_stopped = true;
+        return false;
+    }
+
+    capture::RecordHeader header{};
+    header.timestamp_ns = static_cast<uint64_t>(timestamp.count());
+    header.session_id = session_id;
+    header.length = length;
+    header.type = static_cast<uint16_t>(type);
+
+    const auto bytes = reinterpret_cast<const uint8_t*>(&header);
+    this->buffer.insert(this->buffer.end(), bytes, bytes + sizeof(header));
+    for (const auto& item : data) {
+        const auto item_bytes = static_cast<const uint8_t*>(item);
+        this->buffer.insert(this->buffer.end(), item_bytes, item_bytes + item.length());
+    }
+    this->buffer.resize(this->buffer.size() + (padded_length - length), 0);
+    this->file_size += record_size;
+
+    if (this->buffer.size() >= buffer_size || (std::chrono::steady_clock::now() - this->last_flush) >= flush_interval) {
+        this->flush_buffer();
+    }
+
+    return !this->is_stopped;
+}
+
+void CaptureFile::flush()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->flush_buffer();
+}
+
+bool CaptureFile::take_stopped_notice()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!this->is_stopped || this->is_stopped_reported) {
+        return false;
+    }
+    this->is_stopped_reported = true;
+    return true;
+}
+
+void CaptureFile::flush_buffer()
+{
+    this->last_flush = std::chrono::steady_clock::now();
+
+    size_t num_written = 0;
+    while (num_written < this->buffer.size()) {
+        const auto result = ::write(this->fd, this->buffer.data() + num_written, this->buffer.size() - num_written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // e.g. the disk is full, stop rather than leave a gap in the middle of the file
+            this->is_stopped = true;
+            break;
+        }
+        num_written += static_cast<size_t>(result);
+    }
+
+    this->buffer.clear();
+}
@@ -0,0 +1,79 @@
+#ifndef SSP21PROXY_CAPTUREFILE_H
+#define SSP21PROXY_CAPTUREFILE_H
+
+#include "CaptureConfig.h"
+#include "CaptureFormat.h"
+
+#include <ser4cpp/util/Uncopyable.h>
+#include <ssp21/util/SequenceTypes.h>
+
+#include <atomic>
+#include <chrono>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * An append-only frame capture file shared by the sessions of every worker.
+ *
+ * Records are collected in a buffer and appended to the file with a single write, so a file
+ * that is briefly open twice, e.g. while a reload replaces the sessions writing to it, only ever
+ * contains whole records. The buffer is written once it fills up, when a session closes, and when
+ * a record arrives more than a second after the last write.
+ */
+class CaptureFile final : private ser4cpp::Uncopyable {
+public:
+    // returns the file already open for the configured path or opens it, throws if that fails
+    static std::shared_ptr<CaptureFile> open(const CaptureConfig& config);
+
+    CaptureFile(const std::string& path, uint64_t max_file_size);
+
+    ~CaptureFile();
+
+    uint64_t next_session_id()
+    {
+        return ++this->num_sessions;
+    }
+
+    // returns false if nothing is recorded anymore because the file is full or couldn't be written
+    bool write(capture::RecordType type, uint64_t session_id, std::initializer_list<ssp21::seq32_t> data);
+
+    void flush();
+
+    // true for the first caller once recording stopped, so that it's only reported once
+    bool take_stopped_notice();
+
+    const std::string& get_path() const
+    {
+        return this->path;
+    }
+
+private:
+    static const size_t buffer_size = 256 * 1024;
+    static const std::chrono::steady_clock::duration flush_interval;
+
+    // the configuration is only read from one thread at a time
+    static std::map<std::string, std::weak_ptr<CaptureFile>> files;
+
+    // with the mutex held
+    void flush_buffer();
+
+    const std::string path;
+    const uint64_t max_file_size;
+    int fd = -1;
+
+    std::atomic<uint64_t> num_sessions{ 0 };
+
+    std::mutex mutex;
+    std::vector<uint8_t> buffer;
+    // what was written plus what is buffered
+    uint64_t file_size = 0;
+    std::chrono::steady_clock::time_point last_flush;
+    bool is_stopped = false;
+    bool is_stopped_reported = false;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef SSP21PROXY_CAPTUREFORMAT_H
+#define SSP21PROXY_CAPTUREFORMAT_H
+
+#include <cstdint>
+
+/**
+ * Layout of the frame capture files written by the proxy and read by the replay tool.
+ *
+ * A file is a FileHeader followed by records that are only ever appended. Every record is a
+ * RecordHeader followed by its data, padded with zeros to a multiple of 8 bytes, so that the
+ * headers stay aligned when the file is mapped into memory. All integers are in the byte order
+ * of the machine that wrote the file, which is little-endian on every supported platform.
+ *
+ * The records of concurrent sessions are interleaved in the order they were written.
+ */
+namespace capture {
+
+static const char file_magic[8] = { 'S', 'S', 'P', '2', '1', 'C', 'A', 'P' };
+static const uint32_t file_version = 1;
+static const uint32_t alignment = 8;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+};
+
+enum class RecordType : uint16_t {
+    // data is a SessionInfo
+    session_open = 1,
+    // a chunk read from the secure socket, as the stack received it
+    rx = 2,
+    // a chunk written to the secure socket
+    tx = 3,
+    // data is a SessionKeysInfo followed by the rx and tx keys, only recorded when enabled
+    session_keys = 4,
+    // no data
+    session_close = 5
+};
+
+struct RecordHeader {
+    // wall clock time the record was written, nanoseconds since the UNIX epoch
+    uint64_t timestamp_ns;
+    // identifies the session within the file
+    uint64_t session_id;
+    // length of the data, not including the padding
+    uint32_t length;
+    uint16_t type;
+    uint16_t reserved;
+};
+
+enum class StackKind : uint8_t {
+    initiator = 0,
+    responder = 1
+};
+
+struct SessionInfo {
+    uint8_t stack_kind;
+    // if set, the rx and tx chunks are link-layer frames
+    uint8_t uses_link_layer;
+    uint16_t reserved1;
+    uint32_t reserved2;
+};
+
+// the keys are from the point of view of the proxy, i.e. the rx key authenticates the rx records
+struct SessionKeysInfo {
+    uint16_t rx_key_length;
+    uint16_t tx_key_length;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) % alignment == 0, "file header must keep the records aligned");
+static_assert(sizeof(RecordHeader) == 24, "unexpected record header layout");
+static_assert(sizeof(SessionInfo) == 8, "unexpected session info layout");
+static_assert(sizeof(SessionKeysInfo) == 8, "unexpected session keys layout");
+
+inline uint32_t get_padded_length(uint32_t length)
+{
+    return (length + alignment - 1) & ~(alignment - 1);
+}
+}
+
+#endif
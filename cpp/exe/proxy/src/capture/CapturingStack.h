@@ -0,0 +1,127 @@
+#ifndef SSP21PROXY_CAPTURINGSTACK_H
+#define SSP21PROXY_CAPTURINGSTACK_H
+
+#include "SessionCapture.h"
+
+#include <ssp21/stack/IStack.h>
+
+#include <memory>
+
+/**
+ * Wraps a stack and records the chunks it reads from and writes to its lower layer.
+ *
+ * The wrapped stack is bound to a tap in front of the real lower layer, so the chunks are
+ * recorded exactly as the stack consumed and produced them, whatever the transport.
+ */
+class CapturingStack final : public ssp21::IStack {
+
+    class LowerTap final : public ssp21::ILowerLayer {
+    public:
+        explicit LowerTap(SessionCapture& capture)
+            : capture(capture)
+        {
+        }
+
+        void bind(ssp21::ILowerLayer& lower)
+        {
+            this->lower = &lower;
+        }
+
+        bool is_tx_ready() const override
+        {
+            return this->lower->is_tx_ready();
+        }
+
+        bool start_tx_from_upper(const ssp21::seq32_t& data) override
+        {
+            if (!this->lower->start_tx_from_upper(data)) {
+                return false;
+            }
+
+            this->capture.record_tx(data);
+            return true;
+        }
+
+    protected:
+        // the real lower layer discards the previous chunk when the next one is requested
+        void discard_rx_data() override {}
+
+        ssp21::seq32_t start_rx_from_upper_impl() override
+        {
+            const auto data = this->lower->start_rx_from_upper();
+            if (data.is_not_empty()) {
+                this->capture.record_rx(data);
+            }
+            return data;
+        }
+
+    private:
+        SessionCapture& capture;
+        ssp21::ILowerLayer* lower = nullptr;
+    };
+
+public:
+    CapturingStack(const std::shared_ptr<SessionCapture>& capture, const std::shared_ptr<ssp21::IStack>& stack)
+        : capture(capture)
+        , stack(stack)
+        , tap(*capture)
+    {
+    }
+
+    void bind(ssp21::ILowerLayer& lower, ssp21::IUpperLayer& upper) override
+    {
+        this->tap.bind(lower);
+        this->stack->bind(this->tap, upper);
+    }
+
+    // ILowerLayer
+
+    bool is_tx_ready() const override
+    {
+        return this->stack->is_tx_ready();
+    }
+
+    bool start_tx_from_upper(const ssp21::seq32_t& data) override
+    {
+        return this->stack->start_tx_from_upper(data);
+    }
+
+protected:
+    // the wrapped stack discards the previous chunk when the next one is requested
+    void discard_rx_data() override {}
+
+    ssp21::seq32_t start_rx_from_upper_impl() override
+    {
+        return this->stack->start_rx_from_upper();
+    }
+
+    // IUpperLayer
+
+    void on_lower_open_impl() override
+    {
+        this->stack->on_lower_open();
+    }
+
+    void on_lower_close_impl() override
+    {
+        this->stack->on_lower_close();
+    }
+
+    void on_lower_tx_ready_impl() override
+    {
+        this->stack->on_lower_tx_ready();
+    }
+
+    void on_lower_rx_ready_impl() override
+    {
+        this->stack->on_lower_rx_ready();
+    }
+
+private:
+    // the wrapped stack may hold the keys handler of the capture, which is released after it
+    const std::shared_ptr<SessionCapture> capture;
+    const std::shared_ptr<ssp21::IStack> stack;
+    LowerTap tap;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#include "SessionCapture.h"
+
+#include <log4cpp/LogMacros.h>
+#include <ssp21/stack/LogLevels.h>
+
+using namespace ssp21;
+
+namespace {
+template <class T>
+seq32_t as_seq(const T& value)
+{
+    return seq32_t(reinterpret_cast<const uint8_t*>(&value), sizeof(T));
+}
+}
+
+SessionCapture::SessionCapture(const std::shared_ptr<CaptureFile>& file, const log4cpp::Logger& logger, capture::StackKind kind, bool uses_link_layer)
+    : file(file)
+    , logger(logger)
+    , id(file->next_session_id())
+{
+    capture::SessionInfo info{};
+    info.stack_kind = static_cast<uint8_t>(kind);
+    info.uses_link_layer = uses_link_layer ? 1 : 0;
+    this->record(capture::RecordType::session_open, { as_seq(info) });
+}
+
+SessionCapture::~SessionCapture()
+{
+    this->record(capture::RecordType::session_close, {});
+    this->file->flush();
+}
+
+void SessionCapture::record_keys(const seq32_t& rx_key, const seq32_t& tx_key)
+{
+    capture::SessionKeysInfo info{};
+    info.rx_key_length = static_cast<uint16_t>(rx_key.length());
+    info.tx_key_length = static_cast<uint16_t>(tx_key.length());
+    this->record(capture::RecordType::session_keys, { as_seq(info), rx_key, tx_key });
+}
+
+void SessionCapture::record(capture::RecordType type, std::initializer_list<seq32_t> data)
+{
+    if (!this->file->write(type, this->id, data) && this->file->take_stopped_notice()) {
+        FORMAT_LOG_BLOCK(this->logger, levels::warn, "capture file %s is full or can't be written, recording stopped", this->file->get_path().c_str());
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef SSP21PROXY_SESSIONCAPTURE_H
+#define SSP21PROXY_SESSIONCAPTURE_H
+
+#include "CaptureFile.h"
+
+#include <log4cpp/Logger.h>
+#include <ser4cpp/util/Uncopyable.h>
+#include <ssp21/crypto/CryptoLayerConfig.h>
+
+#include <memory>
+
+/**
+ * Records the traffic of a single stack into a capture file, from the thread of its worker.
+ *
+ * The session is opened in the file on construction and closed on destruction.
+ */
+class SessionCapture final : private ser4cpp::Uncopyable {
+public:
+    SessionCapture(const std::shared_ptr<CaptureFile>& file, const log4cpp::Logger& logger, capture::StackKind kind, bool uses_link_layer);
+
+    ~SessionCapture();
+
+    void record_rx(const ssp21::seq32_t& data)
+    {
+        this->record(capture::RecordType::rx, { data });
+    }
+
+    void record_tx(const ssp21::seq32_t& data)
+    {
+        this->record(capture::RecordType::tx, { data });
+    }
+
+    void record_keys(const ssp21::seq32_t& rx_key, const ssp21::seq32_t& tx_key);
+
+private:
+    void record(capture::RecordType type, std::initializer_list<ssp21::seq32_t> data);
+
+    const std::shared_ptr<CaptureFile> file;
+    log4cpp::Logger logger;
+    const uint64_t id;
+};
+
+#endif
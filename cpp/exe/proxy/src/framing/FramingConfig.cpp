@@ -0,0 +1,45 @@
+#include "FramingConfig.h"
+
+#include "YAMLHelpers.h"
+
+FramingType get_framing_type(const YAML::Node& node)
+{
+    const auto value = yaml::optional_string(node, "type", "pass_through");
+
+    if (value == "pass_through") {
+        return FramingType::pass_through;
+    }
+
+    if (value == "modbus_tcp") {
+        return FramingType::modbus_tcp;
+    }
+
+    if (value == "dnp3") {
+        return FramingType::dnp3;
+    }
+
+    if (value == "length_prefix") {
+        return FramingType::length_prefix;
+    }
+
+    throw yaml::YAMLException(node.Mark(), "unknown plaintext framing: ", value);
+}
+
+FramingConfig::FramingConfig(const YAML::Node& session)
+    : type(get_framing_type(session["plaintext_framing"]))
+{
+    if (this->type != FramingType::length_prefix) {
+        return;
+    }
+
+    const auto node = session["plaintext_framing"];
+
+    this->length_offset = yaml::optional_integer<uint32_t>(node, "length_offset", this->length_offset);
+    this->length_size = yaml::optional_integer<uint8_t>(node, "length_size", this->length_size);
+    this->big_endian = yaml::optional_bool(node, "big_endian", this->big_endian);
+    this->length_adjustment = yaml::optional_integer<int32_t>(node, "length_adjustment", this->length_adjustment);
+
+    if (this->length_size != 1 && this->length_size != 2 && this->length_size != 4) {
+        throw yaml::YAMLException(node.Mark(), "plaintext_framing.length_size must be 1, 2 or 4");
+    }
+}
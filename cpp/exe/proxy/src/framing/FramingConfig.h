@@ -0,0 +1,39 @@
+#ifndef SSP21PROXY_FRAMINGCONFIG_H
+#define SSP21PROXY_FRAMINGCONFIG_H
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstdint>
+
+enum class FramingType {
+    // every socket read is a message, as it arrives
+    pass_through,
+    // Modbus/TCP, the length field of the MBAP header
+    modbus_tcp,
+    // DNP3 over TCP, the length byte of the link-layer header
+    dnp3,
+    // a length field of a configurable size and position
+    length_prefix
+};
+
+/**
+ * How the plaintext stream is cut into messages before they are encrypted, from the optional
+ * 'plaintext_framing' node of a session.
+ *
+ * For length_prefix, a message is length_offset + length_size + the value of the field + length_adjustment bytes long.
+ */
+struct FramingConfig {
+    // pass-through when the node isn't present
+    FramingConfig() = default;
+
+    explicit FramingConfig(const YAML::Node& session);
+
+    FramingType type = FramingType::pass_through;
+
+    uint32_t length_offset = 0;
+    uint8_t length_size = 2;
+    bool big_endian = true;
+    int32_t length_adjustment = 0;
+};
+
+#endif
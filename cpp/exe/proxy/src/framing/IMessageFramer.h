@@ -0,0 +1,34 @@
+#ifndef SSP21PROXY_IMESSAGEFRAMER_H
+#define SSP21PROXY_IMESSAGEFRAMER_H
+
+#include <ssp21/link/LinkConstants.h>
+#include <ssp21/util/SequenceTypes.h>
+
+#include <cstdint>
+
+enum class FramingResult : uint8_t {
+    // the length of the message at the start of the data is known
+    ok,
+    // the data is too short to tell
+    need_more,
+    // the data doesn't start with a valid header, the stream can't be framed anymore
+    invalid
+};
+
+/**
+ * Finds the application message boundaries in a plaintext stream
+ */
+class IMessageFramer {
+public:
+    // messages larger than a plaintext queue slot are invalid
+    static const uint32_t max_message_size = ssp21::consts::link::max_frame_size;
+
+    virtual ~IMessageFramer() = default;
+
+    /**
+     * Read the length of the message at the start of the data, the data may hold less or more than the message
+     */
+    virtual FramingResult get_message_length(const ssp21::seq32_t& data, uint32_t& length) const = 0;
+};
+
+#endif
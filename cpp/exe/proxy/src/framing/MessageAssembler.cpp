@@ -0,0 +1,79 @@
+#include "MessageAssembler.h"
+
+#include "MessageFramers.h"
+
+#include <cstring>
+
+MessageAssembler::MessageAssembler(const FramingConfig& config)
+    : framer(create_message_framer(config))
+    , buffer(2 * IMessageFramer::max_message_size)
+{
+}
+
+bool MessageAssembler::can_accept() const
+{
+    return this->get_free_space() >= IMessageFramer::max_message_size;
+}
+
+bool MessageAssembler::append(const ssp21::seq32_t& data)
+{
+    if (data.length() > this->get_free_space()) {
+        return false;
+    }
+
+    // move the unread bytes to the front when the data doesn't fit after them
+    if (this->start > 0 && data.length() > this->buffer.length() - this->end) {
+        const auto unread = this->end - this->start;
+        memmove(this->buffer.as_wslice(), this->buffer.as_rslice().skip(this->start), unread);
+        this->start = 0;
+        this->end = unread;
+    }
+
+    memcpy(this->buffer.as_wslice().skip(this->end), data, data.length());
+    this->end += data.length();
+    return true;
+}
+
+FramingResult MessageAssembler::next(ssp21::seq32_t& message) const
+{
+    const auto unread = this->buffer.as_rslice().skip(this->start).take(this->end - this->start);
+    if (unread.is_empty()) {
+        return FramingResult::need_more;
+    }
+
+    uint32_t length = 0;
+    const auto result = this->framer->get_message_length(unread, length);
+    if (result != FramingResult::ok) {
+        return result;
+    }
+
+    if (length == 0 || length > IMessageFramer::max_message_size) {
+        return FramingResult::invalid;
+    }
+
+    if (length > unread.length()) {
+        return FramingResult::need_more;
+    }
+
+    message = unread.take(length);
+    return FramingResult::ok;
+}
+
+void MessageAssembler::pop(uint32_t length)
+{
+    this->start += length;
+    if (this->start >= this->end) {
+        this->clear();
+    }
+}
+
+void MessageAssembler::clear()
+{
+    this->start = 0;
+    this->end = 0;
+}
+
+uint32_t MessageAssembler::get_free_space() const
+{
+    return this->buffer.length() - (this->end - this->start);
+}
@@ -0,0 +1,47 @@
+#ifndef SSP21PROXY_MESSAGEASSEMBLER_H
+#define SSP21PROXY_MESSAGEASSEMBLER_H
+
+#include "FramingConfig.h"
+#include "IMessageFramer.h"
+
+#include <ser4cpp/container/Buffer.h>
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <memory>
+
+/**
+ * Buffers socket reads until they hold complete messages.
+ *
+ * Holds up to two maximum size reads, so a partial message at the end of one read can always be
+ * completed by the next one.
+ */
+class MessageAssembler final : private ser4cpp::Uncopyable {
+public:
+    explicit MessageAssembler(const FramingConfig& config);
+
+    // true if a maximum size socket read can be appended
+    bool can_accept() const;
+
+    // false if the data doesn't fit
+    bool append(const ssp21::seq32_t& data);
+
+    // the next complete message, only valid until the next call to append() or pop()
+    FramingResult next(ssp21::seq32_t& message) const;
+
+    // discard the first length bytes, usually the message returned by next()
+    void pop(uint32_t length);
+
+    void clear();
+
+private:
+    uint32_t get_free_space() const;
+
+    const std::unique_ptr<IMessageFramer> framer;
+
+    ser4cpp::Buffer buffer;
+    // the unread bytes are in [start, end)
+    uint32_t start = 0;
+    uint32_t end = 0;
+};
+
+#endif
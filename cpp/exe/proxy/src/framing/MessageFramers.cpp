@@ -0,0 +1,100 @@
+#include "MessageFramers.h"
+
+namespace {
+// transaction id, protocol id and length, the unit id is counted by the length
+const uint32_t mbap_length_end = 6;
+const uint16_t mbap_min_length = 2;
+const uint16_t mbap_max_length = 254;
+
+// start bytes, length, control, destination, source and the CRC of the header
+const uint32_t dnp3_header_size = 10;
+const uint8_t dnp3_min_length = 5;
+const uint32_t dnp3_block_size = 16;
+const uint32_t dnp3_crc_size = 2;
+}
+
+FramingResult PassThroughFramer::get_message_length(const ssp21::seq32_t& data, uint32_t& length) const
+{
+    const uint32_t max = max_message_size;
+    length = (data.length() < max) ? data.length() : max;
+    return FramingResult::ok;
+}
+
+FramingResult ModbusTcpFramer::get_message_length(const ssp21::seq32_t& data, uint32_t& length) const
+{
+    if (data.length() < mbap_length_end) {
+        return FramingResult::need_more;
+    }
+
+    const auto protocol_id = static_cast<uint16_t>((data[2] << 8) | data[3]);
+    const auto mbap_length = static_cast<uint16_t>((data[4] << 8) | data[5]);
+
+    if (protocol_id != 0 || mbap_length < mbap_min_length || mbap_length > mbap_max_length) {
+        return FramingResult::invalid;
+    }
+
+    length = mbap_length_end + mbap_length;
+    return FramingResult::ok;
+}
+
+FramingResult Dnp3Framer::get_message_length(const ssp21::seq32_t& data, uint32_t& length) const
+{
+    if (data.length() < 3) {
+        return FramingResult::need_more;
+    }
+
+    if (data[0] != 0x05 || data[1] != 0x64 || data[2] < dnp3_min_length) {
+        return FramingResult::invalid;
+    }
+
+    // the length counts the control, address and user data bytes, every block of user data has a CRC
+    const uint32_t user_data_length = data[2] - dnp3_min_length;
+    const auto num_blocks = (user_data_length + dnp3_block_size - 1) / dnp3_block_size;
+
+    length = dnp3_header_size + user_data_length + num_blocks * dnp3_crc_size;
+    return FramingResult::ok;
+}
+
+LengthPrefixFramer::LengthPrefixFramer(const FramingConfig& config)
+    : length_offset(config.length_offset)
+    , length_size(config.length_size)
+    , big_endian(config.big_endian)
+    , length_adjustment(config.length_adjustment)
+{
+}
+
+FramingResult LengthPrefixFramer::get_message_length(const ssp21::seq32_t& data, uint32_t& length) const
+{
+    const auto header_size = this->length_offset + this->length_size;
+    if (data.length() < header_size) {
+        return FramingResult::need_more;
+    }
+
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < this->length_size; ++i) {
+        const auto index = this->big_endian ? i : (this->length_size - 1 - i);
+        value = (value << 8) | data[this->length_offset + index];
+    }
+
+    const auto total = static_cast<int64_t>(header_size) + value + this->length_adjustment;
+    if (total < header_size || total > max_message_size) {
+        return FramingResult::invalid;
+    }
+
+    length = static_cast<uint32_t>(total);
+    return FramingResult::ok;
+}
+
+std::unique_ptr<IMessageFramer> create_message_framer(const FramingConfig& config)
+{
+    switch (config.type) {
+    case (FramingType::modbus_tcp):
+        return std::make_unique<ModbusTcpFramer>();
+    case (FramingType::dnp3):
+        return std::make_unique<Dnp3Framer>();
+    case (FramingType::length_prefix):
+        return std::make_unique<LengthPrefixFramer>(config);
+    default:
+        return std::make_unique<PassThroughFramer>();
+    }
+}
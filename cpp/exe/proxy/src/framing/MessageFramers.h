@@ -0,0 +1,41 @@
+#ifndef SSP21PROXY_MESSAGEFRAMERS_H
+#define SSP21PROXY_MESSAGEFRAMERS_H
+
+#include "FramingConfig.h"
+#include "IMessageFramer.h"
+
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <memory>
+
+class PassThroughFramer final : public IMessageFramer, private ser4cpp::Uncopyable {
+public:
+    FramingResult get_message_length(const ssp21::seq32_t& data, uint32_t& length) const override;
+};
+
+class ModbusTcpFramer final : public IMessageFramer, private ser4cpp::Uncopyable {
+public:
+    FramingResult get_message_length(const ssp21::seq32_t& data, uint32_t& length) const override;
+};
+
+class Dnp3Framer final : public IMessageFramer, private ser4cpp::Uncopyable {
+public:
+    FramingResult get_message_length(const ssp21::seq32_t& data, uint32_t& length) const override;
+};
+
+class LengthPrefixFramer final : public IMessageFramer, private ser4cpp::Uncopyable {
+public:
+    explicit LengthPrefixFramer(const FramingConfig& config);
+
+    FramingResult get_message_length(const ssp21::seq32_t& data, uint32_t& length) const override;
+
+private:
+    const uint32_t length_offset;
+    const uint8_t length_size;
+    const bool big_endian;
+    const int32_t length_adjustment;
+};
+
+std::unique_ptr<IMessageFramer> create_message_framer(const FramingConfig& config);
+
+#endif
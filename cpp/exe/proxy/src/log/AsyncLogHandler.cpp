@@ -0,0 +1,109 @@
+#include "AsyncLogHandler.h"
+
+#include "LogFormatting.h"
+
+#include <cinttypes>
+#include <cstring>
+
+// bound on how long a record can sit in the ring if the writer misses a notification
+const auto max_writer_sleep = std::chrono::milliseconds(10);
+
+void copy_string(char* dest, size_t size, const char* src)
+{
+    strncpy(dest, src, size - 1);
+    dest[size - 1] = '\0';
+}
+
+AsyncLogHandler::AsyncLogHandler(uint32_t ring_size, std::unique_ptr<ILogSink> sink)
+    : ring(ring_size)
+    , sink(std::move(sink))
+    , writer([this]() { this->run(); })
+{
+}
+
+AsyncLogHandler::~AsyncLogHandler()
+{
+    this->is_shutdown = true;
+    this->condition.notify_one();
+    this->writer.join();
+}
+
+void AsyncLogHandler::log(log4cpp::ModuleId module, const char* id, log4cpp::LogLevel level, char const* location, char const* message)
+{
+    const auto time = std::chrono::system_clock::now();
+
+    const auto pushed = this->ring.try_push([&](Record& record) {
+        record.time = time;
+        record.level = level;
+        copy_string(record.id, max_id_size, id);
+        copy_string(record.message, log4cpp::max_log_entry_size, message);
+    });
+
+    if (!pushed) {
+        this->num_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // waking the writer is best effort, it also polls
+    if (this->is_writer_idle.load(std::memory_order_relaxed)) {
+        this->condition.notify_one();
+    }
+}
+
+void AsyncLogHandler::run()
+{
+    while (true) {
+        if (this->drain()) {
+            continue;
+        }
+
+        this->report_drops();
+        this->sink->flush();
+
+        if (this->is_shutdown) {
+            // one last pass for anything logged during shutdown
+            this->drain();
+            this->report_drops();
+            this->sink->flush();
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->is_writer_idle = true;
+        this->condition.wait_for(lock, max_writer_sleep);
+        this->is_writer_idle = false;
+    }
+}
+
+bool AsyncLogHandler::drain()
+{
+    char line[log4cpp::max_log_entry_size + max_id_size + 64];
+
+    bool wrote = false;
+
+    while (this->ring.try_pop([&](const Record& record) {
+        logging::format_line(line, sizeof(line), record.time, record.level, record.id, record.message);
+        this->sink->write(record.level, line);
+    })) {
+        wrote = true;
+    }
+
+    return wrote;
+}
+
+void AsyncLogHandler::report_drops()
+{
+    const auto total = this->num_dropped.load(std::memory_order_relaxed);
+    if (total == this->num_dropped_reported) {
+        return;
+    }
+
+    char message[log4cpp::max_log_entry_size];
+    snprintf(message, sizeof(message), "log ring full, dropped %" PRIu64 " records (%" PRIu64 " total)", total - this->num_dropped_reported, total);
+
+    char line[log4cpp::max_log_entry_size + max_id_size + 64];
+    logging::format_line(line, sizeof(line), std::chrono::system_clock::now(), ssp21::levels::warn, "log", message);
+    this->sink->write(ssp21::levels::warn, line);
+
+    this->num_dropped_reported = total;
+}
@@ -0,0 +1,71 @@
+#ifndef SSP21PROXY_ASYNCLOGHANDLER_H
+#define SSP21PROXY_ASYNCLOGHANDLER_H
+
+#include "ILogSink.h"
+
+#include <log4cpp/ILogHandler.h>
+#include <log4cpp/LogMacros.h>
+#include <ser4cpp/util/Uncopyable.h>
+#include <ssp21/stack/LogLevels.h>
+#include <ssp21/util/MPSCQueue.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * Log handler that never blocks the calling thread.
+ *
+ * Records are copied into a bounded lock-free ring and formatted and written to the sink
+ * on a dedicated thread. When the ring is full, records are dropped and counted, and the
+ * writer thread reports the number of dropped records once the ring drains.
+ */
+class AsyncLogHandler final : public log4cpp::ILogHandler, private ser4cpp::Uncopyable {
+
+    static const size_t max_id_size = 64;
+
+    struct Record {
+        std::chrono::system_clock::time_point time;
+        log4cpp::LogLevel level = ssp21::levels::event;
+        char id[max_id_size];
+        char message[log4cpp::max_log_entry_size];
+    };
+
+public:
+    AsyncLogHandler(uint32_t ring_size, std::unique_ptr<ILogSink> sink);
+
+    ~AsyncLogHandler();
+
+    void log(log4cpp::ModuleId module, const char* id, log4cpp::LogLevel level, char const* location, char const* message) override;
+
+    uint64_t get_num_dropped() const
+    {
+        return this->num_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    void run();
+
+    // returns true if at least one record was written
+    bool drain();
+
+    void report_drops();
+
+    ssp21::MPSCQueue<Record> ring;
+    const std::unique_ptr<ILogSink> sink;
+
+    std::atomic<uint64_t> num_dropped{ 0 };
+    uint64_t num_dropped_reported = 0;
+
+    std::atomic<bool> is_shutdown{ false };
+    std::atomic<bool> is_writer_idle{ false };
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    std::thread writer;
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef SSP21PROXY_ILOGSINK_H
+#define SSP21PROXY_ILOGSINK_H
+
+#include <log4cpp/LogLevels.h>
+
+/**
+ * Destination for fully formatted log lines
+ */
+class ILogSink {
+
+public:
+    virtual ~ILogSink() = default;
+
+    virtual void write(log4cpp::LogLevel level, const char* line) = 0;
+
+    // called when there is a lull in logging activity
+    virtual void flush() {}
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include "LogBackendConfig.h"
+
+#include "LogConfig.h"
+#include "YAMLHelpers.h"
+
+LogBackendType get_backend_type(const YAML::Node& node)
+{
+    const auto value = yaml::optional_string(node, "backend", "sync");
+
+    if (value == "sync") {
+        return LogBackendType::sync;
+    }
+
+    if (value == "async") {
+        return LogBackendType::async;
+    }
+
+    throw yaml::YAMLException(node.Mark(), "unknown log backend: ", value);
+}
+
+LogSinkType get_sink_type(const YAML::Node& node)
+{
+    const auto value = yaml::require_string(node, "type");
+
+    if (value == "stdout") {
+        return LogSinkType::console;
+    }
+
+    if (value == "file") {
+        return LogSinkType::file;
+    }
+
+    if (value == "syslog") {
+        return LogSinkType::syslog;
+    }
+
+    throw yaml::YAMLException(node.Mark(), "unknown log sink: ", value);
+}
+
+LogBackendConfig::LogBackendConfig(const YAML::Node& node)
+    : backend(get_backend_type(node))
+    , ring_size(yaml::optional_integer<uint32_t>(node, "ring_size", default_ring_size))
+{
+    if (this->ring_size == 0) {
+        throw yaml::YAMLException(node.Mark(), "ring_size must be greater than zero");
+    }
+
+    const auto levels_node = node["levels"];
+    if (levels_node) {
+        this->levels = get_log_levels(levels_node, levels_node.as<std::string>());
+    }
+
+    const auto sink_node = node["sink"];
+    if (sink_node) {
+        this->sink = get_sink_type(sink_node);
+        if (this->sink == LogSinkType::file) {
+            this->file_path = yaml::require_string(sink_node, "path");
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef SSP21PROXY_LOGBACKENDCONFIG_H
+#define SSP21PROXY_LOGBACKENDCONFIG_H
+
+#include <log4cpp/LogLevels.h>
+#include <yaml-cpp/yaml.h>
+
+#include <cstdint>
+#include <string>
+
+enum class LogBackendType {
+    sync,
+    async
+};
+
+enum class LogSinkType {
+    console,
+    file,
+    syslog
+};
+
+/**
+ * Process-wide logging settings from the optional top-level "logging" node
+ */
+struct LogBackendConfig {
+    // synchronous console output when the node isn't present
+    LogBackendConfig() = default;
+
+    explicit LogBackendConfig(const YAML::Node& node);
+
+    LogBackendType backend = LogBackendType::sync;
+    uint32_t ring_size = default_ring_size;
+    LogSinkType sink = LogSinkType::console;
+    std::string file_path;
+    // levels of the process-wide logger, sessions set their own
+    log4cpp::LogLevels levels = log4cpp::LogLevels::everything();
+
+    static const uint32_t default_ring_size = 4096;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#include "LogFormatting.h"
+
+#include <ssp21/stack/LogLevels.h>
+
+#include <cstdio>
+#include <ctime>
+
+namespace logging {
+
+const char* get_level_name(log4cpp::LogLevel level)
+{
+    if (level.value == ssp21::levels::event.value)
+        return "event";
+    if (level.value == ssp21::levels::error.value)
+        return "error";
+    if (level.value == ssp21::levels::warn.value)
+        return "warn";
+    if (level.value == ssp21::levels::info.value)
+        return "info";
+    if (level.value == ssp21::levels::debug.value)
+        return "debug";
+    if (level.value == ssp21::levels::rx_crypto_msg.value)
+        return "<-";
+    if (level.value == ssp21::levels::tx_crypto_msg.value)
+        return "->";
+    if (level.value == ssp21::levels::rx_crypto_msg_fields.value)
+        return "<-";
+    return "->";
+}
+
+void format_line(char* dest, size_t size, std::chrono::system_clock::time_point time, log4cpp::LogLevel level, const char* id, const char* message)
+{
+    const auto seconds = std::chrono::system_clock::to_time_t(time);
+    const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+
+    std::tm local_time;
+    localtime_r(&seconds, &local_time);
+
+    char time_buffer[32];
+    strftime(time_buffer, sizeof(time_buffer), "%Y-%m-%d %H:%M:%S", &local_time);
+
+    snprintf(dest, size, "%s.%03d %-5s %s - %s", time_buffer, static_cast<int>(millis), get_level_name(level), id, message);
+}
+
+}
@@ -0,0 +1,18 @@
+#ifndef SSP21PROXY_LOGFORMATTING_H
+#define SSP21PROXY_LOGFORMATTING_H
+
+#include <log4cpp/LogLevels.h>
+
+#include <chrono>
+#include <cstddef>
+
+namespace logging {
+
+const char* get_level_name(log4cpp::LogLevel level);
+
+// formats "<local time> <level> <id> - <message>" into the destination, truncating if required
+void format_line(char* dest, size_t size, std::chrono::system_clock::time_point time, log4cpp::LogLevel level, const char* id, const char* message);
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include "LogSinks.h"
+
+#include <ssp21/stack/LogLevels.h>
+#include <ssp21/util/Exception.h>
+
+#include <syslog.h>
+
+void ConsoleLogSink::write(log4cpp::LogLevel level, const char* line)
+{
+    fputs(line, stdout);
+    fputc('\n', stdout);
+}
+
+void ConsoleLogSink::flush()
+{
+    fflush(stdout);
+}
+
+FileLogSink::FileLogSink(const std::string& path)
+    : file(fopen(path.c_str(), "a"))
+{
+    if (!this->file) {
+        throw ssp21::Exception("unable to open log file: ", path);
+    }
+}
+
+FileLogSink::~FileLogSink()
+{
+    fclose(this->file);
+}
+
+void FileLogSink::write(log4cpp::LogLevel level, const char* line)
+{
+    fputs(line, this->file);
+    fputc('\n', this->file);
+}
+
+void FileLogSink::flush()
+{
+    fflush(this->file);
+}
+
+SyslogLogSink::SyslogLogSink()
+{
+    openlog("ssp21-proxy", LOG_PID, LOG_DAEMON);
+}
+
+SyslogLogSink::~SyslogLogSink()
+{
+    closelog();
+}
+
+int get_syslog_priority(log4cpp::LogLevel level)
+{
+    if (level.value == ssp21::levels::error.value) {
+        return LOG_ERR;
+    }
+
+    if (level.value == ssp21::levels::warn.value) {
+        return LOG_WARNING;
+    }
+
+    if (level.value == ssp21::levels::event.value) {
+        return LOG_NOTICE;
+    }
+
+    if (level.value == ssp21::levels::info.value) {
+        return LOG_INFO;
+    }
+
+    return LOG_DEBUG;
+}
+
+void SyslogLogSink::write(log4cpp::LogLevel level, const char* line)
+{
+    ::syslog(get_syslog_priority(level), "%s", line);
+}
+
+std::unique_ptr<ILogSink> create_log_sink(const LogBackendConfig& config)
+{
+    switch (config.sink) {
+    case (LogSinkType::file):
+        return std::make_unique<FileLogSink>(config.file_path);
+    case (LogSinkType::syslog):
+        return std::make_unique<SyslogLogSink>();
+    default:
+        return std::make_unique<ConsoleLogSink>();
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef SSP21PROXY_LOGSINKS_H
+#define SSP21PROXY_LOGSINKS_H
+
+#include "ILogSink.h"
+#include "LogBackendConfig.h"
+
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+class ConsoleLogSink final : public ILogSink, private ser4cpp::Uncopyable {
+public:
+    void write(log4cpp::LogLevel level, const char* line) override;
+    void flush() override;
+};
+
+class FileLogSink final : public ILogSink, private ser4cpp::Uncopyable {
+public:
+    explicit FileLogSink(const std::string& path);
+    ~FileLogSink();
+
+    void write(log4cpp::LogLevel level, const char* line) override;
+    void flush() override;
+
+private:
+    FILE* file;
+};
+
+class SyslogLogSink final : public ILogSink, private ser4cpp::Uncopyable {
+public:
+    SyslogLogSink();
+    ~SyslogLogSink();
+
+    void write(log4cpp::LogLevel level, const char* line) override;
+};
+
+std::unique_ptr<ILogSink> create_log_sink(const LogBackendConfig& config);
+
+#endif
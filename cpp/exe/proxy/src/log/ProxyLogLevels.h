@@ -0,0 +1,16 @@
+#ifndef SSP21PROXY_PROXYLOGLEVELS_H
+#define SSP21PROXY_PROXYLOGLEVELS_H
+
+#include <ssp21/stack/LogLevels.h>
+
+/**
+ * Levels the proxy adds to those of the ssp21 library
+ */
+namespace proxy_levels {
+
+// hex dump of every buffer a socket receives, formatted on the worker thread, so only set by its own flag
+const log4cpp::LogLevel rx_bytes = ssp21::levels::tx_crypto_msg_fields.next();
+
+}
+
+#endif
@@ -0,0 +1,20 @@
+#include "SyncLogHandler.h"
+
+#include "LogFormatting.h"
+
+#include <log4cpp/LogMacros.h>
+
+SyncLogHandler::SyncLogHandler(std::unique_ptr<ILogSink> sink)
+    : sink(std::move(sink))
+{
+}
+
+void SyncLogHandler::log(log4cpp::ModuleId module, const char* id, log4cpp::LogLevel level, char const* location, char const* message)
+{
+    char line[log4cpp::max_log_entry_size + 128];
+    logging::format_line(line, sizeof(line), std::chrono::system_clock::now(), level, id, message);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->sink->write(level, line);
+    this->sink->flush();
+}
@@ -0,0 +1,27 @@
+#ifndef SSP21PROXY_SYNCLOGHANDLER_H
+#define SSP21PROXY_SYNCLOGHANDLER_H
+
+#include "ILogSink.h"
+
+#include <log4cpp/ILogHandler.h>
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <memory>
+#include <mutex>
+
+/**
+ * Formats and writes each record to the sink on the calling thread
+ */
+class SyncLogHandler final : public log4cpp::ILogHandler, private ser4cpp::Uncopyable {
+
+public:
+    explicit SyncLogHandler(std::unique_ptr<ILogSink> sink);
+
+    void log(log4cpp::ModuleId module, const char* id, log4cpp::LogLevel level, char const* location, char const* message) override;
+
+private:
+    const std::unique_ptr<ILogSink> sink;
+    std::mutex mutex;
+};
+
+#endif
@@ -10,7 +10,13 @@
 #include <ssp21/stack/LogLevels.h>
 #include <ssp21/stack/Version.h>
 
+#include "ConfigReloader.h"
+#include "FlightRecorderDumper.h"
 #include "ProxyConfig.h"
+#include "WorkerPool.h"
+#include "log/AsyncLogHandler.h"
+#include "log/LogSinks.h"
+#include "log/SyncLogHandler.h"
 #include "tcp/TcpProxySession.h"
 #include "udp/UdpProxySession.h"
 
@@ -27,7 +33,8 @@ int main(int argc, char* argv[])
         cerr << "Usage:" << endl
              << endl;
         cerr << "ssp21-proxy -v      # prints version info" << endl;
-        cerr << "ssp21-proxy <path>  # runs the proxy with specified configuration file" << endl;
+        cerr << "ssp21-proxy <path>  # runs the proxy with specified configuration file, reloaded on SIGHUP" << endl;
+        cerr << "                    # the flight recorder is dumped on SIGUSR1" << endl;
         return -1;
     }
 
@@ -47,49 +54,38 @@ int main(int argc, char* argv[])
     return 0;
 }
 
-std::shared_ptr<log4cpp::ILogHandler> get_log_backend()
+std::shared_ptr<log4cpp::ILogHandler> get_log_backend(const LogBackendConfig& config)
 {
-    log4cpp::ConsolePrettyPrinter::Settings settings;
-    settings.max_id_size = 20;
-    return make_shared<log4cpp::ConsolePrettyPrinter>(settings);
-}
-
-std::vector<std::unique_ptr<IProxySession>> configure_sessions(
-    const std::string& config_file_path,
-    const log4cpp::Logger& logger,
-    const std::shared_ptr<exe4cpp::BasicExecutor>& executor)
-{
-    const auto factories = config::read(config_file_path, executor, logger);
-
-    if (factories.empty()) {
-        throw std::logic_error("no proxy sessions were specified");
+    if (config.backend == LogBackendType::async) {
+        return make_shared<AsyncLogHandler>(config.ring_size, create_log_sink(config));
     }
 
-    std::vector<std::unique_ptr<IProxySession>> sessions;
-
-    // initialize all the proxies. might throw on bad configuration.
-    for (auto& factory : factories) {
-        sessions.push_back(factory(logger, executor));
+    if (config.sink != LogSinkType::console) {
+        return make_shared<SyncLogHandler>(create_log_sink(config));
     }
 
-    return sessions;
+    log4cpp::ConsolePrettyPrinter::Settings settings;
+    settings.max_id_size = 20;
+    return make_shared<log4cpp::ConsolePrettyPrinter>(settings);
 }
 
 void run(const std::string& config_file_path)
 {
     // setup the logging backend
-    log4cpp::Logger logger(get_log_backend(), Module::id, "ssp21-proxy", log4cpp::LogLevels::everything());
+    const auto log_config = config::read_log_backend(config_file_path);
+    log4cpp::Logger logger(get_log_backend(log_config), Module::id, "ssp21-proxy", log_config.levels);
 
-    const auto executor = exe4cpp::BasicExecutor::create(std::make_shared<asio::io_service>());
+    // outlives the sessions, which report their errors to it
+    FlightRecorderDumper dumper(config::read_flight_recorder(config_file_path), logger);
+    dumper.start();
 
-    const auto sessions = configure_sessions(config_file_path, logger, executor);
+    WorkerPool workers(config::read_worker_config(config_file_path), logger);
 
-    // start all the sessions
-    for (auto& s : sessions)
-        s->start();
+    // starts all the sessions, then reloads them on SIGHUP
+    ConfigReloader reloader(config_file_path, logger, workers);
+    reloader.start();
 
-    // run the event loop
-    SIMPLE_LOG_BLOCK(logger, ssp21::levels::event, "begin io_context::run()");
-    executor->get_service()->run();
-    SIMPLE_LOG_BLOCK(logger, ssp21::levels::event, "end io_context::run()");
+    // run the event loops
+    FORMAT_LOG_BLOCK(logger, ssp21::levels::event, "starting %u worker(s)", static_cast<uint32_t>(workers.size()));
+    workers.run();
 }
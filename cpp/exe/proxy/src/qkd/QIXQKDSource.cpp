@@ -9,57 +9,10 @@
 #include <log4cpp/LogMacros.h>
 
 #include "YAMLHelpers.h"
+#include "serial/SerialConfig.h"
 
 using namespace std::chrono;
 
-asio::serial_port::flow_control::type get_flow_control(const YAML::Node& node)
-{
-    const auto value = yaml::optional_string(node, "flow_control", "none");
-
-    if (value == "none") {
-        return asio::serial_port::flow_control::type::none;
-    }
-
-    if (value == "hardware") {
-        return asio::serial_port::flow_control::type::hardware;
-    }
-
-    if (value == "software") {
-        return asio::serial_port::flow_control::type::software;
-    }
-
-    throw yaml::YAMLException(node.Mark(), "Unknown flow_control type: ", value);
-}
-
-asio::serial_port::stop_bits::type get_stop_bits(const YAML::Node& node)
-{
-    const auto value = yaml::optional_string(node, "stop_bits", "one");
-
-    if (value == "one") {
-        return asio::serial_port::stop_bits::type::one;
-    }
-
-    if (value == "onepointfive") {
-        return asio::serial_port::stop_bits::type::onepointfive;
-    }
-
-    if (value == "two") {
-        return asio::serial_port::stop_bits::type::two;
-    }
-
-    throw yaml::YAMLException(node.Mark(), "Unknown stop_bits type: ", value);
-}
-
-SerialSettings read_serial_settings(const YAML::Node& node)
-{
-    return SerialSettings(
-        yaml::require_string(node, "device"),
-        yaml::optional_integer<unsigned int>(node, "baud_rate", 9600),
-        yaml::optional_integer<unsigned int>(node, "data_bits", 8),
-        get_flow_control(node),
-        get_stop_bits(node));
-}
-
 QIXQKDSource::FrameHandler::FrameHandler(const YAML::Node& config, const YAML::Node& metrics, log4cpp::Logger& logger)
     : num_subscribers(yaml::require_integer<uint16_t>(config, "num_subscribers"))
     , metric_update_period(yaml::require_duration(metrics, "update_period"))
@@ -6,9 +6,14 @@
 #include "YAMLHelpers.h"
 
 std::map<std::string, std::shared_ptr<IQKDSource>> QKDSourceRegistry::sources;
+std::map<QKDSourceRegistry::binding_key_t, std::shared_ptr<ssp21::IKeySource>> QKDSourceRegistry::initiator_bindings;
+std::map<QKDSourceRegistry::binding_key_t, std::shared_ptr<ssp21::IKeyLookup>> QKDSourceRegistry::responder_bindings;
+bool QKDSourceRegistry::is_sealed = false;
 
 void QKDSourceRegistry::configure_qkd_source(const YAML::Node& node, const std::shared_ptr<exe4cpp::BasicExecutor>& executor, log4cpp::Logger logger)
 {
+    check_not_sealed(node);
+
     const auto qkd_source_id = yaml::require_string(node, "qkd_source_id");
 
     if (sources.find(qkd_source_id) != sources.end()) {
@@ -49,14 +54,53 @@ uint16_t get_max_key_cache_size(const YAML::Node& node)
     return yaml::require_integer<uint16_t>(node, "max_key_cache_size");
 }
 
+QKDSourceRegistry::binding_key_t QKDSourceRegistry::get_binding_key(const YAML::Node& node)
+{
+    return binding_key_t(yaml::require_string(node, "key_source_id"), get_subscriber_id(node));
+}
+
+void QKDSourceRegistry::check_not_sealed(const YAML::Node& node)
+{
+    if (is_sealed) {
+        throw yaml::YAMLException(node.Mark(), "QKD sources and subscribers can only be added by restarting the proxy");
+    }
+}
+
 std::shared_ptr<ssp21::IKeySource> QKDSourceRegistry::get_initiator_key_source(const YAML::Node& node)
 {
-    return get_key_source(node)->bind_initiator_key_source(get_subscriber_id(node), get_max_key_cache_size(node));
+    const auto key = get_binding_key(node);
+    const auto existing = initiator_bindings.find(key);
+    // binding the same subscriber twice at startup is still reported by the source
+    if (is_sealed && existing != initiator_bindings.end()) {
+        return existing->second;
+    }
+
+    check_not_sealed(node);
+
+    const auto binding = get_key_source(node)->bind_initiator_key_source(get_subscriber_id(node), get_max_key_cache_size(node));
+    initiator_bindings[key] = binding;
+    return binding;
 }
 
 std::shared_ptr<ssp21::IKeyLookup> QKDSourceRegistry::get_responder_key_lookup(const YAML::Node& node)
 {
-    return get_key_source(node)->bind_responder_key_lookup(get_subscriber_id(node), get_max_key_cache_size(node));
+    const auto key = get_binding_key(node);
+    const auto existing = responder_bindings.find(key);
+    // binding the same subscriber twice at startup is still reported by the source
+    if (is_sealed && existing != responder_bindings.end()) {
+        return existing->second;
+    }
+
+    check_not_sealed(node);
+
+    const auto binding = get_key_source(node)->bind_responder_key_lookup(get_subscriber_id(node), get_max_key_cache_size(node));
+    responder_bindings[key] = binding;
+    return binding;
+}
+
+void QKDSourceRegistry::seal()
+{
+    is_sealed = true;
 }
 
 //static std::map<std::string, std::unique_ptr<IQKDSource>> sources;
@@ -14,12 +14,14 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 
 /**
 * Static methods for configuring and retrieving QKD interfaces during configuration
 *  
 * No thread synchronization is required on these methods as they are only called during
-* initialization from the entry point thread
+* initialization from the entry point thread, and from the reload thread once the sources are
+* sealed. Sealed sources are only looked up, never modified.
 */
 class QKDSourceRegistry {
 public:
@@ -38,12 +40,28 @@ public:
 	*/
     static std::shared_ptr<ssp21::IKeyLookup> get_responder_key_lookup(const YAML::Node& node);
 
+    /**
+    * Called once the initial configuration is complete. Afterwards the interfaces bound during
+    * initialization are handed out again and binding new subscribers is a configuration error,
+    * as the sources are in use by their reader threads.
+    */
+    static void seal();
+
 private:
+    using binding_key_t = std::pair<std::string, uint16_t>;
+
     static std::shared_ptr<IQKDSource> get_key_source(const YAML::Node& node);
 
     static std::shared_ptr<IQKDSource> create_qkd_source(const YAML::Node& node, const std::shared_ptr<exe4cpp::BasicExecutor>& executor, log4cpp::Logger logger);
 
+    static binding_key_t get_binding_key(const YAML::Node& node);
+
+    static void check_not_sealed(const YAML::Node& node);
+
     static std::map<std::string, std::shared_ptr<IQKDSource>> sources;
+    static std::map<binding_key_t, std::shared_ptr<ssp21::IKeySource>> initiator_bindings;
+    static std::map<binding_key_t, std::shared_ptr<ssp21::IKeyLookup>> responder_bindings;
+    static bool is_sealed;
 };
 
 #endif
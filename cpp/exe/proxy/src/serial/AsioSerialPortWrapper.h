@@ -0,0 +1,358 @@
+#ifndef SSP21PROXY_ASIOSERIALPORTWRAPPER_H
+#define SSP21PROXY_ASIOSERIALPORTWRAPPER_H
+
+#include <exe4cpp/Typedefs.h>
+#include <log4cpp/LogMacros.h>
+#include <log4cpp/Logger.h>
+#include <ser4cpp/container/Buffer.h>
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <ssp21/link/CastagnoliCRC32.h>
+#include <ssp21/link/LinkConstants.h>
+#include <ssp21/stack/LogLevels.h>
+#include <ssp21/util/SequenceTypes.h>
+
+#include "HandlerMemory.h"
+#include "IAsioLayer.h"
+#include "IAsioSocketWrapper.h"
+#include "log/ProxyLogLevels.h"
+
+#include <asio.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+/**
+ * How the bytes read from a serial line are cut into the chunks handed to the layer
+ */
+enum class SerialFraming {
+    // SSP21 link frames: read the header, then exactly the body it announces
+    link,
+    // opaque data: a chunk ends when the line goes quiet for the inter-character timeout
+    gap
+};
+
+/**
+ * Serial port wrapper that hands the layer whole chunks the moment they are complete.
+ *
+ * With link framing the wrapper never reads past the end of the current frame, so a frame is
+ * delivered as soon as its last byte arrives rather than when the next read happens to return.
+ * Bytes that don't start a valid header are skipped up to the next sync byte, and a partial frame
+ * is abandoned when the line is silent for the inter-character timeout.
+ *
+ * With gap framing the silence itself marks the end of a chunk, as serial SCADA protocols do.
+ *
+ * The chunk is lent to the layer until it calls start_rx_from_socket() again.
+ */
+class AsioSerialPortWrapper final : public IAsioSocketWrapper, private ser4cpp::Uncopyable {
+
+public:
+    using port_t = asio::serial_port;
+
+    struct Statistics {
+        // bytes skipped while looking for the start of a frame
+        uint64_t num_bytes_discarded = 0;
+        // partial frames abandoned after an inter-character timeout
+        uint64_t num_frames_timed_out = 0;
+    };
+
+    AsioSerialPortWrapper(const log4cpp::Logger& logger, IAsioLayer& layer, port_t port, SerialFraming framing, const exe4cpp::duration_t& inter_character_timeout)
+        : layer(layer)
+        , port(std::move(port))
+        , logger(logger)
+        , framing(framing)
+        , inter_character_timeout(inter_character_timeout)
+        , timer(this->port.get_executor())
+        , rx_buffer(ssp21::consts::link::max_frame_size)
+    {
+    }
+
+    // 3.5 character times of 11 bits, but no less than 1.75 ms, the same rule Modbus RTU uses for frame gaps
+    static exe4cpp::duration_t get_default_inter_character_timeout(unsigned int baud)
+    {
+        const auto character_times = std::chrono::microseconds((35 * 11 * 1000000ull) / (10 * std::max(baud, 1u)));
+        return std::max<exe4cpp::duration_t>(character_times, std::chrono::microseconds(1750));
+    }
+
+    bool try_close_socket() override
+    {
+        if (!this->port.is_open())
+            return false;
+
+        std::error_code ec;
+        this->timer.cancel(ec);
+        this->port.close(ec);
+
+        return true;
+    }
+
+    bool start_rx_from_socket() override
+    {
+        if (!this->port.is_open())
+            return false;
+
+        // the layer is done with the chunk it was lent, keep anything read after it
+        if (this->is_rx_lent) {
+            this->is_rx_lent = false;
+            const auto remaining = this->num_buffered - this->lent_length;
+            auto buffer = this->rx_buffer.as_wslice();
+            memmove(buffer, static_cast<uint8_t*>(buffer) + this->lent_length, remaining);
+            this->num_buffered = remaining;
+            this->frame_size = ssp21::consts::link::header_total_size;
+            // leftover bytes are a chunk of their own if the line stays quiet
+            this->start_timer();
+        }
+
+        this->is_rx_requested = true;
+
+        this->process();
+
+        return true;
+    }
+
+    bool start_tx_to_socket(const ssp21::seq32_t& data) override
+    {
+        if (!this->port.is_open() || this->is_tx_active)
+            return false;
+
+        auto callback = [this](const std::error_code& ec, size_t num_tx) {
+            this->is_tx_active = false;
+
+            if (ec) {
+                if (this->port.is_open()) {
+                    FORMAT_LOG_BLOCK(this->logger, ssp21::levels::error, "tx error: %s", ec.message().c_str());
+                    this->try_close_socket();
+                    this->layer.on_rx_or_tx_error();
+                }
+            } else {
+                FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "complete port tx: %u", static_cast<uint32_t>(num_tx));
+                this->layer.on_tx_complete();
+            }
+
+            this->notify_if_inactive();
+        };
+
+        this->is_tx_active = true;
+
+        FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "start port tx: %d", data.length());
+
+        asio::async_write(this->port, asio::buffer(data, data.length()), make_custom_alloc_handler(this->tx_handler_memory, callback));
+
+        return true;
+    }
+
+    bool get_is_tx_active() const override
+    {
+        return this->is_tx_active;
+    }
+
+    bool get_is_rx_active() const override
+    {
+        return this->is_rx_active || this->is_timer_active;
+    }
+
+    const Statistics& get_statistics() const
+    {
+        return this->statistics;
+    }
+
+private:
+    // deliver a complete chunk if there is one, otherwise keep reading
+    void process()
+    {
+        if (!this->is_rx_requested || this->is_rx_lent)
+            return;
+
+        if (this->framing == SerialFraming::link) {
+            if (this->try_complete_frame()) {
+                this->lend(this->frame_size);
+                return;
+            }
+        } else if (this->num_buffered == this->rx_buffer.length()) {
+            // nowhere left to read into, don't wait for the line to go quiet
+            this->lend(this->num_buffered);
+            return;
+        }
+
+        this->start_read();
+    }
+
+    bool try_complete_frame()
+    {
+        while (this->frame_size == ssp21::consts::link::header_total_size && this->num_buffered >= ssp21::consts::link::header_total_size) {
+            const auto payload_length = this->read_header();
+            if (payload_length < 0) {
+                this->skip_to_next_sync();
+            } else {
+                this->frame_size = ssp21::consts::link::header_total_size + static_cast<uint32_t>(payload_length) + ssp21::consts::link::crc_size;
+            }
+        }
+
+        return this->num_buffered >= this->frame_size && this->frame_size > ssp21::consts::link::header_total_size;
+    }
+
+    // the payload length announced by a valid header at the start of the buffer, or -1
+    int32_t read_header() const
+    {
+        const auto header = this->rx_buffer.as_rslice();
+
+        if (header[0] != ssp21::consts::link::sync1 || header[1] != ssp21::consts::link::sync2) {
+            return -1;
+        }
+
+        const auto actual_crc = (static_cast<uint32_t>(header[8]) << 24) | (static_cast<uint32_t>(header[9]) << 16) | (static_cast<uint32_t>(header[10]) << 8) | header[11];
+        if (ssp21::CastagnoliCRC32::calc(header.take(ssp21::consts::link::header_fields_size)) != actual_crc) {
+            return -1;
+        }
+
+        const auto payload_length = (static_cast<uint16_t>(header[6]) << 8) | header[7];
+        if (payload_length > ssp21::consts::link::max_config_payload_size) {
+            return -1;
+        }
+
+        return payload_length;
+    }
+
+    void skip_to_next_sync()
+    {
+        auto buffer = this->rx_buffer.as_wslice();
+
+        uint32_t next = 1;
+        while (next < this->num_buffered && buffer[next] != ssp21::consts::link::sync1) {
+            ++next;
+        }
+
+        memmove(buffer, static_cast<uint8_t*>(buffer) + next, this->num_buffered - next);
+        this->num_buffered -= next;
+        this->statistics.num_bytes_discarded += next;
+
+        FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "discarded %u bytes looking for a frame header", next);
+    }
+
+    void lend(uint32_t length)
+    {
+        this->is_rx_requested = false;
+        this->is_rx_lent = true;
+        this->lent_length = length;
+
+        const auto rx_data = this->rx_buffer.as_rslice().take(length);
+        FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "complete port rx: %u", length);
+        if (this->logger.is_enabled(proxy_levels::rx_bytes)) {
+            log4cpp::HexLogging::log(this->logger, proxy_levels::rx_bytes, rx_data);
+        }
+        this->layer.on_rx_complete(rx_data);
+    }
+
+    void start_read()
+    {
+        if (this->is_rx_active || !this->port.is_open())
+            return;
+
+        // with link framing never read beyond the end of the header or frame being assembled
+        const auto limit = (this->framing == SerialFraming::link) ? this->frame_size : this->rx_buffer.length();
+        const auto offset = this->num_buffered;
+
+        auto callback = [this, offset](const std::error_code& ec, size_t num_rx) {
+            this->is_rx_active = false;
+
+            if (ec) {
+                if (this->port.is_open()) {
+                    FORMAT_LOG_BLOCK(this->logger, ssp21::levels::error, "rx error: %s", ec.message().c_str());
+                    this->try_close_socket();
+                    this->layer.on_rx_or_tx_error();
+                }
+            } else {
+                if (offset != this->num_buffered) {
+                    // a lent chunk was handed back or partial data abandoned while the read was outstanding
+                    auto buffer = this->rx_buffer.as_wslice();
+                    memmove(static_cast<uint8_t*>(buffer) + this->num_buffered, static_cast<uint8_t*>(buffer) + offset, num_rx);
+                }
+                this->num_buffered += static_cast<uint32_t>(num_rx);
+                this->last_rx_time = std::chrono::steady_clock::now();
+                this->start_timer();
+                this->process();
+            }
+
+            this->notify_if_inactive();
+        };
+
+        auto dest = this->rx_buffer.as_wslice().skip(offset).take(limit - offset);
+
+        this->is_rx_active = true;
+
+        this->port.async_read_some(asio::buffer(dest, dest.length()), make_custom_alloc_handler(this->rx_handler_memory, callback));
+    }
+
+    // one wait per timeout period, not one per read, re-armed for whatever remains of the period
+    void start_timer()
+    {
+        if (this->is_timer_active || this->num_buffered == 0)
+            return;
+
+        this->is_timer_active = true;
+        this->timer.expires_at(this->last_rx_time + this->inter_character_timeout);
+        this->timer.async_wait([this](const std::error_code& ec) {
+            this->is_timer_active = false;
+            if (!ec && this->port.is_open()) {
+                this->on_timer();
+            }
+            this->notify_if_inactive();
+        });
+    }
+
+    void on_timer()
+    {
+        if (std::chrono::steady_clock::now() < this->last_rx_time + this->inter_character_timeout) {
+            this->start_timer();
+            return;
+        }
+
+        // a lent chunk is measured again once the layer hands it back
+        if (this->is_rx_lent || this->num_buffered == 0)
+            return;
+
+        if (this->framing == SerialFraming::gap) {
+            if (this->is_rx_requested) {
+                this->lend(this->num_buffered);
+            }
+            return;
+        }
+
+        FORMAT_LOG_BLOCK(this->logger, ssp21::levels::warn, "line idle with %u bytes of a partial frame, discarding", this->num_buffered);
+        ++this->statistics.num_frames_timed_out;
+        this->num_buffered = 0;
+        this->frame_size = ssp21::consts::link::header_total_size;
+    }
+
+    bool is_tx_active = false;
+    // a read is outstanding on the port
+    bool is_rx_active = false;
+    bool is_timer_active = false;
+
+    // the layer asked for data and hasn't been given any yet
+    bool is_rx_requested = false;
+    // the first lent_length bytes of the buffer are lent to the layer
+    bool is_rx_lent = false;
+    uint32_t lent_length = 0;
+
+    // bytes in the buffer, and the size of the frame being assembled once its header is known
+    uint32_t num_buffered = 0;
+    uint32_t frame_size = ssp21::consts::link::header_total_size;
+    std::chrono::steady_clock::time_point last_rx_time;
+
+    IAsioLayer& layer;
+    port_t port;
+    log4cpp::Logger logger;
+    const SerialFraming framing;
+    const exe4cpp::duration_t inter_character_timeout;
+    asio::steady_timer timer;
+    ser4cpp::Buffer rx_buffer;
+    Statistics statistics;
+
+    // operation state for the single outstanding read and write
+    HandlerMemory rx_handler_memory;
+    HandlerMemory tx_handler_memory;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "serial/SerialConfig.h"
+
+#include "YAMLHelpers.h"
+#include "serial/AsioSerialPortWrapper.h"
+
+namespace {
+asio::serial_port::flow_control::type get_flow_control(const YAML::Node& node)
+{
+    const auto value = yaml::optional_string(node, "flow_control", "none");
+
+    if (value == "none") {
+        return asio::serial_port::flow_control::type::none;
+    }
+
+    if (value == "hardware") {
+        return asio::serial_port::flow_control::type::hardware;
+    }
+
+    if (value == "software") {
+        return asio::serial_port::flow_control::type::software;
+    }
+
+    throw yaml::YAMLException(node.Mark(), "Unknown flow_control type: ", value);
+}
+
+asio::serial_port::stop_bits::type get_stop_bits(const YAML::Node& node)
+{
+    const auto value = yaml::optional_string(node, "stop_bits", "one");
+
+    if (value == "one") {
+        return asio::serial_port::stop_bits::type::one;
+    }
+
+    if (value == "onepointfive") {
+        return asio::serial_port::stop_bits::type::onepointfive;
+    }
+
+    if (value == "two") {
+        return asio::serial_port::stop_bits::type::two;
+    }
+
+    throw yaml::YAMLException(node.Mark(), "Unknown stop_bits type: ", value);
+}
+}
+
+SerialSettings read_serial_settings(const YAML::Node& node)
+{
+    return SerialSettings(
+        yaml::require_string(node, "device"),
+        yaml::optional_integer<unsigned int>(node, "baud_rate", 9600),
+        yaml::optional_integer<unsigned int>(node, "data_bits", 8),
+        get_flow_control(node),
+        get_stop_bits(node));
+}
+
+SerialPortConfig::SerialPortConfig(const YAML::Node& node)
+    : settings(read_serial_settings(node))
+    , inter_character_timeout(yaml::optional_duration(node, "inter_character_timeout", AsioSerialPortWrapper::get_default_inter_character_timeout(settings.baud)))
+{
+    if (this->inter_character_timeout <= exe4cpp::duration_t::zero()) {
+        throw yaml::YAMLException(node.Mark(), "inter_character_timeout must be greater than zero");
+    }
+}
+
+SerialConfig::SerialConfig(const YAML::Node& node)
+    : secure(yaml::require(node, "secure"))
+    , raw(yaml::require(node, "raw"))
+{
+    if (this->secure.settings.serial_device == this->raw.settings.serial_device) {
+        throw yaml::YAMLException(node.Mark(), "the secure and raw sides must use different serial devices");
+    }
+}
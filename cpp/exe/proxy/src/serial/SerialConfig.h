@@ -0,0 +1,34 @@
+#ifndef SSP21PROXY_SERIALCONFIG_H
+#define SSP21PROXY_SERIALCONFIG_H
+
+#include <exe4cpp/Typedefs.h>
+#include <qix/SerialSettings.h>
+
+#include <yaml-cpp/yaml.h>
+
+// reads a 'device' and the optional line settings, shared with the QIX key source
+SerialSettings read_serial_settings(const YAML::Node& node);
+
+/**
+ * One serial port of the proxy
+ */
+struct SerialPortConfig {
+    SerialPortConfig(const YAML::Node& node);
+
+    const SerialSettings settings;
+
+    // silence on the line that ends a chunk of raw data, or abandons a partial SSP21 frame
+    const exe4cpp::duration_t inter_character_timeout;
+};
+
+/**
+ * Configuration for a proxy between two serial lines
+ */
+struct SerialConfig {
+    SerialConfig(const YAML::Node& node);
+
+    const SerialPortConfig secure;
+    const SerialPortConfig raw;
+};
+
+#endif
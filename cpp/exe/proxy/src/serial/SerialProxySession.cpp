@@ -0,0 +1,163 @@
+#include "serial/SerialProxySession.h"
+
+#include <log4cpp/LogMacros.h>
+#include <ssp21/stack/LogLevels.h>
+
+#include "AsioLowerLayer.h"
+#include "AsioUpperLayer.h"
+
+using namespace ssp21;
+
+const exe4cpp::duration_t SerialProxySession::reopen_delay = std::chrono::seconds(1);
+
+SerialProxySession::SerialProxySession(
+    const SerialConfig& config,
+    const StackFactory& factory,
+    const PlaintextQueueConfig& queue_config,
+    const LatencyTracingConfig& tracing_config,
+    const std::shared_ptr<exe4cpp::BasicExecutor>& executor,
+    const log4cpp::Logger& logger)
+    : executor(executor)
+    , logger(logger)
+    , config(config)
+    , factory(factory)
+    , queue_config(queue_config)
+    , latency_stats(tracing_config.enabled ? std::make_shared<LatencyStats>(tracing_config, logger) : nullptr)
+    , close_metrics(logger)
+{
+}
+
+void SerialProxySession::start()
+{
+    FORMAT_LOG_BLOCK(
+        this->logger,
+        levels::info,
+        "proxying raw traffic on %s (%u baud) to SSP21 traffic on %s (%u baud)",
+        this->config.raw.settings.serial_device.c_str(), this->config.raw.settings.baud,
+        this->config.secure.settings.serial_device.c_str(), this->config.secure.settings.baud);
+
+    this->try_start_session();
+}
+
+void SerialProxySession::drain()
+{
+    if (this->is_draining)
+        return;
+
+    // the ports can only be opened once, so the session can't outlive the configuration
+    this->is_draining = true;
+    this->reopen_timer.cancel();
+    if (this->session) {
+        this->session->shutdown(this->get_close_handler());
+        this->session.reset();
+    }
+
+    SIMPLE_LOG_BLOCK(this->logger, levels::info, "session removed from the configuration, closing the serial ports");
+}
+
+bool SerialProxySession::is_drained() const
+{
+    return this->is_draining && this->num_closing == 0;
+}
+
+void SerialProxySession::set_log_levels(log4cpp::LogLevels levels)
+{
+    this->logger.set_levels(levels);
+}
+
+void SerialProxySession::set_stack_factory(const StackFactory& factory)
+{
+    // takes effect when the session is next restarted
+    this->factory = factory;
+}
+
+void SerialProxySession::on_session_error()
+{
+    if (this->is_draining)
+        return;
+
+    session->shutdown(this->get_close_handler());
+    this->session.reset();
+
+    // Restart the session
+    this->try_start_session();
+}
+
+void SerialProxySession::try_start_session()
+{
+    try {
+        this->start_session();
+    } catch (const std::exception& ex) {
+        // devices such as USB adapters come and go, keep trying
+        FORMAT_LOG_BLOCK(this->logger, levels::error, "unable to open serial ports: %s", ex.what());
+        this->reopen_timer = exe4cpp::Timer(this->executor->start(reopen_delay, [this]() { this->try_start_session(); }));
+    }
+}
+
+void SerialProxySession::start_session()
+{
+    auto error_handler = [this]() {
+        this->on_session_error();
+    };
+
+    // frame-aware reads need the link layer, without it the secure side is cut at line gaps too
+    const auto secure_framing = this->factory.get_uses_link_layer() ? SerialFraming::link : SerialFraming::gap;
+
+    auto lower_layer_logger = this->logger.detach_and_append("-lower");
+    auto lower_layer = std::make_unique<AsioLowerLayer>(lower_layer_logger);
+    auto lower_layer_socket = std::make_unique<AsioSerialPortWrapper>(
+        lower_layer_logger,
+        *lower_layer,
+        this->open_port(this->config.secure.settings),
+        secure_framing,
+        this->config.secure.inter_character_timeout);
+
+    auto upper_layer_logger = this->logger.detach_and_append("-upper");
+    auto upper_layer = std::make_unique<AsioUpperLayer>(upper_layer_logger, this->queue_config);
+    auto upper_layer_socket = std::make_unique<AsioSerialPortWrapper>(
+        upper_layer_logger,
+        *upper_layer,
+        this->open_port(this->config.raw.settings),
+        SerialFraming::gap,
+        this->config.raw.inter_character_timeout);
+
+    this->session = Session::create(
+        0,
+        error_handler,
+        this->executor,
+        std::move(lower_layer_socket),
+        std::move(lower_layer),
+        std::move(upper_layer_socket),
+        std::move(upper_layer),
+        factory.create_stack(
+            this->logger.detach_and_append("-ssp21"),
+            this->executor));
+
+    if (this->latency_stats) {
+        this->session->trace_latency(this->latency_stats);
+    }
+
+    this->session->start();
+}
+
+asio::serial_port SerialProxySession::open_port(const SerialSettings& settings) const
+{
+    // any of these synchronous operations can throw
+    asio::serial_port port(*this->executor->get_service());
+    port.open(settings.serial_device);
+    port.set_option(asio::serial_port_base::baud_rate(settings.baud));
+    port.set_option(asio::serial_port_base::character_size(settings.data_bits));
+    port.set_option(asio::serial_port::flow_control(settings.flow_control));
+    port.set_option(asio::serial_port_base::stop_bits(settings.stop_bits));
+    return port;
+}
+
+session_close_handler_t SerialProxySession::get_close_handler()
+{
+    ++this->num_closing;
+
+    return [this](const exe4cpp::duration_t& time_to_close, bool deadline_exceeded) {
+        --this->num_closing;
+        this->close_metrics.record(time_to_close, deadline_exceeded);
+    };
+}
@@ -0,0 +1,76 @@
+#ifndef SSP21PROXY_SERIALPROXYSESSION_H
+#define SSP21PROXY_SERIALPROXYSESSION_H
+
+#include <exe4cpp/Timer.h>
+#include <exe4cpp/asio/BasicExecutor.h>
+#include <log4cpp/Logger.h>
+
+#include <asio.hpp>
+
+#include "CloseMetrics.h"
+#include "IProxySession.h"
+#include "LatencyStats.h"
+#include "LatencyTracingConfig.h"
+#include "PlaintextQueueConfig.h"
+#include "Session.h"
+#include "StackConfigReader.h"
+#include "serial/AsioSerialPortWrapper.h"
+#include "serial/SerialConfig.h"
+
+#include <memory>
+
+/**
+ * Proxy between two serial lines, e.g. an RTU on the raw side and a radio on the secure side
+ */
+class SerialProxySession final : public IProxySession {
+
+public:
+    SerialProxySession(
+        const SerialConfig& config,
+        const StackFactory& factory,
+        const PlaintextQueueConfig& queue_config,
+        const LatencyTracingConfig& tracing_config,
+        const std::shared_ptr<exe4cpp::BasicExecutor>& executor,
+        const log4cpp::Logger& logger);
+
+    void start() override;
+
+    void drain() override;
+
+    bool is_drained() const override;
+
+    void set_log_levels(log4cpp::LogLevels levels) override;
+
+    void set_stack_factory(const StackFactory& factory) override;
+
+private:
+    // delay before the ports are opened again after they failed to open
+    static const exe4cpp::duration_t reopen_delay;
+
+    void on_session_error();
+
+    session_close_handler_t get_close_handler();
+
+    void start_session();
+
+    void try_start_session();
+
+    asio::serial_port open_port(const SerialSettings& settings) const;
+
+    const std::shared_ptr<exe4cpp::BasicExecutor> executor;
+    log4cpp::Logger logger;
+    const SerialConfig config;
+    StackFactory factory;
+    const PlaintextQueueConfig queue_config;
+    // null unless latency tracing is enabled
+    const std::shared_ptr<LatencyStats> latency_stats;
+    CloseMetrics close_metrics;
+
+    std::shared_ptr<Session> session;
+    exe4cpp::Timer reopen_timer;
+
+    bool is_draining = false;
+    uint32_t num_closing = 0;
+};
+
+#endif
@@ -10,21 +10,35 @@
 #include <ssp21/stack/LogLevels.h>
 #include <ssp21/util/SequenceTypes.h>
 
+#include "HandlerMemory.h"
 #include "IAsioLayer.h"
 #include "IAsioSocketWrapper.h"
+#include "log/ProxyLogLevels.h"
 
 #include <asio.hpp>
 
+#include <vector>
+
+/**
+ * TCP socket wrapper that reads into a ring of receive buffers.
+ *
+ * A read is kept outstanding into the next free buffer while the layer processes the buffer it
+ * was handed, so the kernel copy of the next chunk overlaps with parsing the current one. A buffer
+ * is lent to the layer until it calls start_rx_from_socket() again. With a ring of one buffer the
+ * wrapper reads strictly one chunk at a time.
+ */
 class AsioTcpSocketWrapper final : public IAsioSocketWrapper, private ser4cpp::Uncopyable {
 
 public:
     using socket_t = asio::ip::tcp::socket;
 
-    AsioTcpSocketWrapper(const log4cpp::Logger& logger, IAsioLayer& layer, socket_t& socket)
+    AsioTcpSocketWrapper(const log4cpp::Logger& logger, IAsioLayer& layer, socket_t& socket, uint32_t num_rx_buffers = 1)
         : layer(layer)
         , socket(std::move(socket))
         , logger(logger)
-        , rx_buffer(ssp21::consts::link::max_frame_size)
+        , num_rx_buffers(num_rx_buffers == 0 ? 1 : num_rx_buffers)
+        , rx_buffer(this->num_rx_buffers * ssp21::consts::link::max_frame_size)
+        , rx_lengths(this->num_rx_buffers, 0)
     {
     }
 
@@ -42,35 +56,27 @@ public:
 
     bool start_rx_from_socket() override
     {
-        if (!this->socket.is_open() || this->is_rx_active)
+        if (!this->socket.is_open())
             return false;
 
-        auto callback = [this](const std::error_code& ec, size_t num_rx) {
-            this->is_rx_active = false;
-
-            if (ec) {
-                if (socket.is_open()) {
-                    FORMAT_LOG_BLOCK(this->logger, ssp21::levels::error, "rx error: %s", ec.message().c_str());
-                    this->try_close_socket();
-                    this->layer.on_rx_or_tx_error();
-                }
-            } else {
-                const auto rx_data = this->rx_buffer.as_rslice().take(static_cast<uint32_t>(num_rx));
-                FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "complete socket rx: %u, tx: %s", rx_data.length(), bool_str(this->is_tx_active));
-                if (this->logger.is_enabled(ssp21::levels::debug)) {
-                    log4cpp::HexLogging::log(this->logger, ssp21::levels::debug, rx_data);
-                }
-                this->layer.on_rx_complete(rx_data);
-            }
-        };
+        // the layer is done with the buffer it was lent
+        if (this->is_rx_lent) {
+            this->is_rx_lent = false;
+            this->rx_head = (this->rx_head + 1) % this->num_rx_buffers;
+            --this->num_rx_filled;
+        }
 
-        auto dest = rx_buffer.as_wslice();
+        if (this->is_rx_error_pending && this->num_rx_filled == 0) {
+            this->post_rx_error();
+            return false;
+        }
 
-        this->is_rx_active = true;
+        this->is_rx_requested = true;
 
-        FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "start socket rx, tx: %s", bool_str(this->is_tx_active));
+        this->start_read();
 
-        this->socket.async_read_some(asio::buffer(dest, dest.length()), callback);
+        // may call back into the layer synchronously with a buffer that was already filled
+        this->try_lend_rx_buffer();
 
         return true;
     }
@@ -91,15 +97,18 @@ public:
                 }
             } else {
                 FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "complete socket tx: %u - rx: %s", static_cast<uint32_t>(num_tx), bool_str(this->is_rx_active));
+                this->record_activity();
                 this->layer.on_tx_complete();
             }
+
+            this->notify_if_inactive();
         };
 
         this->is_tx_active = true;
 
         FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "start socket tx: %d, rx: %s", data.length(), bool_str(this->is_tx_active));
 
-        asio::async_write(this->socket, asio::buffer(data, data.length()), callback);
+        asio::async_write(this->socket, asio::buffer(data, data.length()), make_custom_alloc_handler(this->tx_handler_memory, callback));
 
         return true;
     }
@@ -120,13 +129,118 @@ private:
         return value ? "true" : "false";
     }
 
+    ssp21::wseq32_t get_rx_slot(uint32_t index)
+    {
+        return this->rx_buffer.as_wslice().skip(index * ssp21::consts::link::max_frame_size).take(ssp21::consts::link::max_frame_size);
+    }
+
+    void start_read()
+    {
+        if (this->is_rx_active || this->is_rx_error_pending || !this->socket.is_open() || this->num_rx_filled == this->num_rx_buffers)
+            return;
+
+        const auto index = (this->rx_head + this->num_rx_filled) % this->num_rx_buffers;
+
+        auto callback = [this, index](const std::error_code& ec, size_t num_rx) {
+            this->is_rx_active = false;
+
+            if (ec) {
+                if (socket.is_open()) {
+                    FORMAT_LOG_BLOCK(this->logger, ssp21::levels::error, "rx error: %s", ec.message().c_str());
+                    if (this->num_rx_filled == 0) {
+                        this->report_rx_error();
+                    } else {
+                        // let the layer drain what was received before the error, e.g. the last data before EOF
+                        this->is_rx_error_pending = true;
+                    }
+                }
+            } else {
+                this->rx_lengths[index] = static_cast<uint32_t>(num_rx);
+                ++this->num_rx_filled;
+                this->record_activity();
+
+                FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "complete socket rx: %u, buffered: %u, tx: %s", static_cast<uint32_t>(num_rx), this->num_rx_filled, bool_str(this->is_tx_active));
+
+                // keep the socket busy while the layer works on the data
+                this->start_read();
+                this->try_lend_rx_buffer();
+            }
+
+            this->notify_if_inactive();
+        };
+
+        auto dest = this->get_rx_slot(index);
+
+        this->is_rx_active = true;
+
+        FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "start socket rx, tx: %s", bool_str(this->is_tx_active));
+
+        this->socket.async_read_some(asio::buffer(dest, dest.length()), make_custom_alloc_handler(this->rx_handler_memory, callback));
+    }
+
+    void try_lend_rx_buffer()
+    {
+        if (!this->is_rx_requested || this->is_rx_lent || this->num_rx_filled == 0)
+            return;
+
+        this->is_rx_requested = false;
+        this->is_rx_lent = true;
+
+        const auto rx_data = this->rx_buffer.as_rslice().skip(this->rx_head * ssp21::consts::link::max_frame_size).take(this->rx_lengths[this->rx_head]);
+        if (this->logger.is_enabled(proxy_levels::rx_bytes)) {
+            log4cpp::HexLogging::log(this->logger, proxy_levels::rx_bytes, rx_data);
+        }
+        this->layer.on_rx_complete(rx_data);
+    }
+
+    void report_rx_error()
+    {
+        this->is_rx_error_pending = false;
+        this->try_close_socket();
+        this->layer.on_rx_or_tx_error();
+    }
+
+    // the layer drained the ring from within a call, so report the deferred error from the event loop
+    void post_rx_error()
+    {
+        auto callback = [this]() {
+            this->is_rx_active = false;
+            if (this->socket.is_open()) {
+                this->report_rx_error();
+            }
+            this->notify_if_inactive();
+        };
+
+        this->is_rx_error_pending = false;
+        this->is_rx_active = true;
+
+        asio::post(this->socket.get_executor(), make_custom_alloc_handler(this->rx_handler_memory, callback));
+    }
+
     bool is_tx_active = false;
     bool is_rx_active = false;
 
+    // the layer asked for data and hasn't been given any yet
+    bool is_rx_requested = false;
+    // the buffer at rx_head is lent to the layer
+    bool is_rx_lent = false;
+    // an error was received after data that the layer hasn't consumed yet
+    bool is_rx_error_pending = false;
+
+    // filled buffers in the ring, starting at rx_head
+    uint32_t rx_head = 0;
+    uint32_t num_rx_filled = 0;
+
     IAsioLayer& layer;
     socket_t socket;
     log4cpp::Logger logger;
+    const uint32_t num_rx_buffers;
     ser4cpp::Buffer rx_buffer;
+    std::vector<uint32_t> rx_lengths;
+
+    // operation state for the single outstanding read and write
+    HandlerMemory rx_handler_memory;
+    HandlerMemory tx_handler_memory;
 };
 
 #endif
@@ -0,0 +1,48 @@
+#ifndef SSP21PROXY_REUSEPORTOPTION_H
+#define SSP21PROXY_REUSEPORTOPTION_H
+
+#include <sys/socket.h>
+
+#include <cstddef>
+
+/**
+ * SO_REUSEPORT as a settable asio socket option, which asio doesn't provide publicly.
+ *
+ * Lets several acceptors bind the same endpoint, the kernel then balances connections between them.
+ */
+class ReusePortOption {
+public:
+    explicit ReusePortOption(bool enabled)
+        : value(enabled ? 1 : 0)
+    {
+    }
+
+    template <class Protocol>
+    int level(const Protocol&) const
+    {
+        return SOL_SOCKET;
+    }
+
+    template <class Protocol>
+    int name(const Protocol&) const
+    {
+        return SO_REUSEPORT;
+    }
+
+    template <class Protocol>
+    const void* data(const Protocol&) const
+    {
+        return &this->value;
+    }
+
+    template <class Protocol>
+    std::size_t size(const Protocol&) const
+    {
+        return sizeof(this->value);
+    }
+
+private:
+    int value;
+};
+
+#endif
@@ -4,7 +4,18 @@
 
 TcpConfig::TcpConfig(const YAML::Node& node)
     : max_sessions(yaml::require_integer<uint16_t>(node, "max_sessions"))
+    , idle_timeout(yaml::optional_duration(node, "idle_timeout", exe4cpp::duration_t::zero()))
+    , rx_buffer_count(yaml::optional_integer<uint32_t>(node, "rx_buffer_count", 2))
+    , io_backend(read_io_backend(node))
+    , warm_pool_size(yaml::optional_integer<uint16_t>(node, "warm_pool_size", 0))
     , listen(yaml::require(node, "listen"))
     , connect(yaml::require(node, "connect"))
 {
+    if (this->rx_buffer_count == 0 || this->rx_buffer_count > 16) {
+        throw yaml::YAMLException(node.Mark(), "rx_buffer_count must be between 1 and 16");
+    }
+
+    if (this->idle_timeout < exe4cpp::duration_t::zero()) {
+        throw yaml::YAMLException(node.Mark(), "idle_timeout must not be negative");
+    }
 }
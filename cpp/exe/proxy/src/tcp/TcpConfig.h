@@ -2,13 +2,23 @@
 #define SSP21PROXY_TCPCONFIG_H
 
 #include "IPEndpoint.h"
+#include "IoBackend.h"
 
+#include <exe4cpp/Typedefs.h>
 #include <yaml-cpp/yaml.h>
 
 struct TcpConfig {
     TcpConfig(const YAML::Node& node);
 
+    // concurrent sessions across all the workers, each worker accepts an even share
     const uint16_t max_sessions;
+    // sessions that neither read nor write for this long are closed, zero disables
+    const exe4cpp::duration_t idle_timeout;
+    // receive buffers in the ring of the SSP21-side socket, 1 reads strictly one chunk at a time
+    const uint32_t rx_buffer_count;
+    const IoBackend io_backend;
+    // SSP21 sessions established ahead of accepting the plaintext connection, initiator only, shared out like max_sessions
+    const uint16_t warm_pool_size;
 
     const IPEndpoint listen;
     const IPEndpoint connect;
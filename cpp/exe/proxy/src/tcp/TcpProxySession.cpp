@@ -5,16 +5,27 @@
 
 #include "Session.h"
 #include "tcp/AsioTcpSocketWrapper.h"
+#include "tcp/ReusePortOption.h"
+#include "uring/AsioUringSocketWrapper.h"
+
+#include <algorithm>
 
 using namespace asio;
 using namespace ssp21;
 
-TcpProxySession::Server::Server(asio::io_service& context, const std::string& address, uint16_t port)
+// delay before replacing pooled sessions that failed to connect or were closed by the responder
+static const exe4cpp::duration_t pool_retry_delay = std::chrono::seconds(1);
+
+TcpProxySession::Server::Server(asio::io_service& context, const std::string& address, uint16_t port, bool reuse_port)
     : acceptor(context)
     , socket(context)
     , local_endpoint(ip::address::from_string(address), port)
 {
     acceptor.open(this->local_endpoint.protocol());
+    if (reuse_port) {
+        // every worker binds its own acceptor to the same port and the kernel balances connections between them
+        acceptor.set_option(ReusePortOption(true));
+    }
     acceptor.bind(this->local_endpoint);
     acceptor.listen();
 }
@@ -22,14 +33,26 @@ TcpProxySession::Server::Server(asio::io_service& context, const std::string& ad
 TcpProxySession::TcpProxySession(
     const TcpConfig& config,
     const StackFactory& factory,
+    const PlaintextQueueConfig& queue_config,
+    const LatencyTracingConfig& tracing_config,
     const std::shared_ptr<exe4cpp::BasicExecutor>& executor,
-    const log4cpp::Logger& logger)
-    : executor(executor)
+    const log4cpp::Logger& logger,
+    const WorkerAssignment& worker)
+    : activity(executor)
+    , executor(executor)
     , logger(logger)
     , factory(factory)
-    , server(*executor->get_service(), config.listen.ip_address, config.listen.port)
+    , queue_config(queue_config)
+    , latency_stats(tracing_config.enabled ? std::make_shared<LatencyStats>(tracing_config, logger) : nullptr)
+    , server(*executor->get_service(), config.listen.ip_address, config.listen.port, worker.is_shared())
     , connect_endpoint(ip::address::from_string(config.connect.ip_address), config.connect.port)
-    , max_sessions(config.max_sessions == 0 ? 1 : config.max_sessions)
+    // the configured limits apply to the process, each worker enforces its share
+    , max_sessions(static_cast<uint16_t>(worker.share_of(config.max_sessions == 0 ? 1 : config.max_sessions)))
+    , rx_buffer_count(config.rx_buffer_count)
+    , idle_timeout(config.idle_timeout)
+    , io_backend(config.io_backend)
+    , close_metrics(logger)
+    , warm_pool_size(static_cast<uint16_t>(worker.share_of(config.warm_pool_size)))
 {
 }
 
@@ -41,33 +64,168 @@ void TcpProxySession::start()
         "listening for connections on %s:%u, forwarding to %s:%u",
         this->server.local_endpoint.address().to_string().c_str(), this->server.local_endpoint.port(),
         this->connect_endpoint.address().to_string().c_str(), this->connect_endpoint.port());
+
+    if (!is_io_backend_available(this->io_backend)) {
+        FORMAT_LOG_BLOCK(this->logger, levels::warn, "io_backend %s is not available, falling back to %s", get_io_backend_name(this->io_backend), get_io_backend_name(IoBackend::asio));
+        this->io_backend = IoBackend::asio;
+    }
+
+    if (this->idle_timeout > exe4cpp::duration_t::zero()) {
+        this->start_idle_timer();
+    }
+
+    this->fill_pool();
+
     this->accept_next();
 }
 
+void TcpProxySession::drain()
+{
+    if (this->is_draining)
+        return;
+
+    this->is_draining = true;
+
+    std::error_code ec;
+    this->server.acceptor.close(ec);
+
+    this->idle_timer.cancel();
+    this->pool_retry_timer.cancel();
+    this->is_pool_fill_scheduled = false;
+
+    // pooled sessions have no plaintext connection to serve yet
+    for (auto& pooled : this->pool) {
+        pooled.session->shutdown(this->get_close_handler());
+    }
+    this->pool.clear();
+
+    FORMAT_LOG_BLOCK(this->logger, levels::info, "stopped listening on %s:%u, draining %u session(s)", this->server.local_endpoint.address().to_string().c_str(), this->server.local_endpoint.port(), static_cast<uint32_t>(this->sessions.size()));
+}
+
+bool TcpProxySession::is_drained() const
+{
+    return this->is_draining && !this->is_accepting && this->num_connecting == 0 && this->num_pool_connecting == 0 && this->num_closing == 0 && this->sessions.empty();
+}
+
+void TcpProxySession::set_log_levels(log4cpp::LogLevels levels)
+{
+    // established sessions detached their loggers when they were created and keep their levels
+    this->logger.set_levels(levels);
+}
+
+void TcpProxySession::set_stack_factory(const StackFactory& factory)
+{
+    this->factory = factory;
+}
+
 void TcpProxySession::on_session_error(uint64_t session_id)
+{
+    const auto pooled = std::find_if(this->pool.begin(), this->pool.end(), [session_id](const PooledSession& item) {
+        return item.id == session_id;
+    });
+
+    if (pooled != this->pool.end()) {
+        FORMAT_LOG_BLOCK(this->logger, levels::info, "pooled session %llu closed before it was used", static_cast<unsigned long long>(session_id));
+        pooled->session->shutdown(this->get_close_handler());
+        this->pool.erase(pooled);
+        // don't reconnect in a tight loop if the responder keeps closing sessions
+        this->schedule_pool_fill();
+        return;
+    }
+
+    this->close_session(session_id, CloseReason::error);
+}
+
+void TcpProxySession::close_session(uint64_t session_id, CloseReason reason)
 {
     const auto iter = this->sessions.find(session_id);
-    if (iter != this->sessions.end()) {
-        const auto session = iter->second;
-        this->sessions.erase(iter);
-        session->shutdown();
+    if (iter == this->sessions.end()) {
+        return;
+    }
+
+    // detaches the sockets from the record before it is released
+    iter->second->session->shutdown(this->get_close_handler());
+    this->sessions.erase(iter);
+
+    switch (reason) {
+    case (CloseReason::idle):
+        this->close_metrics.record_eviction(CloseMetrics::Eviction::idle);
+        break;
+    case (CloseReason::capacity):
+        this->close_metrics.record_eviction(CloseMetrics::Eviction::capacity);
+        break;
+    default:
+        ++this->stats.num_closed_error;
+        return;
+    }
+
+    FORMAT_LOG_BLOCK(
+        this->logger,
+        levels::metric,
+        "evicted %s session %llu, %u active (evicted idle: %llu, evicted at capacity: %llu, closed on error: %llu)",
+        (reason == CloseReason::idle) ? "idle" : "least recently active",
+        static_cast<unsigned long long>(session_id),
+        static_cast<uint32_t>(this->sessions.size()),
+        static_cast<unsigned long long>(this->close_metrics.get_num_evicted_idle()),
+        static_cast<unsigned long long>(this->close_metrics.get_num_evicted_capacity()),
+        static_cast<unsigned long long>(this->stats.num_closed_error));
+}
+
+void TcpProxySession::start_idle_timer()
+{
+    // wake up exactly when the least recently active session would expire
+    const auto oldest = this->activity.least_recent();
+    const auto now = this->executor->get_time();
+    const auto expiration = oldest ? oldest->get_last_activity() + this->idle_timeout : now + this->idle_timeout;
+    const auto delay = std::max<exe4cpp::duration_t>(expiration - now, exe4cpp::duration_t::zero());
+
+    this->idle_timer = exe4cpp::Timer(this->executor->start(delay, [this]() {
+        this->evict_idle_sessions();
+        this->start_idle_timer();
+    }));
+}
+
+void TcpProxySession::evict_idle_sessions()
+{
+    const auto now = this->executor->get_time();
+
+    // the list is ordered by activity, so stop at the first session that is still fresh
+    while (true) {
+        const auto oldest = static_cast<SessionRecord*>(this->activity.least_recent());
+        if (!oldest || (now - oldest->get_last_activity()) < this->idle_timeout) {
+            return;
+        }
+
+        FORMAT_LOG_BLOCK(this->logger, levels::info, "closing session %llu after %lld ms without activity", static_cast<unsigned long long>(oldest->id), static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(now - oldest->get_last_activity()).count()));
+        this->close_session(oldest->id, CloseReason::idle);
     }
 }
 
 void TcpProxySession::accept_next()
 {
     auto accept_callback = [this](std::error_code ec) {
+        this->is_accepting = false;
+
         if (ec) {
             FORMAT_LOG_BLOCK(this->logger, levels::info, "accept failure: %s", ec.message().c_str());
         } else {
             FORMAT_LOG_BLOCK(this->logger, levels::info, "Accepted connection from %s:%u", this->server.remote_endpoint.address().to_string().c_str(), this->server.remote_endpoint.port());
 
-            this->start_connect(std::move(this->server.socket));
+            if (this->pool.empty()) {
+                if (this->warm_pool_size > 0) {
+                    ++this->stats.num_pool_misses;
+                    this->log_pool_statistics();
+                }
+                this->start_connect(std::move(this->server.socket));
+            } else {
+                this->take_from_pool(std::move(this->server.socket));
+            }
 
             this->accept_next();
         }
     };
 
+    this->is_accepting = true;
     server.acceptor.async_accept(server.socket, server.remote_endpoint, accept_callback);
 }
 
@@ -78,56 +236,203 @@ void TcpProxySession::start_connect(asio::ip::tcp::socket accepted_socket)
     const auto connect = std::make_shared<ConnectOperation>(*executor->get_service(), std::move(accepted_socket));
 
     auto connect_cb = [this, connect](const std::error_code& ec) {
-        if (ec) {
-            FORMAT_LOG_BLOCK(this->logger, levels::warn, "error connecting: %s", ec.message().c_str());
+        --this->num_connecting;
+
+        if (ec || this->is_draining) {
+            if (ec) {
+                FORMAT_LOG_BLOCK(this->logger, levels::warn, "error connecting: %s", ec.message().c_str());
+            }
             std::error_code ec;
+            connect->connect_socket.close(ec);
             connect->listen_socket.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
             connect->listen_socket.close(ec);
         } else {
             FORMAT_LOG_BLOCK(this->logger, levels::warn, "connected to %s:%u", connect_endpoint.address().to_string().c_str(), connect_endpoint.port());
 
-            if (this->sessions.size() == this->max_sessions) // have to kick a session to make room for new session
-            {
-                // max_sessions guaranteed to be > 0
-                const auto oldest = this->sessions.begin();
-                SIMPLE_LOG_BLOCK(this->logger, levels::warn, "Max sessions exceeded, shutting down oldest session");
-                oldest->second->shutdown();
-                this->sessions.erase(oldest);
-            }
-
             const auto id = this->session_id++;
-
-            // this will get called when any error occurs on the session
-            auto error_handler = [this, id]() {
-                this->on_session_error(id);
-            };
-
-            auto lower_layer_logger = this->logger.detach_and_append("-", id, "-lower");
-            auto lower_layer = std::make_unique<AsioLowerLayer>(lower_layer_logger);
-            auto lower_layer_socket = std::make_unique<AsioTcpSocketWrapper>(lower_layer_logger, *lower_layer, connect->get_lower_layer_socket(this->factory.get_type()));
-
-            auto upper_layer_logger = this->logger.detach_and_append("-", id, "-upper");
-            auto upper_layer = std::make_unique<AsioUpperLayer>(upper_layer_logger);
-            auto upper_layer_socket = std::make_unique<AsioTcpSocketWrapper>(upper_layer_logger, *upper_layer, connect->get_upper_layer_socket(this->factory.get_type()));
-
-            const auto session = Session::create(
-                id,
-                error_handler,
-                this->executor,
-                std::move(lower_layer_socket),
-                std::move(lower_layer),
-                std::move(upper_layer_socket),
-                std::move(upper_layer),
-                this->factory.create_stack(
-                    this->logger.detach_and_append("-", id, "-ssp21"),
-                    this->executor));
-
-            this->sessions[id] = session;
-
+            const auto session = this->create_session(id, connect->get_lower_layer_socket(this->factory.get_type()), &connect->get_upper_layer_socket(this->factory.get_type()));
+            this->add_session(id, session);
             session->start();
         }
     };
 
     FORMAT_LOG_BLOCK(this->logger, levels::info, "Initiating connection to %s:%u", connect_endpoint.address().to_string().c_str(), connect_endpoint.port());
+    ++this->num_connecting;
     connect->connect_socket.async_connect(this->connect_endpoint, connect_cb);
 }
+
+void TcpProxySession::take_from_pool(asio::ip::tcp::socket accepted_socket)
+{
+    // prefer a session that has completed its handshake over one that is still connecting or handshaking
+    auto iter = std::find_if(this->pool.begin(), this->pool.end(), [](const PooledSession& item) {
+        return item.session->is_established();
+    });
+
+    if (iter == this->pool.end()) {
+        iter = this->pool.begin();
+        ++this->stats.num_pool_partial_hits;
+    } else {
+        ++this->stats.num_pool_hits;
+    }
+
+    const auto pooled = *iter;
+    this->pool.erase(iter);
+
+    FORMAT_LOG_BLOCK(this->logger, levels::info, "accepted connection joins pooled session %llu", static_cast<unsigned long long>(pooled.id));
+
+    pooled.session->attach_upper_socket(this->create_socket(this->logger.detach_and_append("-", pooled.id, "-upper"), pooled.session->get_upper_layer(), accepted_socket, 1));
+    this->add_session(pooled.id, pooled.session);
+
+    this->log_pool_statistics();
+    this->fill_pool();
+}
+
+void TcpProxySession::fill_pool()
+{
+    if (this->is_draining)
+        return;
+
+    while ((this->pool.size() + this->num_pool_connecting) < this->warm_pool_size) {
+        this->start_pool_connect();
+    }
+}
+
+void TcpProxySession::schedule_pool_fill()
+{
+    if (this->is_pool_fill_scheduled || this->is_draining)
+        return;
+
+    this->is_pool_fill_scheduled = true;
+    this->pool_retry_timer = exe4cpp::Timer(this->executor->start(pool_retry_delay, [this]() {
+        this->is_pool_fill_scheduled = false;
+        this->fill_pool();
+    }));
+}
+
+void TcpProxySession::start_pool_connect()
+{
+    ++this->num_pool_connecting;
+
+    // won't need this once C++XX has move capture
+    const auto socket = std::make_shared<ip::tcp::socket>(*this->executor->get_service());
+
+    auto connect_cb = [this, socket](const std::error_code& ec) {
+        --this->num_pool_connecting;
+
+        if (ec) {
+            FORMAT_LOG_BLOCK(this->logger, levels::warn, "error connecting pooled session: %s", ec.message().c_str());
+            this->schedule_pool_fill();
+            return;
+        }
+
+        if (this->is_draining) {
+            std::error_code ec;
+            socket->close(ec);
+            return;
+        }
+
+        const auto id = this->session_id++;
+        FORMAT_LOG_BLOCK(this->logger, levels::info, "connected pooled session %llu to %s:%u", static_cast<unsigned long long>(id), connect_endpoint.address().to_string().c_str(), connect_endpoint.port());
+
+        // the handshake starts right away, the plaintext socket is attached when a connection is accepted
+        const auto session = this->create_session(id, *socket, nullptr);
+        this->pool.push_back(PooledSession{ id, session });
+        session->start();
+    };
+
+    socket->async_connect(this->connect_endpoint, connect_cb);
+}
+
+void TcpProxySession::log_pool_statistics()
+{
+    const auto num_accepted = this->stats.num_pool_hits + this->stats.num_pool_partial_hits + this->stats.num_pool_misses;
+    const auto hit_rate = (num_accepted == 0) ? 0.0 : (100.0 * static_cast<double>(this->stats.num_pool_hits) / static_cast<double>(num_accepted));
+
+    FORMAT_LOG_BLOCK(
+        this->logger,
+        levels::metric,
+        "warm pool: %u of %u pooled, %u connecting (hits: %llu, handshake in progress: %llu, misses: %llu, hit rate: %.1f%%)",
+        static_cast<uint32_t>(this->pool.size()),
+        static_cast<uint32_t>(this->warm_pool_size),
+        static_cast<uint32_t>(this->num_pool_connecting),
+        static_cast<unsigned long long>(this->stats.num_pool_hits),
+        static_cast<unsigned long long>(this->stats.num_pool_partial_hits),
+        static_cast<unsigned long long>(this->stats.num_pool_misses),
+        hit_rate);
+}
+
+std::shared_ptr<Session> TcpProxySession::create_session(uint64_t id, asio::ip::tcp::socket& lower_socket, asio::ip::tcp::socket* upper_socket)
+{
+    // this will get called when any error occurs on the session
+    auto error_handler = [this, id]() {
+        this->on_session_error(id);
+    };
+
+    auto lower_layer_logger = this->logger.detach_and_append("-", id, "-lower");
+    auto lower_layer = std::make_unique<AsioLowerLayer>(lower_layer_logger);
+    auto lower_layer_socket = this->create_socket(lower_layer_logger, *lower_layer, lower_socket, this->rx_buffer_count);
+
+    auto upper_layer_logger = this->logger.detach_and_append("-", id, "-upper");
+    auto upper_layer = std::make_unique<AsioUpperLayer>(upper_layer_logger, this->queue_config);
+    auto upper_layer_socket = upper_socket ? this->create_socket(upper_layer_logger, *upper_layer, *upper_socket, 1) : nullptr;
+
+    const auto session = Session::create(
+        id,
+        error_handler,
+        this->executor,
+        std::move(lower_layer_socket),
+        std::move(lower_layer),
+        std::move(upper_layer_socket),
+        std::move(upper_layer),
+        this->factory.create_stack(
+            this->logger.detach_and_append("-", id, "-ssp21"),
+            this->executor));
+
+    if (this->latency_stats) {
+        session->trace_latency(this->latency_stats);
+    }
+
+    return session;
+}
+
+void TcpProxySession::add_session(uint64_t id, const std::shared_ptr<Session>& session)
+{
+    if (this->sessions.size() == this->max_sessions) // have to kick a session to make room for new session
+    {
+        // max_sessions guaranteed to be > 0
+        const auto least_recent = static_cast<SessionRecord*>(this->activity.least_recent());
+        SIMPLE_LOG_BLOCK(this->logger, levels::warn, "Max sessions exceeded, shutting down least recently active session");
+        this->close_session(least_recent->id, CloseReason::capacity);
+    }
+
+    auto record = std::make_unique<SessionRecord>(id, session);
+    this->activity.push_front(*record);
+    session->track_activity(*record);
+    this->sessions[id] = std::move(record);
+}
+
+std::unique_ptr<IAsioSocketWrapper> TcpProxySession::create_socket(
+    const log4cpp::Logger& logger,
+    IAsioLayer& layer,
+    asio::ip::tcp::socket& socket,
+    uint32_t num_rx_buffers) const
+{
+#ifdef SSP21PROXY_IO_URING
+    if (this->io_backend == IoBackend::io_uring) {
+        // the multishot receive queues buffers by itself, the ring size doesn't apply
+        return std::make_unique<AsioUringTcpSocketWrapper>(logger, layer, std::move(socket));
+    }
+#endif
+
+    return std::make_unique<AsioTcpSocketWrapper>(logger, layer, socket, num_rx_buffers);
+}
+
+session_close_handler_t TcpProxySession::get_close_handler()
+{
+    ++this->num_closing;
+
+    return [this](const exe4cpp::duration_t& time_to_close, bool deadline_exceeded) {
+        --this->num_closing;
+        this->close_metrics.record(time_to_close, deadline_exceeded);
+    };
+}
@@ -1,17 +1,28 @@
 #ifndef SSP21PROXY_TCPPROXYSESSION_H
 #define SSP21PROXY_TCPPROXYSESSION_H
 
+#include <exe4cpp/Timer.h>
 #include <exe4cpp/asio/BasicExecutor.h>
 #include <log4cpp/Logger.h>
 #include <ser4cpp/util/Uncopyable.h>
 
 #include <asio.hpp>
 
+#include "ActivityList.h"
+#include "CloseMetrics.h"
+#include "IAsioLayer.h"
+#include "IAsioSocketWrapper.h"
 #include "IProxySession.h"
+#include "IoBackend.h"
+#include "LatencyStats.h"
+#include "LatencyTracingConfig.h"
+#include "PlaintextQueueConfig.h"
+#include "ProxySessionFactory.h"
 #include "Session.h"
 #include "StackConfigReader.h"
 #include "tcp/TcpConfig.h"
 
+#include <deque>
 #include <map>
 
 /**
@@ -19,7 +30,7 @@
 */
 class TcpProxySession final : public IProxySession {
     struct Server {
-        Server(asio::io_service& context, const std::string& address, uint16_t port);
+        Server(asio::io_service& context, const std::string& address, uint16_t port, bool reuse_port);
 
         asio::ip::tcp::endpoint endpoint;
         asio::ip::tcp::acceptor acceptor;
@@ -49,33 +60,130 @@ class TcpProxySession final : public IProxySession {
         asio::ip::tcp::socket listen_socket;
     };
 
+    // a running session and its place in the activity list
+    struct SessionRecord final : public ActivityNode {
+        SessionRecord(uint64_t id, const std::shared_ptr<Session>& session)
+            : id(id)
+            , session(session)
+        {
+        }
+
+        const uint64_t id;
+        const std::shared_ptr<Session> session;
+    };
+
+    // a session started ahead of time that is waiting for a plaintext connection
+    struct PooledSession {
+        uint64_t id;
+        std::shared_ptr<Session> session;
+    };
+
+    enum class CloseReason : uint8_t {
+        error,
+        idle,
+        capacity
+    };
+
+    struct Statistics {
+        uint64_t num_closed_error = 0;
+        // accepted connections given a pooled session that had completed its handshake
+        uint64_t num_pool_hits = 0;
+        // accepted connections given a pooled session with the handshake still in progress
+        uint64_t num_pool_partial_hits = 0;
+        // accepted connections that found the pool empty and connected from scratch
+        uint64_t num_pool_misses = 0;
+    };
+
 public:
     TcpProxySession(
         const TcpConfig& config,
         const StackFactory& factory,
+        const PlaintextQueueConfig& queue_config,
+        const LatencyTracingConfig& tracing_config,
         const std::shared_ptr<exe4cpp::BasicExecutor>& executor,
-        const log4cpp::Logger& logger);
+        const log4cpp::Logger& logger,
+        const WorkerAssignment& worker);
 
     void start() override;
 
+    void drain() override;
+
+    bool is_drained() const override;
+
+    void set_log_levels(log4cpp::LogLevels levels) override;
+
+    void set_stack_factory(const StackFactory& factory) override;
+
 private:
     void on_session_error(uint64_t session_id);
 
-    std::map<uint64_t, std::shared_ptr<Session>> sessions;
+    void close_session(uint64_t session_id, CloseReason reason);
+
+    void start_idle_timer();
+
+    void evict_idle_sessions();
+
+    session_close_handler_t get_close_handler();
+
+    std::map<uint64_t, std::unique_ptr<SessionRecord>> sessions;
+    // least recently active session at the back
+    ActivityList activity;
 
     void accept_next();
 
     void start_connect(asio::ip::tcp::socket accepted_socket);
 
+    void take_from_pool(asio::ip::tcp::socket accepted_socket);
+
+    void fill_pool();
+
+    void schedule_pool_fill();
+
+    void start_pool_connect();
+
+    void log_pool_statistics();
+
+    // 'upper_socket' may be null for a session that gets its plaintext socket later
+    std::shared_ptr<Session> create_session(uint64_t id, asio::ip::tcp::socket& lower_socket, asio::ip::tcp::socket* upper_socket);
+
+    void add_session(uint64_t id, const std::shared_ptr<Session>& session);
+
+    std::unique_ptr<IAsioSocketWrapper> create_socket(
+        const log4cpp::Logger& logger,
+        IAsioLayer& layer,
+        asio::ip::tcp::socket& socket,
+        uint32_t num_rx_buffers) const;
+
     const std::shared_ptr<exe4cpp::BasicExecutor> executor;
     log4cpp::Logger logger;
     StackFactory factory;
+    const PlaintextQueueConfig queue_config;
+    // null unless latency tracing is enabled
+    const std::shared_ptr<LatencyStats> latency_stats;
 
     Server server;
     asio::ip::tcp::endpoint connect_endpoint;
     const uint16_t max_sessions;
+    const uint32_t rx_buffer_count;
+    const exe4cpp::duration_t idle_timeout;
+    IoBackend io_backend;
+    CloseMetrics close_metrics;
+    Statistics stats;
+    exe4cpp::Timer idle_timer;
+
+    const uint16_t warm_pool_size;
+    std::deque<PooledSession> pool;
+    uint16_t num_pool_connecting = 0;
+    bool is_pool_fill_scheduled = false;
+    exe4cpp::Timer pool_retry_timer;
 
     uint64_t session_id = 0;
+
+    // operations that refer back to this object, it can't be released until they complete
+    bool is_draining = false;
+    bool is_accepting = false;
+    uint32_t num_connecting = 0;
+    uint32_t num_closing = 0;
 };
 
 #endif
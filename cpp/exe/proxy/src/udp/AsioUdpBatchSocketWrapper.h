@@ -0,0 +1,364 @@
+#ifndef SSP21PROXY_ASIOUDPBATCHSOCKETWRAPPER_H
+#define SSP21PROXY_ASIOUDPBATCHSOCKETWRAPPER_H
+
+#include <log4cpp/LogMacros.h>
+#include <log4cpp/Logger.h>
+#include <ser4cpp/container/Buffer.h>
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <ssp21/link/LinkConstants.h>
+#include <ssp21/stack/LogLevels.h>
+#include <ssp21/util/SequenceTypes.h>
+
+#include "HandlerMemory.h"
+#include "IAsioLayer.h"
+#include "IAsioSocketWrapper.h"
+#include "log/ProxyLogLevels.h"
+
+#include <asio.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <vector>
+
+/**
+ * Linux-only UDP socket wrapper that moves datagrams in batches.
+ *
+ * When the socket becomes readable, up to batch_size datagrams are drained with a single
+ * recvmmsg() into a preallocated ring and handed to the layer one at a time as it asks for
+ * more data. Frames written by the layer are copied into a second ring and flushed with a
+ * single sendmmsg() when the ring fills or when the layer stops producing frames.
+ */
+class AsioUdpBatchSocketWrapper final : public IAsioSocketWrapper, private ser4cpp::Uncopyable {
+
+    struct Ring : private ser4cpp::Uncopyable {
+        explicit Ring(uint32_t size)
+            : buffer(size * ssp21::consts::link::max_frame_size)
+            , lengths(size, 0)
+            , iovecs(size)
+            , headers(size)
+        {
+            for (uint32_t i = 0; i < size; ++i) {
+                memset(&headers[i], 0, sizeof(mmsghdr));
+                iovecs[i].iov_base = this->slot(i);
+                iovecs[i].iov_len = ssp21::consts::link::max_frame_size;
+                headers[i].msg_hdr.msg_iov = &iovecs[i];
+                headers[i].msg_hdr.msg_iovlen = 1;
+            }
+        }
+
+        uint8_t* slot(uint32_t index)
+        {
+            return this->buffer.as_wslice() + (index * ssp21::consts::link::max_frame_size);
+        }
+
+        ser4cpp::Buffer buffer;
+        std::vector<uint32_t> lengths;
+        std::vector<iovec> iovecs;
+        std::vector<mmsghdr> headers;
+    };
+
+public:
+    using socket_t = asio::ip::udp::socket;
+    using endpoint_t = asio::ip::udp::endpoint;
+
+    AsioUdpBatchSocketWrapper(const log4cpp::Logger& logger, IAsioLayer& layer, socket_t socket, endpoint_t send_endpoint, uint32_t batch_size)
+        : layer(layer)
+        , socket(std::move(socket))
+        , send_endpoint(send_endpoint)
+        , logger(logger)
+        , batch_size(batch_size == 0 ? 1 : batch_size)
+        , rx(this->batch_size)
+        , tx(this->batch_size)
+    {
+        // every outgoing datagram goes to the same destination
+        for (auto& header : this->tx.headers) {
+            header.msg_hdr.msg_name = this->send_endpoint.data();
+            header.msg_hdr.msg_namelen = static_cast<socklen_t>(this->send_endpoint.size());
+        }
+    }
+
+    bool try_close_socket() override
+    {
+        if (!this->socket.is_open())
+            return false;
+
+        this->is_tx_open = false;
+        this->is_rx_open = false;
+
+        std::error_code ec;
+        this->socket.shutdown(asio::ip::udp::socket::shutdown_both, ec);
+        this->socket.close(ec);
+
+        return true;
+    }
+
+    bool start_rx_from_socket() override
+    {
+        if (!this->socket.is_open() || this->is_rx_wait_active)
+            return false;
+
+        // the layer asked for more data while we're handing it a datagram, continue the delivery loop
+        if (this->is_delivering) {
+            this->is_rx_requested = true;
+            return true;
+        }
+
+        if (this->rx_index < this->rx_count) {
+            this->deliver();
+        } else {
+            this->wait_for_rx();
+        }
+
+        return true;
+    }
+
+    bool start_tx_to_socket(const ssp21::seq32_t& data) override
+    {
+        if (!this->socket.is_open() || this->get_is_tx_active())
+            return false;
+
+        if (data.length() > ssp21::consts::link::max_frame_size)
+            return false;
+
+        memcpy(this->tx.slot(this->tx_count), data, data.length());
+        this->tx.iovecs[this->tx_count].iov_len = data.length();
+        ++this->tx_count;
+        ++this->num_tx_queued;
+
+        FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "queued socket tx: %u (%u queued)", data.length(), this->tx_count);
+
+        // complete the operation from the event loop so that the layer isn't re-entered
+        this->is_tx_completion_pending = true;
+        auto callback = [this]() {
+            this->complete_tx();
+            this->notify_if_inactive();
+        };
+
+        asio::post(this->socket.get_executor(), make_custom_alloc_handler(this->tx_handler_memory, callback));
+
+        return true;
+    }
+
+    bool get_is_tx_active() const override
+    {
+        return this->is_tx_completion_pending || this->is_tx_wait_active;
+    }
+
+    bool get_is_rx_active() const override
+    {
+        return this->is_rx_wait_active || this->is_delivering;
+    }
+
+private:
+    void wait_for_rx()
+    {
+        auto callback = [this](const std::error_code& ec) {
+            this->on_rx_ready(ec);
+            this->notify_if_inactive();
+        };
+
+        this->is_rx_wait_active = true;
+
+        SIMPLE_LOG_BLOCK(this->logger, ssp21::levels::debug, "start socket rx wait");
+
+        this->socket.async_wait(socket_t::wait_read, make_custom_alloc_handler(this->rx_handler_memory, callback));
+    }
+
+    void on_rx_ready(const std::error_code& ec)
+    {
+        this->is_rx_wait_active = false;
+
+        if (ec) {
+            FORMAT_LOG_BLOCK(this->logger, ssp21::levels::error, "rx error: %s", ec.message().c_str());
+            if (this->is_rx_open) {
+                this->layer.on_rx_or_tx_error();
+            }
+            return;
+        }
+
+        const auto count = recvmmsg(this->socket.native_handle(), this->rx.headers.data(), this->batch_size, MSG_DONTWAIT, nullptr);
+        if (count < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // spurious wakeup
+                this->wait_for_rx();
+                return;
+            }
+
+            FORMAT_LOG_BLOCK(this->logger, ssp21::levels::error, "recvmmsg error: %s", strerror(errno));
+            if (this->is_rx_open) {
+                this->layer.on_rx_or_tx_error();
+            }
+            return;
+        }
+
+        this->is_rx_open = true;
+        this->rx_count = static_cast<uint32_t>(count);
+        this->rx_index = 0;
+
+        FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "complete socket rx batch: %u datagrams", this->rx_count);
+
+        this->deliver();
+    }
+
+    void deliver()
+    {
+        this->is_delivering = true;
+
+        do {
+            this->is_rx_requested = false;
+
+            const auto index = this->rx_index++;
+            const ssp21::seq32_t rx_data(this->rx.slot(index), this->rx.headers[index].msg_len);
+
+            FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "deliver datagram %u of %u: %u", index + 1, this->rx_count, rx_data.length());
+            if (this->logger.is_enabled(proxy_levels::rx_bytes)) {
+                log4cpp::HexLogging::log(this->logger, proxy_levels::rx_bytes, rx_data);
+            }
+
+            this->layer.on_rx_complete(rx_data);
+
+        } while (this->is_rx_requested && this->rx_index < this->rx_count && this->socket.is_open());
+
+        this->is_delivering = false;
+
+        // the batch is exhausted and the layer wants more
+        if (this->is_rx_requested) {
+            this->is_rx_requested = false;
+            if (this->socket.is_open()) {
+                this->wait_for_rx();
+            }
+        }
+    }
+
+    void complete_tx()
+    {
+        this->is_tx_completion_pending = false;
+
+        if (!this->socket.is_open()) {
+            return;
+        }
+
+        if (this->tx_count == this->batch_size) {
+            this->flush_tx();
+            if (this->is_tx_wait_active) {
+                // the completion is reported once the remainder of the batch is written
+                return;
+            }
+        }
+
+        const auto num_tx_queued_before = this->num_tx_queued;
+
+        this->layer.on_tx_complete();
+
+        // the layer didn't follow up with another frame, so nothing else is coming right away
+        if (this->num_tx_queued == num_tx_queued_before && !this->is_tx_completion_pending) {
+            this->flush_tx();
+        }
+    }
+
+    void flush_tx()
+    {
+        uint32_t num_sent = 0;
+
+        while (num_sent < this->tx_count) {
+            const auto count = sendmmsg(this->socket.native_handle(), this->tx.headers.data() + num_sent, this->tx_count - num_sent, MSG_DONTWAIT);
+
+            if (count < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    this->shift_tx(num_sent);
+                    this->wait_for_tx();
+                    return;
+                }
+
+                FORMAT_LOG_BLOCK(this->logger, ssp21::levels::error, "sendmmsg error: %s", strerror(errno));
+                this->tx_count = 0;
+                if (this->is_tx_open) {
+                    this->layer.on_rx_or_tx_error();
+                }
+                return;
+            }
+
+            num_sent += static_cast<uint32_t>(count);
+        }
+
+        FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "flushed socket tx batch: %u datagrams", num_sent);
+
+        this->is_tx_open = true;
+        this->tx_count = 0;
+    }
+
+    // move unsent frames to the front of the ring
+    void shift_tx(uint32_t num_sent)
+    {
+        for (uint32_t i = num_sent; i < this->tx_count; ++i) {
+            const auto dest = i - num_sent;
+            const auto length = this->tx.iovecs[i].iov_len;
+            memmove(this->tx.slot(dest), this->tx.slot(i), length);
+            this->tx.iovecs[dest].iov_len = length;
+        }
+
+        this->tx_count -= num_sent;
+    }
+
+    void wait_for_tx()
+    {
+        auto callback = [this](const std::error_code& ec) {
+            this->on_tx_writable(ec);
+            this->notify_if_inactive();
+        };
+
+        this->is_tx_wait_active = true;
+
+        this->socket.async_wait(socket_t::wait_write, make_custom_alloc_handler(this->tx_wait_handler_memory, callback));
+    }
+
+    void on_tx_writable(const std::error_code& ec)
+    {
+        this->is_tx_wait_active = false;
+
+        if (ec) {
+            if (this->is_tx_open) {
+                FORMAT_LOG_BLOCK(this->logger, ssp21::levels::error, "tx error: %s", ec.message().c_str());
+                this->layer.on_rx_or_tx_error();
+            }
+            return;
+        }
+
+        this->flush_tx();
+
+        if (!this->is_tx_wait_active) {
+            this->layer.on_tx_complete();
+        }
+    }
+
+    bool is_tx_open = false;
+    bool is_rx_open = false;
+
+    bool is_rx_wait_active = false;
+    bool is_rx_requested = false;
+    bool is_delivering = false;
+    uint32_t rx_count = 0;
+    uint32_t rx_index = 0;
+
+    bool is_tx_completion_pending = false;
+    bool is_tx_wait_active = false;
+    uint32_t tx_count = 0;
+    uint64_t num_tx_queued = 0;
+
+    IAsioLayer& layer;
+    socket_t socket;
+    endpoint_t send_endpoint;
+    log4cpp::Logger logger;
+
+    const uint32_t batch_size;
+    Ring rx;
+    Ring tx;
+
+    HandlerMemory rx_handler_memory;
+    HandlerMemory tx_handler_memory;
+    HandlerMemory tx_wait_handler_memory;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef SSP21PROXY_ASIOUDPPEERSOCKETWRAPPER_H
+#define SSP21PROXY_ASIOUDPPEERSOCKETWRAPPER_H
+
+#include <log4cpp/LogMacros.h>
+#include <log4cpp/Logger.h>
+#include <ser4cpp/container/Buffer.h>
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <ssp21/link/LinkConstants.h>
+#include <ssp21/stack/LogLevels.h>
+#include <ssp21/util/SequenceTypes.h>
+
+#include "HandlerMemory.h"
+#include "IAsioLayer.h"
+#include "IAsioSocketWrapper.h"
+
+#include <asio.hpp>
+
+#include <cstring>
+
+/**
+ * Presents one peer of a shared UDP socket as a socket of its own.
+ *
+ * Received datagrams are pushed in by the owner of the shared socket after it has demultiplexed
+ * them, and transmissions are addressed to the peer's endpoint. Closing the wrapper never closes
+ * the shared socket.
+ */
+class AsioUdpPeerSocketWrapper final : public IAsioSocketWrapper, private ser4cpp::Uncopyable {
+
+public:
+    using socket_t = asio::ip::udp::socket;
+    using endpoint_t = asio::ip::udp::endpoint;
+
+    AsioUdpPeerSocketWrapper(const log4cpp::Logger& logger, IAsioLayer& layer, socket_t& socket, endpoint_t peer_endpoint)
+        : layer(layer)
+        , socket(socket)
+        , peer_endpoint(peer_endpoint)
+        , logger(logger)
+        , rx_buffer(ssp21::consts::link::max_frame_size)
+    {
+    }
+
+    /**
+     * Hand a datagram received from the peer to the layer
+     *
+     * @return false if the layer is still processing the previous datagram and this one was dropped
+     */
+    bool deliver(const ssp21::seq32_t& data)
+    {
+        if (!this->is_open || !this->is_rx_active || data.length() > this->rx_buffer.length()) {
+            return false;
+        }
+
+        this->is_rx_active = false;
+
+        // the shared receive buffer is reused as soon as we return
+        auto dest = this->rx_buffer.as_wslice();
+        memcpy(dest, data, data.length());
+        const auto rx_data = this->rx_buffer.as_rslice().take(data.length());
+
+        FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "complete peer rx: %u", rx_data.length());
+
+        this->layer.on_rx_complete(rx_data);
+
+        return true;
+    }
+
+    bool try_close_socket() override
+    {
+        if (!this->is_open)
+            return false;
+
+        this->is_open = false;
+        this->is_rx_active = false;
+
+        this->notify_if_inactive();
+
+        return true;
+    }
+
+    bool start_rx_from_socket() override
+    {
+        if (!this->is_open || this->is_rx_active)
+            return false;
+
+        this->is_rx_active = true;
+
+        return true;
+    }
+
+    bool start_tx_to_socket(const ssp21::seq32_t& data) override
+    {
+        if (!this->is_open || this->is_tx_active)
+            return false;
+
+        auto callback = [this](const std::error_code& ec, size_t num_tx) {
+            this->is_tx_active = false;
+
+            if (ec) {
+                if (this->is_open) {
+                    FORMAT_LOG_BLOCK(this->logger, ssp21::levels::error, "tx error: %s", ec.message().c_str());
+                    this->layer.on_rx_or_tx_error();
+                }
+            } else {
+                FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "complete peer tx: %u", static_cast<uint32_t>(num_tx));
+                this->layer.on_tx_complete();
+            }
+
+            this->notify_if_inactive();
+        };
+
+        this->is_tx_active = true;
+
+        this->socket.async_send_to(asio::buffer(data, data.length()), this->peer_endpoint, make_custom_alloc_handler(this->tx_handler_memory, callback));
+
+        return true;
+    }
+
+    bool get_is_tx_active() const override
+    {
+        return this->is_tx_active;
+    }
+
+    bool get_is_rx_active() const override
+    {
+        return this->is_rx_active;
+    }
+
+private:
+    bool is_open = true;
+    bool is_tx_active = false;
+    bool is_rx_active = false;
+
+    IAsioLayer& layer;
+    socket_t& socket;
+    endpoint_t peer_endpoint;
+    log4cpp::Logger logger;
+    ser4cpp::Buffer rx_buffer;
+
+    HandlerMemory tx_handler_memory;
+};
+
+#endif
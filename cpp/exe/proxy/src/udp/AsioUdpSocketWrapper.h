@@ -10,8 +10,10 @@
 #include <ssp21/stack/LogLevels.h>
 #include <ssp21/util/SequenceTypes.h>
 
+#include "HandlerMemory.h"
 #include "IAsioLayer.h"
 #include "IAsioSocketWrapper.h"
+#include "log/ProxyLogLevels.h"
 
 #include <asio.hpp>
 
@@ -62,11 +64,13 @@ public:
                 this->is_rx_open = true;
                 const auto rx_data = this->rx_buffer.as_rslice().take(static_cast<uint32_t>(num_rx));
                 FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "complete socket rx: %u, tx: %s", rx_data.length(), bool_str(this->is_tx_active));
-                if (this->logger.is_enabled(ssp21::levels::debug)) {
-                    log4cpp::HexLogging::log(this->logger, ssp21::levels::debug, rx_data);
+                if (this->logger.is_enabled(proxy_levels::rx_bytes)) {
+                    log4cpp::HexLogging::log(this->logger, proxy_levels::rx_bytes, rx_data);
                 }
                 this->layer.on_rx_complete(rx_data);
             }
+
+            this->notify_if_inactive();
         };
 
         auto dest = rx_buffer.as_wslice();
@@ -75,7 +79,7 @@ public:
 
         FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "start socket rx, tx: %s", bool_str(this->is_tx_active));
 
-        this->socket.async_receive(asio::buffer(dest, dest.length()), callback);
+        this->socket.async_receive(asio::buffer(dest, dest.length()), make_custom_alloc_handler(this->rx_handler_memory, callback));
 
         return true;
     }
@@ -99,13 +103,15 @@ public:
                 FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "complete socket tx: %u - rx: %s", static_cast<uint32_t>(num_tx), bool_str(this->is_rx_active));
                 this->layer.on_tx_complete();
             }
+
+            this->notify_if_inactive();
         };
 
         this->is_tx_active = true;
 
         FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "start socket tx: %d, rx: %s", data.length(), bool_str(this->is_tx_active));
 
-        this->socket.async_send_to(asio::buffer(data, data.length()), send_endpoint, callback);
+        this->socket.async_send_to(asio::buffer(data, data.length()), send_endpoint, make_custom_alloc_handler(this->tx_handler_memory, callback));
 
         return true;
     }
@@ -136,6 +142,10 @@ private:
     endpoint_t send_endpoint;
     log4cpp::Logger logger;
     ser4cpp::Buffer rx_buffer;
+
+    // operation state for the single outstanding read and write
+    HandlerMemory rx_handler_memory;
+    HandlerMemory tx_handler_memory;
 };
 
 #endif
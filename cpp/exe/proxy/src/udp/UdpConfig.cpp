@@ -7,5 +7,12 @@ UdpConfig::UdpConfig(const YAML::Node& node)
     , raw_tx_endpoint(yaml::require(node, "raw_tx"))
     , secure_rx_endpoint(yaml::require(node, "secure_rx"))
     , secure_tx_endpoint(yaml::require(node, "secure_tx"))
+    , batch_size(yaml::optional_integer<uint32_t>(node, "batch_size", 0))
+    , io_backend(read_io_backend(node))
 {
+#ifndef __linux__
+    if (this->batch_size > 0) {
+        throw yaml::YAMLException(node.Mark(), "batch_size is only supported on Linux");
+    }
+#endif
 }
@@ -2,6 +2,9 @@
 #define SSP21PROXY_UDPCONFIG_H
 
 #include "IPEndpoint.h"
+#include "IoBackend.h"
+
+#include <cstdint>
 
 struct UdpConfig {
     UdpConfig(const YAML::Node& node);
@@ -10,6 +13,11 @@ struct UdpConfig {
     const IPEndpoint raw_tx_endpoint;
     const IPEndpoint secure_rx_endpoint;
     const IPEndpoint secure_tx_endpoint;
+
+    // number of datagrams moved per recvmmsg/sendmmsg call, 0 disables batching
+    const uint32_t batch_size;
+    // io_uring takes precedence over batching
+    const IoBackend io_backend;
 };
 
 #endif
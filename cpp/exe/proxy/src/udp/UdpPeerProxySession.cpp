@@ -0,0 +1,329 @@
+#include "udp/UdpPeerProxySession.h"
+
+#include <log4cpp/LogMacros.h>
+#include <ser4cpp/serialization/BigEndian.h>
+#include <ssp21/stack/LogLevels.h>
+
+#include "AsioLowerLayer.h"
+#include "AsioUpperLayer.h"
+#include "udp/AsioUdpSocketWrapper.h"
+
+#include <functional>
+
+using namespace asio;
+using namespace ssp21;
+
+size_t UdpPeerProxySession::PeerKeyHash::operator()(const PeerKey& key) const
+{
+    size_t hash = std::hash<uint32_t>()((static_cast<uint32_t>(key.endpoint.port()) << 16) | key.link_address);
+
+    const auto combine = [&hash](size_t value) {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+
+    if (key.endpoint.address().is_v4()) {
+        combine(std::hash<uint32_t>()(key.endpoint.address().to_v4().to_ulong()));
+    } else {
+        for (auto byte : key.endpoint.address().to_v6().to_bytes()) {
+            combine(byte);
+        }
+    }
+
+    return hash;
+}
+
+UdpPeerProxySession::UdpPeerProxySession(
+    const UdpPeersConfig& config,
+    const StackFactory& factory,
+    const PlaintextQueueConfig& queue_config,
+    const LatencyTracingConfig& tracing_config,
+    const std::shared_ptr<exe4cpp::BasicExecutor>& executor,
+    const log4cpp::Logger& logger)
+    : executor(executor)
+    , logger(logger)
+    , factory(factory)
+    , queue_config(queue_config)
+    , latency_stats(tracing_config.enabled ? std::make_shared<LatencyStats>(tracing_config, logger) : nullptr)
+    , secure_socket(*executor->get_service(), endpoint_t(ip::address::from_string(config.secure_rx_endpoint.ip_address), config.secure_rx_endpoint.port))
+    , raw_tx_endpoint(ip::address::from_string(config.raw_tx_endpoint.ip_address), config.raw_tx_endpoint.port)
+    , raw_bind_endpoint(ip::address::from_string(config.raw_bind_address), 0)
+    , max_peers(config.max_peers)
+    , peer_idle_timeout(config.peer_idle_timeout)
+    , rx_buffer(consts::link::max_frame_size)
+    , close_metrics(logger)
+{
+}
+
+void UdpPeerProxySession::start()
+{
+    const auto local = this->secure_socket.local_endpoint();
+
+    FORMAT_LOG_BLOCK(
+        this->logger,
+        levels::info,
+        "serving up to %u SSP21 peers on %s:%u, forwarding raw traffic to %s:%u",
+        this->max_peers,
+        local.address().to_string().c_str(), local.port(),
+        this->raw_tx_endpoint.address().to_string().c_str(), this->raw_tx_endpoint.port());
+
+    this->start_eviction_timer();
+    this->receive_next();
+}
+
+void UdpPeerProxySession::drain()
+{
+    if (this->is_draining)
+        return;
+
+    // existing peers share the socket, so it stays open until the last of them goes away
+    this->is_draining = true;
+
+    FORMAT_LOG_BLOCK(this->logger, levels::info, "no longer accepting new peers, draining %u peer(s)", static_cast<uint32_t>(this->peers.size()));
+
+    this->close_if_drained();
+}
+
+bool UdpPeerProxySession::is_drained() const
+{
+    return this->is_draining && this->peers.empty() && this->num_closing == 0 && !this->is_rx_active && !this->secure_socket.is_open();
+}
+
+void UdpPeerProxySession::set_log_levels(log4cpp::LogLevels levels)
+{
+    this->logger.set_levels(levels);
+}
+
+void UdpPeerProxySession::set_stack_factory(const StackFactory& factory)
+{
+    this->factory = factory;
+}
+
+void UdpPeerProxySession::close_if_drained()
+{
+    if (!this->is_draining || !this->peers.empty() || !this->secure_socket.is_open())
+        return;
+
+    this->eviction_timer.cancel();
+
+    std::error_code ec;
+    this->secure_socket.close(ec);
+
+    SIMPLE_LOG_BLOCK(this->logger, levels::info, "all peers drained, closed the socket");
+}
+
+void UdpPeerProxySession::receive_next()
+{
+    auto callback = [this](const std::error_code& ec, size_t num_rx) {
+        this->is_rx_active = false;
+
+        if (ec) {
+            if (ec == asio::error::operation_aborted || !this->secure_socket.is_open()) {
+                return;
+            }
+            FORMAT_LOG_BLOCK(this->logger, levels::error, "rx error: %s", ec.message().c_str());
+        } else {
+            this->on_secure_rx(this->rx_buffer.as_rslice().take(static_cast<uint32_t>(num_rx)));
+        }
+
+        this->receive_next();
+    };
+
+    auto dest = this->rx_buffer.as_wslice();
+    this->is_rx_active = true;
+    this->secure_socket.async_receive_from(asio::buffer(dest, dest.length()), this->rx_endpoint, make_custom_alloc_handler(this->rx_handler_memory, callback));
+}
+
+void UdpPeerProxySession::on_secure_rx(const seq32_t& data)
+{
+    const PeerKey key{ this->rx_endpoint, this->get_link_address(data) };
+
+    auto iter = this->peers.find(key);
+
+    Peer* peer = nullptr;
+
+    if (iter == this->peers.end()) {
+        peer = this->create_peer(key);
+        if (!peer) {
+            return;
+        }
+    } else {
+        peer = &iter->second;
+    }
+
+    peer->last_rx = this->executor->get_time();
+
+    if (!peer->secure_socket->deliver(data)) {
+        ++this->stats.num_datagrams_dropped;
+        FORMAT_LOG_BLOCK(this->logger, levels::debug, "dropped datagram for busy peer %u", static_cast<uint32_t>(peer->id));
+    }
+}
+
+UdpPeerProxySession::Peer* UdpPeerProxySession::create_peer(const PeerKey& key)
+{
+    if (this->is_draining) {
+        FORMAT_LOG_BLOCK(this->logger, levels::debug, "draining, ignoring new peer %s:%u", key.endpoint.address().to_string().c_str(), key.endpoint.port());
+        return nullptr;
+    }
+
+    if (this->peers.size() >= this->max_peers) {
+        // evicting an active peer to make room would let anyone who can reach the socket starve legitimate peers
+        ++this->stats.num_peers_rejected;
+        FORMAT_LOG_BLOCK(
+            this->logger,
+            levels::warn,
+            "max peers (%u) reached, ignoring %s:%u",
+            this->max_peers,
+            key.endpoint.address().to_string().c_str(), key.endpoint.port());
+        return nullptr;
+    }
+
+    // the raw socket is connected so that it only accepts replies from the raw destination
+    std::error_code ec;
+    asio::ip::udp::socket raw_socket(*executor->get_service());
+    raw_socket.open(this->raw_bind_endpoint.protocol(), ec);
+    if (!ec) {
+        raw_socket.bind(this->raw_bind_endpoint, ec);
+    }
+    if (!ec) {
+        raw_socket.connect(this->raw_tx_endpoint, ec);
+    }
+    if (ec) {
+        FORMAT_LOG_BLOCK(this->logger, levels::error, "unable to open raw socket for peer: %s", ec.message().c_str());
+        return nullptr;
+    }
+
+    const auto id = this->peer_id++;
+
+    auto error_handler = [this, key, id]() {
+        this->on_peer_error(key, id);
+    };
+
+    auto lower_layer_logger = this->logger.detach_and_append("-", id, "-lower");
+    auto lower_layer = std::make_unique<AsioLowerLayer>(lower_layer_logger);
+    auto lower_layer_socket = std::make_unique<AsioUdpPeerSocketWrapper>(lower_layer_logger, *lower_layer, this->secure_socket, key.endpoint);
+    const auto secure_socket = lower_layer_socket.get();
+
+    auto upper_layer_logger = this->logger.detach_and_append("-", id, "-upper");
+    auto upper_layer = std::make_unique<AsioUpperLayer>(upper_layer_logger, this->queue_config);
+    auto upper_layer_socket = std::make_unique<AsioUdpSocketWrapper>(upper_layer_logger, *upper_layer, std::move(raw_socket), this->raw_tx_endpoint);
+
+    const auto session = Session::create(
+        id,
+        error_handler,
+        this->executor,
+        std::move(lower_layer_socket),
+        std::move(lower_layer),
+        std::move(upper_layer_socket),
+        std::move(upper_layer),
+        this->factory.create_stack(
+            this->logger.detach_and_append("-", id, "-ssp21"),
+            this->executor));
+
+    if (this->latency_stats) {
+        session->trace_latency(this->latency_stats);
+    }
+
+    this->peers.emplace(key, Peer{ id, secure_socket, session, this->executor->get_time() });
+
+    ++this->stats.num_peers_created;
+
+    FORMAT_LOG_BLOCK(
+        this->logger,
+        levels::info,
+        "new peer %u from %s:%u (link address: %u), %u active",
+        static_cast<uint32_t>(id),
+        key.endpoint.address().to_string().c_str(), key.endpoint.port(),
+        key.link_address,
+        static_cast<uint32_t>(this->peers.size()));
+
+    session->start();
+
+    // starting the session may have already failed and removed the peer
+    const auto iter = this->peers.find(key);
+    return (iter != this->peers.end() && iter->second.id == id) ? &iter->second : nullptr;
+}
+
+void UdpPeerProxySession::on_peer_error(const PeerKey& key, uint64_t id)
+{
+    const auto iter = this->peers.find(key);
+
+    // a session that was already replaced may still report an error
+    if (iter != this->peers.end() && iter->second.id == id) {
+        const auto session = iter->second.session;
+        this->peers.erase(iter);
+        session->shutdown(this->get_close_handler());
+        this->close_if_drained();
+    }
+}
+
+void UdpPeerProxySession::start_eviction_timer()
+{
+    // sweeping twice per timeout bounds how long an idle peer can linger to 1.5x the timeout
+    this->eviction_timer = exe4cpp::Timer(this->executor->start(this->peer_idle_timeout / 2, [this]() {
+        this->evict_idle_peers();
+        this->start_eviction_timer();
+    }));
+}
+
+void UdpPeerProxySession::evict_idle_peers()
+{
+    const auto now = this->executor->get_time();
+
+    uint32_t num_evicted = 0;
+
+    for (auto iter = this->peers.begin(); iter != this->peers.end();) {
+        if ((now - iter->second.last_rx) >= this->peer_idle_timeout) {
+            const auto session = iter->second.session;
+            iter = this->peers.erase(iter);
+            session->shutdown(this->get_close_handler());
+            ++num_evicted;
+        } else {
+            ++iter;
+        }
+    }
+
+    this->stats.num_peers_evicted += num_evicted;
+
+    this->close_if_drained();
+
+    if (num_evicted > 0) {
+        FORMAT_LOG_BLOCK(
+            this->logger,
+            levels::info,
+            "evicted %u idle peers, %u active (created: %llu, evicted: %llu, rejected: %llu, dropped datagrams: %llu)",
+            num_evicted,
+            static_cast<uint32_t>(this->peers.size()),
+            static_cast<unsigned long long>(this->stats.num_peers_created),
+            static_cast<unsigned long long>(this->stats.num_peers_evicted),
+            static_cast<unsigned long long>(this->stats.num_peers_rejected),
+            static_cast<unsigned long long>(this->stats.num_datagrams_dropped));
+    }
+}
+
+uint16_t UdpPeerProxySession::get_link_address(const seq32_t& data) const
+{
+    // without the link-layer the source endpoint alone identifies the peer
+    if (!this->factory.get_uses_link_layer() || data.length() < consts::link::header_fields_size) {
+        return 0;
+    }
+
+    if (data[0] != consts::link::sync1 || data[1] != consts::link::sync2) {
+        return 0;
+    }
+
+    // sync1, sync2, destination, source - the stack validates the header CRC
+    auto source = data.skip(4);
+    uint16_t address = 0;
+    ser4cpp::BigEndian::read(source, address);
+    return address;
+}
+
+session_close_handler_t UdpPeerProxySession::get_close_handler()
+{
+    ++this->num_closing;
+
+    return [this](const exe4cpp::duration_t& time_to_close, bool deadline_exceeded) {
+        --this->num_closing;
+        this->close_metrics.record(time_to_close, deadline_exceeded);
+    };
+}
@@ -0,0 +1,138 @@
+#ifndef SSP21PROXY_UDPPEERPROXYSESSION_H
+#define SSP21PROXY_UDPPEERPROXYSESSION_H
+
+#include <exe4cpp/Timer.h>
+#include <exe4cpp/asio/BasicExecutor.h>
+#include <log4cpp/Logger.h>
+#include <ser4cpp/container/Buffer.h>
+
+#include <asio.hpp>
+
+#include "CloseMetrics.h"
+#include "HandlerMemory.h"
+#include "IProxySession.h"
+#include "LatencyStats.h"
+#include "LatencyTracingConfig.h"
+#include "PlaintextQueueConfig.h"
+#include "Session.h"
+#include "StackConfigReader.h"
+#include "udp/AsioUdpPeerSocketWrapper.h"
+#include "udp/UdpPeersConfig.h"
+
+#include <memory>
+#include <unordered_map>
+
+/**
+* Serves many SSP21 peers from a single UDP socket.
+*
+* Datagrams are demultiplexed by source endpoint, and by link-layer source address when the
+* link-layer is enabled, into a table of per-peer stacks that are created on first contact.
+* Each peer exchanges raw traffic over its own ephemeral socket so that replies from the raw
+* side are routed back to the peer that they're meant for.
+*/
+class UdpPeerProxySession final : public IProxySession {
+
+    using endpoint_t = asio::ip::udp::endpoint;
+
+    struct PeerKey {
+        endpoint_t endpoint;
+        uint16_t link_address;
+
+        bool operator==(const PeerKey& other) const
+        {
+            return this->endpoint == other.endpoint && this->link_address == other.link_address;
+        }
+    };
+
+    struct PeerKeyHash {
+        size_t operator()(const PeerKey& key) const;
+    };
+
+    struct Peer {
+        uint64_t id;
+        AsioUdpPeerSocketWrapper* secure_socket;
+        std::shared_ptr<Session> session;
+        exe4cpp::steady_time_t last_rx;
+    };
+
+    struct Statistics {
+        uint64_t num_peers_created = 0;
+        uint64_t num_peers_evicted = 0;
+        uint64_t num_peers_rejected = 0;
+        uint64_t num_datagrams_dropped = 0;
+    };
+
+public:
+    UdpPeerProxySession(
+        const UdpPeersConfig& config,
+        const StackFactory& factory,
+        const PlaintextQueueConfig& queue_config,
+        const LatencyTracingConfig& tracing_config,
+        const std::shared_ptr<exe4cpp::BasicExecutor>& executor,
+        const log4cpp::Logger& logger);
+
+    void start() override;
+
+    void drain() override;
+
+    bool is_drained() const override;
+
+    void set_log_levels(log4cpp::LogLevels levels) override;
+
+    void set_stack_factory(const StackFactory& factory) override;
+
+    size_t get_num_peers() const
+    {
+        return this->peers.size();
+    }
+
+private:
+    void receive_next();
+
+    void on_secure_rx(const ssp21::seq32_t& data);
+
+    Peer* create_peer(const PeerKey& key);
+
+    void on_peer_error(const PeerKey& key, uint64_t id);
+
+    session_close_handler_t get_close_handler();
+
+    void start_eviction_timer();
+
+    void evict_idle_peers();
+
+    // releases the shared socket once a draining session has no peers left
+    void close_if_drained();
+
+    uint16_t get_link_address(const ssp21::seq32_t& data) const;
+
+    const std::shared_ptr<exe4cpp::BasicExecutor> executor;
+    log4cpp::Logger logger;
+    StackFactory factory;
+    const PlaintextQueueConfig queue_config;
+    // null unless latency tracing is enabled
+    const std::shared_ptr<LatencyStats> latency_stats;
+
+    asio::ip::udp::socket secure_socket;
+    endpoint_t raw_tx_endpoint;
+    endpoint_t raw_bind_endpoint;
+    const uint16_t max_peers;
+    const exe4cpp::duration_t peer_idle_timeout;
+
+    ser4cpp::Buffer rx_buffer;
+    endpoint_t rx_endpoint;
+    HandlerMemory rx_handler_memory;
+
+    std::unordered_map<PeerKey, Peer, PeerKeyHash> peers;
+    exe4cpp::Timer eviction_timer;
+    Statistics stats;
+    CloseMetrics close_metrics;
+
+    uint64_t peer_id = 0;
+
+    bool is_draining = false;
+    bool is_rx_active = false;
+    uint32_t num_closing = 0;
+};
+
+#endif
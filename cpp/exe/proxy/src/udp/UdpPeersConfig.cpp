@@ -0,0 +1,19 @@
+#include "UdpPeersConfig.h"
+
+#include "YAMLHelpers.h"
+
+UdpPeersConfig::UdpPeersConfig(const YAML::Node& node)
+    : secure_rx_endpoint(yaml::require(node, "secure_rx"))
+    , raw_tx_endpoint(yaml::require(node, "raw_tx"))
+    , raw_bind_address(yaml::optional_string(node, "raw_bind_address", "0.0.0.0"))
+    , max_peers(yaml::require_integer<uint16_t>(node, "max_peers"))
+    , peer_idle_timeout(yaml::optional_duration(node, "peer_idle_timeout", std::chrono::minutes(5)))
+{
+    if (this->max_peers == 0) {
+        throw yaml::YAMLException(node.Mark(), "max_peers must be greater than zero");
+    }
+
+    if (this->peer_idle_timeout <= exe4cpp::duration_t::zero()) {
+        throw yaml::YAMLException(node.Mark(), "peer_idle_timeout must be greater than zero");
+    }
+}
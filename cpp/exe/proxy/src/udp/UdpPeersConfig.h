@@ -0,0 +1,27 @@
+#ifndef SSP21PROXY_UDPPEERSCONFIG_H
+#define SSP21PROXY_UDPPEERSCONFIG_H
+
+#include "IPEndpoint.h"
+
+#include <exe4cpp/Typedefs.h>
+
+#include <string>
+
+/**
+ * Configuration for a UDP proxy that serves many peers from a single secure socket
+ */
+struct UdpPeersConfig {
+    UdpPeersConfig(const YAML::Node& node);
+
+    // shared socket on which SSP21 traffic is received from, and sent to, every peer
+    const IPEndpoint secure_rx_endpoint;
+    // destination for the raw traffic of every peer
+    const IPEndpoint raw_tx_endpoint;
+    // each peer sends raw traffic from its own ephemeral port on this address
+    const std::string raw_bind_address;
+
+    const uint16_t max_peers;
+    const exe4cpp::duration_t peer_idle_timeout;
+};
+
+#endif
@@ -6,6 +6,7 @@
 #include "AsioLowerLayer.h"
 #include "AsioUpperLayer.h"
 #include "Session.h"
+#include "uring/AsioUringSocketWrapper.h"
 
 using namespace asio;
 using namespace ssp21;
@@ -13,6 +14,8 @@ using namespace ssp21;
 UdpProxySession::UdpProxySession(
     const UdpConfig& config,
     const StackFactory& factory,
+    const PlaintextQueueConfig& queue_config,
+    const LatencyTracingConfig& tracing_config,
     const std::shared_ptr<exe4cpp::BasicExecutor>& executor,
     const log4cpp::Logger& logger)
     : executor(executor)
@@ -21,7 +24,12 @@ UdpProxySession::UdpProxySession(
     , raw_rx_endpoint(ip::address::from_string(config.raw_rx_endpoint.ip_address), config.raw_rx_endpoint.port)
     , secure_tx_endpoint(ip::address::from_string(config.secure_tx_endpoint.ip_address), config.secure_tx_endpoint.port)
     , secure_rx_endpoint(ip::address::from_string(config.secure_rx_endpoint.ip_address), config.secure_rx_endpoint.port)
+    , batch_size(config.batch_size)
+    , io_backend(config.io_backend)
     , factory(factory)
+    , queue_config(queue_config)
+    , latency_stats(tracing_config.enabled ? std::make_shared<LatencyStats>(tracing_config, logger) : nullptr)
+    , close_metrics(logger)
 {
 }
 
@@ -41,12 +49,55 @@ void UdpProxySession::start()
         this->secure_rx_endpoint.address().to_string().c_str(), this->secure_rx_endpoint.port(),
         this->raw_tx_endpoint.address().to_string().c_str(), this->raw_tx_endpoint.port());
 
+    if (!is_io_backend_available(this->io_backend)) {
+        FORMAT_LOG_BLOCK(this->logger, levels::warn, "io_backend %s is not available, falling back to %s", get_io_backend_name(this->io_backend), get_io_backend_name(IoBackend::asio));
+        this->io_backend = IoBackend::asio;
+    }
+
+    if (this->io_backend == IoBackend::io_uring) {
+        SIMPLE_LOG_BLOCK(this->logger, levels::info, "performing socket I/O through io_uring");
+    } else if (this->batch_size > 0) {
+        FORMAT_LOG_BLOCK(this->logger, levels::info, "batching up to %u datagrams per system call", this->batch_size);
+    }
+
     this->start_session();
 }
 
+void UdpProxySession::drain()
+{
+    if (this->is_draining)
+        return;
+
+    // the sockets are bound to fixed endpoints, so the session can't outlive the configuration
+    this->is_draining = true;
+    this->session->shutdown(this->get_close_handler());
+    this->session.reset();
+
+    SIMPLE_LOG_BLOCK(this->logger, levels::info, "session removed from the configuration, closing");
+}
+
+bool UdpProxySession::is_drained() const
+{
+    return this->is_draining && this->num_closing == 0;
+}
+
+void UdpProxySession::set_log_levels(log4cpp::LogLevels levels)
+{
+    this->logger.set_levels(levels);
+}
+
+void UdpProxySession::set_stack_factory(const StackFactory& factory)
+{
+    // takes effect when the session is next restarted
+    this->factory = factory;
+}
+
 void UdpProxySession::on_session_error()
 {
-    session->shutdown();
+    if (this->is_draining)
+        return;
+
+    session->shutdown(this->get_close_handler());
 
     // Restart the session
     this->start_session();
@@ -65,22 +116,18 @@ void UdpProxySession::start_session()
 
     auto lower_layer_logger = this->logger.detach_and_append("-lower");
     auto lower_layer = std::make_unique<AsioLowerLayer>(lower_layer_logger);
-    auto lower_layer_socket = std::make_unique<AsioUdpSocketWrapper>(
+    auto lower_layer_socket = this->create_socket(
         lower_layer_logger,
         *lower_layer,
-        AsioUdpSocketWrapper::socket_t(
-            *executor->get_service(),
-            lower_receive_endpoint),
+        lower_receive_endpoint,
         lower_send_endpoint);
 
     auto upper_layer_logger = this->logger.detach_and_append("-upper");
-    auto upper_layer = std::make_unique<AsioUpperLayer>(upper_layer_logger);
-    auto upper_layer_socket = std::make_unique<AsioUdpSocketWrapper>(
+    auto upper_layer = std::make_unique<AsioUpperLayer>(upper_layer_logger, this->queue_config);
+    auto upper_layer_socket = this->create_socket(
         upper_layer_logger,
         *upper_layer,
-        AsioUdpSocketWrapper::socket_t(
-            *executor->get_service(),
-            upper_receive_endpoint),
+        upper_receive_endpoint,
         upper_send_endpoint);
 
     this->session = Session::create(
@@ -95,5 +142,42 @@ void UdpProxySession::start_session()
             this->logger.detach_and_append("-ssp21"),
             this->executor));
 
+    if (this->latency_stats) {
+        this->session->trace_latency(this->latency_stats);
+    }
+
     this->session->start();
 }
+
+std::unique_ptr<IAsioSocketWrapper> UdpProxySession::create_socket(
+    const log4cpp::Logger& logger,
+    IAsioLayer& layer,
+    const AsioUdpSocketWrapper::endpoint_t& receive_endpoint,
+    const AsioUdpSocketWrapper::endpoint_t& send_endpoint) const
+{
+    AsioUdpSocketWrapper::socket_t socket(*executor->get_service(), receive_endpoint);
+
+#ifdef SSP21PROXY_IO_URING
+    if (this->io_backend == IoBackend::io_uring) {
+        return std::make_unique<AsioUringUdpSocketWrapper>(logger, layer, std::move(socket), send_endpoint);
+    }
+#endif
+
+#ifdef __linux__
+    if (this->batch_size > 0) {
+        return std::make_unique<AsioUdpBatchSocketWrapper>(logger, layer, std::move(socket), send_endpoint, this->batch_size);
+    }
+#endif
+
+    return std::make_unique<AsioUdpSocketWrapper>(logger, layer, std::move(socket), send_endpoint);
+}
+
+session_close_handler_t UdpProxySession::get_close_handler()
+{
+    ++this->num_closing;
+
+    return [this](const exe4cpp::duration_t& time_to_close, bool deadline_exceeded) {
+        --this->num_closing;
+        this->close_metrics.record(time_to_close, deadline_exceeded);
+    };
+}
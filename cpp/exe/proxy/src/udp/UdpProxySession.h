@@ -7,10 +7,18 @@
 
 #include <asio.hpp>
 
+#include "CloseMetrics.h"
 #include "IProxySession.h"
+#include "IoBackend.h"
+#include "LatencyStats.h"
+#include "LatencyTracingConfig.h"
+#include "PlaintextQueueConfig.h"
 #include "Session.h"
 #include "StackConfigReader.h"
 #include "udp/AsioUdpSocketWrapper.h"
+#ifdef __linux__
+#include "udp/AsioUdpBatchSocketWrapper.h"
+#endif
 #include "udp/UdpConfig.h"
 
 #include <memory>
@@ -21,25 +29,52 @@ public:
     UdpProxySession(
         const UdpConfig& config,
         const StackFactory& factory,
+        const PlaintextQueueConfig& queue_config,
+        const LatencyTracingConfig& tracing_config,
         const std::shared_ptr<exe4cpp::BasicExecutor>& executor,
         const log4cpp::Logger& logger);
 
     void start() override;
 
+    void drain() override;
+
+    bool is_drained() const override;
+
+    void set_log_levels(log4cpp::LogLevels levels) override;
+
+    void set_stack_factory(const StackFactory& factory) override;
+
 private:
     void on_session_error();
 
+    session_close_handler_t get_close_handler();
+
     void start_session();
 
+    std::unique_ptr<IAsioSocketWrapper> create_socket(
+        const log4cpp::Logger& logger,
+        IAsioLayer& layer,
+        const AsioUdpSocketWrapper::endpoint_t& receive_endpoint,
+        const AsioUdpSocketWrapper::endpoint_t& send_endpoint) const;
+
     const std::shared_ptr<exe4cpp::BasicExecutor> executor;
     log4cpp::Logger logger;
     AsioUdpSocketWrapper::endpoint_t raw_tx_endpoint;
     AsioUdpSocketWrapper::endpoint_t raw_rx_endpoint;
     AsioUdpSocketWrapper::endpoint_t secure_tx_endpoint;
     AsioUdpSocketWrapper::endpoint_t secure_rx_endpoint;
+    const uint32_t batch_size;
+    IoBackend io_backend;
     StackFactory factory;
+    const PlaintextQueueConfig queue_config;
+    // null unless latency tracing is enabled
+    const std::shared_ptr<LatencyStats> latency_stats;
+    CloseMetrics close_metrics;
 
     std::shared_ptr<Session> session;
+
+    bool is_draining = false;
+    uint32_t num_closing = 0;
 };
 
 #endif
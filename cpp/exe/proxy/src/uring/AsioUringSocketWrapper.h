@@ -0,0 +1,409 @@
+#ifndef SSP21PROXY_ASIOURINGSOCKETWRAPPER_H
+#define SSP21PROXY_ASIOURINGSOCKETWRAPPER_H
+
+#ifdef SSP21PROXY_IO_URING
+
+#include <log4cpp/LogMacros.h>
+#include <log4cpp/Logger.h>
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <ssp21/link/LinkConstants.h>
+#include <ssp21/stack/LogLevels.h>
+#include <ssp21/util/SequenceTypes.h>
+
+#include "HandlerMemory.h"
+#include "IAsioLayer.h"
+#include "IAsioSocketWrapper.h"
+#include "log/ProxyLogLevels.h"
+#include "uring/IoUringService.h"
+
+#include <asio.hpp>
+
+#include <cstring>
+#include <deque>
+#include <type_traits>
+
+/**
+ * Socket wrapper that performs I/O through the io_uring of its io_service instead of the reactor.
+ *
+ * A single multishot receive stays armed for the lifetime of the socket and the kernel fills
+ * buffers from the shared provided buffer pool without a system call per read. Received buffers
+ * queue up until the layer asks for them, and one buffer at a time is lent to the layer until it
+ * calls start_rx_from_socket() again. The receive is cancelled when too many buffers are queued
+ * and re-armed once the layer catches up.
+ *
+ * Writes are copied into a buffer registered with the ring. Streams are written with
+ * IORING_OP_WRITE_FIXED, datagrams are sent to a fixed endpoint with IORING_OP_SENDMSG.
+ */
+template <class Protocol>
+class AsioUringSocketWrapper final : public IAsioSocketWrapper, private IUringBufferWaiter, private ser4cpp::Uncopyable {
+
+    static constexpr bool is_datagram = std::is_same<Protocol, asio::ip::udp>::value;
+
+    // received buffers queued before the receive is cancelled
+    static const size_t max_queued_rx = 8;
+
+    class Completion final : public IUringOperation {
+    public:
+        using handler_t = void (AsioUringSocketWrapper::*)(int32_t, uint32_t);
+
+        Completion(AsioUringSocketWrapper& wrapper, handler_t handler)
+            : wrapper(wrapper)
+            , handler(handler)
+        {
+        }
+
+        void on_uring_complete(int32_t result, uint32_t flags) override
+        {
+            (this->wrapper.*(this->handler))(result, flags);
+        }
+
+    private:
+        AsioUringSocketWrapper& wrapper;
+        const handler_t handler;
+    };
+
+    struct RxChunk {
+        uint16_t buffer_id;
+        uint32_t length;
+    };
+
+public:
+    using socket_t = typename Protocol::socket;
+    using endpoint_t = typename Protocol::endpoint;
+
+    // the send endpoint is only used by datagram sockets
+    AsioUringSocketWrapper(const log4cpp::Logger& logger, IAsioLayer& layer, socket_t socket, endpoint_t send_endpoint = endpoint_t())
+        : layer(layer)
+        , socket(std::move(socket))
+        , send_endpoint(send_endpoint)
+        , logger(logger)
+        , service(asio::use_service<IoUringService>(static_cast<asio::io_service&>(this->socket.get_executor().context())))
+        , rx_operation(*this, &AsioUringSocketWrapper::on_rx_complete)
+        , tx_operation(*this, &AsioUringSocketWrapper::on_tx_complete)
+        , cancel_operation(*this, &AsioUringSocketWrapper::on_cancel_complete)
+    {
+    }
+
+    bool try_close_socket() override
+    {
+        if (!this->socket.is_open())
+            return false;
+
+        if (this->is_recv_armed && !this->is_recv_cancel_pending) {
+            this->cancel(this->rx_operation);
+            this->is_recv_cancel_pending = true;
+        }
+
+        if (this->is_tx_active) {
+            this->cancel(this->tx_operation);
+        }
+
+        if (this->is_waiting_for_buffers) {
+            this->is_waiting_for_buffers = false;
+            this->service.cancel_wait_for_rx_buffers(*this);
+        }
+
+        // the layer won't read anything else, including the buffer it was lent
+        this->is_rx_lent = false;
+        this->recycle_rx_queue();
+
+        std::error_code ec;
+        this->socket.shutdown(socket_t::shutdown_both, ec);
+        this->socket.close(ec);
+
+        return true;
+    }
+
+    bool start_rx_from_socket() override
+    {
+        if (!this->socket.is_open())
+            return false;
+
+        // the layer is done with the buffer it was lent
+        if (this->is_rx_lent) {
+            this->is_rx_lent = false;
+            const auto buffer_id = this->rx_queue.front().buffer_id;
+            this->rx_queue.pop_front();
+            this->service.recycle_rx_buffer(buffer_id);
+        }
+
+        if (this->is_rx_error_pending && this->rx_queue.empty()) {
+            this->post_rx_error();
+            return false;
+        }
+
+        this->is_rx_requested = true;
+
+        this->arm_receive();
+
+        // may call back into the layer synchronously with a buffer that was already filled
+        this->try_lend_rx_buffer();
+
+        return true;
+    }
+
+    bool start_tx_to_socket(const ssp21::seq32_t& data) override
+    {
+        if (!this->socket.is_open() || this->is_tx_active)
+            return false;
+
+        this->tx_buffer_index = (data.length() <= ssp21::consts::link::max_frame_size) ? this->service.acquire_tx_buffer() : -1;
+
+        if (this->tx_buffer_index < 0) {
+            // registered buffers are exhausted, the layer keeps 'data' valid until the write completes
+            this->tx_remaining = data;
+        } else {
+            auto dest = this->service.get_tx_buffer(this->tx_buffer_index);
+            memcpy(dest, data, data.length());
+            this->tx_remaining = ssp21::seq32_t(dest, data.length());
+        }
+
+        this->is_tx_active = true;
+
+        FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "start socket tx: %d, rx: %s", data.length(), bool_str(this->is_recv_armed));
+
+        this->submit_tx();
+
+        return true;
+    }
+
+    bool get_is_tx_active() const override
+    {
+        return this->is_tx_active;
+    }
+
+    bool get_is_rx_active() const override
+    {
+        return this->is_recv_armed || this->is_rx_error_posted || this->num_cancels_pending > 0;
+    }
+
+private:
+    static const char* bool_str(bool value)
+    {
+        return value ? "true" : "false";
+    }
+
+    void cancel(IUringOperation& target)
+    {
+        ++this->num_cancels_pending;
+        this->service.cancel(target, this->cancel_operation);
+    }
+
+    void arm_receive()
+    {
+        if (this->is_recv_armed || this->is_rx_error_pending || this->is_waiting_for_buffers || !this->socket.is_open() || this->rx_queue.size() >= max_queued_rx)
+            return;
+
+        auto sqe = this->service.get_sqe(this->rx_operation);
+        io_uring_prep_recv_multishot(sqe, this->socket.native_handle(), nullptr, 0, 0);
+        sqe->flags |= IOSQE_BUFFER_SELECT;
+        sqe->buf_group = this->service.get_rx_buffer_group();
+
+        this->is_recv_armed = true;
+
+        FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "arm socket rx, tx: %s", bool_str(this->is_tx_active));
+    }
+
+    void on_rx_complete(int32_t result, uint32_t flags)
+    {
+        if (!(flags & IORING_CQE_F_MORE)) {
+            // the multishot receive has terminated
+            this->is_recv_armed = false;
+            this->is_recv_cancel_pending = false;
+        }
+
+        if (flags & IORING_CQE_F_BUFFER) {
+            const auto buffer_id = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+            if (result > 0 && this->socket.is_open()) {
+                this->rx_queue.push_back(RxChunk{ buffer_id, static_cast<uint32_t>(result) });
+                this->record_activity();
+                FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "complete socket rx: %d, buffered: %u, tx: %s", result, static_cast<uint32_t>(this->rx_queue.size()), bool_str(this->is_tx_active));
+            } else {
+                this->service.recycle_rx_buffer(buffer_id);
+            }
+        }
+
+        if (this->socket.is_open()) {
+            if (result == -ENOBUFS) {
+                // the shared pool is empty, wait for some other socket to hand a buffer back
+                this->service.on_rx_buffer_exhausted();
+                this->is_waiting_for_buffers = true;
+                this->service.wait_for_rx_buffers(*this);
+            } else if ((result < 0 && result != -ECANCELED) || (result == 0 && !is_datagram)) {
+                FORMAT_LOG_BLOCK(this->logger, ssp21::levels::error, "rx error: %s", (result == 0) ? "end of stream" : strerror(-result));
+                if (this->rx_queue.empty()) {
+                    this->report_rx_error();
+                } else {
+                    // let the layer drain what was received before the error, e.g. the last data before EOF
+                    this->is_rx_error_pending = true;
+                }
+            }
+
+            if (this->rx_queue.size() >= max_queued_rx && this->is_recv_armed && !this->is_recv_cancel_pending) {
+                this->cancel(this->rx_operation);
+                this->is_recv_cancel_pending = true;
+            }
+
+            this->arm_receive();
+            this->try_lend_rx_buffer();
+        }
+
+        this->notify_if_inactive();
+    }
+
+    void on_rx_buffers_available() override
+    {
+        this->is_waiting_for_buffers = false;
+        this->arm_receive();
+    }
+
+    void try_lend_rx_buffer()
+    {
+        if (!this->is_rx_requested || this->is_rx_lent || this->rx_queue.empty())
+            return;
+
+        this->is_rx_requested = false;
+        this->is_rx_lent = true;
+
+        const auto& chunk = this->rx_queue.front();
+        const auto rx_data = this->service.get_rx_buffer(chunk.buffer_id, chunk.length);
+        if (this->logger.is_enabled(proxy_levels::rx_bytes)) {
+            log4cpp::HexLogging::log(this->logger, proxy_levels::rx_bytes, rx_data);
+        }
+        this->layer.on_rx_complete(rx_data);
+    }
+
+    void recycle_rx_queue()
+    {
+        while (!this->rx_queue.empty()) {
+            const auto buffer_id = this->rx_queue.front().buffer_id;
+            this->rx_queue.pop_front();
+            this->service.recycle_rx_buffer(buffer_id);
+        }
+    }
+
+    void report_rx_error()
+    {
+        this->is_rx_error_pending = false;
+        this->try_close_socket();
+        this->layer.on_rx_or_tx_error();
+    }
+
+    // the layer drained the queue from within a call, so report the deferred error from the event loop
+    void post_rx_error()
+    {
+        auto callback = [this]() {
+            this->is_rx_error_posted = false;
+            if (this->socket.is_open()) {
+                this->report_rx_error();
+            }
+            this->notify_if_inactive();
+        };
+
+        this->is_rx_error_pending = false;
+        this->is_rx_error_posted = true;
+
+        asio::post(this->socket.get_executor(), make_custom_alloc_handler(this->rx_handler_memory, callback));
+    }
+
+    void submit_tx()
+    {
+        auto sqe = this->service.get_sqe(this->tx_operation);
+
+        if (is_datagram) {
+            this->tx_iovec.iov_base = const_cast<uint8_t*>(static_cast<const uint8_t*>(this->tx_remaining));
+            this->tx_iovec.iov_len = this->tx_remaining.length();
+            memset(&this->tx_message, 0, sizeof(this->tx_message));
+            this->tx_message.msg_name = this->send_endpoint.data();
+            this->tx_message.msg_namelen = static_cast<socklen_t>(this->send_endpoint.size());
+            this->tx_message.msg_iov = &this->tx_iovec;
+            this->tx_message.msg_iovlen = 1;
+            io_uring_prep_sendmsg(sqe, this->socket.native_handle(), &this->tx_message, 0);
+        } else if (this->tx_buffer_index >= 0) {
+            io_uring_prep_write_fixed(sqe, this->socket.native_handle(), this->tx_remaining, this->tx_remaining.length(), 0, this->tx_buffer_index);
+        } else {
+            io_uring_prep_send(sqe, this->socket.native_handle(), this->tx_remaining, this->tx_remaining.length(), MSG_NOSIGNAL);
+        }
+    }
+
+    void on_tx_complete(int32_t result, uint32_t flags)
+    {
+        if (!is_datagram && result > 0 && static_cast<uint32_t>(result) < this->tx_remaining.length() && this->socket.is_open()) {
+            // short write on a stream, send the rest
+            this->tx_remaining.advance(static_cast<uint32_t>(result));
+            this->submit_tx();
+            return;
+        }
+
+        this->is_tx_active = false;
+
+        if (this->tx_buffer_index >= 0) {
+            this->service.release_tx_buffer(this->tx_buffer_index);
+            this->tx_buffer_index = -1;
+        }
+
+        if (result < 0) {
+            if (this->socket.is_open()) {
+                FORMAT_LOG_BLOCK(this->logger, ssp21::levels::error, "tx error: %s", strerror(-result));
+                this->try_close_socket();
+                this->layer.on_rx_or_tx_error();
+            }
+        } else {
+            FORMAT_LOG_BLOCK(this->logger, ssp21::levels::debug, "complete socket tx: %d - rx: %s", result, bool_str(this->is_recv_armed));
+            this->record_activity();
+            this->layer.on_tx_complete();
+        }
+
+        this->notify_if_inactive();
+    }
+
+    void on_cancel_complete(int32_t result, uint32_t flags)
+    {
+        --this->num_cancels_pending;
+        this->notify_if_inactive();
+    }
+
+    // a multishot receive is outstanding
+    bool is_recv_armed = false;
+    bool is_recv_cancel_pending = false;
+    // the shared buffer pool ran dry and this socket is waiting to re-arm
+    bool is_waiting_for_buffers = false;
+    bool is_tx_active = false;
+
+    // the layer asked for data and hasn't been given any yet
+    bool is_rx_requested = false;
+    // the buffer at the front of the queue is lent to the layer
+    bool is_rx_lent = false;
+    // an error was received after data that the layer hasn't consumed yet
+    bool is_rx_error_pending = false;
+    bool is_rx_error_posted = false;
+
+    uint32_t num_cancels_pending = 0;
+
+    IAsioLayer& layer;
+    socket_t socket;
+    endpoint_t send_endpoint;
+    log4cpp::Logger logger;
+    IoUringService& service;
+
+    std::deque<RxChunk> rx_queue;
+
+    int32_t tx_buffer_index = -1;
+    ssp21::seq32_t tx_remaining;
+    iovec tx_iovec{};
+    msghdr tx_message{};
+
+    Completion rx_operation;
+    Completion tx_operation;
+    Completion cancel_operation;
+
+    HandlerMemory rx_handler_memory;
+};
+
+using AsioUringTcpSocketWrapper = AsioUringSocketWrapper<asio::ip::tcp>;
+using AsioUringUdpSocketWrapper = AsioUringSocketWrapper<asio::ip::udp>;
+
+#endif
+
+#endif
@@ -0,0 +1,261 @@
+#include "uring/IoUringService.h"
+
+#ifdef SSP21PROXY_IO_URING
+
+#include <ssp21/link/LinkConstants.h>
+
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <sys/utsname.h>
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <system_error>
+
+asio::io_service::id IoUringService::id;
+
+namespace {
+bool is_kernel_at_least(int required_major, int required_minor)
+{
+    utsname name{};
+    if (uname(&name) != 0) {
+        return false;
+    }
+
+    int major = 0;
+    int minor = 0;
+    if (sscanf(name.release, "%d.%d", &major, &minor) != 2) {
+        return false;
+    }
+
+    return (major > required_major) || (major == required_major && minor >= required_minor);
+}
+
+bool probe_kernel()
+{
+    // multishot receives into a provided buffer ring are available since 6.0
+    if (!is_kernel_at_least(6, 0)) {
+        return false;
+    }
+
+    io_uring ring{};
+    // also fails if io_uring is disabled by sysctl or a seccomp policy
+    if (io_uring_queue_init(8, &ring, 0) < 0) {
+        return false;
+    }
+
+    const auto probe = io_uring_get_probe_ring(&ring);
+    const auto supported = probe && io_uring_opcode_supported(probe, IORING_OP_RECV) && io_uring_opcode_supported(probe, IORING_OP_SEND) && io_uring_opcode_supported(probe, IORING_OP_SENDMSG) && io_uring_opcode_supported(probe, IORING_OP_WRITE_FIXED) && io_uring_opcode_supported(probe, IORING_OP_ASYNC_CANCEL);
+
+    if (probe) {
+        io_uring_free_probe(probe);
+    }
+
+    io_uring_queue_exit(&ring);
+
+    return supported;
+}
+
+void throw_if_error(int result, const char* operation)
+{
+    if (result < 0) {
+        throw std::system_error(-result, std::system_category(), operation);
+    }
+}
+}
+
+IoUringService::IoUringService(asio::io_service& owner)
+    : asio::io_service::service(owner)
+    , owner(owner)
+    , rx_buffers(num_rx_buffers * ssp21::consts::link::max_frame_size)
+    , tx_buffers(num_tx_buffers * ssp21::consts::link::max_frame_size)
+    , event_descriptor(owner)
+{
+    // writes to a stream socket without MSG_NOSIGNAL raise SIGPIPE when the peer has gone away
+    std::signal(SIGPIPE, SIG_IGN);
+
+    throw_if_error(io_uring_queue_init(num_ring_entries, &this->ring, 0), "io_uring_queue_init");
+
+    int result = 0;
+    this->rx_buffer_ring = io_uring_setup_buf_ring(&this->ring, num_rx_buffers, rx_buffer_group, 0, &result);
+    if (!this->rx_buffer_ring) {
+        io_uring_queue_exit(&this->ring);
+        throw_if_error(result, "io_uring_setup_buf_ring");
+    }
+
+    const auto mask = io_uring_buf_ring_mask(num_rx_buffers);
+    for (uint16_t i = 0; i < num_rx_buffers; ++i) {
+        io_uring_buf_ring_add(this->rx_buffer_ring, this->rx_buffers.as_wslice().skip(i * ssp21::consts::link::max_frame_size), ssp21::consts::link::max_frame_size, i, mask, i);
+    }
+    io_uring_buf_ring_advance(this->rx_buffer_ring, num_rx_buffers);
+
+    std::vector<iovec> registered(num_tx_buffers);
+    for (uint16_t i = 0; i < num_tx_buffers; ++i) {
+        registered[i].iov_base = this->get_tx_buffer(i);
+        registered[i].iov_len = ssp21::consts::link::max_frame_size;
+        this->free_tx_buffers.push_back(num_tx_buffers - 1 - i);
+    }
+    throw_if_error(io_uring_register_buffers(&this->ring, registered.data(), num_tx_buffers), "io_uring_register_buffers");
+
+    const auto event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (event_fd < 0) {
+        throw std::system_error(errno, std::system_category(), "eventfd");
+    }
+    this->event_descriptor.assign(event_fd);
+    throw_if_error(io_uring_register_eventfd(&this->ring, event_fd), "io_uring_register_eventfd");
+
+    this->wait_for_completions();
+}
+
+IoUringService::~IoUringService()
+{
+    // outstanding requests are cancelled by the kernel when the ring is torn down
+    io_uring_free_buf_ring(&this->ring, this->rx_buffer_ring, num_rx_buffers, rx_buffer_group);
+    io_uring_queue_exit(&this->ring);
+}
+
+bool IoUringService::is_supported()
+{
+    static const bool supported = probe_kernel();
+    return supported;
+}
+
+io_uring_sqe* IoUringService::get_sqe(IUringOperation& operation)
+{
+    auto sqe = io_uring_get_sqe(&this->ring);
+    if (!sqe) {
+        // the submission queue is full, flush it early
+        this->submit();
+        sqe = io_uring_get_sqe(&this->ring);
+    }
+
+    io_uring_sqe_set_data(sqe, &operation);
+
+    this->schedule_submit();
+
+    return sqe;
+}
+
+void IoUringService::cancel(IUringOperation& target, IUringOperation& completion)
+{
+    auto sqe = this->get_sqe(completion);
+    io_uring_prep_cancel(sqe, &target, IORING_ASYNC_CANCEL_ALL);
+}
+
+ssp21::seq32_t IoUringService::get_rx_buffer(uint16_t buffer_id, uint32_t length) const
+{
+    return this->rx_buffers.as_rslice().skip(buffer_id * ssp21::consts::link::max_frame_size).take(length);
+}
+
+void IoUringService::recycle_rx_buffer(uint16_t buffer_id)
+{
+    io_uring_buf_ring_add(this->rx_buffer_ring, this->rx_buffers.as_wslice().skip(buffer_id * ssp21::consts::link::max_frame_size), ssp21::consts::link::max_frame_size, buffer_id, io_uring_buf_ring_mask(num_rx_buffers), 0);
+    io_uring_buf_ring_advance(this->rx_buffer_ring, 1);
+
+    if (!this->rx_buffer_waiters.empty()) {
+        const auto waiter = this->rx_buffer_waiters.front();
+        this->rx_buffer_waiters.pop_front();
+        waiter->on_rx_buffers_available();
+    }
+}
+
+void IoUringService::wait_for_rx_buffers(IUringBufferWaiter& waiter)
+{
+    this->rx_buffer_waiters.push_back(&waiter);
+}
+
+void IoUringService::cancel_wait_for_rx_buffers(IUringBufferWaiter& waiter)
+{
+    this->rx_buffer_waiters.erase(std::remove(this->rx_buffer_waiters.begin(), this->rx_buffer_waiters.end(), &waiter), this->rx_buffer_waiters.end());
+}
+
+int32_t IoUringService::acquire_tx_buffer()
+{
+    if (this->free_tx_buffers.empty()) {
+        return -1;
+    }
+
+    const auto index = this->free_tx_buffers.back();
+    this->free_tx_buffers.pop_back();
+    return index;
+}
+
+ssp21::wseq32_t IoUringService::get_tx_buffer(int32_t index)
+{
+    return this->tx_buffers.as_wslice().skip(index * ssp21::consts::link::max_frame_size).take(ssp21::consts::link::max_frame_size);
+}
+
+void IoUringService::release_tx_buffer(int32_t index)
+{
+    this->free_tx_buffers.push_back(index);
+}
+
+void IoUringService::shutdown()
+{
+    this->is_shut_down = true;
+    this->rx_buffer_waiters.clear();
+
+    std::error_code ec;
+    this->event_descriptor.close(ec);
+}
+
+void IoUringService::schedule_submit()
+{
+    if (this->is_submit_scheduled)
+        return;
+
+    this->is_submit_scheduled = true;
+
+    // everything prepared by the handlers that run before this one goes out with one system call
+    asio::post(this->owner, [this]() {
+        this->is_submit_scheduled = false;
+        this->submit();
+    });
+}
+
+void IoUringService::submit()
+{
+    if (this->is_shut_down || io_uring_sq_ready(&this->ring) == 0)
+        return;
+
+    ++this->statistics.num_submit_calls;
+    io_uring_submit(&this->ring);
+}
+
+void IoUringService::wait_for_completions()
+{
+    this->event_descriptor.async_wait(asio::posix::stream_descriptor::wait_read, [this](const std::error_code& ec) {
+        if (ec || this->is_shut_down)
+            return;
+
+        // reset the counter before draining so completions posted meanwhile trigger another wake-up
+        uint64_t value = 0;
+        if (read(this->event_descriptor.native_handle(), &value, sizeof(value)) == sizeof(value)) {
+            ++this->statistics.num_wakeups;
+        }
+
+        this->dispatch_completions();
+        this->wait_for_completions();
+    });
+}
+
+void IoUringService::dispatch_completions()
+{
+    io_uring_cqe* cqe = nullptr;
+    while (io_uring_peek_cqe(&this->ring, &cqe) == 0) {
+        const auto operation = static_cast<IUringOperation*>(io_uring_cqe_get_data(cqe));
+        const auto result = cqe->res;
+        const auto flags = cqe->flags;
+
+        // release the entry first, the operation may prepare new requests
+        io_uring_cqe_seen(&this->ring, cqe);
+        ++this->statistics.num_completions;
+
+        if (operation) {
+            operation->on_uring_complete(result, flags);
+        }
+    }
+}
+
+#endif
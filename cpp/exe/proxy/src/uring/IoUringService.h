@@ -0,0 +1,141 @@
+#ifndef SSP21PROXY_IOURINGSERVICE_H
+#define SSP21PROXY_IOURINGSERVICE_H
+
+#ifdef SSP21PROXY_IO_URING
+
+#include <ser4cpp/container/Buffer.h>
+#include <ser4cpp/util/Uncopyable.h>
+
+#include <ssp21/util/SequenceTypes.h>
+
+#include <asio.hpp>
+#include <liburing.h>
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/**
+ * Receives the completions of the requests submitted on its behalf.
+ */
+class IUringOperation {
+public:
+    virtual ~IUringOperation() = default;
+
+    // 'result' and 'flags' are the fields of the completion queue entry
+    virtual void on_uring_complete(int32_t result, uint32_t flags) = 0;
+};
+
+/**
+ * Notified when a provided receive buffer is returned to the pool after the pool ran dry.
+ */
+class IUringBufferWaiter {
+public:
+    virtual ~IUringBufferWaiter() = default;
+
+    virtual void on_rx_buffers_available() = 0;
+};
+
+/**
+ * One io_uring instance per io_service, shared by every io_uring socket wrapper running on it.
+ *
+ * Requests prepared during one turn of the event loop are submitted together with a single
+ * system call. The ring signals completions through an eventfd that the io_service waits on like
+ * any other descriptor, so the ring and asio sockets can be mixed freely on a worker.
+ *
+ * The service owns a pool of receive buffers handed to the kernel as a provided buffer ring,
+ * which multishot receives pick from, and a pool of transmit buffers registered with the ring.
+ */
+class IoUringService final : public asio::io_service::service, private ser4cpp::Uncopyable {
+
+public:
+    static asio::io_service::id id;
+
+    struct Statistics {
+        // io_uring_enter calls made to submit requests
+        uint64_t num_submit_calls = 0;
+        // reads of the eventfd, i.e. wake-ups of the event loop by the ring
+        uint64_t num_wakeups = 0;
+        uint64_t num_completions = 0;
+        // multishot receives terminated because the receive buffer pool was empty
+        uint64_t num_rx_buffer_exhaustions = 0;
+    };
+
+    explicit IoUringService(asio::io_service& owner);
+
+    ~IoUringService() override;
+
+    // true if this kernel supports everything the io_uring wrappers use, probed once per process
+    static bool is_supported();
+
+    // returns an entry to prepare, submitted at the end of the current turn of the event loop
+    io_uring_sqe* get_sqe(IUringOperation& operation);
+
+    // cancels every request submitted by 'target', the cancellation itself completes on 'completion'
+    void cancel(IUringOperation& target, IUringOperation& completion);
+
+    uint16_t get_rx_buffer_group() const
+    {
+        return rx_buffer_group;
+    }
+
+    ssp21::seq32_t get_rx_buffer(uint16_t buffer_id, uint32_t length) const;
+
+    void recycle_rx_buffer(uint16_t buffer_id);
+
+    void wait_for_rx_buffers(IUringBufferWaiter& waiter);
+
+    void cancel_wait_for_rx_buffers(IUringBufferWaiter& waiter);
+
+    // index of a free registered transmit buffer or -1 if all of them are in use
+    int32_t acquire_tx_buffer();
+
+    ssp21::wseq32_t get_tx_buffer(int32_t index);
+
+    void release_tx_buffer(int32_t index);
+
+    void on_rx_buffer_exhausted()
+    {
+        ++this->statistics.num_rx_buffer_exhaustions;
+    }
+
+    const Statistics& get_statistics() const
+    {
+        return this->statistics;
+    }
+
+private:
+    static const uint32_t num_ring_entries = 256;
+    // must be a power of two
+    static const uint16_t num_rx_buffers = 256;
+    static const uint16_t rx_buffer_group = 0;
+    static const uint16_t num_tx_buffers = 64;
+
+    void shutdown() override;
+
+    void schedule_submit();
+
+    void submit();
+
+    void wait_for_completions();
+
+    void dispatch_completions();
+
+    bool is_shut_down = false;
+    bool is_submit_scheduled = false;
+
+    asio::io_service& owner;
+    io_uring ring;
+    io_uring_buf_ring* rx_buffer_ring = nullptr;
+    ser4cpp::Buffer rx_buffers;
+    ser4cpp::Buffer tx_buffers;
+    std::vector<int32_t> free_tx_buffers;
+    std::deque<IUringBufferWaiter*> rx_buffer_waiters;
+
+    asio::posix::stream_descriptor event_descriptor;
+    Statistics statistics;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,47 @@
+#include "catch.hpp"
+
+#include "ActivityList.h"
+
+#include <exe4cpp/MockExecutor.h>
+
+#define SUITE(name) "ActivityListTestSuite - " name
+
+TEST_CASE(SUITE("times activity with the executor clock"))
+{
+    const auto exe = std::make_shared<exe4cpp::MockExecutor>();
+    ActivityList list(exe);
+    ActivityNode first;
+    ActivityNode second;
+
+    const auto start = exe->get_time();
+    list.push_front(first);
+    exe->advance_time(std::chrono::seconds(1));
+    list.push_front(second);
+
+    REQUIRE(list.least_recent() == &first);
+    REQUIRE(first.get_last_activity() == start);
+    REQUIRE(second.get_last_activity() == start + std::chrono::seconds(1));
+
+    exe->advance_time(std::chrono::seconds(1));
+    first.touch();
+
+    REQUIRE(list.least_recent() == &second);
+    REQUIRE(first.get_last_activity() == start + std::chrono::seconds(2));
+}
+
+TEST_CASE(SUITE("nodes leave the list when destroyed"))
+{
+    const auto exe = std::make_shared<exe4cpp::MockExecutor>();
+    ActivityList list(exe);
+    ActivityNode first;
+
+    {
+        ActivityNode second;
+        list.push_front(second);
+        list.push_front(first);
+        REQUIRE(list.size() == 2);
+    }
+
+    REQUIRE(list.size() == 1);
+    REQUIRE(list.least_recent() == &first);
+}
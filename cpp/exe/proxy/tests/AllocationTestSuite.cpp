@@ -0,0 +1,171 @@
+#include "catch.hpp"
+
+#include "AllocationCounter.h"
+#include "HandlerMemory.h"
+#include "Session.h"
+#include "SessionStacks.h"
+#include "tcp/AsioTcpSocketWrapper.h"
+
+#include <exe4cpp/asio/BasicExecutor.h>
+
+#include <chrono>
+#include <vector>
+
+#define SUITE(name) "AllocationTestSuite - " name
+
+using socket_t = asio::ip::tcp::socket;
+
+namespace {
+/**
+ * Plaintext client -> initiator session -> responder session -> plaintext server, over loopback TCP
+ *
+ * The test owns the plaintext ends of the chain and uses blocking calls on them, so that only the
+ * proxy sessions run on the io_service.
+ */
+struct ProxyChain {
+    ProxyChain(ssp21::SessionCryptoMode mode)
+        : service(std::make_shared<asio::io_service>())
+        , executor(exe4cpp::BasicExecutor::create(service))
+        , client(*service)
+        , server(*service)
+    {
+        socket_t initiator_upper(*this->service);
+        socket_t initiator_lower(*this->service);
+        socket_t responder_lower(*this->service);
+        socket_t responder_upper(*this->service);
+
+        this->connect(this->client, initiator_upper);
+        this->connect(initiator_lower, responder_lower);
+        this->connect(responder_upper, this->server);
+
+        const auto stacks = ssp21::SessionStacks::create(ssp21::StackType::full, mode, this->executor);
+        this->initiator = this->create_session(1, initiator_lower, initiator_upper, stacks.initiator);
+        this->responder = this->create_session(2, responder_lower, responder_upper, stacks.responder);
+
+        this->initiator->start();
+        this->responder->start();
+    }
+
+    ~ProxyChain()
+    {
+        this->initiator->shutdown([](const exe4cpp::duration_t&, bool) {});
+        this->responder->shutdown([](const exe4cpp::duration_t&, bool) {});
+        this->service->run();
+    }
+
+    template <class Condition>
+    bool run_until(const Condition& condition)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            this->service->run_one_for(std::chrono::milliseconds(10));
+        }
+        return true;
+    }
+
+    bool is_established() const
+    {
+        return this->initiator->is_established() && this->responder->is_established();
+    }
+
+    // write the data to one plaintext end and read it back from the other
+    bool transfer(socket_t& sender, socket_t& receiver, const ssp21::seq32_t& data)
+    {
+        asio::write(sender, asio::buffer(data, data.length()));
+
+        if (!this->run_until([&]() { return receiver.available() >= data.length(); })) {
+            return false;
+        }
+
+        asio::read(receiver, asio::buffer(this->rx_buffer.data(), data.length()));
+        return memcmp(this->rx_buffer.data(), data, data.length()) == 0;
+    }
+
+    const std::shared_ptr<asio::io_service> service;
+    const std::shared_ptr<exe4cpp::BasicExecutor> executor;
+
+    socket_t client;
+    socket_t server;
+
+    std::shared_ptr<Session> initiator;
+    std::shared_ptr<Session> responder;
+
+    uint32_t num_errors = 0;
+
+private:
+    void connect(socket_t& socket, socket_t& peer)
+    {
+        asio::ip::tcp::acceptor acceptor(*this->service, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+        socket.connect(acceptor.local_endpoint());
+        acceptor.accept(peer);
+        socket.set_option(asio::ip::tcp::no_delay(true));
+    }
+
+    std::shared_ptr<Session> create_session(uint64_t id, socket_t& lower_socket, socket_t& upper_socket, const std::shared_ptr<ssp21::IStack>& stack)
+    {
+        const auto logger = log4cpp::Logger::empty();
+
+        auto lower_layer = std::make_unique<AsioLowerLayer>(logger);
+        auto lower_layer_socket = std::make_unique<AsioTcpSocketWrapper>(logger, *lower_layer, lower_socket, 2);
+
+        auto upper_layer = std::make_unique<AsioUpperLayer>(logger);
+        auto upper_layer_socket = std::make_unique<AsioTcpSocketWrapper>(logger, *upper_layer, upper_socket, 1);
+
+        return Session::create(
+            id,
+            [this]() { ++this->num_errors; },
+            this->executor,
+            std::move(lower_layer_socket),
+            std::move(lower_layer),
+            std::move(upper_layer_socket),
+            std::move(upper_layer),
+            stack);
+    }
+
+    std::vector<uint8_t> rx_buffer = std::vector<uint8_t>(ssp21::consts::link::max_config_payload_size);
+};
+}
+
+TEST_CASE(SUITE("steady state session data does not allocate on the proxy path"))
+{
+    const auto payload_sizes = { 1u, 64u, 1024u, 4092u };
+
+    for (auto mode : { ssp21::SessionCryptoMode::hmac_sha256_16, ssp21::SessionCryptoMode::aes_256_gcm }) {
+        ProxyChain chain(mode);
+        REQUIRE(chain.run_until([&]() { return chain.is_established(); }));
+
+        const std::vector<uint8_t> buffer(ssp21::consts::link::max_config_payload_size, 0xAA);
+
+        // the first transfer in each direction is allowed to perform any lazy initialization
+        REQUIRE(chain.transfer(chain.client, chain.server, ssp21::seq32_t(buffer.data(), 1)));
+        REQUIRE(chain.transfer(chain.server, chain.client, ssp21::seq32_t(buffer.data(), 1)));
+
+        const auto num_heap_allocations = HandlerMemory::get_num_heap_allocations();
+        uint32_t num_failures = 0;
+        uint64_t num_allocations = 0;
+
+        {
+            ssp21::AllocationCounter::Scope scope;
+
+            for (int i = 0; i < 10; ++i) {
+                for (auto size : payload_sizes) {
+                    const ssp21::seq32_t data(buffer.data(), size);
+                    // avoid REQUIRE inside the counted region
+                    if (!chain.transfer(chain.client, chain.server, data) || !chain.transfer(chain.server, chain.client, data)) {
+                        ++num_failures;
+                    }
+                }
+            }
+
+            num_allocations = scope.count();
+        }
+
+        REQUIRE(num_failures == 0);
+        REQUIRE(chain.num_errors == 0);
+        REQUIRE(num_allocations == 0);
+        REQUIRE(HandlerMemory::get_num_heap_allocations() == num_heap_allocations);
+    }
+}
@@ -0,0 +1,57 @@
+#include "catch.hpp"
+
+#include "AsioUpperLayer.h"
+
+#include "mocks/MockSocketWrapper.h"
+#include "mocks/MockStack.h"
+
+#include <log4cpp/MockLogHandler.h>
+
+#include <vector>
+
+#define SUITE(name) "AsioUpperLayerTestSuite - " name
+
+namespace {
+struct Fixture {
+    Fixture()
+        : log("upper")
+        , layer(log.logger)
+    {
+        this->layer.bind(this->stack, [this]() { ++this->num_errors; });
+        this->layer.attach_socket(this->socket);
+    }
+
+    log4cpp::MockLogHandler log;
+    MockStack stack;
+    MockSocketWrapper socket;
+    AsioUpperLayer layer;
+
+    uint32_t num_errors = 0;
+};
+
+ssp21::seq32_t as_seq(const std::vector<uint8_t>& data)
+{
+    return ssp21::seq32_t(data.data(), static_cast<uint32_t>(data.size()));
+}
+}
+
+TEST_CASE(SUITE("closes the session instead of dropping socket data that doesn't fit"))
+{
+    Fixture fix;
+    const std::vector<uint8_t> read(IMessageFramer::max_message_size, 0x01);
+
+    // the crypto layer holds the first message, so the reads fill every queue slot and then the assembler
+    for (uint32_t i = 0; i < PlaintextQueueConfig::default_depth + 2; ++i) {
+        fix.layer.on_rx_complete(as_seq(read));
+    }
+    REQUIRE(fix.num_errors == 0);
+
+    fix.layer.on_rx_complete(as_seq(read).take(1));
+    REQUIRE(fix.num_errors == 1);
+
+    // nothing read before the overflow is kept
+    for (uint32_t i = 0; i < PlaintextQueueConfig::default_depth; ++i) {
+        fix.layer.on_rx_complete(as_seq(read));
+    }
+    REQUIRE(fix.num_errors == 1);
+}
@@ -0,0 +1,243 @@
+#include "catch.hpp"
+
+#include "ConfigReloader.h"
+#include "mocks/MockProxySession.h"
+
+#include <ssp21/stack/LogLevels.h>
+
+#include <exe4cpp/MockExecutor.h>
+
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+#define SUITE(name) "ConfigReloaderTestSuite - " name
+
+namespace {
+/**
+ * A reloader whose configuration is a list the test edits, with its workers running on background
+ * threads and the release timer on a mock executor
+ */
+struct ReloaderFixture {
+    explicit ReloaderFixture(uint32_t max_instances = 1, uint16_t worker_threads = 1)
+        : executor(std::make_shared<exe4cpp::MockExecutor>())
+        , workers(WorkerConfig(YAML::Load("worker_threads: " + std::to_string(worker_threads))), log4cpp::Logger::empty())
+        , reloader(
+              std::make_unique<ConfigReloader>(
+                  [this]() {
+                      if (this->is_unparseable) {
+                          throw std::runtime_error("unparseable configuration");
+                      }
+                      return this->config;
+                  },
+                  log4cpp::Logger::empty(),
+                  this->workers,
+                  this->executor))
+    {
+        this->config = { this->session("a", "tcp:1", log4cpp::LogLevels::none(), max_instances), this->session("b", "tcp:2") };
+        this->reloader->start(this->config);
+        this->worker_thread = std::thread([this]() { this->workers.run(); });
+    }
+
+    ~ReloaderFixture()
+    {
+        // releases the workers, which then run out of work
+        this->reloader.reset();
+        this->worker_thread.join();
+    }
+
+    ProxySessionFactory session(const std::string& id, const std::string& restart_signature, log4cpp::LogLevels levels = log4cpp::LogLevels::none(), uint32_t max_instances = 1)
+    {
+        return ProxySessionFactory{
+            max_instances,
+            [this, id](const log4cpp::Logger&, std::shared_ptr<exe4cpp::BasicExecutor>, const WorkerAssignment& worker) {
+                const auto state = std::make_shared<MockProxySession::State>();
+                this->instances[id].push_back(state);
+                this->assignments[id].push_back(worker);
+                return std::make_unique<MockProxySession>(state);
+            },
+            id,
+            levels,
+            restart_signature,
+            StackFactory(false, StackType::responder, nullptr)
+        };
+    }
+
+    // the most recently created instance of a session
+    const MockProxySession::State& latest(const std::string& id)
+    {
+        return *this->instances[id].back();
+    }
+
+    // let the release timer expire once
+    void release_drained()
+    {
+        this->executor->advance_time(ConfigReloader::release_period);
+        this->executor->run_many();
+    }
+
+    const std::shared_ptr<exe4cpp::MockExecutor> executor;
+    WorkerPool workers;
+
+    std::vector<ProxySessionFactory> config;
+    bool is_unparseable = false;
+
+    // every instance ever created, by session id
+    std::map<std::string, std::vector<std::shared_ptr<MockProxySession::State>>> instances;
+    std::map<std::string, std::vector<WorkerAssignment>> assignments;
+
+    std::unique_ptr<ConfigReloader> reloader;
+    std::thread worker_thread;
+};
+}
+
+TEST_CASE(SUITE("starts the configured sessions"))
+{
+    ReloaderFixture fix;
+
+    REQUIRE(fix.instances.size() == 2);
+    REQUIRE(fix.latest("a").is_started);
+    REQUIRE(fix.latest("b").is_started);
+}
+
+TEST_CASE(SUITE("replicated sessions run no more instances than allowed"))
+{
+    SECTION("one per worker")
+    {
+        ReloaderFixture fix(4, 2);
+
+        REQUIRE(fix.assignments["a"].size() == 2);
+        REQUIRE(fix.assignments["a"][0].index == 0);
+        REQUIRE(fix.assignments["a"][1].index == 1);
+        REQUIRE(fix.assignments["a"][1].count == 2);
+        REQUIRE(fix.assignments["b"].size() == 1);
+        REQUIRE_FALSE(fix.assignments["b"][0].is_shared());
+    }
+
+    SECTION("fewer than the workers")
+    {
+        ReloaderFixture fix(2, 3);
+
+        REQUIRE(fix.assignments["a"].size() == 2);
+        REQUIRE(fix.assignments["a"][0].count == 2);
+    }
+}
+
+TEST_CASE(SUITE("worker shares of a limit add up to the limit"))
+{
+    for (uint32_t count = 1; count <= 4; ++count) {
+        for (uint32_t total = 0; total <= 9; ++total) {
+            uint32_t sum = 0;
+            for (size_t index = 0; index < count; ++index) {
+                const auto share = WorkerAssignment{ index, count }.share_of(total);
+                REQUIRE(share >= total / count);
+                REQUIRE(share <= total / count + 1);
+                sum += share;
+            }
+            REQUIRE(sum == total);
+        }
+    }
+}
+
+TEST_CASE(SUITE("unchanged sessions are updated in place"))
+{
+    ReloaderFixture fix;
+
+    const auto debug = log4cpp::LogLevels(ssp21::levels::debug.value);
+    fix.config = { fix.session("a", "tcp:1", debug), fix.session("b", "tcp:2") };
+    fix.reloader->reload();
+
+    REQUIRE(fix.instances["a"].size() == 1);
+    REQUIRE(fix.instances["b"].size() == 1);
+
+    const auto& a = fix.latest("a");
+    REQUIRE_FALSE(a.is_draining);
+    REQUIRE(a.levels.is_set(ssp21::levels::debug));
+    REQUIRE(a.num_stack_factory_updates == 1);
+    REQUIRE(fix.latest("b").num_stack_factory_updates == 1);
+    REQUIRE(fix.executor->num_pending_timers() == 0);
+}
+
+TEST_CASE(SUITE("a changed restart signature drains the session and starts it again"))
+{
+    ReloaderFixture fix;
+
+    fix.config = { fix.session("a", "tcp:3"), fix.session("b", "tcp:2") };
+    fix.reloader->reload();
+
+    REQUIRE(fix.instances["a"].size() == 2);
+    REQUIRE(fix.instances["a"][0]->is_draining);
+    REQUIRE_FALSE(fix.instances["a"][0]->is_released);
+    REQUIRE(fix.instances["a"][1]->is_started);
+    REQUIRE_FALSE(fix.instances["a"][1]->is_draining);
+
+    REQUIRE(fix.instances["b"].size() == 1);
+    REQUIRE_FALSE(fix.latest("b").is_draining);
+
+    fix.instances["a"][0]->is_drained = true;
+    fix.release_drained();
+
+    REQUIRE(fix.instances["a"][0]->is_released);
+    REQUIRE_FALSE(fix.instances["a"][1]->is_released);
+}
+
+TEST_CASE(SUITE("a removed session is released only once it has drained"))
+{
+    ReloaderFixture fix;
+
+    fix.config = { fix.session("b", "tcp:2") };
+    fix.reloader->reload();
+
+    const auto& a = fix.latest("a");
+    REQUIRE(a.is_draining);
+    REQUIRE_FALSE(a.is_released);
+    REQUIRE(fix.executor->num_pending_timers() == 1);
+
+    // still draining, checked again on the next period
+    fix.release_drained();
+    REQUIRE_FALSE(a.is_released);
+    REQUIRE(fix.executor->num_pending_timers() == 1);
+
+    fix.instances["a"].back()->is_drained = true;
+    fix.release_drained();
+
+    REQUIRE(a.is_released);
+    REQUIRE(fix.executor->num_pending_timers() == 0);
+    REQUIRE_FALSE(fix.latest("b").is_draining);
+}
+
+TEST_CASE(SUITE("a configuration that fails to parse leaves the sessions untouched"))
+{
+    ReloaderFixture fix;
+
+    fix.config = { fix.session("a", "tcp:3") };
+    fix.is_unparseable = true;
+    fix.reloader->reload();
+
+    REQUIRE(fix.instances["a"].size() == 1);
+    REQUIRE(fix.instances["b"].size() == 1);
+
+    for (const auto& id : { "a", "b" }) {
+        const auto& state = fix.latest(id);
+        REQUIRE_FALSE(state.is_draining);
+        REQUIRE(state.num_stack_factory_updates == 0);
+    }
+
+    REQUIRE(fix.executor->num_pending_timers() == 0);
+}
+
+TEST_CASE(SUITE("a configuration with duplicate session ids is rejected"))
+{
+    ReloaderFixture fix;
+
+    fix.config = { fix.session("a", "tcp:1"), fix.session("c", "tcp:4"), fix.session("c", "tcp:5") };
+    fix.reloader->reload();
+
+    REQUIRE(fix.instances.count("c") == 0);
+
+    for (const auto& id : { "a", "b" }) {
+        const auto& state = fix.latest(id);
+        REQUIRE_FALSE(state.is_draining);
+        REQUIRE(state.num_stack_factory_updates == 0);
+    }
+}
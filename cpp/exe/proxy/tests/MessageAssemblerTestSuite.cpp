@@ -0,0 +1,175 @@
+#include "catch.hpp"
+
+#include "framing/MessageAssembler.h"
+
+#include <vector>
+
+#define SUITE(name) "MessageAssemblerTestSuite - " name
+
+namespace {
+FramingConfig get_config(FramingType type)
+{
+    FramingConfig config;
+    config.type = type;
+    return config;
+}
+
+ssp21::seq32_t as_seq(const std::vector<uint8_t>& data)
+{
+    return ssp21::seq32_t(data.data(), static_cast<uint32_t>(data.size()));
+}
+
+// a Modbus/TCP request of the given total length, every byte after the header set to the value
+std::vector<uint8_t> modbus_message(uint8_t length, uint8_t value)
+{
+    std::vector<uint8_t> message(length, value);
+    message[0] = 0x00;
+    message[1] = value;
+    message[2] = 0x00;
+    message[3] = 0x00;
+    message[4] = 0x00;
+    message[5] = static_cast<uint8_t>(length - 6);
+    return message;
+}
+
+// the last count bytes of the data
+std::vector<uint8_t> tail(const std::vector<uint8_t>& data, size_t count)
+{
+    return std::vector<uint8_t>(data.end() - count, data.end());
+}
+
+std::vector<uint8_t> concat(const std::vector<uint8_t>& first, const std::vector<uint8_t>& second)
+{
+    auto result = first;
+    result.insert(result.end(), second.begin(), second.end());
+    return result;
+}
+
+void require_message(MessageAssembler& assembler, const std::vector<uint8_t>& expected)
+{
+    ssp21::seq32_t message;
+    REQUIRE(assembler.next(message) == FramingResult::ok);
+    REQUIRE(message.length() == expected.size());
+    for (uint32_t i = 0; i < message.length(); ++i) {
+        REQUIRE(message[i] == expected[i]);
+    }
+    assembler.pop(message.length());
+}
+}
+
+TEST_CASE(SUITE("waits for the rest of a split header"))
+{
+    MessageAssembler assembler(get_config(FramingType::modbus_tcp));
+    const auto message = modbus_message(12, 0x01);
+    ssp21::seq32_t next;
+
+    REQUIRE(assembler.next(next) == FramingResult::need_more);
+    REQUIRE(assembler.append(as_seq(message).take(3)));
+    REQUIRE(assembler.next(next) == FramingResult::need_more);
+    REQUIRE(assembler.append(as_seq(message).skip(3)));
+
+    require_message(assembler, message);
+    REQUIRE(assembler.next(next) == FramingResult::need_more);
+}
+
+TEST_CASE(SUITE("assembles a message that spans several reads"))
+{
+    MessageAssembler assembler(get_config(FramingType::modbus_tcp));
+    const auto message = modbus_message(200, 0x02);
+    ssp21::seq32_t next;
+
+    REQUIRE(assembler.append(as_seq(message).take(10)));
+    REQUIRE(assembler.next(next) == FramingResult::need_more);
+    REQUIRE(assembler.append(as_seq(message).skip(10).take(100)));
+    REQUIRE(assembler.next(next) == FramingResult::need_more);
+    REQUIRE(assembler.append(as_seq(message).skip(110)));
+
+    require_message(assembler, message);
+}
+
+TEST_CASE(SUITE("returns every message of a single read in order"))
+{
+    MessageAssembler assembler(get_config(FramingType::modbus_tcp));
+    const auto first = modbus_message(8, 0x01);
+    const auto second = modbus_message(12, 0x02);
+    const auto third = modbus_message(20, 0x03);
+    ssp21::seq32_t next;
+
+    // the third one is cut short
+    REQUIRE(assembler.append(as_seq(concat(concat(first, second), third)).take(30)));
+
+    require_message(assembler, first);
+    require_message(assembler, second);
+    REQUIRE(assembler.next(next) == FramingResult::need_more);
+
+    REQUIRE(assembler.append(as_seq(third).skip(10)));
+    require_message(assembler, third);
+}
+
+TEST_CASE(SUITE("accepts messages of the maximum size"))
+{
+    FramingConfig config = get_config(FramingType::length_prefix);
+    config.length_size = 2;
+    MessageAssembler assembler(config);
+
+    const uint32_t max = IMessageFramer::max_message_size;
+    const auto message = [max](uint8_t value) {
+        std::vector<uint8_t> result(max, value);
+        result[0] = static_cast<uint8_t>((max - 2) >> 8);
+        result[1] = static_cast<uint8_t>(max - 2);
+        return result;
+    };
+    const auto first = message(0x01);
+    const auto second = message(0x02);
+    const auto third = message(0x03);
+    ssp21::seq32_t next;
+
+    // every read is of the maximum size and ends one byte short of a message
+    REQUIRE(assembler.append(as_seq(first).take(max - 1)));
+    REQUIRE(assembler.next(next) == FramingResult::need_more);
+
+    REQUIRE(assembler.can_accept());
+    REQUIRE(assembler.append(as_seq(concat(tail(first, 1), second)).take(max)));
+    require_message(assembler, first);
+    REQUIRE(assembler.next(next) == FramingResult::need_more);
+
+    // only fits once the unread part of the second message is moved to the front
+    REQUIRE(assembler.can_accept());
+    REQUIRE(assembler.append(as_seq(concat(tail(second, 1), third)).take(max)));
+    require_message(assembler, second);
+
+    REQUIRE(assembler.append(as_seq(third).skip(max - 1)));
+    require_message(assembler, third);
+    REQUIRE(assembler.next(next) == FramingResult::need_more);
+}
+
+TEST_CASE(SUITE("refuses data that doesn't fit"))
+{
+    MessageAssembler assembler(get_config(FramingType::pass_through));
+    const std::vector<uint8_t> read(IMessageFramer::max_message_size, 0x01);
+
+    REQUIRE(assembler.append(as_seq(read)));
+    REQUIRE(assembler.append(as_seq(read)));
+    REQUIRE_FALSE(assembler.can_accept());
+    REQUIRE_FALSE(assembler.append(as_seq(read).take(1)));
+
+    // pass-through hands out the data as it arrived, up to the maximum message size
+    require_message(assembler, read);
+    REQUIRE(assembler.can_accept());
+}
+
+TEST_CASE(SUITE("reports an invalid header until cleared"))
+{
+    MessageAssembler assembler(get_config(FramingType::dnp3));
+    ssp21::seq32_t next;
+
+    REQUIRE(assembler.append(as_seq({ 0x05, 0x65, 0x05, 0x00 })));
+    REQUIRE(assembler.next(next) == FramingResult::invalid);
+    REQUIRE(assembler.next(next) == FramingResult::invalid);
+
+    assembler.clear();
+    REQUIRE(assembler.next(next) == FramingResult::need_more);
+    const std::vector<uint8_t> frame = { 0x05, 0x64, 0x05, 0xC0, 0x01, 0x00, 0x0A, 0x00, 0x00, 0x00 };
+    REQUIRE(assembler.append(as_seq(frame)));
+    require_message(assembler, frame);
+}
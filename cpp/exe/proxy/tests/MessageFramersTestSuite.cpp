@@ -0,0 +1,189 @@
+#include "catch.hpp"
+
+#include "framing/MessageFramers.h"
+
+#include <vector>
+
+#define SUITE(name) "MessageFramersTestSuite - " name
+
+namespace {
+FramingResult get_length(const IMessageFramer& framer, const std::vector<uint8_t>& data, uint32_t& length)
+{
+    return framer.get_message_length(ssp21::seq32_t(data.data(), static_cast<uint32_t>(data.size())), length);
+}
+
+FramingConfig get_length_prefix_config(uint32_t offset, uint8_t size, bool big_endian, int32_t adjustment)
+{
+    FramingConfig config;
+    config.type = FramingType::length_prefix;
+    config.length_offset = offset;
+    config.length_size = size;
+    config.big_endian = big_endian;
+    config.length_adjustment = adjustment;
+    return config;
+}
+}
+
+TEST_CASE(SUITE("pass-through takes everything up to the maximum message size"))
+{
+    PassThroughFramer framer;
+    uint32_t length = 0;
+
+    REQUIRE(get_length(framer, { 0x01, 0x02, 0x03 }, length) == FramingResult::ok);
+    REQUIRE(length == 3);
+
+    const uint32_t max = IMessageFramer::max_message_size;
+    const std::vector<uint8_t> large(max + 1);
+    REQUIRE(get_length(framer, large, length) == FramingResult::ok);
+    REQUIRE(length == max);
+}
+
+TEST_CASE(SUITE("modbus needs the whole MBAP length field"))
+{
+    ModbusTcpFramer framer;
+    uint32_t length = 0;
+
+    REQUIRE(get_length(framer, {}, length) == FramingResult::need_more);
+    REQUIRE(get_length(framer, { 0x00, 0x01, 0x00, 0x00, 0x00 }, length) == FramingResult::need_more);
+}
+
+TEST_CASE(SUITE("modbus length counts the unit id and the PDU after the length field"))
+{
+    ModbusTcpFramer framer;
+    uint32_t length = 0;
+
+    REQUIRE(get_length(framer, { 0x00, 0x01, 0x00, 0x00, 0x00, 0x06 }, length) == FramingResult::ok);
+    REQUIRE(length == 12);
+
+    // smallest and largest lengths allowed
+    REQUIRE(get_length(framer, { 0x00, 0x01, 0x00, 0x00, 0x00, 0x02 }, length) == FramingResult::ok);
+    REQUIRE(length == 8);
+    REQUIRE(get_length(framer, { 0xFF, 0xFF, 0x00, 0x00, 0x00, 0xFE }, length) == FramingResult::ok);
+    REQUIRE(length == 260);
+}
+
+TEST_CASE(SUITE("modbus rejects invalid MBAP headers"))
+{
+    ModbusTcpFramer framer;
+    uint32_t length = 0;
+
+    // protocol id
+    REQUIRE(get_length(framer, { 0x00, 0x01, 0x00, 0x01, 0x00, 0x06 }, length) == FramingResult::invalid);
+    REQUIRE(get_length(framer, { 0x00, 0x01, 0x01, 0x00, 0x00, 0x06 }, length) == FramingResult::invalid);
+    // length out of range
+    REQUIRE(get_length(framer, { 0x00, 0x01, 0x00, 0x00, 0x00, 0x01 }, length) == FramingResult::invalid);
+    REQUIRE(get_length(framer, { 0x00, 0x01, 0x00, 0x00, 0x00, 0xFF }, length) == FramingResult::invalid);
+    REQUIRE(get_length(framer, { 0x00, 0x01, 0x00, 0x00, 0x01, 0x00 }, length) == FramingResult::invalid);
+}
+
+TEST_CASE(SUITE("dnp3 needs the start bytes and the length byte"))
+{
+    Dnp3Framer framer;
+    uint32_t length = 0;
+
+    REQUIRE(get_length(framer, {}, length) == FramingResult::need_more);
+    REQUIRE(get_length(framer, { 0x05, 0x64 }, length) == FramingResult::need_more);
+}
+
+TEST_CASE(SUITE("dnp3 adds a CRC for the header and every started block of user data"))
+{
+    Dnp3Framer framer;
+    uint32_t length = 0;
+
+    // header only
+    REQUIRE(get_length(framer, { 0x05, 0x64, 5 }, length) == FramingResult::ok);
+    REQUIRE(length == 10);
+
+    REQUIRE(get_length(framer, { 0x05, 0x64, 6 }, length) == FramingResult::ok);
+    REQUIRE(length == 10 + 1 + 2);
+
+    // exactly one full block, then one byte into the second
+    REQUIRE(get_length(framer, { 0x05, 0x64, 5 + 16 }, length) == FramingResult::ok);
+    REQUIRE(length == 10 + 16 + 2);
+    REQUIRE(get_length(framer, { 0x05, 0x64, 5 + 17 }, length) == FramingResult::ok);
+    REQUIRE(length == 10 + 17 + 4);
+
+    // largest frame, 250 bytes of user data in 16 blocks
+    REQUIRE(get_length(framer, { 0x05, 0x64, 0xFF }, length) == FramingResult::ok);
+    REQUIRE(length == 10 + 250 + 32);
+}
+
+TEST_CASE(SUITE("dnp3 rejects invalid link headers"))
+{
+    Dnp3Framer framer;
+    uint32_t length = 0;
+
+    REQUIRE(get_length(framer, { 0x05, 0x65, 5 }, length) == FramingResult::invalid);
+    REQUIRE(get_length(framer, { 0x04, 0x64, 5 }, length) == FramingResult::invalid);
+    REQUIRE(get_length(framer, { 0x05, 0x64, 4 }, length) == FramingResult::invalid);
+}
+
+TEST_CASE(SUITE("length prefix needs the whole field"))
+{
+    LengthPrefixFramer framer(get_length_prefix_config(2, 2, true, 0));
+    uint32_t length = 0;
+
+    REQUIRE(get_length(framer, { 0xAA, 0xBB, 0x00 }, length) == FramingResult::need_more);
+    REQUIRE(get_length(framer, { 0xAA, 0xBB, 0x00, 0x01 }, length) == FramingResult::ok);
+    REQUIRE(length == 5);
+}
+
+TEST_CASE(SUITE("length prefix reads both byte orders"))
+{
+    uint32_t length = 0;
+
+    LengthPrefixFramer big(get_length_prefix_config(0, 2, true, 0));
+    REQUIRE(get_length(big, { 0x01, 0x02 }, length) == FramingResult::ok);
+    REQUIRE(length == 2 + 0x0102);
+
+    LengthPrefixFramer little(get_length_prefix_config(0, 2, false, 0));
+    REQUIRE(get_length(little, { 0x01, 0x02 }, length) == FramingResult::ok);
+    REQUIRE(length == 2 + 0x0201);
+
+    LengthPrefixFramer single(get_length_prefix_config(1, 1, false, 0));
+    REQUIRE(get_length(single, { 0xFF, 0x07 }, length) == FramingResult::ok);
+    REQUIRE(length == 2 + 7);
+}
+
+TEST_CASE(SUITE("length prefix applies a signed adjustment"))
+{
+    uint32_t length = 0;
+
+    // the field counts itself
+    LengthPrefixFramer inclusive(get_length_prefix_config(0, 2, true, -2));
+    REQUIRE(get_length(inclusive, { 0x00, 0x06 }, length) == FramingResult::ok);
+    REQUIRE(length == 6);
+    REQUIRE(get_length(inclusive, { 0x00, 0x02 }, length) == FramingResult::ok);
+    REQUIRE(length == 2);
+
+    // would end before the field does
+    REQUIRE(get_length(inclusive, { 0x00, 0x01 }, length) == FramingResult::invalid);
+    REQUIRE(get_length(inclusive, { 0x00, 0x00 }, length) == FramingResult::invalid);
+
+    // a trailer that the field doesn't count
+    LengthPrefixFramer trailer(get_length_prefix_config(0, 1, true, 4));
+    REQUIRE(get_length(trailer, { 0x02 }, length) == FramingResult::ok);
+    REQUIRE(length == 1 + 2 + 4);
+}
+
+TEST_CASE(SUITE("length prefix rejects messages larger than the maximum"))
+{
+    const uint32_t max = IMessageFramer::max_message_size;
+    uint32_t length = 0;
+
+    LengthPrefixFramer framer(get_length_prefix_config(0, 2, true, 0));
+    const auto largest = max - 2;
+    REQUIRE(get_length(framer, { static_cast<uint8_t>(largest >> 8), static_cast<uint8_t>(largest) }, length) == FramingResult::ok);
+    REQUIRE(length == max);
+
+    const auto too_large = max - 1;
+    REQUIRE(get_length(framer, { static_cast<uint8_t>(too_large >> 8), static_cast<uint8_t>(too_large) }, length) == FramingResult::invalid);
+
+    // the value doesn't overflow
+    LengthPrefixFramer wide(get_length_prefix_config(0, 4, true, 0));
+    REQUIRE(get_length(wide, { 0xFF, 0xFF, 0xFF, 0xFF }, length) == FramingResult::invalid);
+
+    // the adjustment can't bring it back in range by wrapping around
+    LengthPrefixFramer adjusted(get_length_prefix_config(0, 4, true, -8));
+    REQUIRE(get_length(adjusted, { 0xFF, 0xFF, 0xFF, 0xFF }, length) == FramingResult::invalid);
+}
@@ -0,0 +1,104 @@
+#include "catch.hpp"
+
+#include "Session.h"
+
+#include "mocks/MockSocketWrapper.h"
+#include "mocks/MockStack.h"
+
+#include <exe4cpp/MockExecutor.h>
+#include <log4cpp/MockLogHandler.h>
+
+#define SUITE(name) "SessionTestSuite - " name
+
+namespace {
+struct Fixture {
+    Fixture()
+        : log("session")
+        , exe(std::make_shared<exe4cpp::MockExecutor>())
+    {
+        auto lower_socket = std::make_unique<MockSocketWrapper>();
+        auto upper_socket = std::make_unique<MockSocketWrapper>();
+        this->lower_socket = lower_socket.get();
+        this->upper_socket = upper_socket.get();
+
+        this->session = Session::create(
+            1,
+            []() {},
+            this->exe,
+            std::move(lower_socket),
+            std::make_unique<AsioLowerLayer>(this->log.logger),
+            std::move(upper_socket),
+            std::make_unique<AsioUpperLayer>(this->log.logger),
+            std::make_shared<MockStack>());
+
+        // both sockets start reading
+        this->session->start();
+    }
+
+    void shutdown()
+    {
+        this->session->shutdown([this](const exe4cpp::duration_t&, bool deadline_exceeded) {
+            ++this->num_closed;
+            this->is_deadline_exceeded = deadline_exceeded;
+        });
+    }
+
+    log4cpp::MockLogHandler log;
+    const std::shared_ptr<exe4cpp::MockExecutor> exe;
+    MockSocketWrapper* lower_socket = nullptr;
+    MockSocketWrapper* upper_socket = nullptr;
+    std::shared_ptr<Session> session;
+
+    uint32_t num_closed = 0;
+    bool is_deadline_exceeded = false;
+};
+}
+
+TEST_CASE(SUITE("closes once both sockets are idle"))
+{
+    Fixture fix;
+    fix.upper_socket->complete_rx();
+    fix.lower_socket->complete_rx();
+
+    fix.shutdown();
+    REQUIRE(fix.exe->run_many() == 1);
+    REQUIRE(fix.num_closed == 1);
+    REQUIRE_FALSE(fix.is_deadline_exceeded);
+}
+
+TEST_CASE(SUITE("an idle socket doesn't re-check while the other one is busy"))
+{
+    Fixture fix;
+    fix.upper_socket->complete_rx();
+    fix.lower_socket->start_tx_to_socket(ssp21::seq32_t::empty());
+
+    fix.shutdown();
+    REQUIRE(fix.exe->run_many() == 0);
+
+    // the lower socket is still reading
+    fix.lower_socket->complete_tx();
+    REQUIRE(fix.exe->run_many() == 0);
+    REQUIRE(fix.num_closed == 0);
+
+    fix.lower_socket->complete_rx();
+    REQUIRE(fix.exe->run_many() == 1);
+    REQUIRE(fix.num_closed == 1);
+    REQUIRE_FALSE(fix.is_deadline_exceeded);
+}
+
+TEST_CASE(SUITE("watches a socket again if it started another operation before the check"))
+{
+    Fixture fix;
+    fix.upper_socket->complete_rx();
+
+    fix.shutdown();
+    fix.lower_socket->complete_rx();
+    fix.lower_socket->start_rx_from_socket();
+
+    REQUIRE(fix.exe->run_many() == 1);
+    REQUIRE(fix.num_closed == 0);
+
+    fix.lower_socket->complete_rx();
+    REQUIRE(fix.exe->run_many() == 1);
+    REQUIRE(fix.num_closed == 1);
+}
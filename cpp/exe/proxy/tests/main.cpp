@@ -0,0 +1,13 @@
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "sodium/Backend.h"
+
+int main(int argc, char* argv[])
+{
+    // the allocation tests run real stacks
+    ssp21::sodium::initialize();
+
+    return Catch::Session().run(argc, argv);
+}
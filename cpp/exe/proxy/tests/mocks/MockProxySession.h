@@ -0,0 +1,61 @@
+#ifndef SSP21PROXY_MOCKPROXYSESSION_H
+#define SSP21PROXY_MOCKPROXYSESSION_H
+
+#include "IProxySession.h"
+
+#include <memory>
+
+// records what is asked of it in a state that outlives the session
+class MockProxySession final : public IProxySession {
+
+public:
+    struct State {
+        bool is_started = false;
+        bool is_draining = false;
+        // set by the test once a draining session may be released
+        bool is_drained = false;
+        bool is_released = false;
+        log4cpp::LogLevels levels;
+        uint32_t num_stack_factory_updates = 0;
+    };
+
+    explicit MockProxySession(const std::shared_ptr<State>& state)
+        : state(state)
+    {
+    }
+
+    ~MockProxySession() override
+    {
+        this->state->is_released = true;
+    }
+
+    void start() override
+    {
+        this->state->is_started = true;
+    }
+
+    void drain() override
+    {
+        this->state->is_draining = true;
+    }
+
+    bool is_drained() const override
+    {
+        return this->state->is_draining && this->state->is_drained;
+    }
+
+    void set_log_levels(log4cpp::LogLevels levels) override
+    {
+        this->state->levels = levels;
+    }
+
+    void set_stack_factory(const StackFactory& factory) override
+    {
+        ++this->state->num_stack_factory_updates;
+    }
+
+private:
+    const std::shared_ptr<State> state;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef SSP21PROXY_MOCKSOCKETWRAPPER_H
+#define SSP21PROXY_MOCKSOCKETWRAPPER_H
+
+#include "IAsioSocketWrapper.h"
+
+// operations stay outstanding until the test completes them
+class MockSocketWrapper final : public IAsioSocketWrapper {
+
+public:
+    bool start_rx_from_socket() override
+    {
+        if (this->is_rx_active) {
+            return false;
+        }
+        this->is_rx_active = true;
+        return true;
+    }
+
+    bool start_tx_to_socket(const ssp21::seq32_t& data) override
+    {
+        if (this->is_tx_active) {
+            return false;
+        }
+        this->is_tx_active = true;
+        return true;
+    }
+
+    bool try_close_socket() override
+    {
+        ++this->num_close;
+        return true;
+    }
+
+    bool get_is_tx_active() const override
+    {
+        return this->is_tx_active;
+    }
+
+    bool get_is_rx_active() const override
+    {
+        return this->is_rx_active;
+    }
+
+    void complete_rx()
+    {
+        this->is_rx_active = false;
+        this->notify_if_inactive();
+    }
+
+    void complete_tx()
+    {
+        this->is_tx_active = false;
+        this->notify_if_inactive();
+    }
+
+    uint32_t num_close = 0;
+
+private:
+    bool is_rx_active = false;
+    bool is_tx_active = false;
+};
+
+#endif
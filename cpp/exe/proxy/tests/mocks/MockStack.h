@@ -0,0 +1,39 @@
+#ifndef SSP21PROXY_MOCKSTACK_H
+#define SSP21PROXY_MOCKSTACK_H
+
+#include <ssp21/stack/IStack.h>
+
+// accepts everything and never produces data
+class MockStack final : public ssp21::IStack {
+
+public:
+    void bind(ssp21::ILowerLayer& lower, ssp21::IUpperLayer& upper) override {}
+
+    bool is_tx_ready() const override
+    {
+        return true;
+    }
+
+    bool start_tx_from_upper(const ssp21::seq32_t& data) override
+    {
+        return true;
+    }
+
+private:
+    void discard_rx_data() override {}
+
+    ssp21::seq32_t start_rx_from_upper_impl() override
+    {
+        return ssp21::seq32_t::empty();
+    }
+
+    void on_lower_open_impl() override {}
+
+    void on_lower_close_impl() override {}
+
+    void on_lower_tx_ready_impl() override {}
+
+    void on_lower_rx_ready_impl() override {}
+};
+
+#endif
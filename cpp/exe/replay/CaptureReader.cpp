@@ -0,0 +1,75 @@
+#include "CaptureReader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+CaptureReader::CaptureReader(const std::string& path)
+{
+    const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("unable to open " + path + ": " + strerror(errno));
+    }
+
+    struct stat info {
+    };
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(capture::FileHeader))) {
+        ::close(fd);
+        throw std::runtime_error("not a capture file: " + path);
+    }
+
+    this->size = static_cast<size_t>(info.st_size);
+    const auto mapping = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid once the descriptor is closed
+    ::close(fd);
+
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("unable to map " + path + ": " + strerror(errno));
+    }
+
+    this->base = static_cast<const uint8_t*>(mapping);
+
+    // the records are only ever read front to back
+    madvise(mapping, this->size, MADV_SEQUENTIAL);
+
+    const auto header = reinterpret_cast<const capture::FileHeader*>(this->base);
+    if (memcmp(header->magic, capture::file_magic, sizeof(header->magic)) != 0 || header->version != capture::file_version || header->header_size != sizeof(capture::FileHeader)) {
+        munmap(mapping, this->size);
+        throw std::runtime_error("not a version " + std::to_string(capture::file_version) + " capture file: " + path);
+    }
+
+    this->index();
+}
+
+CaptureReader::~CaptureReader()
+{
+    munmap(const_cast<uint8_t*>(this->base), this->size);
+}
+
+void CaptureReader::index()
+{
+    size_t offset = sizeof(capture::FileHeader);
+
+    while (offset < this->size) {
+        if (this->size - offset < sizeof(capture::RecordHeader)) {
+            this->truncated = true;
+            return;
+        }
+
+        const auto header = reinterpret_cast<const capture::RecordHeader*>(this->base + offset);
+        const auto record_size = sizeof(capture::RecordHeader) + capture::get_padded_length(header->length);
+
+        if (this->size - offset < record_size) {
+            this->truncated = true;
+            return;
+        }
+
+        this->records.push_back(Record{ header, ssp21::seq32_t(this->base + offset + sizeof(capture::RecordHeader), header->length) });
+        offset += record_size;
+    }
+}
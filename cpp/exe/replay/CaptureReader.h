@@ -0,0 +1,60 @@
+#ifndef SSP21REPLAY_CAPTUREREADER_H
+#define SSP21REPLAY_CAPTUREREADER_H
+
+#include "capture/CaptureFormat.h"
+
+#include <ser4cpp/util/Uncopyable.h>
+#include <ssp21/util/SequenceTypes.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Maps a capture file into memory and indexes its records.
+ *
+ * The records point into the mapping, so they are only valid for the lifetime of the reader.
+ */
+class CaptureReader final : private ser4cpp::Uncopyable {
+public:
+    struct Record {
+        const capture::RecordHeader* header;
+        ssp21::seq32_t data;
+
+        capture::RecordType get_type() const
+        {
+            return static_cast<capture::RecordType>(this->header->type);
+        }
+    };
+
+    // throws std::runtime_error if the file can't be mapped or isn't a capture file
+    explicit CaptureReader(const std::string& path);
+
+    ~CaptureReader();
+
+    const std::vector<Record>& get_records() const
+    {
+        return this->records;
+    }
+
+    // set if the file ends in the middle of a record, e.g. because the proxy was killed
+    bool is_truncated() const
+    {
+        return this->truncated;
+    }
+
+    size_t get_file_size() const
+    {
+        return this->size;
+    }
+
+private:
+    void index();
+
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    std::vector<Record> records;
+    bool truncated = false;
+};
+
+#endif
@@ -0,0 +1,233 @@
+#include "Replayer.h"
+
+#include "crypto/SessionModes.h"
+#include "crypto/gen/Function.h"
+#include "crypto/gen/RequestHandshakeBegin.h"
+#include "crypto/gen/SessionData.h"
+
+#include <ssp21/link/LinkConstants.h>
+
+#include <cstring>
+#include <thread>
+
+using namespace ssp21;
+
+Replayer::SessionState::SessionState(LinkParser::IReporter& reporter, bool uses_link_layer)
+    : uses_link_layer(uses_link_layer)
+    , rx_parser(consts::link::max_config_payload_size, reporter)
+    , tx_parser(consts::link::max_config_payload_size, reporter)
+    , mode(SessionModes::default_mode())
+{
+}
+
+Replayer::Replayer(const Options& options)
+    : options(options)
+    , decrypt_buffer(consts::link::max_config_payload_size)
+{
+}
+
+std::chrono::steady_clock::duration Replayer::replay(const CaptureReader& reader)
+{
+    // every pass starts from the beginning of the sessions
+    this->sessions.clear();
+
+    const auto& records = reader.get_records();
+    const auto start = std::chrono::steady_clock::now();
+
+    if (records.empty()) {
+        return std::chrono::steady_clock::duration::zero();
+    }
+
+    const auto first_timestamp = records.front().header->timestamp_ns;
+
+    for (const auto& record : records) {
+        if (this->options.original_timing && record.header->timestamp_ns > first_timestamp) {
+            // the records of different workers may be slightly out of order, those are replayed without waiting
+            const auto offset = std::chrono::nanoseconds(static_cast<int64_t>((record.header->timestamp_ns - first_timestamp) / this->options.speed));
+            std::this_thread::sleep_until(start + offset);
+        }
+
+        this->process(record);
+    }
+
+    return std::chrono::steady_clock::now() - start;
+}
+
+void Replayer::process(const CaptureReader::Record& record)
+{
+    ++this->counters.num_records;
+
+    const auto id = record.header->session_id;
+
+    if (record.get_type() == capture::RecordType::session_open) {
+        this->open_session(id, record.data);
+        return;
+    }
+
+    const auto iter = this->sessions.find(id);
+    if (iter == this->sessions.end()) {
+        // recorded while the file was reopened, or the open record was lost
+        return;
+    }
+
+    switch (record.get_type()) {
+    case (capture::RecordType::rx):
+        this->process_chunk(*iter->second, true, record.data);
+        break;
+    case (capture::RecordType::tx):
+        this->process_chunk(*iter->second, false, record.data);
+        break;
+    case (capture::RecordType::session_keys):
+        this->set_keys(*iter->second, record.data);
+        break;
+    case (capture::RecordType::session_close):
+        this->sessions.erase(iter);
+        break;
+    default:
+        break;
+    }
+}
+
+void Replayer::open_session(uint64_t id, const seq32_t& data)
+{
+    if (data.length() < sizeof(capture::SessionInfo)) {
+        return;
+    }
+
+    capture::SessionInfo info{};
+    memcpy(&info, static_cast<const uint8_t*>(data), sizeof(info));
+
+    ++this->counters.num_sessions;
+    this->sessions[id] = std::make_unique<SessionState>(*this, info.uses_link_layer != 0);
+}
+
+void Replayer::set_keys(SessionState& session, const seq32_t& data)
+{
+    if (data.length() < sizeof(capture::SessionKeysInfo)) {
+        return;
+    }
+
+    capture::SessionKeysInfo info{};
+    memcpy(&info, static_cast<const uint8_t*>(data), sizeof(info));
+
+    if (info.rx_key_length != consts::crypto::symmetric_key_length || info.tx_key_length != consts::crypto::symmetric_key_length || data.length() < sizeof(info) + info.rx_key_length + info.tx_key_length) {
+        return;
+    }
+
+    const auto rx_key = data.skip(sizeof(info)).take(info.rx_key_length);
+    const auto tx_key = data.skip(sizeof(info) + info.rx_key_length).take(info.tx_key_length);
+
+    auto keys = std::make_unique<Keys>();
+    keys->rx_key.as_wseq().copy_from(rx_key);
+    keys->rx_key.set_length(BufferLength::length_32);
+    keys->tx_key.as_wseq().copy_from(tx_key);
+    keys->tx_key.set_length(BufferLength::length_32);
+
+    session.previous_keys = std::move(session.keys);
+    session.keys = std::move(keys);
+}
+
+void Replayer::process_chunk(SessionState& session, bool is_rx, seq32_t data)
+{
+    this->counters.num_bytes += data.length();
+
+    if (!session.uses_link_layer) {
+        // without the link-layer every chunk is a whole message
+        this->process_message(session, is_rx, data);
+        return;
+    }
+
+    auto& parser = is_rx ? session.rx_parser : session.tx_parser;
+
+    while (data.is_not_empty()) {
+        if (!parser.parse(data)) {
+            continue;
+        }
+
+        LinkParser::Result result;
+        parser.read(result);
+        ++this->counters.num_frames;
+        this->process_message(session, is_rx, result.payload);
+        parser.reset();
+    }
+}
+
+void Replayer::process_message(SessionState& session, bool is_rx, const seq32_t& message)
+{
+    if (message.is_empty()) {
+        return;
+    }
+
+    switch (FunctionSpec::from_type(message[0])) {
+    case (Function::request_handshake_begin): {
+        ++this->counters.num_handshake_messages;
+        RequestHandshakeBegin request;
+        if (any(request.read(message))) {
+            ++this->counters.num_parse_errors;
+            return;
+        }
+        // the initiator proposes the session mode and the responder either uses it or replies with an error
+        session.mode = (request.spec.session_crypto_mode == SessionCryptoMode::aes_256_gcm) ? SessionModes::aes_256_gcm() : SessionModes::hmac_sha_256_trunc16();
+        return;
+    }
+    case (Function::session_data):
+        break;
+    case (Function::undefined):
+        ++this->counters.num_parse_errors;
+        return;
+    default:
+        ++this->counters.num_handshake_messages;
+        return;
+    }
+
+    ++this->counters.num_session_messages;
+
+    SessionData data;
+    if (any(data.read(message))) {
+        ++this->counters.num_parse_errors;
+        return;
+    }
+
+    if (!session.keys) {
+        ++this->counters.num_without_keys;
+        return;
+    }
+
+    if (this->try_decrypt(session.mode, is_rx ? session.keys->rx_key : session.keys->tx_key, data)) {
+        return;
+    }
+
+    if (session.previous_keys && this->try_decrypt(session.mode, is_rx ? session.previous_keys->rx_key : session.previous_keys->tx_key, data)) {
+        return;
+    }
+
+    ++this->counters.num_auth_failures;
+}
+
+bool Replayer::try_decrypt(const SessionMode& mode, const SymmetricKey& key, const SessionData& message)
+{
+    std::error_code ec;
+    const auto payload = mode.read(key, message, wseq32_t(this->decrypt_buffer.data(), static_cast<uint32_t>(this->decrypt_buffer.size())), ec);
+    if (ec) {
+        return false;
+    }
+
+    ++this->counters.num_decrypted;
+    this->counters.num_decrypted_bytes += payload.length();
+    return true;
+}
+
+void Replayer::on_bad_header_crc(uint32_t expected, uint32_t actual)
+{
+    ++this->counters.num_bad_frames;
+}
+
+void Replayer::on_bad_body_crc(uint32_t expected, uint32_t actual)
+{
+    ++this->counters.num_bad_frames;
+}
+
+void Replayer::on_bad_body_length(uint32_t max_allowed, uint32_t actual)
+{
+    ++this->counters.num_bad_frames;
+}
@@ -0,0 +1,101 @@
+#ifndef SSP21REPLAY_REPLAYER_H
+#define SSP21REPLAY_REPLAYER_H
+
+#include "CaptureReader.h"
+
+#include "crypto/SessionMode.h"
+#include "link/LinkParser.h"
+
+#include <ssp21/crypto/BufferTypes.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * Feeds the records of a capture through the parsers of the stack.
+ *
+ * Link-layer frames are reassembled with LinkParser, session messages are parsed with
+ * SessionData::read and, if the capture contains the session keys, authenticated and decrypted
+ * with the SessionMode negotiated by the captured handshake. Only the parsing and cryptography
+ * are exercised, nonces and session times aren't validated.
+ */
+class Replayer final : private ssp21::LinkParser::IReporter {
+
+public:
+    struct Options {
+        // sleep to reproduce the gaps between the records, divided by the speed
+        bool original_timing = false;
+        double speed = 1.0;
+    };
+
+    struct Counters {
+        uint64_t num_records = 0;
+        uint64_t num_sessions = 0;
+        uint64_t num_bytes = 0;
+        uint64_t num_frames = 0;
+        uint64_t num_bad_frames = 0;
+        uint64_t num_handshake_messages = 0;
+        uint64_t num_session_messages = 0;
+        uint64_t num_parse_errors = 0;
+        uint64_t num_decrypted = 0;
+        uint64_t num_decrypted_bytes = 0;
+        uint64_t num_auth_failures = 0;
+        // session messages of sessions without keys in the capture
+        uint64_t num_without_keys = 0;
+    };
+
+    explicit Replayer(const Options& options);
+
+    // replays every record of the capture once, the counters accumulate over calls
+    std::chrono::steady_clock::duration replay(const CaptureReader& reader);
+
+    const Counters& get_counters() const
+    {
+        return this->counters;
+    }
+
+private:
+    struct Keys {
+        ssp21::SymmetricKey rx_key;
+        ssp21::SymmetricKey tx_key;
+    };
+
+    struct SessionState {
+        SessionState(ssp21::LinkParser::IReporter& reporter, bool uses_link_layer);
+
+        const bool uses_link_layer;
+        ssp21::LinkParser rx_parser;
+        ssp21::LinkParser tx_parser;
+        ssp21::SessionMode mode;
+        // messages sent just before a renegotiation completes still use the previous keys
+        std::unique_ptr<Keys> keys;
+        std::unique_ptr<Keys> previous_keys;
+    };
+
+    void process(const CaptureReader::Record& record);
+
+    void open_session(uint64_t id, const ssp21::seq32_t& data);
+
+    void set_keys(SessionState& session, const ssp21::seq32_t& data);
+
+    void process_chunk(SessionState& session, bool is_rx, ssp21::seq32_t data);
+
+    void process_message(SessionState& session, bool is_rx, const ssp21::seq32_t& message);
+
+    bool try_decrypt(const ssp21::SessionMode& mode, const ssp21::SymmetricKey& key, const ssp21::SessionData& message);
+
+    // LinkParser::IReporter
+    void on_bad_header_crc(uint32_t expected, uint32_t actual) override;
+    void on_bad_body_crc(uint32_t expected, uint32_t actual) override;
+    void on_bad_body_length(uint32_t max_allowed, uint32_t actual) override;
+
+    const Options options;
+    Counters counters;
+    std::map<uint64_t, std::unique_ptr<SessionState>> sessions;
+    std::vector<uint8_t> decrypt_buffer;
+};
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * Replays a frame capture recorded by the proxy through the parsers and session modes of the stack.
+ *
+ * At maximum speed the capture is a reproducible benchmark of parsing and decrypting real traffic
+ * and a workload to profile offline. With --timing the gaps between the records are reproduced.
+ */
+
+#include "CaptureReader.h"
+#include "Replayer.h"
+
+#include <sodium/Backend.h>
+
+#include <argagg/argagg.hpp>
+
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+double per_second(uint64_t count, double seconds)
+{
+    return (seconds > 0) ? static_cast<double>(count) / seconds : 0.0;
+}
+
+void print_report(const CaptureReader& reader, const Replayer::Counters& counters, uint32_t passes, double seconds)
+{
+    printf("\n%zu records in %.1f MB, %u pass(es) in %.3f s%s\n\n",
+           reader.get_records().size(),
+           static_cast<double>(reader.get_file_size()) / 1e6,
+           passes,
+           seconds,
+           reader.is_truncated() ? ", the last record is truncated" : "");
+
+    printf("sessions      %12llu\n", static_cast<unsigned long long>(counters.num_sessions));
+    printf("bytes         %12llu  %12.1f MB/s\n",
+           static_cast<unsigned long long>(counters.num_bytes),
+           per_second(counters.num_bytes, seconds) / 1e6);
+    printf("frames        %12llu  %12.1f /s  %llu bad\n",
+           static_cast<unsigned long long>(counters.num_frames),
+           per_second(counters.num_frames, seconds),
+           static_cast<unsigned long long>(counters.num_bad_frames));
+    printf("handshake     %12llu\n", static_cast<unsigned long long>(counters.num_handshake_messages));
+    printf("session data  %12llu  %12.1f /s  %llu failed to parse\n",
+           static_cast<unsigned long long>(counters.num_session_messages),
+           per_second(counters.num_session_messages, seconds),
+           static_cast<unsigned long long>(counters.num_parse_errors));
+    printf("decrypted     %12llu  %12.1f /s  %llu failed to authenticate, %llu without keys\n",
+           static_cast<unsigned long long>(counters.num_decrypted),
+           per_second(counters.num_decrypted, seconds),
+           static_cast<unsigned long long>(counters.num_auth_failures),
+           static_cast<unsigned long long>(counters.num_without_keys));
+    printf("\n");
+}
+}
+
+int main(int argc, char* argv[])
+{
+    argagg::parser parser{ {
+        { "help", { "-h", "--help" }, "shows this help message", 0 },
+        { "timing", { "-t", "--timing" }, "reproduce the original gaps between the records instead of replaying at maximum speed", 0 },
+        { "speed", { "-s", "--speed" }, "with --timing, replay this many times faster - defaults to 1", 1 },
+        { "repeat", { "-r", "--repeat" }, "number of passes over the capture - defaults to 1", 1 },
+    } };
+
+    try {
+        const auto results = parser.parse(argc, argv);
+
+        if (results.has_option("help")) {
+            std::cout << "usage: replay [options] <capture file>" << std::endl
+                      << std::endl
+                      << parser << std::endl;
+            return 0;
+        }
+
+        if (results.pos.size() != 1) {
+            throw std::runtime_error("expected the path of a single capture file");
+        }
+
+        Replayer::Options options;
+        options.original_timing = results.has_option("timing");
+        if (results.has_option("speed"))
+            options.speed = results["speed"].as<double>();
+        const auto passes = results.has_option("repeat") ? results["repeat"].as<uint32_t>() : 1u;
+
+        if (options.speed <= 0 || passes == 0) {
+            throw std::runtime_error("speed and repeat must be greater than zero");
+        }
+
+        ssp21::sodium::initialize();
+
+        const CaptureReader reader(results.pos.front());
+        Replayer replayer(options);
+
+        std::chrono::steady_clock::duration elapsed{};
+        for (uint32_t i = 0; i < passes; ++i) {
+            elapsed += replayer.replay(reader);
+        }
+
+        print_report(reader, replayer.get_counters(), passes, std::chrono::duration<double>(elapsed).count());
+
+        return 0;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl
+                  << std::endl;
+        std::cout << parser << std::endl;
+        return -1;
+    }
+}
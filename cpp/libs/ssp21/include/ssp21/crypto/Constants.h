@@ -41,6 +41,7 @@ namespace consts {
         namespace initiator {
             const exe4cpp::duration_t default_response_timeout = std::chrono::seconds(2);
             const exe4cpp::duration_t default_retry_timeout = std::chrono::seconds(5);
+            const exe4cpp::duration_t default_max_retry_timeout = default_retry_timeout; // no backoff
 
             const uint16_t default_max_nonce = 32768;
             const uint16_t default_nonce_renegotiation_trigger = default_max_nonce - 128;
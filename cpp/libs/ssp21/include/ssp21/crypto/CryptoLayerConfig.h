@@ -3,11 +3,21 @@
 #define SSP21_CRYPTOLAYERCONFIG_H
 
 #include <cstdint>
+#include <functional>
+#include <vector>
 
 #include "ssp21/crypto/Constants.h"
+#include "ssp21/crypto/gen/SessionCompressionMode.h"
+#include "ssp21/util/SequenceTypes.h"
 
 namespace ssp21 {
 
+/**
+ * Receives the rx and tx keys of every session as it is initialized, e.g. so that captured traffic
+ * can be decrypted offline. Anyone holding the keys can read and forge the messages of the session.
+ */
+using session_keys_handler_t = std::function<void(const seq32_t& rx_key, const seq32_t& tx_key)>;
+
 struct SessionConfig {
     SessionConfig() {}
 
@@ -18,16 +28,30 @@ struct SessionConfig {
 
     // the TTL padding added to the current session time of every message
     uint32_t ttl_pad_ms = consts::crypto::default_ttl_pad_ms;
+
+    // not set by default, the keys never leave the session
+    session_keys_handler_t on_session_keys;
 };
 
 struct CryptoLayerConfig {
     // The maximum size of the payload data
     uint16_t max_payload_size = consts::link::max_config_payload_size;
+
+    // How many decrypted payloads can wait for the upper layer. With more than one, the layer keeps
+    // reading and authenticating frames while the upper layer is still busy with earlier payloads.
+    uint16_t max_rx_queue_count = 1;
+
+    // Bytes shared by the queued payloads, zero sizes them for max_rx_queue_count payloads of max_payload_size.
+    // Reading stops when a payload of max_payload_size wouldn't fit.
+    uint32_t max_rx_queue_bytes = 0;
 };
 
 struct ResponderConfig {
     CryptoLayerConfig config;
     SessionConfig session;
+
+    // compression modes an initiator may request besides none, handshakes requesting any other are refused
+    std::vector<SessionCompressionMode> allowed_compression_modes;
 };
 
 struct SessionLimits {
@@ -47,11 +71,33 @@ struct InitiatorConfig {
         /// How long the initiator will wait before retrying a failed timeout
         exe4cpp::duration_t retry_timeout = consts::crypto::initiator::default_retry_timeout;
 
+        /// The retry timeout doubles after each consecutive failed handshake up to this value
+        exe4cpp::duration_t max_retry_timeout = consts::crypto::initiator::default_max_retry_timeout;
+
+        /// Wait a random time between zero and the retry timeout ("full jitter") so that initiators don't retry in lock-step
+        bool retry_jitter = false;
+
         /// The initiator will begin renegotiating when the session time reaches this value
         uint32_t session_time_renegotiation_trigger_ms = consts::crypto::initiator::default_session_time_renegotiation_trigger_ms;
 
+        /// Each session's time trigger is brought forward by a random amount up to this value
+        uint32_t session_time_renegotiation_spread_ms = 0;
+
         /// The initiator will begin renegotiating when either nonce value reaches this trigger level
         uint16_t nonce_renegotiation_trigger_value = consts::crypto::initiator::default_nonce_renegotiation_trigger;
+
+        /// Each session's nonce trigger is lowered by a random amount up to this value
+        uint16_t nonce_renegotiation_spread = 0;
+
+        /// Seeds the generator behind the jitter and spreads, zero seeds it from std::random_device
+        uint32_t random_seed = 0;
+
+        /// Upper layer data of up to this many bytes is accepted before the session is open and sent with
+        /// the session auth message, saving a round trip. It's encrypted with the new session keys, but goes
+        /// out before the responder has proven that it holds them. Early data is sent at most once: if the
+        /// handshake that carried it fails, it's dropped and the upper layer is told with
+        /// @ref IUpperLayer::on_lower_tx_dropped(). Zero disables early data.
+        uint16_t max_early_data_size = 0;
     };
 
     Params params;
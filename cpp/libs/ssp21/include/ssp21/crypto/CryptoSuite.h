@@ -5,6 +5,7 @@
 #include "ssp21/crypto/gen/HandshakeEphemeral.h"
 #include "ssp21/crypto/gen/HandshakeHash.h"
 #include "ssp21/crypto/gen/HandshakeKDF.h"
+#include "ssp21/crypto/gen/SessionCompressionMode.h"
 #include "ssp21/crypto/gen/SessionCryptoMode.h"
 #include "ssp21/crypto/gen/SessionNonceMode.h"
 
@@ -32,6 +33,7 @@ struct CryptoSuite {
     HandshakeKDF handshake_kdf = HandshakeKDF::hkdf_sha256;
     SessionNonceMode session_nonce_mode = SessionNonceMode::strict_increment;
     SessionCryptoMode session_crypto_mode = SessionCryptoMode::hmac_sha256_16;
+    SessionCompressionMode session_compression_mode = SessionCompressionMode::none;
 };
 
 struct DHCryptoSuite {
@@ -14,6 +14,11 @@ public:
         ++value;
     }
 
+    inline void add(uint64_t count)
+    {
+        value += count;
+    }
+
     operator const uint64_t &() const
     {
         return value;
@@ -27,6 +32,8 @@ struct SessionStatistics {
     Statistic num_ttl_expiration;
     Statistic num_nonce_fail;
     Statistic num_success;
+    // user data bytes that compression kept off the wire
+    Statistic num_bytes_saved_by_compression;
 };
 
 }
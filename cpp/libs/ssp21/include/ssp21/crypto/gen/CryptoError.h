@@ -60,7 +60,9 @@ enum class CryptoError : uint8_t
     /// AEAD encryption failed in the underlying implementation
     aead_encrypt_fail = 0xF,
     /// AEAD authentication failed in the underlying implementation
-    aead_decrypt_fail = 0x10
+    aead_decrypt_fail = 0x10,
+    /// Authenticated user data could not be decompressed
+    bad_compressed_data = 0x11
 };
 
 struct CryptoErrorSpec : private ser4cpp::StaticOnly
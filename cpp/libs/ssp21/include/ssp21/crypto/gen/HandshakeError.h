@@ -54,6 +54,8 @@ enum class HandshakeError : uint8_t
     no_prior_handshake_begin = 0xC,
     /// In QKD mode, the requested key id was not found
     key_not_found = 0xD,
+    /// The requested session compression mode is not supported
+    unsupported_compression_mode = 0xE,
     /// This value gets used internally in ssp21-cpp only
     none = 0xFD,
     /// value not defined
@@ -0,0 +1,48 @@
+//
+//  _   _         ______    _ _ _   _             _ _ _
+// | \ | |       |  ____|  | (_) | (_)           | | | |
+// |  \| | ___   | |__   __| |_| |_ _ _ __   __ _| | | |
+// | . ` |/ _ \  |  __| / _` | | __| | '_ \ / _` | | | |
+// | |\  | (_) | | |___| (_| | | |_| | | | | (_| |_|_|_|
+// |_| \_|\___/  |______\__,_|_|\__|_|_| |_|\__, (_|_|_)
+//                                           __/ |
+//                                          |___/
+//
+// This file is auto-generated. Do not edit manually
+//
+// Licensed under the terms of the BSDv3 license
+//
+
+#ifndef SSP21_SESSIONCOMPRESSIONMODE_H
+#define SSP21_SESSIONCOMPRESSIONMODE_H
+
+#include <cstdint>
+#include "ser4cpp/util/Uncopyable.h"
+
+namespace ssp21 {
+
+/**
+    Specifies how user data is compressed before it is encrypted
+*/
+enum class SessionCompressionMode : uint8_t
+{
+    /// User data is sent as is
+    none = 0x0,
+    /// LZ77 with a 1KB window, primed with a dictionary of common SCADA protocol headers
+    lz_scada = 0x1,
+    /// value not defined
+    undefined = 0xFF
+};
+
+struct SessionCompressionModeSpec : private ser4cpp::StaticOnly
+{
+    using enum_type_t = SessionCompressionMode;
+
+    static uint8_t to_type(SessionCompressionMode arg);
+    static SessionCompressionMode from_type(uint8_t arg);
+    static const char* to_string(SessionCompressionMode arg);
+};
+
+}
+
+#endif
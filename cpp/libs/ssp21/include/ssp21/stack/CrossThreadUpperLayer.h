@@ -0,0 +1,145 @@
+#ifndef SSP21_CROSSTHREADUPPERLAYER_H
+#define SSP21_CROSSTHREADUPPERLAYER_H
+
+/** @file
+ * @brief Class @ref ssp21::CrossThreadUpperLayer.
+ */
+
+#include "ssp21/link/LinkConstants.h"
+#include "ssp21/stack/ILowerLayer.h"
+#include "ssp21/stack/IUpperLayer.h"
+#include "ssp21/util/MPSCQueue.h"
+#include "ssp21/util/SPSCQueue.h"
+
+#include "exe4cpp/IExecutor.h"
+#include "ser4cpp/util/Uncopyable.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace ssp21 {
+
+/**
+ * @brief Upper layer that lets other threads exchange data with a stack running on an executor.
+ *
+ * A stack and its layers must only be called on the thread of their executor. Bind this layer as
+ * the upper layer of a stack and any thread may submit messages with @ref try_send(). They're copied
+ * into a lock-free ring of pre-sized slots that the executor thread drains in batches: up to
+ * @ref ILowerLayer::max_tx_slices messages are handed to the stack in a single gather transmit, and
+ * their slots are only released once the stack has transmitted them. A producer only posts to the
+ * executor when the ring goes from idle to having work, not once per message.
+ *
+ * Like any upper layer data, submitted messages form a byte stream. Their boundaries aren't preserved.
+ *
+ * Received data is copied into a single producer, single consumer ring that one consumer thread reads
+ * with @ref try_receive(). While that ring is full, data is left in the stack until the consumer
+ * catches up.
+ *
+ * The layer must outlive the stack it's bound to, which @ref create() and the shared pointers held by
+ * the posted work take care of as long as the caller keeps its own pointer while the stack is bound.
+ */
+class CrossThreadUpperLayer final : public IUpperLayer, public std::enable_shared_from_this<CrossThreadUpperLayer>, private ser4cpp::Uncopyable {
+
+    struct Message {
+        std::vector<uint8_t> data;
+        uint32_t length = 0;
+    };
+
+public:
+    struct Config {
+        /// Messages that producers can submit before the stack takes them
+        uint32_t tx_slot_count = 64;
+        /// Largest message accepted by @ref try_send()
+        uint32_t tx_slot_size = 1024;
+        /// Chunks of received data buffered for the consumer
+        uint32_t rx_slot_count = 64;
+        /// Received payloads larger than this are delivered in several chunks
+        uint32_t rx_slot_size = consts::link::max_config_payload_size;
+    };
+
+    /// Called on the executor thread once received data was added to the ring, e.g. to wake the consumer
+    using rx_ready_handler_t = std::function<void()>;
+
+    static std::shared_ptr<CrossThreadUpperLayer> create(const std::shared_ptr<exe4cpp::IExecutor>& executor, const Config& config, const rx_ready_handler_t& on_rx_ready = nullptr);
+
+    /**
+     * @brief Set the stack this layer is the upper layer of. Must be called on the executor thread.
+     */
+    void bind(ILowerLayer& stack);
+
+    /**
+     * @brief Copy a message into the transmit ring. Safe to call from any thread.
+     * @return @cpp false @ce if the message is empty or larger than a slot, or if the ring is full
+     */
+    bool try_send(const seq32_t& message);
+
+    /**
+     * @brief Read the oldest chunk of received data in place. Must only be called from one consumer thread.
+     * @param reader Invoked with the data, which is only valid during the call
+     * @return @cpp false @ce if there is no received data, in which case the reader is not invoked
+     */
+    template <class Reader>
+    bool try_receive(const Reader& reader)
+    {
+        const auto result = this->rx_ring.try_pop([&reader](const Message& message) {
+            reader(seq32_t(message.data.data(), message.length));
+        });
+
+        if (result) {
+            this->on_rx_slot_released();
+        }
+
+        return result;
+    }
+
+private:
+    CrossThreadUpperLayer(const std::shared_ptr<exe4cpp::IExecutor>& executor, const Config& config, const rx_ready_handler_t& on_rx_ready);
+
+    // --- executor thread ---
+
+    void drain_tx();
+
+    void try_start_tx();
+
+    void read_from_stack();
+
+    // copy the next chunk of the current received payload, false if the ring is full
+    bool try_push_rx_chunk();
+
+    void on_lower_open_impl() override;
+
+    void on_lower_close_impl() override;
+
+    void on_lower_tx_ready_impl() override;
+
+    void on_lower_rx_ready_impl() override;
+
+    // --- consumer thread ---
+
+    void on_rx_slot_released();
+
+    const std::shared_ptr<exe4cpp::IExecutor> executor;
+    const rx_ready_handler_t on_rx_ready;
+    const uint32_t tx_slot_size;
+    const uint32_t rx_slot_size;
+
+    MPSCQueue<Message> tx_ring;
+    SPSCQueue<Message> rx_ring;
+
+    // set by the producer that finds the ring idle, cleared by the executor before it drains
+    std::atomic<bool> is_tx_drain_posted{ false };
+    // set by the executor when the receive ring is full, cleared by the consumer that makes room
+    std::atomic<bool> is_rx_blocked{ false };
+
+    ILowerLayer* stack = nullptr;
+    // messages at the front of the transmit ring loaned to the stack
+    uint32_t num_tx_in_flight = 0;
+    // the part of the current received payload that isn't in the ring yet
+    seq32_t rx_data;
+};
+
+}
+
+#endif
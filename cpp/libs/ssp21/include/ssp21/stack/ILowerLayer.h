@@ -19,6 +19,11 @@ class ILowerLayer {
     friend class AbstractStack;
 
 public:
+    /**
+     * @brief Maximum number of slices accepted by @ref start_gather_tx_from_upper().
+     */
+    static const uint32_t max_tx_slices = 8;
+
     /**
      * @brief Check if the layer is ready to transmit data.
      * @return @cpp true @ce if a call to @ref start_tx_from_upper() will succeed, @cpp false @ce otherwise.
@@ -37,6 +42,34 @@ public:
      */
     virtual bool start_tx_from_upper(const seq32_t& data) = 0;
 
+    /**
+     * @brief Start an asynchronous TX operation of several buffers, transmitted as if they were concatenated.
+     * @param slices Array of @p num_slices buffers, empty ones are skipped
+     * @param num_slices Number of buffers, at most @ref max_tx_slices
+     * @return @cpp true @ce if the operation was successfully executed or queued, @cpp false @ce otherwise.
+     *
+     * The stack fills its frames from the slices directly, so a message built from a header and a
+     * body doesn't have to be copied into one buffer first. The array itself is copied, but the
+     * underlying buffers are loaned out like the one of @ref start_tx_from_upper().
+     *
+     * The default implementation only accepts a single non-empty slice and passes it to
+     * @ref start_tx_from_upper().
+     */
+    virtual bool start_gather_tx_from_upper(const seq32_t* slices, uint32_t num_slices)
+    {
+        const seq32_t* data = nullptr;
+        for (uint32_t i = 0; i < num_slices; ++i) {
+            if (slices[i].is_not_empty()) {
+                if (data) {
+                    return false;
+                }
+                data = &slices[i];
+            }
+        }
+
+        return this->start_tx_from_upper(data ? *data : seq32_t::empty());
+    }
+
     /**
      * @brief Called by the @ref IUpperLayer when it's ready to receive the next chunk of data.
      * @return Slice of received data
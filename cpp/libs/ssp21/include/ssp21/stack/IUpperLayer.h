@@ -83,6 +83,20 @@ public:
         }
     }
 
+    /**
+     * @brief Called by the @ref ILowerLayer when it discards data that it accepted while this layer was closed.
+     *
+     * This happens when early data went out with a handshake that then failed. The data may or may not
+     * have been delivered, so it isn't sent again, and the buffer it was passed in is no longer loaned.
+     * Unlike the other notifications, this one is delivered while the layer is closed.
+     *
+     * Implementor of this class should override @ref IUpperLayer::on_lower_tx_dropped_impl() if it sends early data.
+     */
+    inline void on_lower_tx_dropped()
+    {
+        this->on_lower_tx_dropped_impl();
+    }
+
     /**
      * @brief Check if layer is currently open.
      * @return @cpp true @ce if the layer is open, @cpp false @ce otherwise.
@@ -121,6 +135,13 @@ protected:
      */
     virtual void on_lower_rx_ready_impl() = 0;
 
+    /**
+     * @brief Callback when @ref ILowerLayer discarded data it accepted while the layer was closed. Does nothing by default.
+     * 
+     * See @ref IUpperLayer::on_lower_tx_dropped()
+     */
+    virtual void on_lower_tx_dropped_impl() {}
+
 private:
     bool is_open_flag = false;
 };
@@ -0,0 +1,184 @@
+#ifndef SSP21_FLIGHTRECORDER_H
+#define SSP21_FLIGHTRECORDER_H
+
+/** @file
+ * @brief Class @ref ssp21::FlightRecorder.
+ */
+
+#include "ser4cpp/util/Uncopyable.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#endif
+
+namespace ssp21 {
+
+/**
+ * @brief What a @ref FlightEvent records, and the meaning of its code and values.
+ */
+enum class FlightEventType : uint16_t {
+    /// code = new Initiator handshake state, value = previous state
+    initiator_state = 1,
+    /// code = function, value = message length
+    crypto_rx_message = 2,
+    /// code = function, value = parse error
+    crypto_rx_parse_error = 3,
+    /// code = raw function byte of a message that the layer doesn't handle
+    crypto_rx_unsupported = 4,
+    /// value = rx nonce, extra = payload length
+    crypto_rx_session_data = 5,
+    /// code = error code of the rejected session message
+    crypto_rx_session_error = 6,
+    /// value = tx nonce, extra = frame length
+    crypto_tx_session_data = 7,
+    /// code = error code of the session message that couldn't be formatted
+    crypto_tx_session_error = 8,
+    /// value = 1 if the session auth message was sent, extra = frame length
+    crypto_tx_session_auth = 9,
+    crypto_lower_close = 10,
+    /// code = 0 for the SSP21 socket and 1 for the plaintext socket, value = bytes read
+    socket_rx = 11,
+    /// code = 0 for the SSP21 socket and 1 for the plaintext socket
+    socket_tx = 12,
+    /// code = 0 for the SSP21 socket and 1 for the plaintext socket
+    socket_error = 13,
+    /// extra = id of a session that is closed because of an error
+    session_error = 14,
+    /// value = size of an asio operation that didn't fit its preallocated handler memory
+    handler_heap_allocation = 15
+};
+
+/**
+ * @brief A fixed-size event in the flight recorder.
+ *
+ * The source identifies the layer or socket that recorded the event, usually its address.
+ */
+struct FlightEvent {
+    uint64_t ticks;
+    uint64_t source;
+    uint16_t type;
+    uint16_t code;
+    uint32_t value;
+    uint64_t extra;
+};
+
+static_assert(sizeof(FlightEvent) == 32, "flight events must stay compact");
+
+/**
+ * @brief Always-on, in-memory record of the recent events of every thread.
+ *
+ * Every thread that records an event gets a ring of the most recent @ref ring_size events on
+ * first use. Writing an event only touches the ring of the calling thread, so it takes no locks
+ * and costs a timestamp and a 32 byte store. The timestamp is the time stamp counter on x86-64
+ * and the steady clock elsewhere; a dump contains what's needed to convert it.
+ *
+ * @ref dump may be called from any thread at any time. Events that a thread overwrites while
+ * its ring is copied are left out of the dump. The rings are stored as relaxed atomic words, so
+ * copying them while their thread writes isn't a data race.
+ *
+ * Dump file layout, in the byte order of the machine: a @ref DumpHeader, then for each ring a
+ * @ref RingHeader followed by its events, oldest first.
+ */
+class FlightRecorder : private ser4cpp::StaticOnly {
+public:
+    static const uint32_t ring_size = 4096;
+    static const uint32_t dump_version = 1;
+
+    struct DumpHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t num_rings;
+        // ticks and steady clock nanoseconds at the first event and at the dump, to convert the ticks
+        uint64_t start_ticks;
+        uint64_t start_ns;
+        uint64_t dump_ticks;
+        uint64_t dump_ns;
+        // wall clock time of the dump, nanoseconds since the UNIX epoch
+        uint64_t dump_wall_ns;
+    };
+
+    struct RingHeader {
+        uint64_t thread_id;
+        uint32_t num_events;
+        uint32_t reserved;
+    };
+
+    /// Record an event on the ring of the calling thread
+    static inline void record(FlightEventType type, const void* source, uint16_t code = 0, uint32_t value = 0, uint64_t extra = 0)
+    {
+        if (!enabled.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        Ring* ring = thread_ring;
+        if (!ring) {
+            ring = create_thread_ring();
+        }
+
+        const FlightEvent event{ now(), reinterpret_cast<uintptr_t>(source), static_cast<uint16_t>(type), code, value, extra };
+        uint64_t words[words_per_event];
+        memcpy(words, &event, sizeof(event));
+
+        const auto index = ring->head.load(std::memory_order_relaxed);
+        const auto slot = &ring->words[(index % num_slots) * words_per_event];
+
+        // a dump that sees any of these words also sees the head of the previous event, see dump()
+        std::atomic_thread_fence(std::memory_order_release);
+        for (uint32_t i = 0; i < words_per_event; ++i) {
+            slot[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        ring->head.store(index + 1, std::memory_order_release);
+    }
+
+    /// Recording is enabled by default
+    static void set_enabled(bool value)
+    {
+        enabled.store(value, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Write the rings of all threads to a file.
+     * @return @cpp false @ce if the file couldn't be written
+     */
+    static bool dump(const std::string& path);
+
+    static inline uint64_t now()
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+private:
+    static const uint32_t words_per_event = sizeof(FlightEvent) / sizeof(uint64_t);
+    // the spare slot may hold a half written event, so that a dump still has ring_size complete ones
+    static const uint32_t num_slots = ring_size + 1;
+
+    struct Ring {
+        std::atomic<uint64_t> head{ 0 };
+        uint64_t thread_id = 0;
+        std::atomic<uint64_t> words[num_slots * words_per_event];
+    };
+
+    struct Registry;
+
+    static Registry& get_registry();
+
+    static Ring* create_thread_ring();
+
+    static std::atomic<bool> enabled;
+    static thread_local Ring* thread_ring;
+};
+
+}
+
+#endif
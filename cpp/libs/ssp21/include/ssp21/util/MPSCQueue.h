@@ -0,0 +1,158 @@
+#ifndef SSP21_MPSCQUEUE_H
+#define SSP21_MPSCQUEUE_H
+
+/** @file
+ * @brief Class @ref ssp21::MPSCQueue.
+ */
+
+#include "ser4cpp/util/Uncopyable.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ssp21 {
+
+/**
+ * @brief Bounded, lock-free queue with any number of producers and a single consumer.
+ *
+ * Each slot carries a sequence number that tells producers and the consumer whose turn it is,
+ * so neither side ever blocks. Producers fail fast when the queue is full.
+ */
+template <class T>
+class MPSCQueue final : private ser4cpp::Uncopyable {
+
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        T value;
+    };
+
+public:
+    /// The capacity is rounded up to the next power of two
+    explicit MPSCQueue(size_t min_capacity)
+        : MPSCQueue(min_capacity, [](T&) {})
+    {
+    }
+
+    /// Calls @p init on every slot, e.g. to size its storage up front
+    template <class Init>
+    MPSCQueue(size_t min_capacity, const Init& init)
+        : capacity(round_up_to_power_of_two(min_capacity))
+        , mask(capacity - 1)
+        , slots(new Slot[capacity])
+    {
+        for (size_t i = 0; i < this->capacity; ++i) {
+            this->slots[i].sequence.store(i, std::memory_order_relaxed);
+            init(this->slots[i].value);
+        }
+    }
+
+    size_t get_capacity() const
+    {
+        return this->capacity;
+    }
+
+    /**
+     * @brief Reserve a slot and fill it in place. Safe to call from any thread.
+     *
+     * @return @cpp false @ce if the queue is full, in which case the writer is not invoked
+     */
+    template <class Writer>
+    bool try_push(const Writer& writer)
+    {
+        auto pos = this->head.load(std::memory_order_relaxed);
+
+        while (true) {
+            auto& slot = this->slots[pos & this->mask];
+            const auto seq = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+
+            if (diff == 0) {
+                if (this->head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    writer(slot.value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = this->head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Consume the oldest value in place. Must only be called from the consumer thread.
+     *
+     * @return @cpp false @ce if the queue is empty, in which case the reader is not invoked
+     */
+    template <class Reader>
+    bool try_pop(const Reader& reader)
+    {
+        auto value = this->peek();
+        if (!value) {
+            return false;
+        }
+
+        reader(*value);
+        this->pop();
+
+        return true;
+    }
+
+    /**
+     * @brief Access a value without consuming it. Must only be called from the consumer thread.
+     * @param index Position of the value, 0 being the oldest
+     * @return @cpp nullptr @ce if there aren't that many completely written values
+     *
+     * The value stays valid and in place until it's consumed with @ref pop().
+     */
+    T* peek(size_t index = 0)
+    {
+        if (index >= this->capacity) {
+            return nullptr;
+        }
+
+        const auto pos = this->tail + index;
+        auto& slot = this->slots[pos & this->mask];
+
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return nullptr;
+        }
+
+        return &slot.value;
+    }
+
+    /**
+     * @brief Release the oldest value to the producers. Must only be called from the consumer
+     * thread, after @ref peek() returned it.
+     */
+    void pop()
+    {
+        this->slots[this->tail & this->mask].sequence.store(this->tail + this->capacity, std::memory_order_release);
+        ++this->tail;
+    }
+
+private:
+    static size_t round_up_to_power_of_two(size_t value)
+    {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t capacity;
+    const size_t mask;
+    const std::unique_ptr<Slot[]> slots;
+
+    // keep the producer and consumer positions on separate cache lines
+    alignas(64) std::atomic<uint64_t> head{ 0 };
+    alignas(64) uint64_t tail = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef SSP21_SPSCQUEUE_H
+#define SSP21_SPSCQUEUE_H
+
+/** @file
+ * @brief Class @ref ssp21::SPSCQueue.
+ */
+
+#include "ser4cpp/util/Uncopyable.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ssp21 {
+
+/**
+ * @brief Bounded, lock-free queue with a single producer and a single consumer.
+ *
+ * Values are written and read in place, so slots can own storage that is sized once and reused.
+ */
+template <class T>
+class SPSCQueue final : private ser4cpp::Uncopyable {
+
+public:
+    /// The capacity is rounded up to the next power of two, @p init is called on every slot
+    template <class Init>
+    SPSCQueue(size_t min_capacity, const Init& init)
+        : capacity(round_up_to_power_of_two(min_capacity))
+        , mask(capacity - 1)
+        , slots(new T[capacity])
+    {
+        for (size_t i = 0; i < this->capacity; ++i) {
+            init(this->slots[i]);
+        }
+    }
+
+    size_t get_capacity() const
+    {
+        return this->capacity;
+    }
+
+    /**
+     * @brief Fill the next slot in place. Must only be called from the producer thread.
+     *
+     * @return @cpp false @ce if the queue is full, in which case the writer is not invoked
+     */
+    template <class Writer>
+    bool try_push(const Writer& writer)
+    {
+        const auto pos = this->head.load(std::memory_order_relaxed);
+        if (pos - this->tail.load(std::memory_order_acquire) == this->capacity) {
+            return false;
+        }
+
+        writer(this->slots[pos & this->mask]);
+        this->head.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consume the oldest value in place. Must only be called from the consumer thread.
+     *
+     * @return @cpp false @ce if the queue is empty, in which case the reader is not invoked
+     */
+    template <class Reader>
+    bool try_pop(const Reader& reader)
+    {
+        const auto pos = this->tail.load(std::memory_order_relaxed);
+        if (pos == this->head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        reader(this->slots[pos & this->mask]);
+        this->tail.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Only exact when called from the producer or the consumer thread while the other is idle
+    bool is_empty() const
+    {
+        return this->head.load(std::memory_order_acquire) == this->tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static size_t round_up_to_power_of_two(size_t value)
+    {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t capacity;
+    const size_t mask;
+    const std::unique_ptr<T[]> slots;
+
+    // keep the producer and consumer positions on separate cache lines
+    alignas(64) std::atomic<uint64_t> head{ 0 };
+    alignas(64) std::atomic<uint64_t> tail{ 0 };
+};
+
+}
+
+#endif
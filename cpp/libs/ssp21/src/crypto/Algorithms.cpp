@@ -5,7 +5,7 @@
 
 namespace ssp21 {
 
-HandshakeError Algorithms::Session::configure(SessionNonceMode nonce_mode, SessionCryptoMode session_mode)
+HandshakeError Algorithms::Session::configure(SessionNonceMode nonce_mode, SessionCryptoMode session_mode, SessionCompressionMode compression_mode)
 {
     switch (nonce_mode) {
     case (SessionNonceMode::greater_than_last_rx):
@@ -36,6 +36,15 @@ HandshakeError Algorithms::Session::configure(SessionNonceMode nonce_mode, Sessi
         return HandshakeError::unsupported_session_mode;
     }
 
+    switch (compression_mode) {
+    case (SessionCompressionMode::none):
+    case (SessionCompressionMode::lz_scada):
+        this->compression_mode = compression_mode;
+        break;
+    default:
+        return HandshakeError::unsupported_compression_mode;
+    }
+
     return HandshakeError::none;
 }
 
@@ -75,7 +84,8 @@ Algorithms::Common Algorithms::Common::get_or_throw(const CryptoSuite& suite)
         suite.handshake_hash,
         suite.handshake_kdf,
         suite.session_nonce_mode,
-        suite.session_crypto_mode);
+        suite.session_crypto_mode,
+        suite.session_compression_mode);
 
     if (any(err)) {
         throw Exception("unable to configure algorithms: ", HandshakeErrorSpec::to_string(err));
@@ -87,7 +97,8 @@ Algorithms::Common Algorithms::Common::get_or_throw(const CryptoSuite& suite)
 HandshakeError Algorithms::Common::configure(HandshakeHash handshake_hash,
                                              HandshakeKDF handshake_kdf,
                                              SessionNonceMode session_nonce_mode,
-                                             SessionCryptoMode session_crypto_mode)
+                                             SessionCryptoMode session_crypto_mode,
+                                             SessionCompressionMode session_compression_mode)
 {
     {
         const auto err = this->handshake.configure(handshake_kdf, handshake_hash);
@@ -96,7 +107,7 @@ HandshakeError Algorithms::Common::configure(HandshakeHash handshake_hash,
         }
     }
     {
-        const auto err = this->session.configure(session_nonce_mode, session_crypto_mode);
+        const auto err = this->session.configure(session_nonce_mode, session_crypto_mode, session_compression_mode);
         if (any(err)) {
             return err;
         }
@@ -105,13 +116,14 @@ HandshakeError Algorithms::Common::configure(HandshakeHash handshake_hash,
     return HandshakeError::none;
 }
 
-HandshakeError Algorithms::Common::configure(const CryptoSpec& spec)
+HandshakeError Algorithms::Common::configure(const CryptoSpec& spec, SessionCompressionMode session_compression_mode)
 {
     return this->configure(
         spec.handshake_hash,
         spec.handshake_kdf,
         spec.session_nonce_mode,
-        spec.session_crypto_mode);
+        spec.session_crypto_mode,
+        session_compression_mode);
 }
 
 Algorithms::DH Algorithms::DH::get_or_throw(HandshakeEphemeral type)
@@ -27,10 +27,12 @@ struct Algorithms : private ser4cpp::StaticOnly {
 
         HandshakeError configure(
             SessionNonceMode nonce_mode,
-            SessionCryptoMode session_mode);
+            SessionCryptoMode session_mode,
+            SessionCompressionMode compression_mode);
 
         verify_nonce_func_t verify_nonce = NonceFunctions::default_verify();
         SessionMode session_mode = SessionModes::default_mode();
+        SessionCompressionMode compression_mode = SessionCompressionMode::none;
     };
 
     struct Handshake {
@@ -52,12 +54,13 @@ struct Algorithms : private ser4cpp::StaticOnly {
 
         static Common get_or_throw(const CryptoSuite& suite);
 
-        HandshakeError configure(const CryptoSpec& spec);
+        HandshakeError configure(const CryptoSpec& spec, SessionCompressionMode session_compression_mode);
 
         HandshakeError configure(HandshakeHash handshake_hash,
                                  HandshakeKDF handshake_kdf,
                                  SessionNonceMode session_nonce_mode,
-                                 SessionCryptoMode session_crypto_mode);
+                                 SessionCryptoMode session_crypto_mode,
+                                 SessionCompressionMode session_compression_mode);
 
         Session session;
         Handshake handshake;
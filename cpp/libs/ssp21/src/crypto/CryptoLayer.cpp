@@ -3,6 +3,7 @@
 
 #include "crypto/LogMessagePrinter.h"
 #include "ssp21/stack/LogLevels.h"
+#include "ssp21/util/FlightRecorder.h"
 
 #include "log4cpp/LogMacros.h"
 
@@ -19,18 +20,18 @@ CryptoLayer::CryptoLayer(
     , executor(executor)
     , statistics(std::make_shared<SessionStatistics>())
     , sessions(frame_writer, statistics, session_config)
-    , payload_buffer(context_config.max_payload_size)
+    , rx_queue(context_config.max_rx_queue_count, context_config.max_rx_queue_bytes, context_config.max_payload_size)
 {
 }
 
 void CryptoLayer::discard_rx_data()
 {
-    this->payload_data.make_empty();
+    this->rx_queue.pop();
 }
 
 bool CryptoLayer::start_tx_from_upper(const seq32_t& data)
 {
-    if (this->is_tx_ready()) {
+    if (this->is_tx_ready() && this->accepts_tx_length(data.length())) {
         this->tx_state.initialize(data);
         this->check_transmit();
         return true;
@@ -39,13 +40,30 @@ bool CryptoLayer::start_tx_from_upper(const seq32_t& data)
     }
 }
 
+bool CryptoLayer::start_gather_tx_from_upper(const seq32_t* slices, uint32_t num_slices)
+{
+    uint32_t length = 0;
+    for (uint32_t i = 0; i < num_slices; ++i) {
+        length += slices[i].length();
+    }
+
+    if (this->is_tx_ready() && this->accepts_tx_length(length) && this->tx_state.initialize(slices, num_slices)) {
+        this->check_transmit();
+        return true;
+    } else {
+        return false;
+    }
+}
+
 seq32_t CryptoLayer::start_rx_from_upper_impl()
 {
-    if (this->payload_data.is_empty()) {
+    if (this->rx_queue.is_empty()) {
         this->try_read_from_lower();
         return seq32_t::empty();
     } else {
-        return this->payload_data;
+        // refill the space freed by the previous payload, new payloads queue up behind this one
+        this->try_read_from_lower();
+        return this->rx_queue.front();
     }
 }
 
@@ -53,11 +71,16 @@ bool CryptoLayer::is_tx_ready() const
 {
     /*
            1) This layer must be open
-           2) We must have already opened the upper layer
+           2) We must have already opened the upper layer, or accept early data
            3) We shouldn't already be transmitting on behalf of the upper layer
         */
 
-    return this->is_open() && this->upper->is_open() && this->tx_state.is_idle();
+    return this->is_open() && (this->upper->is_open() || this->get_early_data_limit() > 0) && this->tx_state.is_idle();
+}
+
+bool CryptoLayer::accepts_tx_length(uint32_t length) const
+{
+    return this->upper->is_open() || length <= this->get_early_data_limit();
 }
 
 template <class MsgType>
@@ -67,10 +90,12 @@ bool CryptoLayer::handle_message(const seq32_t& message, const exe4cpp::steady_t
     auto err = msg.read(message);
     if (any(err)) {
         FORMAT_LOG_BLOCK(logger, levels::warn, "Error parsing message (%s): %s", FunctionSpec::to_string(MsgType::function), ParseErrorSpec::to_string(err));
+        FlightRecorder::record(FlightEventType::crypto_rx_parse_error, this, static_cast<uint16_t>(MsgType::function), static_cast<uint32_t>(err));
         this->on_parse_error(MsgType::function, err);
         return false;
     } else {
         FORMAT_LOG_BLOCK(this->logger, levels::rx_crypto_msg, "%s (length = %u)", FunctionSpec::to_string(MsgType::function), message.length());
+        FlightRecorder::record(FlightEventType::crypto_rx_message, this, static_cast<uint16_t>(MsgType::function), message.length());
 
         if (this->logger.is_enabled(levels::rx_crypto_msg_fields)) {
             LogMessagePrinter printer(this->logger, levels::rx_crypto_msg_fields);
@@ -85,14 +110,24 @@ bool CryptoLayer::handle_message(const seq32_t& message, const exe4cpp::steady_t
 
 void CryptoLayer::on_lower_close_impl()
 {
+    FlightRecorder::record(FlightEventType::crypto_lower_close, this);
+
+    // the only data accepted while the upper layer is closed is early data, closing won't tell it
+    const bool drops_early_data = !this->upper->is_open() && this->tx_state.is_active();
+
     // let the super class reset
     this->reset_state_on_close_from_lower();
 
     this->sessions.reset_both();
-    this->payload_data.make_empty();
+    this->rx_queue.clear();
     this->upper->on_lower_close();
     this->tx_state.reset();
+    this->is_early_data_sent = false;
     this->reset_this_lower_layer();
+
+    if (drops_early_data) {
+        this->upper->on_lower_tx_dropped();
+    }
 }
 
 void CryptoLayer::on_lower_rx_ready_impl()
@@ -123,8 +158,15 @@ void CryptoLayer::on_lower_tx_ready_impl()
 
 void CryptoLayer::try_read_from_lower()
 {
+    // the upper layer may read from the queue while it's being filled, that mustn't start another read
+    if (this->is_reading_from_lower) {
+        return;
+    }
+
+    this->is_reading_from_lower = true;
     while (this->try_read_one_from_lower())
         ;
+    this->is_reading_from_lower = false;
 }
 
 bool CryptoLayer::try_read_one_from_lower()
@@ -133,11 +175,11 @@ bool CryptoLayer::try_read_one_from_lower()
         * We can only read data if
         *
         * 1) We can immediately transmit a reply if required
-        * 2) There isn't unread session data buffered for the upper layer
+        * 2) The queue has room for another payload of the maximum size
         *
         */
 
-    if (!this->lower->is_tx_ready() || this->payload_data.is_not_empty())
+    if (!this->lower->is_tx_ready() || !this->rx_queue.can_push())
         return false;
 
     const seq32_t message = this->lower->start_rx_from_upper();
@@ -162,6 +204,7 @@ void CryptoLayer::process(const seq32_t& message)
 
     if (!this->supports(function)) {
         FORMAT_LOG_BLOCK(logger, levels::warn, "Received unsupported function: %s(%u)", FunctionSpec::to_string(function), raw_function);
+        FlightRecorder::record(FlightEventType::crypto_rx_unsupported, this, raw_function);
         return;
     }
 
@@ -196,6 +239,7 @@ void CryptoLayer::check_transmit()
     const auto frame = this->sessions.active->format_session_data(now, remainder, ec);
     if (ec) {
         FORMAT_LOG_BLOCK(this->logger, levels::warn, "Error formatting session message: %s", ec.message().c_str());
+        FlightRecorder::record(FlightEventType::crypto_tx_session_error, this, static_cast<uint16_t>(ec.value()));
 
         // if any error occurs with transmission, we reset the session and notify the upper layer
         this->sessions.active->reset();
@@ -208,6 +252,8 @@ void CryptoLayer::check_transmit()
 
     this->lower->start_tx_from_upper(frame);
 
+    FlightRecorder::record(FlightEventType::crypto_tx_session_data, this, 0, this->sessions.active->get_tx_nonce(), frame.length());
+
     this->on_session_nonce_change(this->sessions.active->get_rx_nonce(), this->sessions.active->get_tx_nonce());
 }
 
@@ -220,6 +266,7 @@ bool CryptoLayer::transmit_session_auth(Session& session)
     const auto frame = session.format_session_auth(this->executor->get_time(), remainder, ec);
     if (ec) {
         FORMAT_LOG_BLOCK(this->logger, levels::warn, "Error formatting session auth message: %s", ec.message().c_str());
+        FlightRecorder::record(FlightEventType::crypto_tx_session_error, this, static_cast<uint16_t>(ec.value()));
 
         // TODO any other actions?
 
@@ -228,9 +275,38 @@ bool CryptoLayer::transmit_session_auth(Session& session)
 
     if (has_payload) {
         this->tx_state.begin_transmit(remainder);
+        this->is_early_data_sent = !this->upper->is_open();
+    }
+
+    const auto sent = this->lower->start_tx_from_upper(frame);
+    FlightRecorder::record(FlightEventType::crypto_tx_session_auth, this, 0, sent ? 1 : 0, frame.length());
+    return sent;
+}
+
+void CryptoLayer::open_upper_layer()
+{
+    const bool early_data_sent = this->is_early_data_sent;
+    // the auth message may have been transmitted while the upper layer was closed and couldn't be told
+    const bool early_data_complete = early_data_sent && this->tx_state.is_idle();
+    this->is_early_data_sent = false;
+
+    this->upper->on_lower_open();
+
+    if (early_data_complete) {
+        this->upper->on_lower_tx_ready();
+    } else if (early_data_sent) {
+        // early data that didn't fit into the auth message
+        this->check_transmit();
     }
+}
 
-    return this->lower->start_tx_from_upper(frame);
+void CryptoLayer::drop_early_data()
+{
+    if (this->is_early_data_sent) {
+        this->is_early_data_sent = false;
+        this->tx_state.reset();
+        this->upper->on_lower_tx_dropped();
+    }
 }
 
 void CryptoLayer::on_message(const SessionData& msg, const seq32_t& raw_data, const exe4cpp::steady_time_t& now)
@@ -246,18 +322,31 @@ void CryptoLayer::on_message(const SessionData& msg, const seq32_t& raw_data, co
 void CryptoLayer::on_session_data(const SessionData& msg, const seq32_t& raw_data, const exe4cpp::steady_time_t& now)
 {
     std::error_code ec;
-    const auto payload = this->sessions.active->validate_session_data(msg, now, this->payload_buffer.as_wslice(), ec);
+    const auto payload = this->sessions.active->validate_session_data(msg, now, this->rx_queue.get_write_slice(), ec);
 
     if (ec) {
         FORMAT_LOG_BLOCK(this->logger, levels::warn, "error reading session data: %s", ec.message().c_str());
+        FlightRecorder::record(FlightEventType::crypto_rx_session_error, this, static_cast<uint16_t>(ec.value()));
         return;
     }
 
-    this->payload_data = payload;
+    FlightRecorder::record(FlightEventType::crypto_rx_session_data, this, 0, this->sessions.active->get_rx_nonce(), payload.length());
 
     this->on_session_nonce_change(this->sessions.active->get_rx_nonce(), this->sessions.active->get_tx_nonce());
 
-    this->upper->on_lower_rx_ready();
+    this->enqueue_rx_payload(payload);
+}
+
+void CryptoLayer::enqueue_rx_payload(const seq32_t& payload)
+{
+    const bool was_empty = this->rx_queue.is_empty();
+
+    this->rx_queue.push(payload);
+
+    // the upper layer reads everything queued behind the first payload without further notification
+    if (was_empty) {
+        this->upper->on_lower_rx_ready();
+    }
 }
 
 }
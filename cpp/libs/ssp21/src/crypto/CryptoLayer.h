@@ -2,6 +2,7 @@
 #ifndef SSP21_CRYPTOLAYER_H
 #define SSP21_CRYPTOLAYER_H
 
+#include "crypto/RxQueue.h"
 #include "crypto/Sessions.h"
 #include "crypto/TxState.h"
 #include "ssp21/crypto/CryptoLayerConfig.h"
@@ -16,7 +17,6 @@
 #include "ssp21/stack/IUpperLayer.h"
 
 #include "exe4cpp/IExecutor.h"
-#include "ssp21/util/SecureDynamicBuffer.h"
 
 namespace ssp21 {
 /**
@@ -42,6 +42,8 @@ public:
 
     virtual bool start_tx_from_upper(const seq32_t& data) override final;
 
+    virtual bool start_gather_tx_from_upper(const seq32_t* slices, uint32_t num_slices) override final;
+
     inline const SessionStatistics& get_statistics() const
     {
         return *this->statistics;
@@ -79,6 +81,12 @@ protected:
     // Called when either the rx or tx nonces change
     virtual void on_session_nonce_change(uint16_t rx_nonce, uint16_t tx_nonce) {}
 
+    // How much upper layer data is accepted before the session is open, zero if none
+    virtual uint32_t get_early_data_limit() const
+    {
+        return 0;
+    }
+
     // optional overrides for optional messages
     virtual void on_message(const RequestHandshakeBegin& msg, const seq32_t& raw_data, const exe4cpp::steady_time_t& now) {}
     virtual void on_message(const ReplyHandshakeBegin& msg, const seq32_t& raw_data, const exe4cpp::steady_time_t& now) {}
@@ -94,6 +102,18 @@ protected:
     // both parties need to call this to complete the handshake at different times
     bool transmit_session_auth(Session& session);
 
+    // queue a decrypted payload, previously written into rx_queue.get_write_slice(), for the upper layer
+    void enqueue_rx_payload(const seq32_t& payload);
+
+    // open the upper layer once the handshake completes, finishing the early data sent with the auth message
+    void open_upper_layer();
+
+    /*
+        The handshake that carried early data failed. The responder may have delivered it and only the
+        reply was lost, so it is never sent again: the upper layer is told that it was dropped.
+    */
+    void drop_early_data();
+
     // ------ member variables ------
 
     log4cpp::Logger logger;
@@ -104,13 +124,19 @@ protected:
     Sessions sessions;
 
     TxState tx_state;
-    SecureDynamicBuffer payload_buffer;
-    seq32_t payload_data;
+    RxQueue rx_queue;
 
     ILowerLayer* lower = nullptr;
     IUpperLayer* upper = nullptr;
 
 private:
+    bool is_reading_from_lower = false;
+
+    // early data went out with a session auth message that the responder hasn't confirmed yet
+    bool is_early_data_sent = false;
+
+    bool accepts_tx_length(uint32_t length) const;
+
     void try_read_from_lower();
 
     bool try_read_one_from_lower();
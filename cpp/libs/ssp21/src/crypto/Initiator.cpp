@@ -4,6 +4,7 @@
 #include "crypto/InitiatorHandshakeStates.h"
 
 #include "ssp21/stack/LogLevels.h"
+#include "ssp21/util/FlightRecorder.h"
 
 #include "log4cpp/LogMacros.h"
 
@@ -28,7 +29,12 @@ Initiator::Initiator(
     , handshake(handshake)
     , response_and_retry_timer(nullptr)
     , session_timeout_timer(nullptr)
+    , nonce_renegotiation_trigger(config.params.nonce_renegotiation_trigger_value)
 {
+    // the first draws of a linear congruential generator grow with the seed, so consecutive seeds
+    // would all wait about the same time. seed_seq mixes the seed bits first
+    std::seed_seq seed{ config.params.random_seed == 0 ? std::random_device()() : config.params.random_seed };
+    this->random.seed(seed);
 }
 
 Initiator::IHandshakeState* Initiator::IHandshakeState::on_reply_message(Initiator& ctx, const ReplyHandshakeBegin& msg, const seq32_t& msg_bytes, const exe4cpp::steady_time_t& now)
@@ -66,10 +72,18 @@ void Initiator::IHandshakeState::log_unexpected_message(log4cpp::Logger& logger,
     FORMAT_LOG_BLOCK(logger, levels::warn, "Received unexpected message: %s", FunctionSpec::to_string(function));
 }
 
+void Initiator::set_state(IHandshakeState* next)
+{
+    if (next != this->handshake_state) {
+        FlightRecorder::record(FlightEventType::initiator_state, this, static_cast<uint16_t>(next->enum_value), static_cast<uint32_t>(this->handshake_state->enum_value));
+        this->handshake_state = next;
+    }
+}
+
 void Initiator::start_response_timer()
 {
     auto on_timeout = [this]() {
-        this->handshake_state = this->handshake_state->on_response_timeout(*this);
+        this->set_state(this->handshake_state->on_response_timeout(*this));
     };
 
     this->response_and_retry_timer = exe4cpp::Timer(executor->start(this->params.response_timeout, on_timeout));
@@ -77,12 +91,58 @@ void Initiator::start_response_timer()
 
 void Initiator::start_retry_timer()
 {
+    this->drop_early_data();
+
     auto on_timeout = [this]() {
-        this->handshake_state = this->handshake_state->on_retry_timeout(*this);
+        this->set_state(this->handshake_state->on_retry_timeout(*this));
         this->on_handshake_required();
     };
 
-    this->response_and_retry_timer = exe4cpp::Timer(executor->start(this->params.retry_timeout, on_timeout));
+    this->response_and_retry_timer = exe4cpp::Timer(executor->start(this->next_retry_timeout(), on_timeout));
+}
+
+template <class T>
+T Initiator::draw_random(T max)
+{
+    if (max == 0) {
+        return 0;
+    }
+
+    // uniform_int_distribution isn't defined for 8-bit types, draw from a wide type and narrow
+    std::uniform_int_distribution<uint64_t> distribution(0, static_cast<uint64_t>(max));
+    return static_cast<T>(distribution(this->random));
+}
+
+exe4cpp::duration_t Initiator::next_retry_timeout()
+{
+    const auto cap = std::max(this->params.retry_timeout, this->params.max_retry_timeout);
+
+    // exponential backoff, doubling stops at the cap so it can't overflow
+    auto timeout = this->params.retry_timeout;
+    for (uint32_t i = 0; i < this->num_retries && timeout < cap; ++i) {
+        timeout *= 2;
+    }
+    timeout = std::min(timeout, cap);
+
+    ++this->num_retries;
+
+    if (!this->params.retry_jitter) {
+        return timeout;
+    }
+
+    return exe4cpp::duration_t(this->draw_random(timeout.count()));
+}
+
+exe4cpp::duration_t Initiator::on_session_activated()
+{
+    this->num_retries = 0;
+
+    // spreading the triggers keeps initiators that handshook together from renegotiating together
+    const auto nonce_spread = std::min(this->params.nonce_renegotiation_spread, this->params.nonce_renegotiation_trigger_value);
+    this->nonce_renegotiation_trigger = this->params.nonce_renegotiation_trigger_value - this->draw_random(nonce_spread);
+
+    const auto time_spread = std::min(this->params.session_time_renegotiation_spread_ms, this->params.session_time_renegotiation_trigger_ms);
+    return std::chrono::milliseconds(this->params.session_time_renegotiation_trigger_ms - this->draw_random(time_spread));
 }
 
 void Initiator::start_session_timer(const exe4cpp::steady_time_t& session_timeout)
@@ -96,7 +156,7 @@ void Initiator::start_session_timer(const exe4cpp::steady_time_t& session_timeou
 
 void Initiator::on_handshake_required()
 {
-    this->handshake_state = this->handshake_state->on_handshake_required(*this, this->executor->get_time());
+    this->set_state(this->handshake_state->on_handshake_required(*this, this->executor->get_time()));
 }
 
 void Initiator::on_lower_open_impl()
@@ -106,10 +166,11 @@ void Initiator::on_lower_open_impl()
 
 void Initiator::reset_state_on_close_from_lower()
 {
-    this->handshake_state = InitiatorHandshakeStates::Idle::get();
+    this->set_state(InitiatorHandshakeStates::Idle::get());
     this->response_and_retry_timer.cancel();
     this->session_timeout_timer.cancel();
     this->handshake_required = false;
+    this->num_retries = 0;
 }
 
 bool Initiator::supports(Function function) const
@@ -126,7 +187,7 @@ bool Initiator::supports(Function function) const
 
 void Initiator::on_session_nonce_change(uint16_t rx_nonce, uint16_t tx_nonce)
 {
-    if (ser4cpp::max(tx_nonce, rx_nonce) >= this->params.nonce_renegotiation_trigger_value) {
+    if (ser4cpp::max(tx_nonce, rx_nonce) >= this->nonce_renegotiation_trigger) {
         this->session_timeout_timer.cancel();
         this->on_handshake_required();
     }
@@ -139,19 +200,32 @@ void Initiator::on_pre_tx_ready()
     }
 }
 
+uint32_t Initiator::get_early_data_limit() const
+{
+    // early data waits for the next session auth message, which these states haven't sent yet
+    switch (this->handshake_state->enum_value) {
+    case (IHandshakeState::Enum::idle):
+    case (IHandshakeState::Enum::wait_for_begin_reply):
+    case (IHandshakeState::Enum::wait_for_retry):
+        return this->params.max_early_data_size;
+    default:
+        return 0;
+    }
+}
+
 void Initiator::on_message(const ReplyHandshakeBegin& msg, const seq32_t& raw_data, const exe4cpp::steady_time_t& now)
 {
-    this->handshake_state = this->handshake_state->on_reply_message(*this, msg, raw_data, now);
+    this->set_state(this->handshake_state->on_reply_message(*this, msg, raw_data, now));
 }
 
 void Initiator::on_message(const ReplyHandshakeError& msg, const seq32_t& raw_data, const exe4cpp::steady_time_t& now)
 {
-    this->handshake_state = this->handshake_state->on_error_message(*this, msg, raw_data, now);
+    this->set_state(this->handshake_state->on_error_message(*this, msg, raw_data, now));
 }
 
 void Initiator::on_auth_session(const SessionData& msg, const seq32_t& raw_data, const exe4cpp::steady_time_t& now)
 {
-    this->handshake_state = this->handshake_state->on_auth_message(*this, msg, raw_data, now);
+    this->set_state(this->handshake_state->on_auth_message(*this, msg, raw_data, now));
 }
 
 }
@@ -6,6 +6,8 @@
 #include "crypto/IInitiatorHandshake.h"
 #include "exe4cpp/Timer.h"
 
+#include <random>
+
 namespace ssp21 {
 /**
     	Initiator implementation - Inherits most of its functionality from the CryptoLayer base class.
@@ -80,10 +82,22 @@ public:
 private:
     // ---- private helper methods -----
 
+    // records the transitions in the flight recorder
+    void set_state(IHandshakeState* next);
+
     void start_response_timer();
 
     void start_retry_timer();
 
+    exe4cpp::duration_t next_retry_timeout();
+
+    // draws the renegotiation triggers for a session that was just activated
+    exe4cpp::duration_t on_session_activated();
+
+    // uniformly distributed in [0, max]
+    template <class T>
+    T draw_random(T max);
+
     void start_session_timer(const exe4cpp::steady_time_t& session_timeout);
 
     void on_handshake_required();
@@ -102,6 +116,8 @@ private:
 
     virtual void on_pre_tx_ready() override;
 
+    virtual uint32_t get_early_data_limit() const override;
+
     virtual void on_message(const ReplyHandshakeBegin& msg, const seq32_t& raw_data, const exe4cpp::steady_time_t& now) override;
 
     virtual void on_message(const ReplyHandshakeError& msg, const seq32_t& raw_data, const exe4cpp::steady_time_t& now) override;
@@ -120,6 +136,11 @@ private:
     exe4cpp::Timer session_timeout_timer;
 
     bool handshake_required = false;
+
+    // consecutive failed handshakes since the last successful one
+    uint32_t num_retries = 0;
+    uint16_t nonce_renegotiation_trigger;
+    std::minstd_rand random;
 };
 
 }
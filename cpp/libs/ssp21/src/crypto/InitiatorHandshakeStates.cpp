@@ -43,7 +43,8 @@ Initiator::IHandshakeState* InitiatorHandshakeStates::Idle::on_handshake_require
             ctx.session_limits.max_session_time_ms),
         ctx.handshake->get_handshake_mode(),
         init_result.mode_ephemeral,
-        init_result.mode_data);
+        init_result.mode_data,
+        suite.base.session_compression_mode);
 
     const auto result = ctx.frame_writer->write(request);
 
@@ -103,7 +104,7 @@ Initiator::IHandshakeState* InitiatorHandshakeStates::WaitForAuthReply::on_auth_
     ctx.response_and_retry_timer.cancel();
 
     std::error_code ec;
-    const auto payload = ctx.sessions.pending->validate_session_auth(msg, now, ctx.payload_buffer.as_wslice(), ec);
+    const auto payload = ctx.sessions.pending->validate_session_auth(msg, now, ctx.rx_queue.get_write_slice(), ec);
 
     if (ec) {
         FORMAT_LOG_BLOCK(ctx.logger, levels::warn, "Error validating session auth: %s", ec.message().c_str());
@@ -118,15 +119,14 @@ Initiator::IHandshakeState* InitiatorHandshakeStates::WaitForAuthReply::on_auth_
     ctx.handshake_required = false;
 
     // the absolute time at which a renegotation should be triggered
-    const exe4cpp::steady_time_t session_timeout_abs_time(ctx.sessions.active->get_session_start() + std::chrono::milliseconds(ctx.params.session_time_renegotiation_trigger_ms));
+    const exe4cpp::steady_time_t session_timeout_abs_time(ctx.sessions.active->get_session_start() + ctx.on_session_activated());
     ctx.start_session_timer(session_timeout_abs_time);
 
-    ctx.upper->on_lower_open();
+    ctx.open_upper_layer();
 
     if (payload.is_not_empty()) {
         // process the payload
-        ctx.payload_data = payload;
-        ctx.upper->on_lower_rx_ready();
+        ctx.enqueue_rx_payload(payload);
     }
 
     return Idle::get();
@@ -24,7 +24,7 @@ IResponderHandshake::Result PublicKeyResponderHandshake::process(const RequestHa
     // lookup the base algorithms
     Algorithms::Common algorithms;
     {
-        const auto err = algorithms.configure(msg.spec);
+        const auto err = algorithms.configure(msg.spec, msg.session_compression_mode);
         if (any(err)) {
             return IResponderHandshake::Result::failure(err);
         }
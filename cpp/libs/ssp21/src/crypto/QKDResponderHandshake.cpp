@@ -29,7 +29,7 @@ IResponderHandshake::Result QKDResponderHandshake::process(const RequestHandshak
     Algorithms::Common algorithms;
 
     {
-        const auto err = algorithms.configure(msg.spec);
+        const auto err = algorithms.configure(msg.spec, msg.session_compression_mode);
         if (any(err)) {
             return IResponderHandshake::Result::failure(err);
         }
@@ -52,7 +52,7 @@ IResponderHandshake::Result QKDResponderHandshake::process(const RequestHandshak
     }
 
     {
-        const auto err = algorithms.configure(msg.spec);
+        const auto err = algorithms.configure(msg.spec, msg.session_compression_mode);
         if (any(err))
             return Result::failure(err);
     }
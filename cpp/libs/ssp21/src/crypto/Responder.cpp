@@ -6,6 +6,8 @@
 #include "crypto/ProtocolVersion.h"
 #include "ssp21/stack/LogLevels.h"
 
+#include <algorithm>
+
 namespace ssp21 {
 Responder::Responder(
     const ResponderConfig& config,
@@ -20,6 +22,7 @@ Responder::Responder(
         frame_writer,
         executor)
     , handshake(handshake)
+    , allowed_compression_modes(config.allowed_compression_modes)
 {
 }
 
@@ -34,6 +37,11 @@ void Responder::reply_with_handshake_error(HandshakeError err)
     }
 }
 
+bool Responder::is_allowed(SessionCompressionMode mode) const
+{
+    return (mode == SessionCompressionMode::none) || (std::find(this->allowed_compression_modes.begin(), this->allowed_compression_modes.end(), mode) != this->allowed_compression_modes.end());
+}
+
 void Responder::reset_state_on_close_from_lower()
 {
     this->sessions.reset_both();
@@ -69,6 +77,12 @@ void Responder::on_message(const RequestHandshakeBegin& msg, const seq32_t& raw_
         return;
     }
 
+    if (!this->is_allowed(msg.session_compression_mode)) {
+        FORMAT_LOG_BLOCK(this->logger, levels::warn, "Handshake request with disallowed compression mode: %s", SessionCompressionModeSpec::to_string(msg.session_compression_mode));
+        this->reply_with_handshake_error(HandshakeError::unsupported_compression_mode);
+        return;
+    }
+
     const auto result = this->handshake->process(msg, raw_msg, now, *this->frame_writer, *this->sessions.pending);
 
     if (any(result.error)) {
@@ -88,7 +102,7 @@ void Responder::on_auth_session(const SessionData& msg, const seq32_t& raw_data,
     }
 
     std::error_code ec;
-    const auto payload = this->sessions.pending->validate_session_auth(msg, now, payload_buffer.as_wslice(), ec);
+    const auto payload = this->sessions.pending->validate_session_auth(msg, now, this->rx_queue.get_write_slice(), ec);
 
     if (ec) {
         FORMAT_LOG_BLOCK(this->logger, levels::warn, "Error processing session auth request: %s", ec.message().c_str());
@@ -105,8 +119,7 @@ void Responder::on_auth_session(const SessionData& msg, const seq32_t& raw_data,
 
     // notify the upper layer there is data ready
     if (payload.is_not_empty()) {
-        this->payload_data = payload;
-        this->upper->on_lower_rx_ready();
+        this->enqueue_rx_payload(payload);
     }
 }
 
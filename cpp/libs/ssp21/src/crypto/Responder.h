@@ -24,6 +24,7 @@ public:
 
 private:
     const std::shared_ptr<IResponderHandshake> handshake;
+    const std::vector<SessionCompressionMode> allowed_compression_modes;
 
     // ---- final implementations from IUpperLayer ----
 
@@ -33,6 +34,8 @@ private:
 
     void reply_with_handshake_error(HandshakeError err);
 
+    bool is_allowed(SessionCompressionMode mode) const;
+
     // ---- implement CryptoLayer -----
 
     virtual void reset_state_on_close_from_lower() override;
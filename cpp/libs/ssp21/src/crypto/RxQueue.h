@@ -0,0 +1,164 @@
+#ifndef SSP21_RXQUEUE_H
+#define SSP21_RXQUEUE_H
+
+#include "ssp21/util/SecureDynamicBuffer.h"
+#include "ssp21/util/SequenceTypes.h"
+
+#include "ser4cpp/util/Uncopyable.h"
+
+#include <cstring>
+#include <vector>
+
+namespace ssp21 {
+/**
+    Decrypted payloads waiting to be read by the upper layer, in the order they were received.
+
+    The payloads share one buffer that is used as a ring. Every payload is decrypted in place into
+    a contiguous region of max_payload_size bytes and only takes up its actual length once pushed.
+*/
+class RxQueue final : ser4cpp::Uncopyable {
+
+public:
+    // a byte capacity of zero sizes the buffer for max_count payloads of max_payload_size
+    RxQueue(uint16_t max_count, uint32_t max_bytes, uint16_t max_payload_size)
+        : max_payload_size(max_payload_size)
+        , entries(max_count ? max_count : 1)
+        , buffer(get_capacity(static_cast<uint32_t>(entries.size()), max_bytes, max_payload_size))
+    {
+    }
+
+    bool is_empty() const
+    {
+        return this->count == 0;
+    }
+
+    uint32_t get_count() const
+    {
+        return this->count;
+    }
+
+    // true if a payload of max_payload_size can be pushed
+    bool can_push() const
+    {
+        uint32_t offset = 0;
+        return this->get_write_offset(offset);
+    }
+
+    // the region to decrypt the next payload into, empty if nothing can be pushed
+    wseq32_t get_write_slice()
+    {
+        if (!this->get_write_offset(this->write_offset)) {
+            return wseq32_t::empty();
+        }
+
+        return this->buffer.as_wslice().skip(this->write_offset).take(this->max_payload_size);
+    }
+
+    // the payload must fit into the last write slice, auth-only session modes return it in place
+    // in the message instead of writing it there, so it's copied
+    void push(const seq32_t& payload)
+    {
+        const auto dest = this->buffer.as_wslice().skip(this->write_offset);
+        if (static_cast<const uint8_t*>(dest) != static_cast<const uint8_t*>(payload)) {
+            memmove(dest, payload, payload.length());
+        }
+
+        this->entries[(this->first + this->count) % this->entries.size()] = Entry{ this->write_offset, payload.length() };
+        ++this->count;
+        this->tail = this->write_offset + payload.length();
+    }
+
+    seq32_t front() const
+    {
+        if (this->is_empty()) {
+            return seq32_t::empty();
+        }
+
+        const auto& entry = this->entries[this->first];
+        return this->buffer.as_rslice().skip(entry.offset).take(entry.length);
+    }
+
+    void pop()
+    {
+        if (this->is_empty()) {
+            return;
+        }
+
+        this->first = (this->first + 1) % this->entries.size();
+        --this->count;
+    }
+
+    void clear()
+    {
+        this->first = 0;
+        this->count = 0;
+        this->tail = 0;
+        this->write_offset = 0;
+    }
+
+private:
+    struct Entry {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    static uint32_t get_capacity(uint32_t max_count, uint32_t max_bytes, uint16_t max_payload_size)
+    {
+        if (max_bytes == 0) {
+            return max_count * max_payload_size;
+        }
+
+        return (max_bytes < max_payload_size) ? max_payload_size : max_bytes;
+    }
+
+    bool get_write_offset(uint32_t& offset) const
+    {
+        if (this->is_empty()) {
+            offset = 0;
+            return true;
+        }
+
+        if (this->count == this->entries.size()) {
+            return false;
+        }
+
+        const auto head = this->entries[this->first].offset;
+        const auto capacity = this->buffer.length();
+
+        if (this->tail > head) {
+            // the payloads are in [head, tail), there's free space after the tail and before the head
+            if (capacity - this->tail >= this->max_payload_size) {
+                offset = this->tail;
+                return true;
+            }
+            if (head >= this->max_payload_size) {
+                offset = 0;
+                return true;
+            }
+            return false;
+        }
+
+        // the payloads wrapped around, the only free space is between the tail and the head
+        if (head - this->tail >= this->max_payload_size) {
+            offset = this->tail;
+            return true;
+        }
+        return false;
+    }
+
+    const uint16_t max_payload_size;
+
+    std::vector<Entry> entries;
+    uint32_t first = 0;
+    uint32_t count = 0;
+
+    // the end of the most recently pushed payload
+    uint32_t tail = 0;
+    // the start of the last write slice
+    uint32_t write_offset = 0;
+
+    SecureDynamicBuffer buffer;
+};
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include "ssp21/crypto/gen/CryptoError.h"
 #include "ssp21/stack/LogLevels.h"
 
+#include <algorithm>
 #include <limits>
 
 namespace ssp21 {
@@ -34,10 +35,20 @@ bool Session::initialize(const Algorithms::Session& algorithms, const Param& par
     this->parameters = parameters;
     this->keys.copy(keys);
 
+    if (algorithms.compression_mode == SessionCompressionMode::none) {
+        this->compressor.reset();
+    } else if (!this->compressor) {
+        this->compressor = std::make_unique<SessionCompressor>(SessionMode::max_user_data_length);
+    }
+
     this->statistics->num_init.increment();
 
     this->valid = true;
 
+    if (this->config.on_session_keys) {
+        this->config.on_session_keys(this->keys.rx_key.as_seq(), this->keys.tx_key.as_seq());
+    }
+
     return true;
 }
 
@@ -88,6 +99,26 @@ seq32_t Session::format_session_data(const exe4cpp::steady_time_t& now, seq32_t&
     return this->format_session_data_no_nonce_check(now, cleartext, ec);
 }
 
+seq32_t Session::format_session_auth(const exe4cpp::steady_time_t& now, TxSlices& cleartext, std::error_code& ec)
+{
+    if (!this->tx_nonce.is_zero()) {
+        ec = CryptoError::max_nonce_exceeded;
+        return seq32_t::empty();
+    }
+
+    return this->format_session_data_no_nonce_check(now, cleartext, ec);
+}
+
+seq32_t Session::format_session_data(const exe4cpp::steady_time_t& now, TxSlices& cleartext, std::error_code& ec)
+{
+    if (this->tx_nonce.get() >= this->parameters.max_nonce) {
+        ec = CryptoError::max_nonce_exceeded;
+        return seq32_t::empty();
+    }
+
+    return this->format_session_data_no_nonce_check(now, cleartext, ec);
+}
+
 seq32_t Session::validate_session_data_with_nonce_func(const SessionData& message, const exe4cpp::steady_time_t& now, wseq32_t dest, verify_nonce_func_t verify_nonce, std::error_code& ec)
 {
     if (!this->valid) {
@@ -96,7 +127,7 @@ seq32_t Session::validate_session_data_with_nonce_func(const SessionData& messag
         return seq32_t::empty();
     }
 
-    const auto payload = this->algorithms.session_mode.read(this->keys.rx_key, message, dest, ec);
+    auto payload = this->algorithms.session_mode.read(this->keys.rx_key, message, dest, ec);
 
     if (ec) {
         this->statistics->num_auth_fail.increment();
@@ -136,6 +167,14 @@ seq32_t Session::validate_session_data_with_nonce_func(const SessionData& messag
         return seq32_t::empty();
     }
 
+    // only authentic data is decompressed
+    if (this->compressor) {
+        payload = this->compressor->decompress(payload, dest, ec);
+        if (ec) {
+            return seq32_t::empty();
+        }
+    }
+
     this->rx_nonce.set(message.metadata.nonce.value);
 
     this->statistics->num_success.increment();
@@ -175,7 +214,7 @@ seq32_t Session::format_session_data_no_nonce_check(const exe4cpp::steady_time_t
 
     MACOutput mac;
 
-    const auto message = this->algorithms.session_mode.write(this->keys.tx_key, metadata, clear_text, this->encrypt_buffer.as_wslice(), mac, ec);
+    const auto message = this->compressor ? this->write_compressed(metadata, clear_text, mac, ec) : this->algorithms.session_mode.write(this->keys.tx_key, metadata, clear_text, this->encrypt_buffer.as_wslice(), mac, ec);
     if (ec) {
         return seq32_t::empty();
     }
@@ -194,4 +233,50 @@ seq32_t Session::format_session_data_no_nonce_check(const exe4cpp::steady_time_t
     return result.frame;
 }
 
+seq32_t Session::format_session_data_no_nonce_check(const exe4cpp::steady_time_t& now, TxSlices& clear_text, std::error_code& ec)
+{
+    auto data = clear_text.front();
+
+    // only the user data of a message that spans slices is gathered, into the buffer it's encrypted in place
+    const uint32_t max_user_data_length = SessionMode::max_user_data_length;
+    const auto max_length = std::min(this->encrypt_buffer.length(), max_user_data_length);
+    if (data.length() < max_length && data.length() < clear_text.length()) {
+        data = clear_text.gather(this->encrypt_buffer.as_wslice().take(max_length));
+    }
+
+    const auto length = data.length();
+    const auto frame = this->format_session_data_no_nonce_check(now, data, ec);
+    if (!ec) {
+        clear_text.advance(length - data.length());
+    }
+
+    return frame;
+}
+
+SessionData Session::write_compressed(const AuthMetadata& metadata, seq32_t& clear_text, MACOutput& mac, std::error_code& ec)
+{
+    // leave room for the worst case expansion so the compressed data is sent in a single message
+    const uint32_t max_user_data_length = SessionMode::max_user_data_length;
+    const auto max_length = std::min(this->encrypt_buffer.length(), max_user_data_length);
+    if (max_length <= SessionCompressor::max_expansion) {
+        ec = CryptoError::bad_buffer_size;
+        return SessionData();
+    }
+
+    const auto input = clear_text.take(max_length - SessionCompressor::max_expansion);
+    auto compressed = this->compressor->compress(input);
+
+    const auto message = this->algorithms.session_mode.write(this->keys.tx_key, metadata, compressed, this->encrypt_buffer.as_wslice(), mac, ec);
+    if (ec) {
+        return message;
+    }
+
+    if (input.length() > message.user_data.length()) {
+        this->statistics->num_bytes_saved_by_compression.add(input.length() - message.user_data.length());
+    }
+
+    clear_text.advance(input.length());
+    return message;
+}
+
 }
@@ -9,7 +9,9 @@
 
 #include "crypto/Algorithms.h"
 #include "crypto/Nonce.h"
+#include "crypto/SessionCompressor.h"
 #include "crypto/SessionModes.h"
+#include "crypto/TxSlices.h"
 #include "ssp21/crypto/BufferTypes.h"
 #include "ssp21/crypto/Constants.h"
 #include "ssp21/crypto/CryptoLayerConfig.h"
@@ -56,6 +58,11 @@ public:
 
     seq32_t format_session_auth(const exe4cpp::steady_time_t& now, seq32_t& cleartext, std::error_code& ec);
 
+    // consume the user data of the message from several buffers
+    seq32_t format_session_data(const exe4cpp::steady_time_t& now, TxSlices& cleartext, std::error_code& ec);
+
+    seq32_t format_session_auth(const exe4cpp::steady_time_t& now, TxSlices& cleartext, std::error_code& ec);
+
     // -------- getters -------------
 
     bool is_valid() const
@@ -81,6 +88,11 @@ public:
 private:
     seq32_t format_session_data_no_nonce_check(const exe4cpp::steady_time_t& now, seq32_t& cleartext, std::error_code& ec);
 
+    seq32_t format_session_data_no_nonce_check(const exe4cpp::steady_time_t& now, TxSlices& cleartext, std::error_code& ec);
+
+    // compress as much of the clear text as fits in one message and encrypt it, consuming the clear text like SessionMode::write
+    SessionData write_compressed(const AuthMetadata& metadata, seq32_t& clear_text, MACOutput& mac, std::error_code& ec);
+
     seq32_t validate_session_data_with_nonce_func(const SessionData& message, const exe4cpp::steady_time_t& now, wseq32_t dest, verify_nonce_func_t verify, std::error_code& ec);
 
     /**
@@ -101,6 +113,8 @@ private:
     Algorithms::Session algorithms;
     Param parameters;
     ser4cpp::Buffer encrypt_buffer;
+    // only allocated once a session negotiates compression
+    std::unique_ptr<SessionCompressor> compressor;
 };
 
 }
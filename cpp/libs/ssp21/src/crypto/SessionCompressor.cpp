@@ -0,0 +1,234 @@
+
+#include "crypto/SessionCompressor.h"
+
+#include "ssp21/crypto/gen/CryptoError.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ssp21 {
+
+namespace {
+    const uint8_t stored_header = 0;
+    const uint8_t tokens_header = 1;
+
+    const uint32_t max_literal_run = 0x80;
+    const uint32_t min_match = 3;
+    const uint32_t max_match = min_match + 0x1F;
+    const uint32_t max_distance = 0x400;
+
+    const uint32_t hash_bits = 10;
+
+    // frequent byte sequences of DNP3, Modbus/TCP and IEC 60870-5-104, the most common last so they're closest
+    const uint8_t dictionary[] = {
+        // IEC 60870-5-104 U-frames, an interrogation command and common ASDU headers
+        0x68, 0x04, 0x07, 0x00, 0x00, 0x00, 0x68, 0x04, 0x0B, 0x00, 0x00, 0x00,
+        0x68, 0x04, 0x43, 0x00, 0x00, 0x00, 0x68, 0x04, 0x83, 0x00, 0x00, 0x00,
+        0x68, 0x0E, 0x00, 0x00, 0x00, 0x00, 0x64, 0x01, 0x06, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x14,
+        0x0D, 0x01, 0x03, 0x00, 0x01, 0x00, 0x09, 0x01, 0x03, 0x00, 0x01, 0x00, 0x01, 0x01, 0x03, 0x00,
+        // Modbus/TCP requests and responses of the common function codes
+        0x00, 0x00, 0x00, 0x06, 0x01, 0x01, 0x00, 0x00, 0x00, 0x10,
+        0x00, 0x00, 0x00, 0x06, 0x01, 0x05, 0x00, 0x00, 0xFF, 0x00,
+        0x00, 0x00, 0x00, 0x06, 0x01, 0x06, 0x00, 0x00, 0x00, 0x01,
+        0x00, 0x00, 0x00, 0x0B, 0x01, 0x10, 0x00, 0x00, 0x00, 0x02, 0x04,
+        0x00, 0x00, 0x00, 0x06, 0x01, 0x04, 0x00, 0x00, 0x00, 0x0A,
+        0x00, 0x00, 0x00, 0x17, 0x01, 0x03, 0x14, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x06, 0x01, 0x03, 0x00, 0x00, 0x00, 0x0A,
+        // DNP3 control relay output, time sync, event and static responses, integrity poll
+        0x0C, 0x01, 0x28, 0x01, 0x00, 0x00, 0x00, 0x03, 0x01, 0xE8, 0x03, 0x00, 0x00, 0xE8, 0x03, 0x00, 0x00, 0x00,
+        0x32, 0x01, 0x07, 0x01, 0x1E, 0x01, 0x00, 0x00, 0x09, 0x01, 0x01, 0x00, 0x00, 0x09,
+        0x20, 0x01, 0x28, 0x01, 0x00, 0x00, 0x00, 0x01, 0x02, 0x01, 0x28, 0x01, 0x00, 0x00, 0x00, 0x81,
+        0xC0, 0xC0, 0x81, 0x00, 0x00, 0xE0, 0x81, 0x80, 0x00, 0xC0, 0x81, 0x90, 0x00,
+        0xC0, 0xC1, 0x01, 0x3C, 0x02, 0x06, 0x3C, 0x03, 0x06, 0x3C, 0x04, 0x06, 0x3C, 0x01, 0x06,
+        // DNP3 link headers, master at 1 and outstation at 10
+        0x05, 0x64, 0x05, 0xC0, 0x0A, 0x00, 0x01, 0x00, 0x05, 0x64, 0x0A, 0x44, 0x01, 0x00, 0x0A, 0x00,
+        0x05, 0x64, 0x14, 0xC4, 0x0A, 0x00, 0x01, 0x00, 0x05, 0x64, 0x12, 0x44, 0x01, 0x00, 0x0A, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF
+    };
+
+    const uint32_t dictionary_length = sizeof(dictionary);
+
+    inline uint32_t hash(const uint8_t* data)
+    {
+        const uint32_t value = (static_cast<uint32_t>(data[0]) << 16) | (static_cast<uint32_t>(data[1]) << 8) | data[2];
+        return (value * 2654435761u) >> (32 - hash_bits);
+    }
+
+    bool write_literals(const uint8_t* data, uint32_t length, uint8_t* output, uint32_t& written, uint32_t limit)
+    {
+        while (length > 0) {
+            const auto run = std::min(length, max_literal_run);
+            if (run + 1 > limit - written) {
+                return false;
+            }
+
+            output[written++] = static_cast<uint8_t>(run - 1);
+            memcpy(output + written, data, run);
+            written += run;
+            data += run;
+            length -= run;
+        }
+
+        return true;
+    }
+}
+
+SessionCompressor::SessionCompressor(uint32_t max_length)
+    : max_length(max_length)
+    , history(dictionary_length + max_length)
+    , output(max_length + max_expansion)
+    , primed_table(1 << hash_bits, 0)
+    , table(1 << hash_bits, 0)
+{
+    memcpy(this->history.as_wslice(), dictionary, dictionary_length);
+
+    for (uint32_t pos = 0; pos + min_match <= dictionary_length; ++pos) {
+        this->primed_table[hash(dictionary + pos)] = static_cast<uint16_t>(pos + 1);
+    }
+}
+
+seq32_t SessionCompressor::compress(const seq32_t& input)
+{
+    if (input.length() > this->max_length) {
+        return seq32_t::empty();
+    }
+
+    uint8_t* output = this->output.as_wslice();
+
+    // only use the tokens if they're shorter than the input
+    const auto length = (input.length() > 1) ? this->compress_tokens(input, output + 1, input.length() - 1) : 0;
+    if (length > 0) {
+        output[0] = tokens_header;
+        return this->output.as_rslice().take(length + 1);
+    }
+
+    output[0] = stored_header;
+    memcpy(output + 1, input, input.length());
+    return this->output.as_rslice().take(input.length() + 1);
+}
+
+uint32_t SessionCompressor::compress_tokens(const seq32_t& input, uint8_t* output, uint32_t limit)
+{
+    uint8_t* history = this->history.as_wslice();
+    memcpy(history + dictionary_length, input, input.length());
+    std::copy(this->primed_table.begin(), this->primed_table.end(), this->table.begin());
+
+    const auto end = dictionary_length + input.length();
+    auto literal_start = dictionary_length;
+    auto pos = dictionary_length;
+    uint32_t written = 0;
+
+    while (pos + min_match <= end) {
+        const auto key = hash(history + pos);
+        const uint32_t candidate = this->table[key];
+        this->table[key] = static_cast<uint16_t>(pos + 1);
+
+        uint32_t length = 0;
+        const auto match = candidate - 1;
+        if (candidate != 0 && (pos - match) <= max_distance) {
+            const auto max_length = std::min(max_match, end - pos);
+            while (length < max_length && history[match + length] == history[pos + length]) {
+                ++length;
+            }
+        }
+
+        if (length < min_match) {
+            ++pos;
+            continue;
+        }
+
+        if (!write_literals(history + literal_start, pos - literal_start, output, written, limit) || (limit - written) < 2) {
+            return 0;
+        }
+
+        const auto distance = pos - match - 1;
+        output[written++] = static_cast<uint8_t>(0x80 | ((length - min_match) << 2) | (distance >> 8));
+        output[written++] = static_cast<uint8_t>(distance & 0xFF);
+
+        // index the positions inside the match so that later data can refer to them
+        for (uint32_t i = 1; i < length && (pos + i + min_match) <= end; ++i) {
+            this->table[hash(history + pos + i)] = static_cast<uint16_t>(pos + i + 1);
+        }
+
+        pos += length;
+        literal_start = pos;
+    }
+
+    if (!write_literals(history + literal_start, end - literal_start, output, written, limit)) {
+        return 0;
+    }
+
+    return written;
+}
+
+seq32_t SessionCompressor::decompress(const seq32_t& input, wseq32_t dest, std::error_code& ec)
+{
+    if (input.is_empty()) {
+        ec = CryptoError::bad_compressed_data;
+        return seq32_t::empty();
+    }
+
+    const auto body = input.skip(1);
+    const auto max_output = std::min(this->max_length, dest.length());
+
+    if (input[0] == stored_header) {
+        if (body.length() > max_output) {
+            ec = CryptoError::bad_compressed_data;
+            return seq32_t::empty();
+        }
+
+        // the input may be a prefix of the destination
+        memmove(dest, body, body.length());
+        return dest.readonly().take(body.length());
+    }
+
+    if (input[0] != tokens_header) {
+        ec = CryptoError::bad_compressed_data;
+        return seq32_t::empty();
+    }
+
+    uint8_t* history = this->history.as_wslice();
+    const auto end = dictionary_length + max_output;
+    auto pos = dictionary_length;
+    uint32_t i = 0;
+
+    while (i < body.length()) {
+        const auto token = body[i++];
+
+        if (token & 0x80) {
+            if (i == body.length()) {
+                ec = CryptoError::bad_compressed_data;
+                return seq32_t::empty();
+            }
+
+            const uint32_t length = ((token >> 2) & 0x1F) + min_match;
+            const uint32_t distance = (((token & 0x03) << 8) | body[i++]) + 1;
+            if (distance > pos || length > end - pos) {
+                ec = CryptoError::bad_compressed_data;
+                return seq32_t::empty();
+            }
+
+            // byte by byte, the source may overlap the bytes being written
+            for (uint32_t j = 0; j < length; ++j) {
+                history[pos + j] = history[pos - distance + j];
+            }
+            pos += length;
+        } else {
+            const uint32_t length = token + 1;
+            if (length > body.length() - i || length > end - pos) {
+                ec = CryptoError::bad_compressed_data;
+                return seq32_t::empty();
+            }
+
+            memcpy(history + pos, body.skip(i), length);
+            i += length;
+            pos += length;
+        }
+    }
+
+    const auto length = pos - dictionary_length;
+    memcpy(dest, history + dictionary_length, length);
+    return dest.readonly().take(length);
+}
+
+}
@@ -0,0 +1,59 @@
+#ifndef SSP21_SESSIONCOMPRESSOR_H
+#define SSP21_SESSIONCOMPRESSOR_H
+
+#include "ssp21/util/SequenceTypes.h"
+
+#include "ser4cpp/container/Buffer.h"
+#include "ser4cpp/util/Uncopyable.h"
+
+#include <system_error>
+#include <vector>
+
+namespace ssp21 {
+
+/**
+    Compression of the user data of session messages, SessionCompressionMode::lz_scada.
+
+    Every message is compressed on its own against a fixed dictionary of common SCADA protocol
+    headers, so a lost message doesn't keep the following ones from being decompressed. Data that
+    doesn't get smaller is sent stored, so a message grows by at most max_expansion bytes.
+
+    Compression happens before encryption, so the length of a message reveals how much its
+    plaintext repeats itself. Don't enable it where secrets share messages with data an attacker
+    controls.
+
+    The data starts with a header byte, 0 if the rest is stored and 1 if it's a sequence of:
+
+    0LLLLLLL                    L + 1 literal bytes follow
+    1LLLLLDD DDDDDDDD           copy L + 3 bytes from D + 1 bytes back, the dictionary precedes the data
+*/
+class SessionCompressor final : private ser4cpp::Uncopyable {
+
+public:
+    static const uint32_t max_expansion = 1;
+
+    // max_length is the most data compressed into, or decompressed from, a single message
+    explicit SessionCompressor(uint32_t max_length);
+
+    // returns an empty sequence if the input exceeds max_length, the result is valid until the next call
+    seq32_t compress(const seq32_t& input);
+
+    seq32_t decompress(const seq32_t& input, wseq32_t dest, std::error_code& ec);
+
+private:
+    uint32_t compress_tokens(const seq32_t& input, uint8_t* output, uint32_t limit);
+
+    const uint32_t max_length;
+
+    // the dictionary followed by the data of the current message
+    ser4cpp::Buffer history;
+    ser4cpp::Buffer output;
+
+    // position + 1 of the last occurrence of each hashed 3-byte sequence, 0 if none
+    std::vector<uint16_t> primed_table;
+    std::vector<uint16_t> table;
+};
+
+}
+
+#endif
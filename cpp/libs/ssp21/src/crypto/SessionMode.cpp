@@ -69,7 +69,7 @@ SessionData SessionMode::write(const SymmetricKey& key, const AuthMetadata& meta
         return SessionData();
     }
 
-    const uint16_t tx_user_data_length = calc_user_data_tx_length(user_data.length(), encrypt_buffer.length(), 1024); // TODO - make this magic number dependent on the frame type
+    const uint16_t tx_user_data_length = calc_user_data_tx_length(user_data.length(), encrypt_buffer.length(), max_user_data_length);
 
     metadata_buffer_t buffer;
     const auto ad_bytes = get_metadata_bytes(metadata, buffer);
@@ -14,6 +14,9 @@ class SessionMode {
     aead_decrypt_func_t decrypt;
 
 public:
+    // most user data written into a single message
+    static const uint32_t max_user_data_length = 1024; // TODO - make this dependent on the frame type
+
     SessionMode(aead_encrypt_func_t encrypt, aead_decrypt_func_t decrypt);
 
     seq32_t read(const SymmetricKey& key, const SessionData& msg, wseq32_t dest, std::error_code& ec) const;
@@ -36,7 +36,7 @@ IResponderHandshake::Result SharedSecretResponderHandshake::process(const Reques
     Algorithms::Common algorithms;
 
     {
-        const auto err = algorithms.configure(msg.spec);
+        const auto err = algorithms.configure(msg.spec, msg.session_compression_mode);
         if (any(err)) {
             return Result::failure(err);
         }
@@ -0,0 +1,115 @@
+#ifndef SSP21_TXSLICES_H
+#define SSP21_TXSLICES_H
+
+#include "ssp21/stack/ILowerLayer.h"
+#include "ssp21/util/SequenceTypes.h"
+
+#include <array>
+#include <cstring>
+
+namespace ssp21 {
+/**
+    The remaining user data of a transmission, possibly spread across several buffers
+*/
+class TxSlices final {
+
+public:
+    TxSlices() = default;
+
+    explicit TxSlices(const seq32_t& data)
+    {
+        if (data.is_not_empty()) {
+            this->slices[0] = data;
+            this->count = 1;
+        }
+    }
+
+    // empty slices are skipped, returns false and leaves this unchanged if there are too many
+    bool assign(const seq32_t* input, uint32_t num_input)
+    {
+        uint32_t num_not_empty = 0;
+        for (uint32_t i = 0; i < num_input; ++i) {
+            if (input[i].is_not_empty()) {
+                ++num_not_empty;
+            }
+        }
+
+        if (num_not_empty > ILowerLayer::max_tx_slices) {
+            return false;
+        }
+
+        this->clear();
+        for (uint32_t i = 0; i < num_input; ++i) {
+            if (input[i].is_not_empty()) {
+                this->slices[this->count++] = input[i];
+            }
+        }
+
+        return true;
+    }
+
+    void clear()
+    {
+        this->count = 0;
+        this->current = 0;
+    }
+
+    bool is_empty() const
+    {
+        return this->current == this->count;
+    }
+
+    bool is_not_empty() const
+    {
+        return this->current < this->count;
+    }
+
+    uint32_t length() const
+    {
+        uint32_t sum = 0;
+        for (auto i = this->current; i < this->count; ++i) {
+            sum += this->slices[i].length();
+        }
+        return sum;
+    }
+
+    // the contiguous data at the head
+    seq32_t front() const
+    {
+        return this->is_empty() ? seq32_t::empty() : this->slices[this->current];
+    }
+
+    void advance(uint32_t num_bytes)
+    {
+        while (num_bytes > 0 && this->is_not_empty()) {
+            auto& head = this->slices[this->current];
+            const auto num = (num_bytes < head.length()) ? num_bytes : head.length();
+            head.advance(num);
+            num_bytes -= num;
+            if (head.is_empty()) {
+                ++this->current;
+            }
+        }
+    }
+
+    // copy as much of the data as fits into dest without consuming it
+    seq32_t gather(wseq32_t dest) const
+    {
+        const auto start = dest;
+        for (auto i = this->current; i < this->count && dest.is_not_empty(); ++i) {
+            const auto num = (this->slices[i].length() < dest.length()) ? this->slices[i].length() : dest.length();
+            memcpy(dest, this->slices[i], num);
+            dest.advance(num);
+        }
+        return start.readonly().take(start.length() - dest.length());
+    }
+
+private:
+    std::array<seq32_t, ILowerLayer::max_tx_slices> slices;
+    uint32_t count = 0;
+    uint32_t current = 0;
+};
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 #define SSP21_TXSTATE_H
 
 #include "crypto/Session.h"
+#include "crypto/TxSlices.h"
 
 #include "ser4cpp/util/Uncopyable.h"
 
@@ -18,13 +19,23 @@ public:
     void reset()
     {
         this->transmitting = false;
-        this->remainder.make_empty();
+        this->remainder.clear();
     }
 
     void initialize(const seq32_t& data)
     {
         this->transmitting = false;
-        this->remainder = data;
+        this->remainder = TxSlices(data);
+    }
+
+    bool initialize(const seq32_t* slices, uint32_t num_slices)
+    {
+        if (!this->remainder.assign(slices, num_slices)) {
+            return false;
+        }
+
+        this->transmitting = false;
+        return true;
     }
 
     bool is_idle() const
@@ -44,7 +55,7 @@ public:
         return false;
     }
 
-    bool begin_transmit(const seq32_t& remainder)
+    bool begin_transmit(const TxSlices& remainder)
     {
         if (this->remainder.is_empty())
             return false;
@@ -72,14 +83,14 @@ public:
         return transmitting;
     }
 
-    seq32_t get_remainder() const
+    TxSlices get_remainder() const
     {
         return remainder;
     }
 
 private:
     bool transmitting = false;
-    seq32_t remainder;
+    TxSlices remainder;
 };
 
 }
@@ -57,6 +57,8 @@ const char* CryptoErrorSpec::to_string(CryptoError arg)
             return "aead_encrypt_fail";
         case(CryptoError::aead_decrypt_fail):
             return "aead_decrypt_fail";
+        case(CryptoError::bad_compressed_data):
+            return "bad_compressed_data";
         default:
             return "undefined";
     }
@@ -53,6 +53,8 @@ HandshakeError HandshakeErrorSpec::from_type(uint8_t arg)
             return HandshakeError::no_prior_handshake_begin;
         case(0xD):
             return HandshakeError::key_not_found;
+        case(0xE):
+            return HandshakeError::unsupported_compression_mode;
         case(0xFF):
             return HandshakeError::unknown;
         case(0xFD):
@@ -93,6 +95,8 @@ const char* HandshakeErrorSpec::to_string(HandshakeError arg)
             return "no_prior_handshake_begin";
         case(HandshakeError::key_not_found):
             return "key_not_found";
+        case(HandshakeError::unsupported_compression_mode):
+            return "unsupported_compression_mode";
         case(HandshakeError::unknown):
             return "unknown";
         case(HandshakeError::none):
@@ -30,14 +30,16 @@ RequestHandshakeBegin::RequestHandshakeBegin(
     const SessionConstraints& constraints,
     HandshakeMode handshake_mode,
     const seq32_t& mode_ephemeral,
-    const seq32_t& mode_data
+    const seq32_t& mode_data,
+    SessionCompressionMode session_compression_mode
 ) :
     version(version),
     spec(spec),
     constraints(constraints),
     handshake_mode(handshake_mode),
     mode_ephemeral(mode_ephemeral),
-    mode_data(mode_data)
+    mode_data(mode_data),
+    session_compression_mode(session_compression_mode)
 {}
 
 size_t RequestHandshakeBegin::size() const
@@ -49,7 +51,8 @@ size_t RequestHandshakeBegin::size() const
         constraints,
         handshake_mode,
         mode_ephemeral,
-        mode_data
+        mode_data,
+        session_compression_mode
     );
 }
 
@@ -65,7 +68,8 @@ ParseError RequestHandshakeBegin::read(seq32_t input)
             constraints,
             handshake_mode,
             mode_ephemeral,
-            mode_data
+            mode_data,
+            session_compression_mode
         );
     };
 
@@ -83,7 +87,8 @@ FormatResult RequestHandshakeBegin::write(wseq32_t& output) const
             constraints,
             handshake_mode,
             mode_ephemeral,
-            mode_data
+            mode_data,
+            session_compression_mode
         );
     };
 
@@ -104,7 +109,9 @@ void RequestHandshakeBegin::print(IMessagePrinter& printer) const
         "mode_ephemeral",
         mode_ephemeral,
         "mode_data",
-        mode_data
+        mode_data,
+        "session_compression_mode",
+        session_compression_mode
     );
 }
 
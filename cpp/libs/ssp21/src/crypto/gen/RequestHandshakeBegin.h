@@ -18,7 +18,9 @@
 
 #include "ssp21/crypto/EnumField.h"
 #include "ssp21/crypto/SeqByteField.h"
+#include "ssp21/crypto/OptionalEnumField.h"
 #include "ssp21/crypto/gen/HandshakeMode.h"
+#include "ssp21/crypto/gen/SessionCompressionMode.h"
 #include "crypto/IMessage.h"
 #include "crypto/gen/Version.h"
 #include "crypto/gen/Function.h"
@@ -37,7 +39,8 @@ struct RequestHandshakeBegin final : public IMessage
         const SessionConstraints& constraints,
         HandshakeMode handshake_mode,
         const seq32_t& mode_ephemeral,
-        const seq32_t& mode_data
+        const seq32_t& mode_data,
+        SessionCompressionMode session_compression_mode
     );
 
     size_t size() const;
@@ -56,6 +59,7 @@ struct RequestHandshakeBegin final : public IMessage
     EnumField<HandshakeModeSpec> handshake_mode;
     SeqByteField mode_ephemeral;
     SeqByteField mode_data;
+    OptionalEnumField<SessionCompressionModeSpec, SessionCompressionMode::none> session_compression_mode;
 
 };
 
@@ -0,0 +1,49 @@
+//
+//  _   _         ______    _ _ _   _             _ _ _
+// | \ | |       |  ____|  | (_) | (_)           | | | |
+// |  \| | ___   | |__   __| |_| |_ _ _ __   __ _| | | |
+// | . ` |/ _ \  |  __| / _` | | __| | '_ \ / _` | | | |
+// | |\  | (_) | | |___| (_| | | |_| | | | | (_| |_|_|_|
+// |_| \_|\___/  |______\__,_|_|\__|_|_| |_|\__, (_|_|_)
+//                                           __/ |
+//                                          |___/
+//
+// This file is auto-generated. Do not edit manually
+//
+// Licensed under the terms of the BSDv3 license
+//
+
+#include "ssp21/crypto/gen/SessionCompressionMode.h"
+
+namespace ssp21 {
+
+uint8_t SessionCompressionModeSpec::to_type(SessionCompressionMode arg)
+{
+    return static_cast<uint8_t>(arg);
+}
+SessionCompressionMode SessionCompressionModeSpec::from_type(uint8_t arg)
+{
+    switch(arg)
+    {
+        case(0x0):
+            return SessionCompressionMode::none;
+        case(0x1):
+            return SessionCompressionMode::lz_scada;
+        default:
+            return SessionCompressionMode::undefined;
+    }
+}
+const char* SessionCompressionModeSpec::to_string(SessionCompressionMode arg)
+{
+    switch(arg)
+    {
+        case(SessionCompressionMode::none):
+            return "none";
+        case(SessionCompressionMode::lz_scada):
+            return "lz_scada";
+        default:
+            return "undefined";
+    }
+}
+
+}
@@ -65,6 +65,11 @@ bool LinkLayer::start_tx_from_upper(const seq32_t& data)
     return this->lower->start_tx_from_upper(data);
 }
 
+bool LinkLayer::start_gather_tx_from_upper(const seq32_t* slices, uint32_t num_slices)
+{
+    return this->lower->start_gather_tx_from_upper(slices, num_slices);
+}
+
 // ---- private helpers -----
 
 bool LinkLayer::get_frame()
@@ -31,6 +31,8 @@ private:
     // ---- ILowerLayer ----
     virtual bool is_tx_ready() const override;
     virtual bool start_tx_from_upper(const seq32_t& data) override;
+
+    virtual bool start_gather_tx_from_upper(const seq32_t* slices, uint32_t num_slices) override;
     virtual void discard_rx_data() override;
     virtual seq32_t start_rx_from_upper_impl() override;
 
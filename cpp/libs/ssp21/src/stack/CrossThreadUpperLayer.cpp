@@ -0,0 +1,179 @@
+
+#include "ssp21/stack/CrossThreadUpperLayer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ssp21 {
+
+std::shared_ptr<CrossThreadUpperLayer> CrossThreadUpperLayer::create(const std::shared_ptr<exe4cpp::IExecutor>& executor, const Config& config, const rx_ready_handler_t& on_rx_ready)
+{
+    return std::shared_ptr<CrossThreadUpperLayer>(new CrossThreadUpperLayer(executor, config, on_rx_ready));
+}
+
+CrossThreadUpperLayer::CrossThreadUpperLayer(const std::shared_ptr<exe4cpp::IExecutor>& executor, const Config& config, const rx_ready_handler_t& on_rx_ready)
+    : executor(executor)
+    , on_rx_ready(on_rx_ready)
+    , tx_slot_size(std::max(config.tx_slot_size, 1u))
+    , rx_slot_size(std::max(config.rx_slot_size, 1u))
+    , tx_ring(config.tx_slot_count, [this](Message& message) { message.data.resize(this->tx_slot_size); })
+    , rx_ring(config.rx_slot_count, [this](Message& message) { message.data.resize(this->rx_slot_size); })
+{
+}
+
+void CrossThreadUpperLayer::bind(ILowerLayer& stack)
+{
+    this->stack = &stack;
+}
+
+bool CrossThreadUpperLayer::try_send(const seq32_t& message)
+{
+    if (message.is_empty() || message.length() > this->tx_slot_size) {
+        return false;
+    }
+
+    const auto pushed = this->tx_ring.try_push([&message](Message& slot) {
+        memcpy(slot.data.data(), message, message.length());
+        slot.length = message.length();
+    });
+
+    if (!pushed) {
+        return false;
+    }
+
+    // only the producer that finds the executor idle posts the drain
+    if (!this->is_tx_drain_posted.exchange(true, std::memory_order_acq_rel)) {
+        auto self = this->shared_from_this();
+        this->executor->post([self]() { self->drain_tx(); });
+    }
+
+    return true;
+}
+
+void CrossThreadUpperLayer::drain_tx()
+{
+    // cleared first, so messages pushed after this point post another drain
+    this->is_tx_drain_posted.exchange(false, std::memory_order_acq_rel);
+    this->try_start_tx();
+}
+
+void CrossThreadUpperLayer::try_start_tx()
+{
+    if (!this->stack || !this->is_open() || this->num_tx_in_flight > 0 || !this->stack->is_tx_ready()) {
+        return;
+    }
+
+    seq32_t slices[ILowerLayer::max_tx_slices];
+    uint32_t count = 0;
+    while (count < ILowerLayer::max_tx_slices) {
+        const auto message = this->tx_ring.peek(count);
+        if (!message) {
+            break;
+        }
+        slices[count] = seq32_t(message->data.data(), message->length);
+        ++count;
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    if (this->stack->start_gather_tx_from_upper(slices, count)) {
+        this->num_tx_in_flight = count;
+    } else if (count > 1 && this->stack->start_tx_from_upper(slices[0])) {
+        // the stack doesn't gather, hand it one message at a time
+        this->num_tx_in_flight = 1;
+    }
+}
+
+void CrossThreadUpperLayer::read_from_stack()
+{
+    if (!this->stack || !this->is_open()) {
+        return;
+    }
+
+    bool is_any_pushed = false;
+
+    while (true) {
+        if (this->rx_data.is_empty()) {
+            this->rx_data = this->stack->start_rx_from_upper();
+            if (this->rx_data.is_empty()) {
+                break;
+            }
+        }
+
+        if (!this->try_push_rx_chunk()) {
+            // the consumer may have made room before it could see the flag, so check once more after setting it
+            this->is_rx_blocked.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!this->try_push_rx_chunk()) {
+                break;
+            }
+            this->is_rx_blocked.store(false, std::memory_order_relaxed);
+        }
+
+        is_any_pushed = true;
+    }
+
+    if (is_any_pushed && this->on_rx_ready) {
+        this->on_rx_ready();
+    }
+}
+
+bool CrossThreadUpperLayer::try_push_rx_chunk()
+{
+    const auto chunk = this->rx_data.take(this->rx_slot_size);
+
+    const auto pushed = this->rx_ring.try_push([&chunk](Message& slot) {
+        memcpy(slot.data.data(), chunk, chunk.length());
+        slot.length = chunk.length();
+    });
+
+    if (pushed) {
+        this->rx_data.advance(chunk.length());
+    }
+
+    return pushed;
+}
+
+void CrossThreadUpperLayer::on_lower_open_impl()
+{
+    // messages submitted while the session was down
+    this->try_start_tx();
+}
+
+void CrossThreadUpperLayer::on_lower_close_impl()
+{
+    // the stack drops the messages it was transmitting, queued messages wait for the next session
+    for (uint32_t i = 0; i < this->num_tx_in_flight; ++i) {
+        this->tx_ring.pop();
+    }
+    this->num_tx_in_flight = 0;
+    this->rx_data = seq32_t::empty();
+}
+
+void CrossThreadUpperLayer::on_lower_tx_ready_impl()
+{
+    for (uint32_t i = 0; i < this->num_tx_in_flight; ++i) {
+        this->tx_ring.pop();
+    }
+    this->num_tx_in_flight = 0;
+
+    this->try_start_tx();
+}
+
+void CrossThreadUpperLayer::on_lower_rx_ready_impl()
+{
+    this->read_from_stack();
+}
+
+void CrossThreadUpperLayer::on_rx_slot_released()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (this->is_rx_blocked.exchange(false, std::memory_order_seq_cst)) {
+        auto self = this->shared_from_this();
+        this->executor->post([self]() { self->read_from_stack(); });
+    }
+}
+
+}
@@ -31,6 +31,11 @@ public:
         return lower.start_tx_from_upper(data);
     }
 
+    virtual bool start_gather_tx_from_upper(const seq32_t* slices, uint32_t num_slices)
+    {
+        return lower.start_gather_tx_from_upper(slices, num_slices);
+    }
+
     virtual void discard_rx_data()
     {
         lower.discard_rx_data();
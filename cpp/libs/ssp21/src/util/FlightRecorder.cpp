@@ -0,0 +1,118 @@
+#include "ssp21/util/FlightRecorder.h"
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ssp21 {
+
+namespace {
+const char dump_magic[8] = { 'S', 'S', 'P', '2', '1', 'F', 'L', 'T' };
+
+uint64_t steady_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+}
+
+// the rings outlive their threads, so that a dump still shows what a finished thread did
+struct FlightRecorder::Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+    uint64_t start_ticks = 0;
+    uint64_t start_ns = 0;
+};
+
+const uint32_t FlightRecorder::ring_size;
+const uint32_t FlightRecorder::dump_version;
+const uint32_t FlightRecorder::num_slots;
+
+std::atomic<bool> FlightRecorder::enabled{ true };
+thread_local FlightRecorder::Ring* FlightRecorder::thread_ring = nullptr;
+
+FlightRecorder::Registry& FlightRecorder::get_registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+FlightRecorder::Ring* FlightRecorder::create_thread_ring()
+{
+    auto ring = std::make_unique<Ring>();
+    ring->thread_id = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+    auto& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    if (registry.rings.empty()) {
+        registry.start_ticks = now();
+        registry.start_ns = steady_ns();
+    }
+
+    thread_ring = ring.get();
+    registry.rings.push_back(std::move(ring));
+    return thread_ring;
+}
+
+bool FlightRecorder::dump(const std::string& path)
+{
+    auto& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    DumpHeader header{};
+    memcpy(header.magic, dump_magic, sizeof(header.magic));
+    header.version = dump_version;
+    header.num_rings = static_cast<uint32_t>(registry.rings.size());
+    header.start_ticks = registry.start_ticks;
+    header.start_ns = registry.start_ns;
+    header.dump_ticks = now();
+    header.dump_ns = steady_ns();
+    header.dump_wall_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+
+    const auto file = fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    std::vector<FlightEvent> events(num_slots);
+    std::vector<uint64_t> words(num_slots * words_per_event);
+
+    for (const auto& ring : registry.rings) {
+        // copy first, then drop whatever the thread may have overwritten in the meantime
+        const auto first_head = ring->head.load(std::memory_order_acquire);
+        for (size_t i = 0; i < words.size(); ++i) {
+            words[i] = ring->words[i].load(std::memory_order_relaxed);
+        }
+
+        // pairs with the release fence in record(): if a copied word belongs to event N, the head
+        // loaded below is at least N, so the slot it overwrote is dropped
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto last_head = ring->head.load(std::memory_order_relaxed);
+        memcpy(events.data(), words.data(), sizeof(FlightEvent) * num_slots);
+
+        // the slot of last_head may be half written, it held the event num_slots before it
+        const auto oldest = (last_head + 1 > num_slots) ? last_head + 1 - num_slots : 0;
+        const auto begin = (first_head > ring_size) ? first_head - ring_size : 0;
+        const auto start = (oldest > begin) ? oldest : begin;
+        const auto count = (first_head > start) ? first_head - start : 0;
+
+        RingHeader ring_header{};
+        ring_header.thread_id = ring->thread_id;
+        ring_header.num_events = static_cast<uint32_t>(count);
+        success = success && fwrite(&ring_header, sizeof(ring_header), 1, file) == 1;
+
+        for (auto i = start; i < first_head; ++i) {
+            success = success && fwrite(&events[i % num_slots], sizeof(FlightEvent), 1, file) == 1;
+        }
+    }
+
+    return (fclose(file) == 0) && success;
+}
+
+}
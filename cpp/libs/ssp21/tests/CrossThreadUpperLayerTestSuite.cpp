@@ -0,0 +1,173 @@
+#include "catch.hpp"
+
+#include "mocks/MockLowerLayer.h"
+
+#include "ssp21/stack/CrossThreadUpperLayer.h"
+
+#include "exe4cpp/MockExecutor.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define SUITE(name) "CrossThreadUpperLayerTestSuite - " name
+
+using namespace ssp21;
+
+namespace {
+struct Fixture {
+    explicit Fixture(const CrossThreadUpperLayer::Config& config)
+        : exe(std::make_shared<exe4cpp::MockExecutor>())
+        , layer(CrossThreadUpperLayer::create(exe, config, [this]() { ++this->num_rx_ready; }))
+    {
+        this->layer->bind(this->lower);
+        this->lower.bind_upper(*this->layer);
+    }
+
+    bool send(const std::string& hex)
+    {
+        const auto buffer = ser4cpp::HexConversions::from_hex(hex);
+        return this->layer->try_send(buffer->as_rslice());
+    }
+
+    std::string receive()
+    {
+        std::string hex;
+        REQUIRE(this->layer->try_receive([&hex](const seq32_t& data) { hex = ser4cpp::HexConversions::to_hex(data); }));
+        return hex;
+    }
+
+    const std::shared_ptr<exe4cpp::MockExecutor> exe;
+    MockLowerLayer lower;
+    uint32_t num_rx_ready = 0;
+    const std::shared_ptr<CrossThreadUpperLayer> layer;
+};
+
+CrossThreadUpperLayer::Config get_config(uint32_t slot_count, uint32_t slot_size)
+{
+    CrossThreadUpperLayer::Config config;
+    config.tx_slot_count = slot_count;
+    config.tx_slot_size = slot_size;
+    config.rx_slot_count = slot_count;
+    config.rx_slot_size = slot_size;
+    return config;
+}
+}
+
+TEST_CASE(SUITE("holds messages until the stack opens"))
+{
+    Fixture fix(get_config(4, 8));
+
+    REQUIRE(fix.send("01 02"));
+    REQUIRE(fix.send("03"));
+    fix.exe->run_many();
+    REQUIRE(fix.lower.num_tx_messages() == 0);
+
+    // the mock only transmits one slice at a time, so the layer falls back to single messages
+    fix.layer->on_lower_open();
+    REQUIRE(fix.lower.num_tx_messages() == 1);
+    REQUIRE(fix.lower.pop_tx_message() == "01 02");
+
+    fix.layer->on_lower_tx_ready();
+    REQUIRE(fix.lower.num_tx_messages() == 1);
+    REQUIRE(fix.lower.pop_tx_message() == "03");
+
+    fix.layer->on_lower_tx_ready();
+    REQUIRE(fix.lower.num_tx_messages() == 0);
+}
+
+TEST_CASE(SUITE("posts a single drain for a batch of messages"))
+{
+    Fixture fix(get_config(4, 8));
+    fix.layer->on_lower_open();
+
+    REQUIRE(fix.send("01"));
+    REQUIRE(fix.send("02"));
+    REQUIRE(fix.send("03"));
+    REQUIRE(fix.exe->run_many() == 1);
+    REQUIRE(fix.lower.pop_tx_message() == "01");
+}
+
+TEST_CASE(SUITE("rejects messages that don't fit"))
+{
+    Fixture fix(get_config(2, 2));
+
+    REQUIRE_FALSE(fix.send(""));
+    REQUIRE_FALSE(fix.send("01 02 03"));
+    REQUIRE(fix.send("01 02"));
+    REQUIRE(fix.send("03"));
+    REQUIRE_FALSE(fix.send("04"));
+
+    // slots are released once the stack has transmitted them
+    fix.layer->on_lower_open();
+    REQUIRE_FALSE(fix.send("04"));
+    fix.layer->on_lower_tx_ready();
+    REQUIRE(fix.send("04"));
+}
+
+TEST_CASE(SUITE("leaves received data in the stack while the consumer is behind"))
+{
+    Fixture fix(get_config(1, 2));
+    fix.layer->on_lower_open();
+
+    // split into two chunks, only the first fits
+    fix.lower.enqueue_message("01 02 03");
+    REQUIRE(fix.num_rx_ready == 1);
+    fix.lower.enqueue_message("04");
+    REQUIRE(fix.lower.num_rx_messages() == 2);
+
+    REQUIRE(fix.receive() == "01 02");
+    REQUIRE(fix.exe->run_many() == 1);
+    REQUIRE(fix.receive() == "03");
+    REQUIRE(fix.exe->run_many() == 1);
+    REQUIRE(fix.receive() == "04");
+    REQUIRE(fix.exe->run_many() == 0);
+    REQUIRE(fix.lower.num_rx_messages() == 0);
+    REQUIRE(fix.num_rx_ready == 3);
+
+    REQUIRE_FALSE(fix.layer->try_receive([](const seq32_t&) {}));
+}
+
+TEST_CASE(SUITE("accepts messages from several threads"))
+{
+    const uint32_t num_threads = 4;
+    const uint32_t num_messages = 250;
+
+    Fixture fix(get_config(num_threads * num_messages, 1));
+    fix.layer->on_lower_open();
+
+    // catch assertions aren't thread-safe, count the failures instead
+    std::atomic<uint32_t> num_failures{ 0 };
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&fix, &num_failures, t]() {
+            const uint8_t value = static_cast<uint8_t>(t);
+            for (uint32_t i = 0; i < num_messages; ++i) {
+                if (!fix.layer->try_send(seq32_t(&value, 1))) {
+                    ++num_failures;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(num_failures == 0);
+
+    fix.exe->run_many();
+
+    std::vector<uint32_t> counts(num_threads, 0);
+    for (uint32_t i = 0; i < num_threads * num_messages; ++i) {
+        REQUIRE(fix.lower.num_tx_messages() == 1);
+        const auto hex = fix.lower.pop_tx_message();
+        ++counts[ser4cpp::HexConversions::from_hex(hex)->as_rslice()[0]];
+        fix.layer->on_lower_tx_ready();
+    }
+
+    REQUIRE(fix.lower.num_tx_messages() == 0);
+    for (auto count : counts) {
+        REQUIRE(count == num_messages);
+    }
+}
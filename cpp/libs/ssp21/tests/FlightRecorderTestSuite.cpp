@@ -0,0 +1,114 @@
+#include "catch.hpp"
+
+#include "fixtures/CryptoLayerFixture.h"
+
+#include "ssp21/util/FlightRecorder.h"
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#define SUITE(name) "FlightRecorderTestSuite - " name
+
+using namespace ssp21;
+
+namespace {
+const char* const dump_path = "flight_recorder_test.bin";
+
+struct Dump {
+    FlightRecorder::DumpHeader header;
+    std::vector<std::vector<FlightEvent>> rings;
+};
+
+Dump dump_and_read()
+{
+    REQUIRE(FlightRecorder::dump(dump_path));
+
+    Dump dump{};
+    const auto file = fopen(dump_path, "rb");
+    REQUIRE(file != nullptr);
+    REQUIRE(fread(&dump.header, sizeof(dump.header), 1, file) == 1);
+
+    for (uint32_t i = 0; i < dump.header.num_rings; ++i) {
+        FlightRecorder::RingHeader ring_header{};
+        REQUIRE(fread(&ring_header, sizeof(ring_header), 1, file) == 1);
+        std::vector<FlightEvent> events(ring_header.num_events);
+        REQUIRE(fread(events.data(), sizeof(FlightEvent), events.size(), file) == events.size());
+        dump.rings.push_back(events);
+    }
+
+    fclose(file);
+    remove(dump_path);
+    return dump;
+}
+
+// earlier tests may have recorded events for objects at the same address
+std::vector<FlightEvent> find_events(const Dump& dump, const void* source, uint64_t since)
+{
+    std::vector<FlightEvent> events;
+    for (const auto& ring : dump.rings) {
+        for (const auto& event : ring) {
+            if (event.source == reinterpret_cast<uintptr_t>(source) && event.ticks >= since) {
+                events.push_back(event);
+            }
+        }
+    }
+    return events;
+}
+}
+
+TEST_CASE(SUITE("keeps the most recent events of a thread"))
+{
+    const auto start = FlightRecorder::now();
+    const int source = 0;
+    const uint32_t num_events = FlightRecorder::ring_size + 10;
+
+    for (uint32_t i = 0; i < num_events; ++i) {
+        FlightRecorder::record(FlightEventType::socket_rx, &source, 0, i);
+    }
+
+    const auto dump = dump_and_read();
+    REQUIRE(memcmp(dump.header.magic, "SSP21FLT", 8) == 0);
+    REQUIRE(dump.header.version == FlightRecorder::dump_version);
+
+    const auto events = find_events(dump, &source, start);
+    REQUIRE(events.size() == FlightRecorder::ring_size);
+    REQUIRE(events.front().value == num_events - FlightRecorder::ring_size);
+    REQUIRE(events.back().value == num_events - 1);
+
+    for (size_t i = 1; i < events.size(); ++i) {
+        REQUIRE(events[i].ticks >= events[i - 1].ticks);
+    }
+}
+
+TEST_CASE(SUITE("dumps the events of other threads"))
+{
+    const auto start = FlightRecorder::now();
+    const int source = 0;
+
+    std::thread thread([&source]() {
+        FlightRecorder::record(FlightEventType::socket_error, &source, 7, 42, 99);
+    });
+    thread.join();
+
+    const auto events = find_events(dump_and_read(), &source, start);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].type == static_cast<uint16_t>(FlightEventType::socket_error));
+    REQUIRE(events[0].code == 7);
+    REQUIRE(events[0].value == 42);
+    REQUIRE(events[0].extra == 99);
+}
+
+TEST_CASE(SUITE("records the handshake states of the initiator"))
+{
+    const auto start = FlightRecorder::now();
+    InitiatorFixture fix;
+    fix.initiator.on_lower_open();
+
+    const auto events = find_events(dump_and_read(), &fix.initiator, start);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].type == static_cast<uint16_t>(FlightEventType::initiator_state));
+    REQUIRE(events[0].code == static_cast<uint16_t>(Initiator::IHandshakeState::Enum::wait_for_begin_reply));
+    REQUIRE(events[0].value == static_cast<uint32_t>(Initiator::IHandshakeState::Enum::idle));
+}
@@ -3,6 +3,11 @@
 
 #include "fixtures/CryptoLayerFixture.h"
 
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
 #define SUITE(name) "InitiatorTestSuite - " name
 
 using namespace ssp21;
@@ -12,9 +17,12 @@ using HandshakeState = Initiator::IHandshakeState::Enum;
 void test_open(InitiatorFixture& fix);
 void test_request_handshake_begin(InitiatorFixture& fix);
 void test_response_timeout(InitiatorFixture& fix, HandshakeState new_state);
-void test_reply_handshake_begin(InitiatorFixture& fix);
+void test_reply_handshake_begin(InitiatorFixture& fix, const std::string& early_data = "");
 void test_reply_handshake_auth(InitiatorFixture& fix);
 void test_open_and_full_handshake(InitiatorFixture& fix);
+std::vector<exe4cpp::duration_t> get_handshake_begin_times(const InitiatorConfig& config, size_t num_handshakes);
+exe4cpp::duration_t get_renegotiation_time(const InitiatorConfig& config);
+size_t get_max_bucket_size(const std::vector<exe4cpp::duration_t>& times, const exe4cpp::duration_t& bucket_width);
 
 // ---------- tests for initial state -----------
 
@@ -171,6 +179,213 @@ TEST_CASE(SUITE("goes to retry state if auth reply doesn't authenticate"))
         });
 }
 
+// ---------- early data -----------
+
+TEST_CASE(SUITE("refuses data before the session is open unless early data is enabled"))
+{
+    InitiatorFixture fix;
+    test_open(fix);
+
+    const auto data = ser4cpp::HexConversions::from_hex("CAFE");
+    REQUIRE_FALSE(fix.initiator.start_tx_from_upper(data->as_rslice()));
+}
+
+TEST_CASE(SUITE("refuses early data larger than the limit"))
+{
+    InitiatorConfig config;
+    config.params.max_early_data_size = 1;
+    InitiatorFixture fix(config);
+    test_open(fix);
+
+    const auto data = ser4cpp::HexConversions::from_hex("CAFE");
+    REQUIRE_FALSE(fix.initiator.start_tx_from_upper(data->as_rslice()));
+}
+
+TEST_CASE(SUITE("sends early data with the session auth message"))
+{
+    InitiatorConfig config;
+    config.params.max_early_data_size = 16;
+    InitiatorFixture fix(config);
+    test_open(fix);
+
+    const auto data = ser4cpp::HexConversions::from_hex("CAFE");
+    REQUIRE(fix.initiator.start_tx_from_upper(data->as_rslice()));
+    test_reply_handshake_begin(fix, "CAFE");
+
+    // the upper layer learns that the data went out once the session opens
+    fix.initiator.on_lower_tx_ready();
+    REQUIRE(fix.upper.num_tx_ready == 0);
+
+    test_reply_handshake_auth(fix);
+    REQUIRE(fix.upper.num_tx_ready == 1);
+    REQUIRE(fix.lower.num_tx_messages() == 0);
+}
+
+TEST_CASE(SUITE("drops early data if the auth reply is lost instead of sending it again"))
+{
+    InitiatorConfig config;
+    config.params.max_early_data_size = 16;
+    InitiatorFixture fix(config);
+    test_open(fix);
+
+    const auto data = ser4cpp::HexConversions::from_hex("CAFE");
+    REQUIRE(fix.initiator.start_tx_from_upper(data->as_rslice()));
+    test_reply_handshake_begin(fix, "CAFE");
+    fix.initiator.on_lower_tx_ready();
+
+    // the responder may have delivered the data, only the reply is missing
+    test_response_timeout(fix, HandshakeState::wait_for_retry);
+    REQUIRE(fix.upper.num_tx_dropped == 1);
+    REQUIRE(fix.upper.num_tx_ready == 0);
+
+    REQUIRE(fix.exe->advance_to_next_timer());
+    REQUIRE(fix.exe->run_many() > 0);
+    test_request_handshake_begin(fix);
+    test_reply_handshake_begin(fix);
+
+    test_reply_handshake_auth(fix);
+    REQUIRE(fix.upper.num_tx_dropped == 1);
+    REQUIRE(fix.upper.num_tx_ready == 0);
+    REQUIRE(fix.lower.num_tx_messages() == 0);
+}
+
+TEST_CASE(SUITE("keeps early data that hasn't been sent across a failed handshake"))
+{
+    InitiatorConfig config;
+    config.params.max_early_data_size = 16;
+    InitiatorFixture fix(config);
+    test_open(fix);
+    test_response_timeout(fix, HandshakeState::wait_for_retry);
+
+    const auto data = ser4cpp::HexConversions::from_hex("CAFE");
+    REQUIRE(fix.initiator.start_tx_from_upper(data->as_rslice()));
+
+    REQUIRE(fix.exe->advance_to_next_timer());
+    REQUIRE(fix.exe->run_many() > 0);
+    test_request_handshake_begin(fix);
+    test_reply_handshake_begin(fix, "CAFE");
+    REQUIRE(fix.upper.num_tx_dropped == 0);
+}
+
+TEST_CASE(SUITE("tells the upper layer when closing drops early data"))
+{
+    InitiatorConfig config;
+    config.params.max_early_data_size = 16;
+    InitiatorFixture fix(config);
+    test_open(fix);
+
+    const auto data = ser4cpp::HexConversions::from_hex("CAFE");
+    REQUIRE(fix.initiator.start_tx_from_upper(data->as_rslice()));
+
+    fix.initiator.on_lower_close();
+    REQUIRE(fix.upper.num_tx_dropped == 1);
+}
+
+// ---------- retry backoff and renegotiation spread -----------
+
+TEST_CASE(SUITE("retry timeout doubles after each failure up to the maximum"))
+{
+    InitiatorConfig config;
+    config.params.retry_timeout = std::chrono::seconds(1);
+    config.params.max_retry_timeout = std::chrono::seconds(8);
+
+    const auto times = get_handshake_begin_times(config, 7);
+
+    const std::vector<exe4cpp::duration_t> expected_retry_timeouts = {
+        std::chrono::seconds(1),
+        std::chrono::seconds(2),
+        std::chrono::seconds(4),
+        std::chrono::seconds(8),
+        std::chrono::seconds(8),
+        std::chrono::seconds(8)
+    };
+
+    for (size_t i = 1; i < times.size(); ++i) {
+        REQUIRE((times[i] - times[i - 1]) == (consts::crypto::initiator::default_response_timeout + expected_retry_timeouts[i - 1]));
+    }
+}
+
+TEST_CASE(SUITE("retry timeout with full jitter stays between zero and the backoff"))
+{
+    InitiatorConfig config;
+    config.params.retry_timeout = std::chrono::seconds(1);
+    config.params.max_retry_timeout = std::chrono::seconds(8);
+    config.params.retry_jitter = true;
+    config.params.random_seed = 42;
+
+    const auto times = get_handshake_begin_times(config, 7);
+
+    std::set<exe4cpp::duration_t::rep> distinct;
+    auto backoff = std::chrono::duration_cast<exe4cpp::duration_t>(std::chrono::seconds(1));
+
+    for (size_t i = 1; i < times.size(); ++i) {
+        const auto retry_timeout = times[i] - times[i - 1] - consts::crypto::initiator::default_response_timeout;
+        REQUIRE(retry_timeout >= exe4cpp::duration_t::zero());
+        REQUIRE(retry_timeout <= backoff);
+        distinct.insert(retry_timeout.count());
+        backoff = std::min<exe4cpp::duration_t>(backoff * 2, std::chrono::seconds(8));
+    }
+
+    REQUIRE(distinct.size() > 1);
+}
+
+TEST_CASE(SUITE("simulated initiators without jitter retry in lock-step"))
+{
+    const size_t num_initiators = 200;
+
+    InitiatorConfig config;
+
+    std::vector<exe4cpp::duration_t> retries;
+    for (size_t i = 0; i < num_initiators; ++i) {
+        const auto times = get_handshake_begin_times(config, 8);
+        // every initiator opens at the same moment, only the retries can be spread
+        retries.insert(retries.end(), times.begin() + 1, times.end());
+    }
+
+    REQUIRE(get_max_bucket_size(retries, std::chrono::milliseconds(100)) == num_initiators);
+}
+
+TEST_CASE(SUITE("simulated initiators with backoff and jitter spread their retries"))
+{
+    const size_t num_initiators = 200;
+
+    InitiatorConfig config;
+    config.params.retry_timeout = std::chrono::seconds(1);
+    config.params.max_retry_timeout = std::chrono::seconds(32);
+    config.params.retry_jitter = true;
+
+    std::vector<exe4cpp::duration_t> retries;
+    for (size_t i = 0; i < num_initiators; ++i) {
+        config.params.random_seed = static_cast<uint32_t>(i + 1);
+        const auto times = get_handshake_begin_times(config, 8);
+        retries.insert(retries.end(), times.begin() + 1, times.end());
+    }
+
+    // without jitter all of them would land in the same bucket
+    REQUIRE(get_max_bucket_size(retries, std::chrono::milliseconds(100)) < (num_initiators / 4));
+}
+
+TEST_CASE(SUITE("simulated initiators spread session time renegotiation"))
+{
+    const size_t num_initiators = 200;
+    const auto trigger = std::chrono::milliseconds(consts::crypto::initiator::default_session_time_renegotiation_trigger_ms);
+    const auto spread = std::chrono::minutes(10);
+
+    InitiatorConfig config;
+    config.params.session_time_renegotiation_spread_ms = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(spread).count());
+
+    std::vector<exe4cpp::duration_t> renegotiations;
+    for (size_t i = 0; i < num_initiators; ++i) {
+        config.params.random_seed = static_cast<uint32_t>(i + 1);
+        const auto time = get_renegotiation_time(config);
+        REQUIRE(time <= trigger);
+        REQUIRE(time >= (trigger - spread));
+        renegotiations.push_back(time);
+    }
+
+    REQUIRE(get_max_bucket_size(renegotiations, std::chrono::minutes(1)) < (num_initiators / 4));
+}
+
 // ---------- helper implementations -----------
 
 void test_open(InitiatorFixture& fix)
@@ -223,7 +438,7 @@ void test_response_timeout(InitiatorFixture& fix, HandshakeState new_state)
     fix.expect_empty();
 }
 
-void test_reply_handshake_begin(InitiatorFixture& fix)
+void test_reply_handshake_begin(InitiatorFixture& fix, const std::string& early_data)
 {
     REQUIRE(fix.initiator.get_state_enum() == HandshakeState::wait_for_begin_reply);
 
@@ -237,7 +452,7 @@ void test_reply_handshake_begin(InitiatorFixture& fix)
 
     REQUIRE(end_stats.num_init == (start_stats.num_init + 1));
 
-    const auto expected = hex::session_data(0, consts::crypto::default_ttl_pad_ms, "", hex::repeat(0xFF, consts::crypto::trunc16));
+    const auto expected = hex::session_data(0, consts::crypto::default_ttl_pad_ms, early_data, hex::repeat(0xFF, consts::crypto::trunc16));
     REQUIRE(fix.lower.pop_tx_message() == expected);
 
     REQUIRE(fix.initiator.get_state_enum() == HandshakeState::wait_for_auth_reply);
@@ -284,3 +499,62 @@ void test_open_and_full_handshake(InitiatorFixture& fix)
     test_reply_handshake_begin(fix);
     test_reply_handshake_auth(fix);
 }
+
+std::vector<exe4cpp::duration_t> get_handshake_begin_times(const InitiatorConfig& config, size_t num_handshakes)
+{
+    // the responder never answers, so every handshake times out and is retried
+    InitiatorFixture fix(config);
+
+    const auto start = fix.exe->get_time();
+    std::vector<exe4cpp::duration_t> times;
+
+    fix.initiator.on_lower_open();
+
+    while (true) {
+        REQUIRE(fix.initiator.get_state_enum() == HandshakeState::wait_for_begin_reply);
+        REQUIRE(fix.lower.num_tx_messages() == 1);
+        fix.lower.pop_tx_message();
+        times.push_back(fix.exe->get_time() - start);
+
+        if (times.size() == num_handshakes) {
+            return times;
+        }
+
+        // response timeout
+        REQUIRE(fix.exe->advance_to_next_timer());
+        REQUIRE(fix.exe->run_many() == 1);
+        REQUIRE(fix.initiator.get_state_enum() == HandshakeState::wait_for_retry);
+
+        // retry timeout
+        REQUIRE(fix.exe->advance_to_next_timer());
+        REQUIRE(fix.exe->run_many() > 0);
+    }
+}
+
+exe4cpp::duration_t get_renegotiation_time(const InitiatorConfig& config)
+{
+    InitiatorFixture fix(config);
+    test_open_and_full_handshake(fix);
+
+    const auto start = fix.exe->get_time();
+
+    REQUIRE(fix.exe->advance_to_next_timer());
+    REQUIRE(fix.exe->run_many() == 1);
+    REQUIRE(fix.initiator.get_state_enum() == HandshakeState::wait_for_begin_reply);
+
+    return fix.exe->get_time() - start;
+}
+
+size_t get_max_bucket_size(const std::vector<exe4cpp::duration_t>& times, const exe4cpp::duration_t& bucket_width)
+{
+    std::map<exe4cpp::duration_t::rep, size_t> buckets;
+    for (const auto& time : times) {
+        ++buckets[time.count() / bucket_width.count()];
+    }
+
+    size_t max = 0;
+    for (const auto& bucket : buckets) {
+        max = std::max(max, bucket.second);
+    }
+    return max;
+}
@@ -81,6 +81,35 @@ TEST_CASE(SUITE("successfully parses message"))
     REQUIRE(HexConversions::to_hex(msg.mode_ephemeral) == "AA AA AA");
 
     REQUIRE(msg.mode_data.is_empty());
+    REQUIRE(msg.session_compression_mode == SessionCompressionMode::none);
+}
+
+TEST_CASE(SUITE("successfully parses message with a compression mode"))
+{
+    RequestHandshakeBegin msg;
+
+    //                                     ------------------------------------------------------------------VV------ compression mode
+    auto input = HexConversions::from_hex("00 D1 D2 A3 A4 00 00 00 00 00 FF FF CA FE BA BE 00 03 AA AA AA 00 01");
+    auto slice = input->as_rslice();
+
+    auto err = msg.read(slice);
+    REQUIRE(!any(err));
+    REQUIRE(msg.spec.session_crypto_mode == SessionCryptoMode::hmac_sha256_16);
+    REQUIRE(HexConversions::to_hex(msg.mode_ephemeral) == "AA AA AA");
+    REQUIRE(msg.mode_data.is_empty());
+    REQUIRE(msg.session_compression_mode == SessionCompressionMode::lz_scada);
+}
+
+TEST_CASE(SUITE("rejects unknown compression mode"))
+{
+    RequestHandshakeBegin msg;
+
+    //                                     ------------------------------------------------------------------VV------ compression mode
+    auto input = HexConversions::from_hex("00 D1 D2 A3 A4 00 00 00 00 00 FF FF CA FE BA BE 00 03 AA AA AA 00 CC");
+    auto slice = input->as_rslice();
+
+    auto err = msg.read(slice);
+    REQUIRE(err == ParseError::undefined_enum);
 }
 
 TEST_CASE(SUITE("pretty prints message"))
@@ -101,7 +130,8 @@ TEST_CASE(SUITE("pretty prints message"))
             0xCAFEBABE),
         HandshakeMode::public_keys,
         public_key,
-        seq32_t::empty());
+        seq32_t::empty(),
+        SessionCompressionMode::none);
 
     log4cpp::MockLogHandler log("log");
     LogMessagePrinter printer(log.logger, ssp21::levels::info, 16);
@@ -121,7 +151,8 @@ TEST_CASE(SUITE("pretty prints message"))
         "handshake_mode: public_keys",
         "mode_ephemeral (length = 2)",
         "CA:FE",
-        "mode_data (length = 0)");
+        "mode_data (length = 0)",
+        "session_compression_mode: none");
 }
 
 TEST_CASE(SUITE("rejects unknown enum"))
@@ -160,6 +191,19 @@ TEST_CASE(SUITE("formats default value"))
     REQUIRE(HexConversions::to_hex(res.written) == "00 00 00 00 00 FF FF FF FF FF 00 00 00 00 00 00 FF 00 00");
 }
 
+TEST_CASE(SUITE("formats compression mode at the end of the message"))
+{
+    ser4cpp::StaticBuffer<uint32_t, RequestHandshakeBegin::min_size_bytes + 1> buffer;
+    RequestHandshakeBegin msg;
+    msg.session_compression_mode.value = SessionCompressionMode::lz_scada;
+    auto dest = buffer.as_wseq();
+    auto res = msg.write(dest);
+
+    REQUIRE(!res.is_error());
+    REQUIRE(res.written.length() == msg.size());
+    REQUIRE(HexConversions::to_hex(res.written) == "00 00 00 00 00 FF FF FF FF FF 00 00 00 00 00 00 FF 00 00 01");
+}
+
 TEST_CASE(SUITE("returns error if insufficient buffer space"))
 {
     ser4cpp::StaticBuffer<uint32_t, RequestHandshakeBegin::min_size_bytes - 1> buffer;
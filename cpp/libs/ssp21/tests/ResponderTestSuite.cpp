@@ -3,13 +3,15 @@
 
 #include "fixtures/CryptoLayerFixture.h"
 
+#include <vector>
+
 #define SUITE(name) "ResponderTestSuite - " name
 
 using namespace ssp21;
 using namespace ser4cpp;
 
 // helper methods
-void test_begin_handshake_success(ResponderFixture& fix, uint16_t max_nonce = consts::crypto::initiator::default_max_nonce, uint32_t max_session_time = consts::crypto::initiator::default_max_session_time_ms);
+void test_begin_handshake_success(ResponderFixture& fix, uint16_t max_nonce = consts::crypto::initiator::default_max_nonce, uint32_t max_session_time = consts::crypto::initiator::default_max_session_time_ms, SessionCompressionMode compression_mode = SessionCompressionMode::none);
 void test_auth_handshake_success(ResponderFixture& fix, const std::string& payload);
 void test_init_session_success(ResponderFixture& fix, uint16_t max_nonce = consts::crypto::initiator::default_max_nonce, uint32_t max_session_time = consts::crypto::initiator::default_max_session_time_ms);
 void test_handshake_error(ResponderFixture& fix, const std::string& request, HandshakeError expected_error, std::initializer_list<CryptoAction> actions);
@@ -59,6 +61,37 @@ TEST_CASE(SUITE("responds to invalid key length with bad_message_format"))
     test_handshake_error(fix, request, HandshakeError::bad_message_format, {});
 }
 
+TEST_CASE(SUITE("responds to a compression mode that isn't allowed with unsupported_compression_mode"))
+{
+    ResponderFixture fix;
+    fix.responder.on_lower_open();
+
+    const auto request = hex::request_handshake_begin(
+        0,
+        SessionNonceMode::strict_increment,
+        HandshakeEphemeral::x25519,
+        HandshakeHash::sha256,
+        HandshakeKDF::hkdf_sha256,
+        SessionCryptoMode::hmac_sha256_16,
+        consts::crypto::initiator::default_max_nonce,
+        consts::crypto::initiator::default_max_session_time_ms,
+        HandshakeMode::public_keys,
+        hex::repeat(0xFF, consts::crypto::x25519_key_length),
+        SessionCompressionMode::lz_scada);
+
+    test_handshake_error(fix, request, HandshakeError::unsupported_compression_mode, {});
+}
+
+TEST_CASE(SUITE("accepts a compression mode that is allowed"))
+{
+    ResponderConfig config;
+    config.allowed_compression_modes = { SessionCompressionMode::lz_scada };
+
+    ResponderFixture fix(config);
+    fix.responder.on_lower_open();
+    test_begin_handshake_success(fix, consts::crypto::initiator::default_max_nonce, consts::crypto::initiator::default_max_session_time_ms, SessionCompressionMode::lz_scada);
+}
+
 TEST_CASE(SUITE("ignores user data without a session"))
 {
     ResponderFixture fix;
@@ -222,6 +255,34 @@ TEST_CASE(SUITE("can authenticate multiple messages"))
     }
 }
 
+TEST_CASE(SUITE("authenticates several buffered messages in one wakeup"))
+{
+    ResponderConfig config;
+    config.config.max_rx_queue_count = 3;
+    ResponderFixture fix(config);
+    fix.responder.on_lower_open();
+
+    test_init_session_success(fix);
+
+    // the responder won't read while it can't reply
+    fix.lower.set_tx_ready(false);
+
+    const auto tag = hex::repeat(0xFF, ssp21::consts::crypto::trunc16);
+    for (uint8_t i = 0; i < 3; ++i) {
+        fix.lower.enqueue_message(hex::session_data(i + 1, 0, HexConversions::to_hex(&i, 1), tag));
+    }
+    REQUIRE(fix.lower.num_rx_messages() == 3);
+    REQUIRE(fix.upper.is_empty());
+
+    fix.set_tx_ready();
+
+    REQUIRE(fix.lower.num_rx_messages() == 0);
+    REQUIRE(fix.responder.get_statistics().num_success == 4);
+    for (uint8_t i = 0; i < 3; ++i) {
+        REQUIRE(fix.upper.pop_rx_message() == HexConversions::to_hex(&i, 1));
+    }
+}
+
 // ---------- tx tests for initialized session -----------
 
 TEST_CASE(SUITE("won't transmit if offline"))
@@ -267,6 +328,43 @@ TEST_CASE(SUITE("can transmit multiple messages if session is initialized"))
     }
 }
 
+TEST_CASE(SUITE("transmits a message gathered from several slices"))
+{
+    ResponderFixture fix;
+    fix.responder.on_lower_open();
+    test_init_session_success(fix);
+
+    const auto header = HexConversions::from_hex("CA");
+    const auto body = HexConversions::from_hex("FE");
+    const seq32_t slices[] = { header->as_rslice(), seq32_t::empty(), body->as_rslice() };
+
+    REQUIRE(fix.responder.start_gather_tx_from_upper(slices, 3));
+
+    const auto expected = hex::session_data(1, consts::crypto::default_ttl_pad_ms, "CA FE", hex::repeat(0xFF, 16));
+    REQUIRE(fix.lower.pop_tx_message() == expected);
+
+    fix.responder.on_lower_tx_ready();
+    REQUIRE(fix.upper.num_tx_ready == 1);
+    REQUIRE(fix.lower.num_tx_messages() == 0);
+}
+
+TEST_CASE(SUITE("won't transmit more slices than it accepts"))
+{
+    ResponderFixture fix;
+    fix.responder.on_lower_open();
+    test_init_session_success(fix);
+
+    const auto msg = HexConversions::from_hex("CA FE");
+    std::vector<seq32_t> slices(ILowerLayer::max_tx_slices + 1, msg->as_rslice());
+
+    REQUIRE_FALSE(fix.responder.start_gather_tx_from_upper(slices.data(), static_cast<uint32_t>(slices.size())));
+    REQUIRE(fix.lower.num_tx_messages() == 0);
+
+    // nothing was started, so the layer is still ready
+    REQUIRE(fix.responder.start_gather_tx_from_upper(slices.data(), ILowerLayer::max_tx_slices));
+    REQUIRE(fix.lower.num_tx_messages() == 1);
+}
+
 TEST_CASE(SUITE("closes upper layer if nonce exceeds configured maximum"))
 {
     ResponderFixture fix;
@@ -314,7 +412,7 @@ TEST_CASE(SUITE("defers transmission if lower layer is not tx_ready"))
 
 // ---------- helper method implementations -----------
 
-void test_begin_handshake_success(ResponderFixture& fix, uint16_t max_nonce, uint32_t max_session_time)
+void test_begin_handshake_success(ResponderFixture& fix, uint16_t max_nonce, uint32_t max_session_time, SessionCompressionMode compression_mode)
 {
     const auto request = hex::request_handshake_begin(
         0,
@@ -326,7 +424,8 @@ void test_begin_handshake_success(ResponderFixture& fix, uint16_t max_nonce, uin
         max_nonce,
         max_session_time,
         HandshakeMode::public_keys,
-        hex::repeat(0xFF, consts::crypto::x25519_key_length));
+        hex::repeat(0xFF, consts::crypto::x25519_key_length),
+        compression_mode);
 
     fix.lower.enqueue_message(request);
 
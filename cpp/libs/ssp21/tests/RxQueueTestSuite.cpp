@@ -0,0 +1,98 @@
+#include "catch.hpp"
+
+#include "crypto/RxQueue.h"
+
+#define SUITE(name) "RxQueueTestSuite - " name
+
+using namespace ssp21;
+
+namespace {
+const uint16_t max_payload_size = 10;
+
+bool push(RxQueue& queue, uint32_t length, uint8_t value)
+{
+    auto dest = queue.get_write_slice();
+    if (dest.is_empty()) {
+        return false;
+    }
+
+    dest.take(length).set_all_to(value);
+    queue.push(dest.readonly().take(length));
+    return true;
+}
+
+void pop_and_check(RxQueue& queue, uint32_t length, uint8_t value)
+{
+    const auto payload = queue.front();
+    REQUIRE(payload.length() == length);
+    for (uint32_t i = 0; i < length; ++i) {
+        REQUIRE(payload[i] == value);
+    }
+    queue.pop();
+}
+}
+
+TEST_CASE(SUITE("holds a single payload by default"))
+{
+    RxQueue queue(1, 0, max_payload_size);
+
+    REQUIRE(queue.is_empty());
+    REQUIRE(queue.front().is_empty());
+    REQUIRE(push(queue, 3, 0xAA));
+    REQUIRE_FALSE(queue.can_push());
+    REQUIRE_FALSE(push(queue, 3, 0xBB));
+
+    pop_and_check(queue, 3, 0xAA);
+    REQUIRE(queue.is_empty());
+    REQUIRE(queue.can_push());
+}
+
+TEST_CASE(SUITE("returns payloads in the order they were pushed"))
+{
+    RxQueue queue(4, 0, max_payload_size);
+
+    for (uint8_t i = 1; i <= 4; ++i) {
+        REQUIRE(push(queue, i, i));
+    }
+    REQUIRE(queue.get_count() == 4);
+    REQUIRE_FALSE(queue.can_push());
+
+    for (uint8_t i = 1; i <= 4; ++i) {
+        pop_and_check(queue, i, i);
+    }
+    REQUIRE(queue.is_empty());
+}
+
+TEST_CASE(SUITE("stops accepting when a maximum size payload wouldn't fit"))
+{
+    RxQueue queue(8, 25, max_payload_size);
+
+    // 0-9, 10-18, then only 6 bytes are left at the end and none at the start
+    REQUIRE(push(queue, 10, 1));
+    REQUIRE(push(queue, 9, 2));
+    REQUIRE_FALSE(queue.can_push());
+
+    // the space before the head is reused once the first payload is read
+    pop_and_check(queue, 10, 1);
+    REQUIRE(push(queue, 4, 3));
+    REQUIRE_FALSE(queue.can_push());
+
+    pop_and_check(queue, 9, 2);
+    REQUIRE(push(queue, 5, 4));
+    pop_and_check(queue, 4, 3);
+    pop_and_check(queue, 5, 4);
+    REQUIRE(queue.is_empty());
+}
+
+TEST_CASE(SUITE("clear discards the queued payloads"))
+{
+    RxQueue queue(2, 0, max_payload_size);
+
+    REQUIRE(push(queue, 5, 1));
+    REQUIRE(push(queue, 5, 2));
+    queue.clear();
+
+    REQUIRE(queue.is_empty());
+    REQUIRE(push(queue, 2, 3));
+    pop_and_check(queue, 2, 3);
+}
@@ -0,0 +1,124 @@
+#include "catch.hpp"
+
+#include "crypto/SessionCompressor.h"
+#include "ssp21/crypto/gen/CryptoError.h"
+
+#include "ser4cpp/container/Buffer.h"
+#include "ser4cpp/util/HexConversions.h"
+
+#define SUITE(name) "SessionCompressorTestSuite - " name
+
+using namespace ssp21;
+using namespace ser4cpp;
+
+namespace {
+const uint32_t max_length = 1024;
+
+std::string round_trip(SessionCompressor& compressor, const std::string& hex, uint32_t& compressed_length)
+{
+    const auto input = HexConversions::from_hex(hex);
+    const auto compressed = compressor.compress(input->as_rslice());
+    REQUIRE(compressed.is_not_empty());
+    compressed_length = compressed.length();
+
+    Buffer dest(max_length);
+    std::error_code ec;
+    const auto output = compressor.decompress(compressed, dest.as_wslice(), ec);
+    REQUIRE_FALSE(ec);
+    return HexConversions::to_hex(output);
+}
+
+std::error_code decompress_error(const std::string& hex)
+{
+    SessionCompressor compressor(max_length);
+    const auto input = HexConversions::from_hex(hex);
+    Buffer dest(max_length);
+    std::error_code ec;
+    compressor.decompress(input->as_rslice(), dest.as_wslice(), ec);
+    return ec;
+}
+}
+
+TEST_CASE(SUITE("compresses a DNP3 integrity poll against the dictionary"))
+{
+    SessionCompressor compressor(max_length);
+    const auto poll = "C0 C1 01 3C 02 06 3C 03 06 3C 04 06 3C 01 06";
+
+    uint32_t length = 0;
+    REQUIRE(round_trip(compressor, poll, length) == poll);
+    REQUIRE(length < 15);
+}
+
+TEST_CASE(SUITE("compresses repeated data"))
+{
+    SessionCompressor compressor(max_length);
+    const auto data = HexConversions::repeat_hex(0x5A, 200);
+
+    uint32_t length = 0;
+    REQUIRE(round_trip(compressor, data, length) == data);
+    REQUIRE(length < 20);
+}
+
+TEST_CASE(SUITE("stores data that doesn't compress with one byte of expansion"))
+{
+    SessionCompressor compressor(max_length);
+    const auto data = "9E 37 79 B9 7F 4A 7C 15";
+
+    const auto input = HexConversions::from_hex(data);
+    const auto compressed = compressor.compress(input->as_rslice());
+    REQUIRE(HexConversions::to_hex(compressed) == "00 9E 37 79 B9 7F 4A 7C 15");
+
+    uint32_t length = 0;
+    REQUIRE(round_trip(compressor, data, length) == data);
+    REQUIRE(length == 8 + SessionCompressor::max_expansion);
+}
+
+TEST_CASE(SUITE("messages are independent of each other"))
+{
+    SessionCompressor sender(max_length);
+    const auto first = HexConversions::from_hex(HexConversions::repeat_hex(0x11, 64));
+    const auto second = HexConversions::from_hex(HexConversions::repeat_hex(0x22, 64));
+
+    sender.compress(first->as_rslice());
+    const auto compressed = HexConversions::from_hex(HexConversions::to_hex(sender.compress(second->as_rslice())));
+
+    // a receiver that never saw the first message
+    SessionCompressor receiver(max_length);
+    Buffer dest(max_length);
+    std::error_code ec;
+    const auto output = receiver.decompress(compressed->as_rslice(), dest.as_wslice(), ec);
+    REQUIRE_FALSE(ec);
+    REQUIRE(HexConversions::to_hex(output) == HexConversions::repeat_hex(0x22, 64));
+}
+
+TEST_CASE(SUITE("won't compress more than the maximum length"))
+{
+    SessionCompressor compressor(4);
+    const auto input = HexConversions::from_hex("01 02 03 04 05");
+    REQUIRE(compressor.compress(input->as_rslice()).is_empty());
+}
+
+TEST_CASE(SUITE("rejects malformed data"))
+{
+    // empty, unknown header
+    REQUIRE(decompress_error("") == CryptoError::bad_compressed_data);
+    REQUIRE(decompress_error("02 AA") == CryptoError::bad_compressed_data);
+    // literal run longer than the data
+    REQUIRE(decompress_error("01 03 AA BB") == CryptoError::bad_compressed_data);
+    // match without its distance byte
+    REQUIRE(decompress_error("01 80") == CryptoError::bad_compressed_data);
+    // match reaching before the start of the dictionary
+    REQUIRE(decompress_error("01 83 FF") == CryptoError::bad_compressed_data);
+}
+
+TEST_CASE(SUITE("rejects data that decompresses beyond the destination"))
+{
+    SessionCompressor compressor(max_length);
+
+    // 5 literals then 34 copies of the last byte
+    const auto input = HexConversions::from_hex("01 04 01 02 03 04 05 FC 00");
+    Buffer dest(10);
+    std::error_code ec;
+    compressor.decompress(input->as_rslice(), dest.as_wslice(), ec);
+    REQUIRE(ec == CryptoError::bad_compressed_data);
+}
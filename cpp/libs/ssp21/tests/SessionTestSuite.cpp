@@ -13,6 +13,9 @@
 #include "ser4cpp/util/HexConversions.h"
 
 #include <array>
+#include <cstring>
+#include <string>
+#include <vector>
 
 #define SUITE(name) "SessionTestSuite - " name
 
@@ -73,6 +76,42 @@ TEST_CASE(SUITE("won't intialize with invalid keys"))
     REQUIRE_FALSE(fixture.session.initialize(Algorithms::Session(), Session::Param(), SessionKeys()));
 }
 
+TEST_CASE(SUITE("reports the session keys when initialized"))
+{
+    std::vector<std::string> reported;
+
+    SessionConfig config;
+    config.on_session_keys = [&reported](const seq32_t& rx_key, const seq32_t& tx_key) {
+        reported.push_back(HexConversions::to_hex(rx_key));
+        reported.push_back(HexConversions::to_hex(tx_key));
+    };
+
+    SessionFixture fixture(config);
+
+    SessionKeys keys;
+    keys.rx_key.set_length(BufferLength::length_32);
+    keys.tx_key.set_length(BufferLength::length_32);
+    memset(keys.rx_key.as_wseq(), 0xAA, consts::crypto::symmetric_key_length);
+    memset(keys.tx_key.as_wseq(), 0xBB, consts::crypto::symmetric_key_length);
+
+    REQUIRE(fixture.session.initialize(Algorithms::Session(), Session::Param(), keys));
+    REQUIRE(reported.size() == 2);
+    REQUIRE(reported[0] == HexConversions::repeat_hex(0xAA, consts::crypto::symmetric_key_length));
+    REQUIRE(reported[1] == HexConversions::repeat_hex(0xBB, consts::crypto::symmetric_key_length));
+}
+
+TEST_CASE(SUITE("doesn't report keys that fail to initialize a session"))
+{
+    uint32_t num_reported = 0;
+
+    SessionConfig config;
+    config.on_session_keys = [&num_reported](const seq32_t&, const seq32_t&) { ++num_reported; };
+
+    SessionFixture fixture(config);
+    REQUIRE_FALSE(fixture.session.initialize(Algorithms::Session(), Session::Param(), SessionKeys()));
+    REQUIRE(num_reported == 0);
+}
+
 TEST_CASE(SUITE("empty max results in mac_auth_fail"))
 {
     SessionFixture fixture;
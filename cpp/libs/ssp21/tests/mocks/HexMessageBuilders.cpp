@@ -51,7 +51,8 @@ namespace hex {
         uint16_t max_nonce,
         uint32_t max_session_time,
         HandshakeMode handshake_mode,
-        const std::string& hex_ephem_pub_key)
+        const std::string& hex_ephem_pub_key,
+        SessionCompressionMode compression_mode)
     {
         HexSeq pub_key(hex_ephem_pub_key);
 
@@ -68,7 +69,8 @@ namespace hex {
                 max_session_time),
             handshake_mode,
             pub_key,
-            seq32_t::empty());
+            seq32_t::empty(),
+            compression_mode);
 
         return write_message(msg);
     }
@@ -10,6 +10,7 @@
 #include "ssp21/crypto/gen/HandshakeHash.h"
 #include "ssp21/crypto/gen/HandshakeKDF.h"
 #include "ssp21/crypto/gen/HandshakeMode.h"
+#include "ssp21/crypto/gen/SessionCompressionMode.h"
 #include "ssp21/crypto/gen/SessionCryptoMode.h"
 #include "ssp21/crypto/gen/SessionNonceMode.h"
 
@@ -30,7 +31,8 @@ namespace hex {
         uint16_t max_nonce,
         uint32_t max_session_time,
         HandshakeMode hansshake_mode,
-        const std::string& hex_ephem_pub_key);
+        const std::string& hex_ephem_pub_key,
+        SessionCompressionMode compression_mode = SessionCompressionMode::none);
 
     std::string reply_handshake_begin(
         const std::string& hex_ephem_pub_key);
@@ -39,6 +39,7 @@ public:
     }
 
     uint32_t num_tx_ready = 0;
+    uint32_t num_tx_dropped = 0;
 
 private:
     bool is_open = false;
@@ -64,6 +65,11 @@ private:
         ++num_tx_ready;
     }
 
+    virtual void on_lower_tx_dropped_impl() override
+    {
+        ++num_tx_dropped;
+    }
+
     virtual void on_lower_rx_ready_impl() override
     {
         // read all available data
@@ -0,0 +1,116 @@
+#ifndef SSP21_BENCHMARK_H
+#define SSP21_BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <initializer_list>
+
+namespace ssp21 {
+
+/**
+ * Payload sizes exercised by every benchmark, from a single byte up to the maximum link payload
+ */
+const auto PAYLOAD_SIZES = { 1u, 16u, 64u, 256u, 512u, 1024u, 2048u, 4092u };
+
+struct BenchmarkResult {
+    const char* layer;
+    const char* variant;
+    uint32_t payload_size;
+    uint64_t iterations;
+    uint64_t total_bytes;
+    std::chrono::nanoseconds elapsed;
+
+    double ns_per_message() const
+    {
+        return static_cast<double>(elapsed.count()) / static_cast<double>(iterations);
+    }
+
+    double messages_per_sec() const
+    {
+        return static_cast<double>(iterations) * 1e9 / static_cast<double>(elapsed.count());
+    }
+
+    double mb_per_sec() const
+    {
+        return (static_cast<double>(total_bytes) / (1024.0 * 1024.0)) * 1e9 / static_cast<double>(elapsed.count());
+    }
+};
+
+class Benchmark {
+
+public:
+    /**
+     * Choose an iteration count that moves a roughly constant amount of data regardless of payload size
+     */
+    static uint64_t num_iterations(uint32_t payload_size)
+    {
+        const uint64_t target_bytes = 64 * 1024 * 1024;
+        const uint64_t min_iterations = 10000;
+        const uint64_t max_iterations = 500000;
+
+        const auto count = target_bytes / (payload_size == 0 ? 1 : payload_size);
+        return (count < min_iterations) ? min_iterations : ((count > max_iterations) ? max_iterations : count);
+    }
+
+    /**
+     * Run an action a number of times and report the elapsed wall clock time.
+     *
+     * @param bytes_per_iteration number of payload bytes processed by each invocation of the action
+     */
+    static BenchmarkResult measure(const char* layer, const char* variant, uint32_t payload_size, uint32_t bytes_per_iteration, const std::function<void()>& action)
+    {
+        const auto iterations = num_iterations(payload_size);
+
+        // warm up caches and lazy initialization before timing anything
+        for (uint64_t i = 0; i < (iterations / 100) + 1; ++i) {
+            action();
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            action();
+        }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+        return BenchmarkResult{
+            layer,
+            variant,
+            payload_size,
+            iterations,
+            iterations * bytes_per_iteration,
+            (elapsed.count() > 0) ? elapsed : std::chrono::nanoseconds(1)
+        };
+    }
+
+    /**
+     * Fold a value into a volatile sink so the compiler cannot discard the work that produced it
+     */
+    static void consume(uint32_t value)
+    {
+        static volatile uint32_t sink = 0;
+        sink = sink + value;
+    }
+
+    static void print_header()
+    {
+        printf("%-22s %-18s %8s %10s %12s %14s %10s\n", "layer", "variant", "size", "iterations", "ns/msg", "msgs/s", "MB/s");
+    }
+
+    static void print(const BenchmarkResult& result)
+    {
+        printf("%-22s %-18s %8u %10llu %12.1f %14.0f %10.2f\n",
+               result.layer,
+               result.variant,
+               result.payload_size,
+               static_cast<unsigned long long>(result.iterations),
+               result.ns_per_message(),
+               result.messages_per_sec(),
+               result.mb_per_sec());
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,171 @@
+
+#include "LayerBenchmarks.h"
+
+#include "crypto/SessionModes.h"
+#include "crypto/gen/SessionData.h"
+#include "link/LinkFrameWriter.h"
+#include "link/LinkParser.h"
+
+#include "ssp21/crypto/Crypto.h"
+#include "ssp21/link/CastagnoliCRC32.h"
+#include "ssp21/util/Exception.h"
+
+#include "ser4cpp/container/Buffer.h"
+
+
+namespace ssp21 {
+
+class NullReporter final : public LinkParser::IReporter {
+public:
+    virtual void on_bad_header_crc(uint32_t expected, uint32_t actual) override {}
+    virtual void on_bad_body_crc(uint32_t expected, uint32_t actual) override {}
+    virtual void on_bad_body_length(uint32_t max_allowed, uint32_t actual) override {}
+};
+
+struct NamedSessionMode {
+    const char* name;
+    SessionMode mode;
+};
+
+std::vector<uint8_t> make_payload(uint32_t size)
+{
+    std::vector<uint8_t> payload(size);
+    for (uint32_t i = 0; i < size; ++i) {
+        payload[i] = static_cast<uint8_t>(i % 256);
+    }
+    return payload;
+}
+
+seq32_t as_seq(const std::vector<uint8_t>& payload)
+{
+    return seq32_t(payload.data(), static_cast<uint32_t>(payload.size()));
+}
+
+void make_key(SymmetricKey& key)
+{
+    Crypto::gen_random(key.as_wseq().take(consts::crypto::symmetric_key_length));
+    key.set_length(BufferLength::length_32);
+}
+
+void benchmark_crc(std::vector<BenchmarkResult>& results, uint32_t size)
+{
+    const auto payload = make_payload(size);
+    const auto data = as_seq(payload);
+
+    results.push_back(
+        Benchmark::measure("CastagnoliCRC32", "calc", size, size, [&]() {
+            Benchmark::consume(CastagnoliCRC32::calc(data));
+        }));
+}
+
+void benchmark_link(std::vector<BenchmarkResult>& results, uint32_t size)
+{
+    const auto payload = make_payload(size);
+    const uint8_t auth_tag[consts::crypto::trunc16] = { 0 };
+    const SessionData message(AuthMetadata(1, 0xFFFFFFFF), as_seq(payload), seq32_t(auth_tag, sizeof(auth_tag)));
+
+    const auto max_payload_size = static_cast<uint16_t>(message.size());
+
+    LinkFrameWriter writer(log4cpp::Logger::empty(), Addresses(1, 10), max_payload_size);
+
+    results.push_back(
+        Benchmark::measure("LinkFrameWriter", "write", size, size, [&]() {
+            Benchmark::consume(writer.write(message).frame.length());
+        }));
+
+    // keep a copy of one frame around to feed the parser
+    const auto written = writer.write(message);
+    if (written.is_error()) {
+        throw Exception("unable to write benchmark frame");
+    }
+    const ser4cpp::Buffer frame(written.frame);
+
+    NullReporter reporter;
+    LinkParser parser(max_payload_size, reporter);
+
+    results.push_back(
+        Benchmark::measure("LinkParser", "parse", size, size, [&]() {
+            parser.reset();
+            auto input = frame.as_rslice();
+            Benchmark::consume(parser.parse(input) ? 1 : 0);
+        }));
+}
+
+void benchmark_session_data(std::vector<BenchmarkResult>& results, uint32_t size)
+{
+    const auto payload = make_payload(size);
+    const uint8_t auth_tag[consts::crypto::trunc16] = { 0 };
+    const SessionData message(AuthMetadata(1, 0xFFFFFFFF), as_seq(payload), seq32_t(auth_tag, sizeof(auth_tag)));
+
+    ser4cpp::Buffer buffer(static_cast<uint32_t>(message.size()));
+    auto dest = buffer.as_wslice();
+    if (message.write(dest).is_error()) {
+        throw Exception("unable to write benchmark session data");
+    }
+
+    results.push_back(
+        Benchmark::measure("SessionData", "read", size, size, [&]() {
+            SessionData msg;
+            Benchmark::consume(static_cast<uint32_t>(msg.read(buffer.as_rslice())));
+        }));
+}
+
+void benchmark_session_mode(std::vector<BenchmarkResult>& results, uint32_t size, const NamedSessionMode& named)
+{
+    SymmetricKey key;
+    make_key(key);
+
+    const auto payload = make_payload(size);
+    const AuthMetadata metadata(1, 0xFFFFFFFF);
+
+    ser4cpp::Buffer encrypt_buffer(consts::link::max_config_payload_size);
+    ser4cpp::Buffer decrypt_buffer(consts::link::max_config_payload_size);
+    MACOutput mac;
+
+    // the session mode may not consume all of the user data in a single message
+    std::error_code ec;
+    auto user_data = as_seq(payload);
+    const auto message = named.mode.write(key, metadata, user_data, encrypt_buffer.as_wslice(), mac, ec);
+    if (ec) {
+        throw Exception("unable to write benchmark session data: ", ec.message());
+    }
+    const auto bytes_per_message = message.user_data.length();
+
+    results.push_back(
+        Benchmark::measure("SessionMode::write", named.name, size, bytes_per_message, [&]() {
+            std::error_code ec;
+            auto input = as_seq(payload);
+            MACOutput mac;
+            Benchmark::consume(named.mode.write(key, metadata, input, encrypt_buffer.as_wslice(), mac, ec).user_data.length());
+        }));
+
+    // the encrypt buffer is overwritten by each write with identical ciphertext, so the message remains valid
+    results.push_back(
+        Benchmark::measure("SessionMode::read", named.name, size, bytes_per_message, [&]() {
+            std::error_code ec;
+            Benchmark::consume(named.mode.read(key, message, decrypt_buffer.as_wslice(), ec).length());
+        }));
+}
+
+std::vector<BenchmarkResult> LayerBenchmarks::run()
+{
+    const NamedSessionMode modes[] = {
+        { "hmac-sha256-16", SessionModes::hmac_sha_256_trunc16() },
+        { "aes-256-gcm", SessionModes::aes_256_gcm() }
+    };
+
+    std::vector<BenchmarkResult> results;
+
+    for (auto size : PAYLOAD_SIZES) {
+        benchmark_crc(results, size);
+        benchmark_link(results, size);
+        benchmark_session_data(results, size);
+        for (const auto& mode : modes) {
+            benchmark_session_mode(results, size, mode);
+        }
+    }
+
+    return results;
+}
+
+}
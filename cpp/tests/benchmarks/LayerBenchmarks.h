@@ -0,0 +1,19 @@
+#ifndef SSP21_LAYERBENCHMARKS_H
+#define SSP21_LAYERBENCHMARKS_H
+
+#include "Benchmark.h"
+
+#include <vector>
+
+namespace ssp21 {
+
+/**
+ * Micro-benchmarks of the individual components on the session data path
+ */
+struct LayerBenchmarks {
+    static std::vector<BenchmarkResult> run();
+};
+
+}
+
+#endif
@@ -0,0 +1,158 @@
+
+#include "StackBenchmarks.h"
+
+#include "fixtures/StackPair.h"
+
+#include "ssp21/util/Exception.h"
+
+#include <cstdio>
+
+namespace ssp21 {
+
+struct StackVariant {
+    const char* name;
+    StackType stack_type;
+    SessionCryptoMode session_mode;
+};
+
+void benchmark_stack(std::vector<BenchmarkResult>& results, const StackVariant& variant)
+{
+    StackPair pair(variant.stack_type, variant.session_mode);
+
+    if (!pair.open()) {
+        throw Exception("unable to complete the handshake for: ", variant.name);
+    }
+
+    for (auto size : PAYLOAD_SIZES) {
+        std::vector<uint8_t> payload(size, 0xAA);
+        const seq32_t data(payload.data(), size);
+
+        if (!pair.transfer(data)) {
+            throw Exception("unable to transfer session data for: ", variant.name);
+        }
+
+        results.push_back(
+            Benchmark::measure("stack", variant.name, size, size, [&]() {
+                Benchmark::consume(pair.transfer(data) ? 1 : 0);
+            }));
+    }
+}
+
+// counts the frames delivered when the responder receives the first payload after a connect
+class FirstRxFrameCounter final : public IReceiveValidator {
+
+public:
+    explicit FirstRxFrameCounter(const StackPair& pair)
+        : pair(pair)
+    {
+    }
+
+    virtual void validate(const seq32_t& data) override
+    {
+        if (this->num_frames == 0) {
+            this->num_frames = this->pair.num_frames() - this->start;
+        }
+    }
+
+    void reset()
+    {
+        this->start = this->pair.num_frames();
+        this->num_frames = 0;
+    }
+
+    uint32_t num_frames = 0;
+
+private:
+    const StackPair& pair;
+    uint32_t start = 0;
+};
+
+// open both sides, send the payload as soon as the initiator takes it, then close again
+bool connect_and_transfer(StackPair& pair, const seq32_t& data)
+{
+    const auto num_bytes_before = pair.responder_upper.num_bytes_rx;
+
+    pair.stacks.responder->on_lower_open();
+    pair.stacks.initiator->on_lower_open();
+
+    // without early data, the initiator only takes the payload once the handshake completes
+    if (!pair.stacks.initiator->start_tx_from_upper(data)) {
+        pair.exe->run_many();
+        if (!pair.stacks.initiator->start_tx_from_upper(data)) {
+            return false;
+        }
+    }
+
+    pair.exe->run_many();
+
+    const bool delivered = (pair.responder_upper.num_bytes_rx - num_bytes_before) == data.length();
+    pair.close();
+    return delivered;
+}
+
+FirstByteResult benchmark_first_byte(const char* variant, uint16_t max_early_data_size)
+{
+    const uint32_t size = 256;
+
+    InitiatorConfig config;
+    config.params.max_early_data_size = max_early_data_size;
+
+    StackPair pair(StackType::full, SessionCryptoMode::hmac_sha256_16, config);
+    const auto counter = std::make_shared<FirstRxFrameCounter>(pair);
+    pair.responder_upper.add_validator(counter);
+
+    std::vector<uint8_t> payload(size, 0xAA);
+    const seq32_t data(payload.data(), size);
+
+    counter->reset();
+    if (!connect_and_transfer(pair, data)) {
+        throw Exception("unable to deliver the first payload for: ", variant);
+    }
+    const auto num_frames = counter->num_frames;
+
+    const auto connect = Benchmark::measure("first-byte", variant, size, size, [&]() {
+        Benchmark::consume(connect_and_transfer(pair, data) ? 1 : 0);
+    });
+
+    return FirstByteResult{ num_frames, connect };
+}
+
+std::vector<FirstByteResult> StackBenchmarks::run_first_byte()
+{
+    return {
+        benchmark_first_byte("no early data", 0),
+        benchmark_first_byte("early data", 1024)
+    };
+}
+
+void StackBenchmarks::print_first_byte(const std::vector<FirstByteResult>& results)
+{
+    printf("%-18s %8s %8s %14s\n", "variant", "size", "frames", "ns/connect");
+    for (const auto& result : results) {
+        printf("%-18s %8u %8u %14.1f\n",
+               result.connect.variant,
+               result.connect.payload_size,
+               result.num_frames,
+               result.connect.ns_per_message());
+    }
+}
+
+std::vector<BenchmarkResult> StackBenchmarks::run()
+{
+    const StackVariant variants[] = {
+        { "full/hmac", StackType::full, SessionCryptoMode::hmac_sha256_16 },
+        { "full/gcm", StackType::full, SessionCryptoMode::aes_256_gcm },
+        { "crypto-only/hmac", StackType::crypto_only, SessionCryptoMode::hmac_sha256_16 },
+        { "crypto-only/gcm", StackType::crypto_only, SessionCryptoMode::aes_256_gcm }
+    };
+
+    std::vector<BenchmarkResult> results;
+
+    for (const auto& variant : variants) {
+        benchmark_stack(results, variant);
+    }
+
+    return results;
+}
+
+}
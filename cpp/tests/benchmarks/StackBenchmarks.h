@@ -0,0 +1,35 @@
+#ifndef SSP21_STACKBENCHMARKS_H
+#define SSP21_STACKBENCHMARKS_H
+
+#include "Benchmark.h"
+
+#include <vector>
+
+namespace ssp21 {
+
+/**
+ * Time to the first payload of a new connection
+ */
+struct FirstByteResult {
+    // frames that crossed the link up to and including the one that delivered the payload,
+    // each is a one-way trip because the handshake is lock-step
+    uint32_t num_frames;
+    // CPU cost of the handshake and the payload on both sides
+    BenchmarkResult connect;
+};
+
+/**
+ * End-to-end benchmarks of session data moving through an established initiator/responder pair
+ */
+struct StackBenchmarks {
+    static std::vector<BenchmarkResult> run();
+
+    // connect and send the first payload, with and without early data
+    static std::vector<FirstByteResult> run_first_byte();
+
+    static void print_first_byte(const std::vector<FirstByteResult>& results);
+};
+
+}
+
+#endif
@@ -0,0 +1,52 @@
+#include "StackPair.h"
+
+namespace ssp21 {
+
+StackPair::StackPair(StackType stack_type, SessionCryptoMode session_mode, const InitiatorConfig& initiator_config)
+    : exe(std::make_shared<exe4cpp::MockExecutor>())
+    , initiator_lower(exe)
+    , responder_lower(exe)
+    , stacks(SessionStacks::create(stack_type, session_mode, exe, initiator_config))
+{
+    initiator_lower.configure(*stacks.initiator, responder_lower);
+    responder_lower.configure(*stacks.responder, initiator_lower);
+
+    initiator_upper.configure(*stacks.initiator);
+    responder_upper.configure(*stacks.responder);
+
+    stacks.initiator->bind(initiator_lower, initiator_upper);
+    stacks.responder->bind(responder_lower, responder_upper);
+}
+
+bool StackPair::open()
+{
+    stacks.responder->on_lower_open();
+    stacks.initiator->on_lower_open();
+
+    exe->run_many();
+
+    return initiator_upper.is_open() && responder_upper.is_open();
+}
+
+void StackPair::close()
+{
+    stacks.initiator->on_lower_close();
+    stacks.responder->on_lower_close();
+
+    exe->run_many();
+}
+
+bool StackPair::transfer(const seq32_t& data)
+{
+    const auto num_bytes_before = responder_upper.num_bytes_rx;
+
+    if (!stacks.initiator->start_tx_from_upper(data)) {
+        return false;
+    }
+
+    exe->run_many();
+
+    return (responder_upper.num_bytes_rx - num_bytes_before) == data.length();
+}
+
+}
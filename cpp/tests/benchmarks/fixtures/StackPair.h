@@ -0,0 +1,50 @@
+#ifndef SSP21_STACKPAIR_H
+#define SSP21_STACKPAIR_H
+
+#include "SessionStacks.h"
+
+#include "mocks/LowerLayer.h"
+#include "mocks/UpperLayer.h"
+
+#include "exe4cpp/MockExecutor.h"
+
+namespace ssp21 {
+
+/**
+ * An initiator and responder wired back-to-back over mock lower layers,
+ * used to measure the cost of moving session data through an established session
+ */
+class StackPair {
+
+public:
+    StackPair(StackType stack_type, SessionCryptoMode session_mode, const InitiatorConfig& initiator_config = InitiatorConfig());
+
+    // complete the handshake, returns true if both sides are open
+    bool open();
+
+    // close both sides, so that they can be opened again
+    void close();
+
+    // frames delivered in either direction
+    uint32_t num_frames() const
+    {
+        return initiator_lower.num_rx + responder_lower.num_rx;
+    }
+
+    // transmit a payload from the initiator to the responder, returns true if it was fully received
+    bool transfer(const seq32_t& data);
+
+    const std::shared_ptr<exe4cpp::MockExecutor> exe;
+
+    LowerLayer initiator_lower;
+    LowerLayer responder_lower;
+
+    UpperLayer initiator_upper;
+    UpperLayer responder_upper;
+
+    SessionStacks stacks;
+};
+
+}
+
+#endif
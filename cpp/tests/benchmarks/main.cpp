@@ -0,0 +1,37 @@
+
+#include "LayerBenchmarks.h"
+#include "StackBenchmarks.h"
+
+#include "sodium/Backend.h"
+
+#include <exception>
+#include <iostream>
+
+using namespace ssp21;
+
+void print_results(const char* title, const std::vector<BenchmarkResult>& results)
+{
+    printf("\n%s\n\n", title);
+    Benchmark::print_header();
+    for (const auto& result : results) {
+        Benchmark::print(result);
+    }
+}
+
+int main()
+{
+    try {
+        ssp21::sodium::initialize();
+
+        print_results("per-layer", LayerBenchmarks::run());
+        print_results("initiator -> responder (established session)", StackBenchmarks::run());
+
+        printf("\nfirst payload after connect (frames = one-way trips across the link)\n\n");
+        StackBenchmarks::print_first_byte(StackBenchmarks::run_first_byte());
+
+        return 0;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return -1;
+    }
+}
@@ -0,0 +1,342 @@
+/**
+ * Pseudo-terminal benchmark of the proxy's serial port wrapper at common baud rates.
+ *
+ * A writer thread plays the remote end of the line. It writes link frames into the master side of
+ * a pty, paced at the baud rate because a pty itself transfers at memory speed. The receiving side
+ * is AsioSerialPortWrapper on the slave device, feeding AsioLowerLayer and a LinkLayer.
+ *
+ * Latency is measured from the write of the last byte of a frame to the delivery of the parsed
+ * frame, with frames spaced apart as in a poll/response exchange. Each frame carries its index as
+ * the nonce, so a lost frame doesn't shift the latency of the frames after it. Link framing delivers on the
+ * last byte; gap framing waits for the inter-character timeout and is shown for comparison.
+ * Throughput is measured with frames sent back to back and is reported as a share of the line rate.
+ * The wrapper uses the proxy's default inter-character timeout for the baud rate.
+ *
+ * The writer is a user space thread, so it can miss its schedule and leave the line quiet for longer
+ * than the timeout in the middle of a frame. The wrapper drops such a frame, as it would on a real
+ * line, and these frames are counted as stalled.
+ *
+ * Exits non-zero if a frame that didn't stall is lost, or if anything but the sent frames is delivered.
+ */
+
+#include "AsioLowerLayer.h"
+#include "serial/AsioSerialPortWrapper.h"
+
+#include "crypto/gen/SessionData.h"
+#include "link/LinkFrameWriter.h"
+#include "link/LinkLayer.h"
+
+#include "ssp21/crypto/Constants.h"
+#include "ssp21/util/Exception.h"
+
+#include <asio.hpp>
+
+#include <pty.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace ssp21;
+using namespace std::chrono;
+
+namespace {
+
+const uint32_t payload_size = 64;
+const auto run_time = seconds(2);
+const auto frame_spacing = milliseconds(20);
+const auto BAUD_RATES = { 9600u, 19200u, 38400u, 57600u, 115200u };
+
+using time_point_t = steady_clock::time_point;
+
+class FrameCounter final : public IUpperLayer {
+public:
+    explicit FrameCounter(size_t max_frames)
+        : delivery_times(max_frames)
+        , is_delivered(max_frames, false)
+    {
+    }
+
+    void configure(ILowerLayer& lower)
+    {
+        this->lower = &lower;
+    }
+
+    // indexed by the nonce of the frame
+    std::vector<time_point_t> delivery_times;
+    std::vector<bool> is_delivered;
+    std::atomic<uint32_t> num_frames{ 0 };
+    // frames that didn't parse, or were delivered twice
+    uint32_t num_unexpected = 0;
+
+private:
+    void on_lower_open_impl() override {}
+
+    void on_lower_close_impl() override {}
+
+    void on_lower_tx_ready_impl() override {}
+
+    void on_lower_rx_ready_impl() override
+    {
+        while (true) {
+            const auto payload = this->lower->start_rx_from_upper();
+            if (payload.is_empty()) {
+                return;
+            }
+
+            const auto now = steady_clock::now();
+
+            SessionData message;
+            if (any(message.read(payload))) {
+                ++this->num_unexpected;
+                continue;
+            }
+
+            const uint16_t index = message.metadata.nonce;
+            if (index >= this->delivery_times.size() || this->is_delivered[index]) {
+                ++this->num_unexpected;
+                continue;
+            }
+
+            this->delivery_times[index] = now;
+            this->is_delivered[index] = true;
+            this->num_frames.store(this->num_frames.load() + 1);
+        }
+    }
+
+    ILowerLayer* lower = nullptr;
+};
+
+std::vector<uint8_t> make_frame(uint16_t index)
+{
+    std::vector<uint8_t> payload(payload_size);
+    for (uint32_t i = 0; i < payload_size; ++i) {
+        payload[i] = static_cast<uint8_t>(i);
+    }
+
+    const uint8_t auth_tag[consts::crypto::trunc16] = { 0 };
+    const SessionData message(AuthMetadata(index, 0xFFFFFFFF), seq32_t(payload.data(), payload_size), seq32_t(auth_tag, sizeof(auth_tag)));
+
+    LinkFrameWriter writer(log4cpp::Logger::empty(), Addresses(1, 10), consts::link::max_config_payload_size);
+    const auto written = writer.write(message);
+    if (written.is_error()) {
+        throw Exception("unable to write benchmark frame");
+    }
+
+    return std::vector<uint8_t>(static_cast<const uint8_t*>(written.frame), static_cast<const uint8_t*>(written.frame) + written.frame.length());
+}
+
+// 10 bits per character: start, 8 data, stop
+nanoseconds get_character_time(uint32_t baud)
+{
+    return nanoseconds(10 * 1000000000ull / baud);
+}
+
+struct WriteResult {
+    // when the last byte was written
+    time_point_t end;
+    // the writer left the line quiet for about the timeout or longer part way through the frame
+    bool stalled;
+};
+
+// writes the frame one character time per byte, in chunks of about half a millisecond
+//
+// The reader sees a quiet period a little longer or shorter than the writer does, so a pause of
+// three quarters of the timeout already counts as a stall.
+WriteResult write_paced(int fd, const std::vector<uint8_t>& frame, uint32_t baud, time_point_t start, nanoseconds timeout)
+{
+    const auto character_time = get_character_time(baud);
+    const auto chunk = std::max<size_t>(1, static_cast<size_t>(microseconds(500) / character_time));
+
+    size_t offset = 0;
+    bool stalled = false;
+    time_point_t last_write;
+    while (offset < frame.size()) {
+        const auto count = std::min(chunk, frame.size() - offset);
+        // the chunk is complete on the line once its last character has been clocked out
+        std::this_thread::sleep_until(start + character_time * (offset + count));
+        if (offset > 0 && (steady_clock::now() - last_write) * 4 > timeout * 3) {
+            stalled = true;
+        }
+        if (write(fd, frame.data() + offset, count) != static_cast<ssize_t>(count)) {
+            throw Exception("pty write failed");
+        }
+        last_write = steady_clock::now();
+        offset += count;
+    }
+
+    return WriteResult{ last_write, stalled };
+}
+
+struct Result {
+    uint32_t num_sent;
+    uint32_t num_received;
+    uint32_t num_stalled;
+    // lost frames that didn't stall
+    uint32_t num_lost;
+    uint32_t num_unexpected;
+    double p50_ms;
+    double p99_ms;
+    double frames_per_sec;
+    double line_utilization;
+};
+
+double get_percentile(std::vector<double>& samples, double percentile)
+{
+    if (samples.empty()) {
+        return 0;
+    }
+    const auto index = static_cast<size_t>(percentile * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+Result run(uint32_t baud, SerialFraming framing, bool spaced)
+{
+    const auto frame_time = get_character_time(baud) * make_frame(0).size();
+    const auto period = spaced ? frame_time + frame_spacing : frame_time;
+    const auto num_frames = static_cast<uint32_t>(std::max<int64_t>(10, duration_cast<nanoseconds>(run_time).count() / duration_cast<nanoseconds>(period).count()));
+
+    std::vector<std::vector<uint8_t>> frames;
+    for (uint32_t i = 0; i < num_frames; ++i) {
+        frames.push_back(make_frame(static_cast<uint16_t>(i)));
+    }
+
+    int master = -1;
+    int slave = -1;
+    char slave_name[256] = { 0 };
+    if (openpty(&master, &slave, slave_name, nullptr, nullptr) != 0) {
+        throw Exception("openpty failed");
+    }
+
+    asio::io_service service;
+    asio::serial_port port(service);
+    port.open(slave_name);
+    port.set_option(asio::serial_port_base::baud_rate(baud));
+    // the wrapper's port holds its own descriptor
+    close(slave);
+
+    AsioLowerLayer lower(log4cpp::Logger::empty());
+    const auto timeout = AsioSerialPortWrapper::get_default_inter_character_timeout(baud);
+    AsioSerialPortWrapper socket(log4cpp::Logger::empty(), lower, std::move(port), framing, timeout);
+    LinkLayer link(1, 10);
+    FrameCounter counter(num_frames);
+
+    counter.configure(link);
+    link.bind(lower, counter);
+    lower.open(socket, link);
+
+    auto work = std::make_unique<asio::io_service::work>(service);
+    std::thread receiver([&]() { service.run(); });
+
+    std::vector<WriteResult> writes;
+    const auto start = steady_clock::now();
+    for (uint32_t i = 0; i < num_frames; ++i) {
+        writes.push_back(write_paced(master, frames[i], baud, start + period * i, timeout));
+    }
+
+    // give the last frame time to arrive
+    const auto deadline = steady_clock::now() + seconds(1);
+    while (counter.num_frames.load() < num_frames && steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+
+    work.reset();
+    service.stop();
+    receiver.join();
+
+    // the wrapper holds the memory of its outstanding read, so the aborted read has to complete before it is destroyed
+    service.restart();
+    socket.try_close_socket();
+    while (socket.is_active()) {
+        service.run_one();
+    }
+    close(master);
+
+    const auto num_received = counter.num_frames.load();
+
+    uint32_t num_stalled = 0;
+    uint32_t num_lost = 0;
+    // a lost frame doesn't hold up the throughput with the wait for it
+    auto last_delivery = start;
+    std::vector<double> latencies;
+    for (uint32_t i = 0; i < num_frames; ++i) {
+        if (writes[i].stalled) {
+            ++num_stalled;
+        }
+        if (counter.is_delivered[i]) {
+            last_delivery = std::max(last_delivery, counter.delivery_times[i]);
+            latencies.push_back(duration_cast<duration<double, std::milli>>(counter.delivery_times[i] - writes[i].end).count());
+        } else if (!writes[i].stalled) {
+            ++num_lost;
+        }
+    }
+
+    const auto elapsed = duration_cast<nanoseconds>(last_delivery - start).count();
+    const auto frames_per_sec = (elapsed > 0) ? static_cast<double>(num_received) * 1e9 / static_cast<double>(elapsed) : 0.0;
+    const auto line_frames_per_sec = 1e9 / static_cast<double>(duration_cast<nanoseconds>(frame_time).count());
+
+    return Result{
+        num_frames,
+        num_received,
+        num_stalled,
+        num_lost,
+        counter.num_unexpected,
+        get_percentile(latencies, 0.50),
+        get_percentile(latencies, 0.99),
+        frames_per_sec,
+        100.0 * frames_per_sec / line_frames_per_sec
+    };
+}
+}
+
+int main()
+{
+    try {
+        bool success = true;
+
+        printf("\nserial wrapper over a pty, %u byte payloads, %u ms between polls\n\n", payload_size, static_cast<uint32_t>(frame_spacing.count()));
+        printf("%-8s %-8s %-12s %8s %8s %10s %10s %12s %8s\n", "baud", "framing", "pattern", "frames", "stalled", "p50 ms", "p99 ms", "frames/s", "line %");
+
+        for (auto baud : BAUD_RATES) {
+            const struct {
+                SerialFraming framing;
+                bool spaced;
+            } cases[] = {
+                { SerialFraming::link, true },
+                { SerialFraming::gap, true },
+                { SerialFraming::link, false }
+            };
+
+            for (const auto& test : cases) {
+                const auto result = run(baud, test.framing, test.spaced);
+                printf("%-8u %-8s %-12s %4u/%-4u %8u %10.2f %10.2f %12.1f %8.1f\n",
+                       baud,
+                       (test.framing == SerialFraming::link) ? "link" : "gap",
+                       test.spaced ? "poll" : "back2back",
+                       result.num_received,
+                       result.num_sent,
+                       result.num_stalled,
+                       result.p50_ms,
+                       result.p99_ms,
+                       result.frames_per_sec,
+                       result.line_utilization);
+
+                if (result.num_lost != 0 || result.num_unexpected != 0) {
+                    success = false;
+                }
+            }
+        }
+
+        return success ? 0 : -1;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return -1;
+    }
+}
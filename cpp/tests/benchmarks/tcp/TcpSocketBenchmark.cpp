@@ -0,0 +1,203 @@
+/**
+ * Loopback benchmark of the proxy's TCP receive path with a varying number of receive buffers.
+ *
+ * A plain socket streams link frames as fast as it can. The receiving side is the proxy's
+ * AsioTcpSocketWrapper and AsioLowerLayer feeding a LinkLayer, so socket reads either alternate
+ * with frame parsing (1 buffer) or overlap with it (2 or more buffers).
+ *
+ * Loopback rates vary from run to run, so each configuration is run several times and the
+ * run with the median rate is reported.
+ */
+
+#include "AsioLowerLayer.h"
+#include "tcp/AsioTcpSocketWrapper.h"
+
+#include "crypto/gen/SessionData.h"
+#include "link/LinkFrameWriter.h"
+#include "link/LinkLayer.h"
+
+#include "ssp21/crypto/Constants.h"
+#include "ssp21/util/Exception.h"
+
+#include <asio.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+using namespace ssp21;
+using namespace std::chrono;
+
+namespace {
+
+using tcp = asio::ip::tcp;
+
+const uint32_t frames_per_write = 64;
+const uint64_t total_bytes = 256 * 1024 * 1024;
+const size_t num_runs = 5;
+const auto PAYLOAD_SIZES = { 64u, 256u, 1024u, 4000u };
+const auto BUFFER_COUNTS = { 1u, 2u, 4u };
+
+class FrameCounter final : public IUpperLayer {
+public:
+    void configure(ILowerLayer& lower)
+    {
+        this->lower = &lower;
+    }
+
+    uint64_t num_frames = 0;
+
+private:
+    void on_lower_open_impl() override {}
+
+    void on_lower_close_impl() override {}
+
+    void on_lower_tx_ready_impl() override {}
+
+    void on_lower_rx_ready_impl() override
+    {
+        while (this->lower->start_rx_from_upper().is_not_empty()) {
+            ++this->num_frames;
+        }
+    }
+
+    ILowerLayer* lower = nullptr;
+};
+
+// the same frame repeated, so one write carries many frames
+std::vector<uint8_t> make_stream(uint32_t payload_size)
+{
+    std::vector<uint8_t> payload(payload_size);
+    for (uint32_t i = 0; i < payload_size; ++i) {
+        payload[i] = static_cast<uint8_t>(i);
+    }
+
+    const uint8_t auth_tag[consts::crypto::trunc16] = { 0 };
+    const SessionData message(AuthMetadata(1, 0xFFFFFFFF), seq32_t(payload.data(), payload_size), seq32_t(auth_tag, sizeof(auth_tag)));
+
+    LinkFrameWriter writer(log4cpp::Logger::empty(), Addresses(1, 10), consts::link::max_config_payload_size);
+    const auto written = writer.write(message);
+    if (written.is_error()) {
+        throw Exception("unable to write benchmark frame");
+    }
+
+    std::vector<uint8_t> stream;
+    for (uint32_t i = 0; i < frames_per_write; ++i) {
+        stream.insert(stream.end(), static_cast<const uint8_t*>(written.frame), static_cast<const uint8_t*>(written.frame) + written.frame.length());
+    }
+    return stream;
+}
+
+struct Result {
+    uint64_t num_frames;
+    double frames_per_sec;
+    double mb_per_sec;
+};
+
+Result run(uint32_t payload_size, uint32_t num_rx_buffers)
+{
+    const auto stream = make_stream(payload_size);
+    const auto num_writes = total_bytes / stream.size();
+    const auto expected_frames = num_writes * frames_per_write;
+
+    asio::io_service service;
+
+    tcp::acceptor acceptor(service, tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+    tcp::socket sender(service);
+    sender.connect(acceptor.local_endpoint());
+    tcp::socket receiver(service);
+    acceptor.accept(receiver);
+
+    AsioLowerLayer lower(log4cpp::Logger::empty());
+    AsioTcpSocketWrapper socket(log4cpp::Logger::empty(), lower, receiver, num_rx_buffers);
+    LinkLayer link(1, 10);
+    FrameCounter counter;
+
+    counter.configure(link);
+    link.bind(lower, counter);
+
+    uint64_t writes_remaining = num_writes;
+    std::function<void()> write_next = [&]() {
+        if (writes_remaining == 0) {
+            return;
+        }
+        --writes_remaining;
+        asio::async_write(sender, asio::buffer(stream), [&](const std::error_code& ec, size_t) {
+            if (!ec) {
+                write_next();
+            }
+        });
+    };
+
+    // stop as soon as every frame was parsed
+    asio::steady_timer timer(service);
+    std::function<void()> poll = [&]() {
+        timer.expires_after(milliseconds(1));
+        timer.async_wait([&](const std::error_code&) {
+            if (counter.num_frames >= expected_frames) {
+                service.stop();
+            } else {
+                poll();
+            }
+        });
+    };
+
+    const auto start = steady_clock::now();
+
+    lower.open(socket, link);
+    write_next();
+    poll();
+    service.run();
+
+    const auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+    socket.try_close_socket();
+
+    return Result{
+        counter.num_frames,
+        static_cast<double>(counter.num_frames) * 1e9 / static_cast<double>(elapsed),
+        (static_cast<double>(num_writes * stream.size()) / (1024.0 * 1024.0)) * 1e9 / static_cast<double>(elapsed)
+    };
+}
+
+Result run_median(uint32_t payload_size, uint32_t num_rx_buffers)
+{
+    std::vector<Result> results;
+    for (size_t i = 0; i < num_runs; ++i) {
+        results.push_back(run(payload_size, num_rx_buffers));
+    }
+
+    std::sort(results.begin(), results.end(), [](const Result& lhs, const Result& rhs) { return lhs.frames_per_sec < rhs.frames_per_sec; });
+
+    return results[results.size() / 2];
+}
+}
+
+int main()
+{
+    try {
+        printf("\nTCP loopback receive path, %llu MB per run, median of %zu runs\n\n", static_cast<unsigned long long>(total_bytes / (1024 * 1024)), num_runs);
+        printf("%-10s %8s %12s %14s %10s\n", "buffers", "size", "frames", "frames/s", "MB/s");
+
+        for (auto payload_size : PAYLOAD_SIZES) {
+            for (auto num_rx_buffers : BUFFER_COUNTS) {
+                const auto result = run_median(payload_size, num_rx_buffers);
+                printf("%-10u %8u %12llu %14.0f %10.2f\n",
+                       num_rx_buffers,
+                       payload_size,
+                       static_cast<unsigned long long>(result.num_frames),
+                       result.frames_per_sec,
+                       result.mb_per_sec);
+            }
+        }
+
+        return 0;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return -1;
+    }
+}
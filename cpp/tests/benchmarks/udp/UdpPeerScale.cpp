@@ -0,0 +1,288 @@
+/**
+ * Loopback scale test for the many-peer UDP proxy.
+ *
+ * A single UdpPeerProxySession serves N initiator peers, each on its own ephemeral port, and
+ * forwards their raw traffic to an echo socket. The test checks that:
+ *
+ * 1) every peer completes a handshake and gets its own payload echoed back (no cross-routing)
+ * 2) a peer beyond max_peers is ignored
+ * 3) idle peers are evicted once they go quiet
+ *
+ * Returns a non-zero exit code if any check fails.
+ */
+
+#include "AsioLowerLayer.h"
+#include "udp/AsioUdpSocketWrapper.h"
+#include "udp/UdpPeerProxySession.h"
+
+#include "ssp21/crypto/Crypto.h"
+#include "ssp21/stack/Factory.h"
+
+#include "sodium/Backend.h"
+
+#include <exe4cpp/asio/BasicExecutor.h>
+
+#include <asio.hpp>
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace ssp21;
+using namespace std::chrono;
+
+namespace {
+
+using udp = asio::ip::udp;
+
+const uint16_t default_num_peers = 1000;
+const uint16_t default_secure_port = 41003;
+const auto peer_idle_timeout_seconds = 10;
+
+class Client final : public IUpperLayer {
+public:
+    Client(uint32_t index, const std::shared_ptr<exe4cpp::BasicExecutor>& executor, const udp::endpoint& proxy_endpoint, const std::shared_ptr<const SymmetricKey>& key)
+        : lower(log4cpp::Logger::empty())
+        , socket(log4cpp::Logger::empty(), lower, udp::socket(*executor->get_service(), udp::endpoint(asio::ip::address_v4::loopback(), 0)), proxy_endpoint)
+        , stack(initiator::factory::shared_secret_mode(InitiatorConfig(), log4cpp::Logger::empty(), executor, CryptoSuite(), key))
+        , payload("peer-" + std::to_string(index))
+    {
+    }
+
+    void start()
+    {
+        this->stack->bind(this->lower, *this);
+        this->lower.open(this->socket, *this->stack);
+    }
+
+    void stop()
+    {
+        this->lower.close();
+    }
+
+    bool is_established = false;
+    bool is_echoed = false;
+    bool is_misrouted = false;
+
+private:
+    void on_lower_open_impl() override
+    {
+        this->is_established = true;
+        this->stack->start_tx_from_upper(seq32_t(reinterpret_cast<const uint8_t*>(this->payload.data()), static_cast<uint32_t>(this->payload.size())));
+    }
+
+    void on_lower_close_impl() override {}
+
+    void on_lower_tx_ready_impl() override {}
+
+    void on_lower_rx_ready_impl() override
+    {
+        for (auto data = this->stack->start_rx_from_upper(); data.is_not_empty(); data = this->stack->start_rx_from_upper()) {
+            const std::string received(reinterpret_cast<const char*>(static_cast<const uint8_t*>(data)), data.length());
+            if (received == this->payload) {
+                this->is_echoed = true;
+            } else {
+                this->is_misrouted = true;
+            }
+        }
+    }
+
+    AsioLowerLayer lower;
+    AsioUdpSocketWrapper socket;
+    const std::shared_ptr<IStack> stack;
+    const std::string payload;
+};
+
+class EchoServer {
+public:
+    EchoServer(asio::io_service& service)
+        : socket(service, udp::endpoint(asio::ip::address_v4::loopback(), 0))
+        , buffer(consts::link::max_frame_size)
+    {
+        this->receive_next();
+    }
+
+    udp::endpoint get_endpoint() const
+    {
+        return this->socket.local_endpoint();
+    }
+
+    void close()
+    {
+        std::error_code ec;
+        this->socket.close(ec);
+    }
+
+private:
+    void receive_next()
+    {
+        this->socket.async_receive_from(asio::buffer(this->buffer), this->sender, [this](const std::error_code& ec, size_t num_rx) {
+            if (ec) {
+                return;
+            }
+            std::error_code tx_ec;
+            this->socket.send_to(asio::buffer(this->buffer.data(), num_rx), this->sender, 0, tx_ec);
+            this->receive_next();
+        });
+    }
+
+    udp::socket socket;
+    udp::endpoint sender;
+    std::vector<uint8_t> buffer;
+};
+
+// every peer needs two descriptors in this process: one for the client, one for its raw socket in the proxy
+void raise_file_limit()
+{
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+bool run_until(asio::io_service& service, const std::function<bool()>& is_done, steady_clock::duration timeout)
+{
+    const auto deadline = steady_clock::now() + timeout;
+
+    asio::steady_timer timer(service);
+    std::function<void()> poll = [&]() {
+        timer.expires_after(milliseconds(10));
+        timer.async_wait([&](const std::error_code&) {
+            if (is_done() || steady_clock::now() >= deadline) {
+                service.stop();
+            } else {
+                poll();
+            }
+        });
+    };
+    poll();
+
+    service.restart();
+    service.run();
+
+    return is_done();
+}
+
+std::string get_config(uint16_t secure_port, const udp::endpoint& echo_endpoint, uint16_t max_peers)
+{
+    return "secure_rx: { address: \"127.0.0.1\", port: " + std::to_string(secure_port) + " }\n"
+        + "raw_tx: { address: \"127.0.0.1\", port: " + std::to_string(echo_endpoint.port()) + " }\n"
+        + "raw_bind_address: \"127.0.0.1\"\n"
+        + "max_peers: " + std::to_string(max_peers) + "\n"
+        + "peer_idle_timeout: { value: " + std::to_string(peer_idle_timeout_seconds) + ", unit: seconds }\n";
+}
+
+bool check(const char* name, bool passed)
+{
+    printf("%-50s %s\n", name, passed ? "PASS" : "FAIL");
+    return passed;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    try {
+        ssp21::sodium::initialize();
+        raise_file_limit();
+
+        const auto num_peers = (argc > 1) ? static_cast<uint16_t>(std::atoi(argv[1])) : default_num_peers;
+        const auto secure_port = (argc > 2) ? static_cast<uint16_t>(std::atoi(argv[2])) : default_secure_port;
+
+        const auto executor = exe4cpp::BasicExecutor::create(std::make_shared<asio::io_service>());
+        auto& service = *executor->get_service();
+
+        const auto key = std::make_shared<SymmetricKey>();
+        Crypto::gen_random(key->as_wseq().take(consts::crypto::symmetric_key_length));
+        key->set_length(BufferLength::length_32);
+
+        EchoServer echo(service);
+
+        const StackFactory factory(false, StackType::responder, [key](const log4cpp::Logger& logger, const std::shared_ptr<exe4cpp::IExecutor>& exe, const session_keys_handler_t&) {
+            return responder::factory::shared_secret_mode(ResponderConfig(), logger, exe, key);
+        });
+
+        UdpPeerProxySession proxy(
+            UdpPeersConfig(YAML::Load(get_config(secure_port, echo.get_endpoint(), num_peers))),
+            factory,
+            PlaintextQueueConfig(),
+            LatencyTracingConfig(),
+            executor,
+            log4cpp::Logger::empty());
+        proxy.start();
+
+        const udp::endpoint proxy_endpoint(asio::ip::address_v4::loopback(), secure_port);
+
+        std::vector<std::unique_ptr<Client>> clients;
+        for (uint32_t i = 0; i < num_peers; ++i) {
+            clients.push_back(std::make_unique<Client>(i, executor, proxy_endpoint, key));
+        }
+
+        printf("\n%u peers on loopback\n\n", num_peers);
+
+        // 1) every peer gets its own data back
+        const auto start = steady_clock::now();
+        for (auto& client : clients) {
+            client->start();
+        }
+
+        const auto count_echoed = [&]() {
+            uint32_t count = 0;
+            for (const auto& client : clients) {
+                if (client->is_echoed)
+                    ++count;
+            }
+            return count;
+        };
+
+        run_until(
+            service, [&]() { return count_echoed() == num_peers; }, seconds(30));
+
+        const auto elapsed_ms = duration_cast<milliseconds>(steady_clock::now() - start).count();
+
+        uint32_t num_misrouted = 0;
+        for (const auto& client : clients) {
+            if (client->is_misrouted)
+                ++num_misrouted;
+        }
+
+        printf("%u of %u peers echoed in %lld ms, %u misrouted, %u proxy peers\n\n",
+               count_echoed(), num_peers, static_cast<long long>(elapsed_ms), num_misrouted, static_cast<uint32_t>(proxy.get_num_peers()));
+
+        bool passed = true;
+        passed &= check("all peers echoed", count_echoed() == num_peers);
+        passed &= check("no datagram routed to the wrong peer", num_misrouted == 0);
+        passed &= check("one proxy peer per client", proxy.get_num_peers() == num_peers);
+
+        // 2) the table is full, so one more peer must not get a session
+        Client extra(num_peers, executor, proxy_endpoint, key);
+        extra.start();
+        run_until(
+            service, [&]() { return extra.is_established; }, seconds(2));
+        passed &= check("peer beyond max_peers is ignored", !extra.is_established && proxy.get_num_peers() == num_peers);
+        extra.stop();
+
+        // 3) once the clients go quiet their peers are evicted
+        for (auto& client : clients) {
+            client->stop();
+        }
+        run_until(
+            service, [&]() { return proxy.get_num_peers() == 0; }, seconds(3 * peer_idle_timeout_seconds));
+        passed &= check("idle peers are evicted", proxy.get_num_peers() == 0);
+
+        echo.close();
+
+        return passed ? 0 : -1;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return -1;
+    }
+}
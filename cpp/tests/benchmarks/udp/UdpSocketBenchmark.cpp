@@ -0,0 +1,242 @@
+/**
+ * Loopback benchmark comparing the proxy's one-datagram-per-call UDP socket wrapper
+ * against the recvmmsg/sendmmsg batching wrapper.
+ *
+ * A sender wrapper writes a fixed number of datagrams as fast as its layer is told it may,
+ * and a receiver wrapper on the same io_service counts what arrives. UDP may drop datagrams
+ * when the receive buffer overflows, so the receive rate is reported along with the loss.
+ *
+ * Loopback rates vary a lot from run to run, so each variant is run several times and the
+ * run with the median receive rate is reported.
+ */
+
+#include "udp/AsioUdpBatchSocketWrapper.h"
+#include "udp/AsioUdpSocketWrapper.h"
+
+#include <asio.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+const uint64_t num_datagrams = 200000;
+const size_t num_runs = 5;
+const auto idle_timeout = milliseconds(200);
+const auto PAYLOAD_SIZES = { 16u, 64u, 256u, 1024u };
+const auto BATCH_SIZES = { 8u, 32u, 64u };
+
+using wrapper_factory_t = std::function<std::unique_ptr<IAsioSocketWrapper>(IAsioLayer& layer, asio::ip::udp::socket socket, asio::ip::udp::endpoint send_endpoint)>;
+
+class SenderLayer final : public IAsioLayer {
+public:
+    SenderLayer(uint32_t payload_size)
+        : payload(payload_size)
+    {
+        for (uint32_t i = 0; i < payload_size; ++i) {
+            payload[i] = static_cast<uint8_t>(i);
+        }
+    }
+
+    void start(IAsioSocketWrapper& socket)
+    {
+        this->socket = &socket;
+        this->start_time = steady_clock::now();
+        this->send_next();
+    }
+
+    void on_rx_complete(const ssp21::seq32_t& data) override {}
+
+    void on_tx_complete() override
+    {
+        this->send_next();
+    }
+
+    void on_rx_or_tx_error() override
+    {
+        ++this->num_errors;
+    }
+
+    bool is_active() const override
+    {
+        return this->num_sent < num_datagrams;
+    }
+
+    steady_clock::time_point start_time;
+    steady_clock::time_point finish_time;
+    uint64_t num_sent = 0;
+    uint64_t num_errors = 0;
+
+private:
+    void send_next()
+    {
+        if (this->num_sent == num_datagrams) {
+            if (this->finish_time == steady_clock::time_point()) {
+                this->finish_time = steady_clock::now();
+            }
+            return;
+        }
+
+        if (this->socket->start_tx_to_socket(ssp21::seq32_t(this->payload.data(), static_cast<uint32_t>(this->payload.size())))) {
+            ++this->num_sent;
+        }
+    }
+
+    IAsioSocketWrapper* socket = nullptr;
+    std::vector<uint8_t> payload;
+};
+
+class ReceiverLayer final : public IAsioLayer {
+public:
+    void start(IAsioSocketWrapper& socket)
+    {
+        this->socket = &socket;
+        this->socket->start_rx_from_socket();
+    }
+
+    void on_rx_complete(const ssp21::seq32_t& data) override
+    {
+        this->last_rx_time = steady_clock::now();
+        ++this->num_received;
+        this->socket->start_rx_from_socket();
+    }
+
+    void on_tx_complete() override {}
+
+    void on_rx_or_tx_error() override
+    {
+        ++this->num_errors;
+    }
+
+    bool is_active() const override
+    {
+        return true;
+    }
+
+    steady_clock::time_point last_rx_time;
+    uint64_t num_received = 0;
+    uint64_t num_errors = 0;
+
+private:
+    IAsioSocketWrapper* socket = nullptr;
+};
+
+struct Result {
+    double tx_per_sec;
+    double rx_per_sec;
+    double loss_percent;
+};
+
+double per_sec(uint64_t count, steady_clock::duration elapsed)
+{
+    const auto ns = duration_cast<nanoseconds>(elapsed).count();
+    return (ns > 0) ? static_cast<double>(count) * 1e9 / static_cast<double>(ns) : 0.0;
+}
+
+Result run(const wrapper_factory_t& factory, uint32_t payload_size)
+{
+    asio::io_service service;
+
+    asio::ip::udp::socket rx_socket(service, asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0));
+    rx_socket.set_option(asio::socket_base::receive_buffer_size(8 * 1024 * 1024));
+    const auto rx_endpoint = rx_socket.local_endpoint();
+
+    asio::ip::udp::socket tx_socket(service, asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0));
+
+    SenderLayer sender(payload_size);
+    ReceiverLayer receiver;
+
+    // the receiver never sends, so point it back at itself
+    auto receiver_socket = factory(receiver, std::move(rx_socket), rx_endpoint);
+    auto sender_socket = factory(sender, std::move(tx_socket), rx_endpoint);
+
+    receiver.start(*receiver_socket);
+    sender.start(*sender_socket);
+
+    // stop once the sender is done and nothing has arrived for a while
+    asio::steady_timer timer(service);
+    std::function<void()> check_for_idle = [&]() {
+        timer.expires_after(idle_timeout);
+        timer.async_wait([&](const std::error_code&) {
+            const auto is_sender_done = sender.num_sent == num_datagrams && !sender_socket->get_is_tx_active();
+            const auto is_receiver_idle = (steady_clock::now() - receiver.last_rx_time) >= idle_timeout;
+            if (receiver.num_received == num_datagrams || (is_sender_done && is_receiver_idle)) {
+                receiver_socket->try_close_socket();
+                sender_socket->try_close_socket();
+            } else {
+                check_for_idle();
+            }
+        });
+    };
+    check_for_idle();
+
+    service.run();
+
+    const auto tx_elapsed = sender.finish_time - sender.start_time;
+    const auto rx_elapsed = receiver.last_rx_time - sender.start_time;
+
+    return Result{
+        per_sec(sender.num_sent, tx_elapsed),
+        per_sec(receiver.num_received, rx_elapsed),
+        100.0 * static_cast<double>(num_datagrams - receiver.num_received) / static_cast<double>(num_datagrams)
+    };
+}
+
+Result run_median(const wrapper_factory_t& factory, uint32_t payload_size)
+{
+    std::vector<Result> results;
+    for (size_t i = 0; i < num_runs; ++i) {
+        results.push_back(run(factory, payload_size));
+    }
+
+    std::sort(results.begin(), results.end(), [](const Result& lhs, const Result& rhs) { return lhs.rx_per_sec < rhs.rx_per_sec; });
+
+    return results[results.size() / 2];
+}
+
+void print(const char* variant, uint32_t payload_size, const Result& result)
+{
+    printf("%-18s %8u %14.0f %14.0f %8.2f\n", variant, payload_size, result.tx_per_sec, result.rx_per_sec, result.loss_percent);
+}
+}
+
+int main()
+{
+    try {
+        const auto logger = log4cpp::Logger::empty();
+
+        printf("\nUDP loopback, %llu datagrams per run, median of %zu runs\n\n", static_cast<unsigned long long>(num_datagrams), num_runs);
+        printf("%-18s %8s %14s %14s %8s\n", "variant", "size", "tx pkts/s", "rx pkts/s", "loss %");
+
+        for (auto payload_size : PAYLOAD_SIZES) {
+
+            print("single", payload_size, run_median([&](IAsioLayer& layer, asio::ip::udp::socket socket, asio::ip::udp::endpoint send_endpoint) {
+                return std::make_unique<AsioUdpSocketWrapper>(logger, layer, std::move(socket), send_endpoint);
+            },
+                                                     payload_size));
+
+            for (auto batch_size : BATCH_SIZES) {
+                char variant[32];
+                snprintf(variant, sizeof(variant), "batch (%u)", batch_size);
+
+                print(variant, payload_size, run_median([&](IAsioLayer& layer, asio::ip::udp::socket socket, asio::ip::udp::endpoint send_endpoint) {
+                    return std::make_unique<AsioUdpBatchSocketWrapper>(logger, layer, std::move(socket), send_endpoint, batch_size);
+                },
+                                                        payload_size));
+            }
+        }
+
+        return 0;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return -1;
+    }
+}
@@ -0,0 +1,307 @@
+/**
+ * Loopback benchmark comparing the proxy's reactor (epoll) socket wrappers with the io_uring wrappers.
+ *
+ * A number of echo sessions run on one io_service thread, most of them idle at any time. A
+ * client on the main thread sends one message at a time to a session and waits for the echo,
+ * spreading the messages across all sessions, and records every round trip.
+ *
+ * System calls per message count the socket reads and writes for the reactor wrappers, and the
+ * io_uring_enter calls and eventfd reads for the io_uring wrappers. The epoll_wait calls made by
+ * the io_service are the same for both and are not counted.
+ */
+
+#include "tcp/AsioTcpSocketWrapper.h"
+#include "udp/AsioUdpSocketWrapper.h"
+#include "uring/AsioUringSocketWrapper.h"
+#include "uring/IoUringService.h"
+
+#include <asio.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+using tcp = asio::ip::tcp;
+using udp = asio::ip::udp;
+
+const uint32_t num_warmup_messages = 1000;
+const uint32_t num_messages = 100000;
+const uint32_t message_size = 64;
+const auto SESSION_COUNTS = { 1u, 100u, 1000u };
+
+enum class Backend {
+    epoll,
+    io_uring
+};
+
+class EchoLayer final : public IAsioLayer {
+public:
+    void start(IAsioSocketWrapper& socket)
+    {
+        this->socket = &socket;
+        this->socket->start_rx_from_socket();
+    }
+
+    // the received data stays valid until the next read is started
+    void on_rx_complete(const ssp21::seq32_t& data) override
+    {
+        ++this->num_socket_ops;
+        this->socket->start_tx_to_socket(data);
+    }
+
+    void on_tx_complete() override
+    {
+        ++this->num_socket_ops;
+        this->socket->start_rx_from_socket();
+    }
+
+    void on_rx_or_tx_error() override
+    {
+        ++this->num_errors;
+    }
+
+    bool is_active() const override
+    {
+        return false;
+    }
+
+    uint64_t num_socket_ops = 0;
+    uint64_t num_errors = 0;
+
+private:
+    IAsioSocketWrapper* socket = nullptr;
+};
+
+struct EchoSession {
+    std::unique_ptr<EchoLayer> layer;
+    std::unique_ptr<IAsioSocketWrapper> socket;
+};
+
+struct Result {
+    double syscalls_per_message;
+    double p50_us;
+    double p99_us;
+    uint64_t num_errors;
+};
+
+double get_percentile(std::vector<nanoseconds::rep>& samples, double percentile)
+{
+    const auto index = static_cast<size_t>(percentile * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return static_cast<double>(samples[index]) / 1000.0;
+}
+
+std::unique_ptr<IAsioSocketWrapper> create_socket(Backend backend, EchoLayer& layer, tcp::socket& socket, const tcp::endpoint&)
+{
+    if (backend == Backend::io_uring) {
+        return std::make_unique<AsioUringTcpSocketWrapper>(log4cpp::Logger::empty(), layer, std::move(socket));
+    }
+    return std::make_unique<AsioTcpSocketWrapper>(log4cpp::Logger::empty(), layer, socket);
+}
+
+std::unique_ptr<IAsioSocketWrapper> create_socket(Backend backend, EchoLayer& layer, udp::socket& socket, const udp::endpoint& send_endpoint)
+{
+    if (backend == Backend::io_uring) {
+        return std::make_unique<AsioUringUdpSocketWrapper>(log4cpp::Logger::empty(), layer, std::move(socket), send_endpoint);
+    }
+    return std::make_unique<AsioUdpSocketWrapper>(log4cpp::Logger::empty(), layer, std::move(socket), send_endpoint);
+}
+
+struct TcpClient {
+    TcpClient(asio::io_service& client_service, asio::io_service& server_service, uint32_t num_sessions)
+    {
+        tcp::acceptor acceptor(server_service, tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+        for (uint32_t i = 0; i < num_sessions; ++i) {
+            this->sockets.emplace_back(client_service);
+            this->sockets.back().connect(acceptor.local_endpoint());
+            this->sockets.back().set_option(tcp::no_delay(true));
+            this->accepted.emplace_back(server_service);
+            acceptor.accept(this->accepted.back());
+            this->accepted.back().set_option(tcp::no_delay(true));
+        }
+    }
+
+    tcp::socket& get_server_socket(uint32_t session)
+    {
+        return this->accepted[session];
+    }
+
+    tcp::endpoint get_send_endpoint(uint32_t)
+    {
+        return tcp::endpoint();
+    }
+
+    void echo(uint32_t session, std::vector<uint8_t>& message)
+    {
+        asio::write(this->sockets[session], asio::buffer(message));
+        asio::read(this->sockets[session], asio::buffer(message));
+    }
+
+    std::vector<tcp::socket> sockets;
+    std::vector<tcp::socket> accepted;
+};
+
+struct UdpClient {
+    UdpClient(asio::io_service& client_service, asio::io_service& server_service, uint32_t num_sessions)
+        : socket(client_service, udp::endpoint(asio::ip::address_v4::loopback(), 0))
+    {
+        for (uint32_t i = 0; i < num_sessions; ++i) {
+            this->server_sockets.emplace_back(server_service, udp::endpoint(asio::ip::address_v4::loopback(), 0));
+            this->server_endpoints.push_back(this->server_sockets.back().local_endpoint());
+        }
+    }
+
+    udp::socket& get_server_socket(uint32_t session)
+    {
+        return this->server_sockets[session];
+    }
+
+    udp::endpoint get_send_endpoint(uint32_t)
+    {
+        return this->socket.local_endpoint();
+    }
+
+    void echo(uint32_t session, std::vector<uint8_t>& message)
+    {
+        this->socket.send_to(asio::buffer(message), this->server_endpoints[session]);
+        udp::endpoint sender;
+        this->socket.receive_from(asio::buffer(message), sender);
+    }
+
+    udp::socket socket;
+    std::vector<udp::socket> server_sockets;
+    std::vector<udp::endpoint> server_endpoints;
+};
+
+template <class Client>
+Result run(Backend backend, uint32_t num_sessions)
+{
+    asio::io_service server_service;
+    asio::io_service client_service;
+    Client client(client_service, server_service, num_sessions);
+
+    std::vector<EchoSession> sessions;
+    for (uint32_t i = 0; i < num_sessions; ++i) {
+        auto layer = std::make_unique<EchoLayer>();
+        auto socket = create_socket(backend, *layer, client.get_server_socket(i), client.get_send_endpoint(i));
+        layer->start(*socket);
+        sessions.push_back(EchoSession{ std::move(layer), std::move(socket) });
+    }
+
+    auto work = std::make_unique<asio::io_service::work>(server_service);
+    std::thread server_thread([&]() { server_service.run(); });
+
+    std::vector<uint8_t> message(message_size, 0xAA);
+    std::vector<nanoseconds::rep> round_trips;
+    round_trips.reserve(num_messages);
+
+    uint64_t ops_before = 0;
+    IoUringService::Statistics uring_before;
+
+    for (uint32_t i = 0; i < num_warmup_messages + num_messages; ++i) {
+        if (i == num_warmup_messages) {
+            // the server is blocked on the client, so its counters are stable here
+            for (auto& session : sessions) {
+                ops_before += session.layer->num_socket_ops;
+            }
+            if (backend == Backend::io_uring) {
+                uring_before = asio::use_service<IoUringService>(server_service).get_statistics();
+            }
+        }
+
+        // a large prime stride touches every session without a fixed neighbour pattern
+        const auto session = static_cast<uint32_t>((static_cast<uint64_t>(i) * 7919) % num_sessions);
+        const auto start = steady_clock::now();
+        client.echo(session, message);
+        if (i >= num_warmup_messages) {
+            round_trips.push_back(duration_cast<nanoseconds>(steady_clock::now() - start).count());
+        }
+    }
+
+    uint64_t syscalls = 0;
+    uint64_t num_errors = 0;
+
+    if (backend == Backend::io_uring) {
+        const auto& after = asio::use_service<IoUringService>(server_service).get_statistics();
+        syscalls = (after.num_submit_calls - uring_before.num_submit_calls) + (after.num_wakeups - uring_before.num_wakeups);
+    } else {
+        for (auto& session : sessions) {
+            syscalls += session.layer->num_socket_ops;
+        }
+        syscalls -= ops_before;
+    }
+
+    for (auto& session : sessions) {
+        num_errors += session.layer->num_errors;
+    }
+
+    work.reset();
+    server_service.stop();
+    server_thread.join();
+
+    // the wrappers hold the memory of their outstanding operations, so the aborted
+    // operations have to complete before the sessions are destroyed
+    server_service.restart();
+    for (auto& session : sessions) {
+        session.socket->try_close_socket();
+    }
+    while (std::any_of(sessions.begin(), sessions.end(), [](const EchoSession& session) { return session.socket->is_active(); })) {
+        server_service.run_one();
+    }
+
+    return Result{
+        static_cast<double>(syscalls) / static_cast<double>(num_messages),
+        get_percentile(round_trips, 0.50),
+        get_percentile(round_trips, 0.99),
+        num_errors
+    };
+}
+
+template <class Client>
+void run_all(const char* transport)
+{
+    for (auto num_sessions : SESSION_COUNTS) {
+        for (auto backend : { Backend::epoll, Backend::io_uring }) {
+            const auto result = run<Client>(backend, num_sessions);
+            printf("%-6s %-10s %10u %14.2f %10.1f %10.1f %8llu\n",
+                   transport,
+                   (backend == Backend::epoll) ? "epoll" : "io_uring",
+                   num_sessions,
+                   result.syscalls_per_message,
+                   result.p50_us,
+                   result.p99_us,
+                   static_cast<unsigned long long>(result.num_errors));
+        }
+    }
+}
+}
+
+int main()
+{
+    try {
+        if (!IoUringService::is_supported()) {
+            std::cerr << "io_uring with multishot receive is not supported by this kernel" << std::endl;
+            return -1;
+        }
+
+        printf("\nloopback echo, %u messages of %u bytes per run\n\n", num_messages, message_size);
+        printf("%-6s %-10s %10s %14s %10s %10s %8s\n", "proto", "backend", "sessions", "syscalls/msg", "p50 us", "p99 us", "errors");
+
+        run_all<TcpClient>("tcp");
+        run_all<UdpClient>("udp");
+
+        return 0;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return -1;
+    }
+}
@@ -0,0 +1,162 @@
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace ssp21 {
+
+std::atomic<uint32_t> AllocationCounter::num_scopes{ 0 };
+std::atomic<uint64_t> AllocationCounter::num_allocations{ 0 };
+
+AllocationCounter::Scope::Scope()
+    : start(num_allocations.load())
+{
+    ++num_scopes;
+}
+
+AllocationCounter::Scope::~Scope()
+{
+    --num_scopes;
+}
+
+uint64_t AllocationCounter::Scope::count() const
+{
+    return num_allocations.load() - start;
+}
+
+void AllocationCounter::record()
+{
+    if (num_scopes.load(std::memory_order_relaxed) > 0) {
+        num_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+}
+
+void* operator new(std::size_t size)
+{
+    ssp21::AllocationCounter::record();
+
+    void* pointer = std::malloc(size == 0 ? 1 : size);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    ssp21::AllocationCounter::record();
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    std::free(pointer);
+}
+
+// types aligned beyond the default go through these since C++17, MSVC has no aligned_alloc to back them
+#if defined(__cpp_aligned_new) && !defined(_MSC_VER)
+
+namespace {
+void* allocate_aligned(std::size_t size, std::align_val_t alignment) noexcept
+{
+    ssp21::AllocationCounter::record();
+
+    // aligned_alloc wants a size that is a multiple of the alignment
+    const auto align = static_cast<std::size_t>(alignment);
+    const auto rounded = ((size == 0 ? 1 : size) + align - 1) / align * align;
+    return std::aligned_alloc(align, rounded);
+}
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* pointer = allocate_aligned(size, alignment);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocate_aligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocate_aligned(size, alignment);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(pointer);
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef SSP21_ALLOCATIONCOUNTER_H
+#define SSP21_ALLOCATIONCOUNTER_H
+
+#include "ser4cpp/util/Uncopyable.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace ssp21 {
+
+/**
+ * Counts calls to the global operator new while a Scope is active.
+ *
+ * The replacement operators live in AllocationCounter.cpp and apply to the whole test executable,
+ * including the aligned forms where the compiler provides them. Allocations on every thread are
+ * counted while any Scope is active, so a scope may wrap code that runs on other threads.
+ */
+class AllocationCounter : private ser4cpp::StaticOnly {
+
+public:
+    class Scope : private ser4cpp::Uncopyable {
+    public:
+        Scope();
+        ~Scope();
+
+        uint64_t count() const;
+
+    private:
+        const uint64_t start;
+    };
+
+    static void record();
+
+private:
+    static std::atomic<uint32_t> num_scopes;
+    static std::atomic<uint64_t> num_allocations;
+};
+
+}
+
+#endif
@@ -0,0 +1,30 @@
+#include "SessionStacks.h"
+
+#include "ssp21/crypto/Crypto.h"
+#include "ssp21/stack/Factory.h"
+
+namespace ssp21 {
+
+SessionStacks SessionStacks::create(StackType stack_type, SessionCryptoMode session_mode, const std::shared_ptr<exe4cpp::IExecutor>& exe, const InitiatorConfig& initiator_config)
+{
+    CryptoSuite suite{};
+    suite.session_crypto_mode = session_mode;
+
+    const auto key = std::make_shared<SymmetricKey>();
+    Crypto::gen_random(key->as_wseq().take(consts::crypto::symmetric_key_length));
+    key->set_length(BufferLength::length_32);
+
+    if (stack_type == StackType::full) {
+        return SessionStacks{
+            initiator::factory::shared_secret_mode(Addresses(1, 10), initiator_config, log4cpp::Logger::empty(), exe, suite, key),
+            responder::factory::shared_secret_mode(Addresses(10, 1), ResponderConfig(), log4cpp::Logger::empty(), exe, key)
+        };
+    }
+
+    return SessionStacks{
+        initiator::factory::shared_secret_mode(initiator_config, log4cpp::Logger::empty(), exe, suite, key),
+        responder::factory::shared_secret_mode(ResponderConfig(), log4cpp::Logger::empty(), exe, key)
+    };
+}
+
+}
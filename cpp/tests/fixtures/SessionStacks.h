@@ -0,0 +1,35 @@
+#ifndef SSP21_SESSIONSTACKS_H
+#define SSP21_SESSIONSTACKS_H
+
+#include "exe4cpp/IExecutor.h"
+
+#include "ssp21/crypto/CryptoLayerConfig.h"
+#include "ssp21/crypto/gen/SessionCryptoMode.h"
+#include "ssp21/stack/IStack.h"
+
+#include <memory>
+
+namespace ssp21 {
+
+enum class StackType : uint8_t {
+    full,
+    crypto_only
+};
+
+/**
+ * A shared secret initiator and responder with a random key, used by the tests and benchmarks
+ * that move session data between two stacks
+ *
+ * Logging is disabled so that formatting log messages can't allocate or skew measurements.
+ */
+struct SessionStacks {
+
+    static SessionStacks create(StackType stack_type, SessionCryptoMode session_mode, const std::shared_ptr<exe4cpp::IExecutor>& exe, const InitiatorConfig& initiator_config = InitiatorConfig());
+
+    const std::shared_ptr<IStack> initiator;
+    const std::shared_ptr<IStack> responder;
+};
+
+}
+
+#endif
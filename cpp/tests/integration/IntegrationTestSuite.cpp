@@ -13,6 +13,7 @@ using namespace ssp21;
 
 void open_and_test_handshake(IntegrationFixture& fix);
 void test_bidirectional_data_transfer(IntegrationFixture& fix, const seq32_t& data);
+ResponderConfig allowing_compression(SessionCompressionMode mode);
 
 const auto HANDSHAKE_TYPES = { HandshakeType::shared_secret, HandshakeType::qkd, HandshakeType::preshared_key, HandshakeType::certificates };
 const auto SESSION_MODES = { SessionCryptoMode::hmac_sha256_16, SessionCryptoMode::aes_256_gcm };
@@ -66,6 +67,92 @@ TEST_CASE(SUITE("can transfer data bidirectionally multiple times"))
     for_each_mode(run_test);
 }
 
+TEST_CASE(SUITE("can transfer compressed data bidirectionally"))
+{
+    auto run_test = [](HandshakeType type, SessionCryptoMode mode) {
+        IntegrationFixture fix(type, mode, SessionCompressionMode::lz_scada, allowing_compression(SessionCompressionMode::lz_scada));
+        open_and_test_handshake(fix);
+
+        // a DNP3 integrity poll compresses against the dictionary
+        const uint8_t poll[] = { 0xC0, 0xC1, 0x01, 0x3C, 0x02, 0x06, 0x3C, 0x03, 0x06, 0x3C, 0x04, 0x06, 0x3C, 0x01, 0x06 };
+        test_bidirectional_data_transfer(fix, seq32_t(poll, sizeof(poll)));
+
+        // data that doesn't compress is sent stored
+        const uint8_t random[] = { 0x9E, 0x37, 0x79, 0xB9, 0x7F, 0x4A, 0x7C, 0x15 };
+        test_bidirectional_data_transfer(fix, seq32_t(random, sizeof(random)));
+
+        // repetitive data, close to the most that's compressed into a single message
+        const auto num_bytes_tx = 1000;
+        uint8_t payload[num_bytes_tx] = { 0x00 };
+        for (int i = 0; i < num_bytes_tx; ++i)
+            payload[i] = (i / 4) % 8;
+        test_bidirectional_data_transfer(fix, seq32_t(payload, num_bytes_tx));
+    };
+
+    for_each_mode(run_test);
+}
+
+TEST_CASE(SUITE("can transfer compressed data at the maximum message size"))
+{
+    auto run_test = [](HandshakeType type, SessionCryptoMode mode) {
+        IntegrationFixture fix(type, mode, SessionCompressionMode::lz_scada, allowing_compression(SessionCompressionMode::lz_scada));
+        open_and_test_handshake(fix);
+
+        // 1024 bytes of user data per message, less the byte that compression can add
+        const auto max_tx_size = 1023;
+        uint8_t payload[max_tx_size + 1] = { 0x00 };
+
+        // data that doesn't compress is sent stored, which is the largest a message gets
+        uint32_t state = 0x9E3779B9;
+        for (int i = 0; i < max_tx_size + 1; ++i) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            payload[i] = static_cast<uint8_t>(state);
+        }
+        test_bidirectional_data_transfer(fix, seq32_t(payload, max_tx_size));
+
+        // one more byte goes in a second message
+        const auto all = seq32_t(payload, max_tx_size + 1);
+        fix.responder_validator->expect(all.take(max_tx_size));
+        fix.responder_validator->expect(all.skip(max_tx_size));
+        REQUIRE(fix.stacks.initiator->start_tx_from_upper(all));
+        REQUIRE(fix.exe->run_many() > 0);
+        REQUIRE(fix.responder_validator->is_empty());
+
+        // repetitive data of the same size
+        for (int i = 0; i < max_tx_size; ++i)
+            payload[i] = (i / 4) % 8;
+        test_bidirectional_data_transfer(fix, seq32_t(payload, max_tx_size));
+    };
+
+    for_each_mode(run_test);
+}
+
+TEST_CASE(SUITE("responder refuses compression it doesn't allow"))
+{
+    auto run_test = [](HandshakeType type, SessionCryptoMode mode) {
+        IntegrationFixture fix(type, mode, SessionCompressionMode::lz_scada);
+
+        fix.stacks.responder->on_lower_open();
+        fix.stacks.initiator->on_lower_open();
+
+        REQUIRE(fix.exe->run_many() > 0);
+
+        REQUIRE_FALSE(fix.responder_upper.is_open());
+        REQUIRE_FALSE(fix.initiator_upper.is_open());
+    };
+
+    for_each_mode(run_test);
+}
+
+ResponderConfig allowing_compression(SessionCompressionMode mode)
+{
+    ResponderConfig config;
+    config.allowed_compression_modes = { mode };
+    return config;
+}
+
 void open_and_test_handshake(IntegrationFixture& fix)
 {
     fix.stacks.responder->on_lower_open();
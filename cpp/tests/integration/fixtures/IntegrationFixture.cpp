@@ -17,38 +17,39 @@
 
 namespace ssp21 {
 
-IntegrationFixture::IntegrationFixture(HandshakeType handshake_type, SessionCryptoMode session_mode)
+IntegrationFixture::IntegrationFixture(HandshakeType handshake_type, SessionCryptoMode session_mode, SessionCompressionMode compression_mode, const ResponderConfig& responder_config)
     : exe(std::make_shared<exe4cpp::MockExecutor>())
     , ilog("initiator")
     , rlog("responder")
     , initiator_lower(exe)
     , responder_lower(exe)
-    , stacks(this->get_stacks(handshake_type, session_mode, rlog.logger, ilog.logger, exe))
+    , stacks(this->get_stacks(handshake_type, session_mode, compression_mode, responder_config, rlog.logger, ilog.logger, exe))
 {
     this->wire();
 }
 
-IntegrationFixture::Stacks IntegrationFixture::get_stacks(HandshakeType handshake_type, SessionCryptoMode session_mode, log4cpp::Logger rlogger, log4cpp::Logger ilogger, std::shared_ptr<exe4cpp::IExecutor> exe)
+IntegrationFixture::Stacks IntegrationFixture::get_stacks(HandshakeType handshake_type, SessionCryptoMode session_mode, SessionCompressionMode compression_mode, const ResponderConfig& responder_config, log4cpp::Logger rlogger, log4cpp::Logger ilogger, std::shared_ptr<exe4cpp::IExecutor> exe)
 {
     // start with the default algorithms, then define the specified session mode
     CryptoSuite suite{};
     suite.session_crypto_mode = session_mode;
+    suite.session_compression_mode = compression_mode;
 
     switch (handshake_type) {
     case (HandshakeType::preshared_key):
-        return preshared_key_stacks(rlogger, ilogger, suite, exe);
+        return preshared_key_stacks(rlogger, ilogger, suite, responder_config, exe);
     case (HandshakeType::certificates):
-        return certificate_stacks(rlogger, ilogger, suite, exe);
+        return certificate_stacks(rlogger, ilogger, suite, responder_config, exe);
     case (HandshakeType::shared_secret):
-        return shared_secret_stacks(rlogger, ilogger, suite, exe);
+        return shared_secret_stacks(rlogger, ilogger, suite, responder_config, exe);
     case (HandshakeType::qkd):
-        return qkd_stacks(rlogger, ilogger, suite, exe);
+        return qkd_stacks(rlogger, ilogger, suite, responder_config, exe);
     default:
         throw new Exception("Unsupported integration test mode");
     }
 }
 
-IntegrationFixture::Stacks IntegrationFixture::preshared_key_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, std::shared_ptr<exe4cpp::IExecutor> exe)
+IntegrationFixture::Stacks IntegrationFixture::preshared_key_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, const ResponderConfig& responder_config, std::shared_ptr<exe4cpp::IExecutor> exe)
 {
     const auto keys = generate_random_keys();
 
@@ -63,7 +64,7 @@ IntegrationFixture::Stacks IntegrationFixture::preshared_key_stacks(log4cpp::Log
 
     const auto responder = responder::factory::preshared_public_key_mode(
         Addresses(10, 1),
-        ResponderConfig(),
+        responder_config,
         rlogger,
         exe,
         keys.responder,
@@ -72,7 +73,7 @@ IntegrationFixture::Stacks IntegrationFixture::preshared_key_stacks(log4cpp::Log
     return Stacks{ initiator, responder };
 }
 
-IntegrationFixture::Stacks IntegrationFixture::qkd_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, std::shared_ptr<exe4cpp::IExecutor> exe)
+IntegrationFixture::Stacks IntegrationFixture::qkd_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, const ResponderConfig& responder_config, std::shared_ptr<exe4cpp::IExecutor> exe)
 {
     const auto key_store = std::make_shared<MockKeyStore>();
 
@@ -86,7 +87,7 @@ IntegrationFixture::Stacks IntegrationFixture::qkd_stacks(log4cpp::Logger rlogge
 
     const auto responder = responder::factory::qkd_mode(
         Addresses(10, 1),
-        ResponderConfig(),
+        responder_config,
         rlogger,
         exe,
         key_store);
@@ -94,7 +95,7 @@ IntegrationFixture::Stacks IntegrationFixture::qkd_stacks(log4cpp::Logger rlogge
     return Stacks{ initiator, responder };
 }
 
-IntegrationFixture::Stacks IntegrationFixture::certificate_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, std::shared_ptr<exe4cpp::IExecutor> exe)
+IntegrationFixture::Stacks IntegrationFixture::certificate_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, const ResponderConfig& responder_config, std::shared_ptr<exe4cpp::IExecutor> exe)
 {
     const auto keys = generate_random_keys();
 
@@ -117,7 +118,7 @@ IntegrationFixture::Stacks IntegrationFixture::certificate_stacks(log4cpp::Logge
 
     const auto responder = responder::factory::certificate_public_key_mode(
         Addresses(10, 1),
-        ResponderConfig(),
+        responder_config,
         rlogger,
         exe,
         keys.responder,
@@ -127,7 +128,7 @@ IntegrationFixture::Stacks IntegrationFixture::certificate_stacks(log4cpp::Logge
     return Stacks{ initiator, responder };
 }
 
-IntegrationFixture::Stacks IntegrationFixture::shared_secret_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, std::shared_ptr<exe4cpp::IExecutor> exe)
+IntegrationFixture::Stacks IntegrationFixture::shared_secret_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, const ResponderConfig& responder_config, std::shared_ptr<exe4cpp::IExecutor> exe)
 {
     const auto shared_secret = generate_shared_secret();
 
@@ -141,7 +142,7 @@ IntegrationFixture::Stacks IntegrationFixture::shared_secret_stacks(log4cpp::Log
 
     const auto responder = responder::factory::shared_secret_mode(
         Addresses(10, 1),
-        ResponderConfig(),
+        responder_config,
         rlogger,
         exe,
         shared_secret);
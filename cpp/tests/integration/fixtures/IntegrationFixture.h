@@ -10,6 +10,7 @@
 #include "log4cpp/ConsolePrettyPrinter.h"
 #include "log4cpp/MockLogHandler.h"
 
+#include "ssp21/crypto/CryptoLayerConfig.h"
 #include "ssp21/crypto/CryptoSuite.h"
 #include "ssp21/crypto/StaticKeys.h"
 #include "ssp21/crypto/gen/PublicKeyType.h"
@@ -44,7 +45,7 @@ class IntegrationFixture {
     };
 
 public:
-    IntegrationFixture(HandshakeType handshake_type, SessionCryptoMode session_mode);
+    IntegrationFixture(HandshakeType handshake_type, SessionCryptoMode session_mode, SessionCompressionMode compression_mode = SessionCompressionMode::none, const ResponderConfig& responder_config = ResponderConfig());
 
     const std::shared_ptr<exe4cpp::MockExecutor> exe;
     log4cpp::MockLogHandler ilog;
@@ -62,15 +63,15 @@ public:
     Stacks stacks;
 
 private:
-    static Stacks get_stacks(HandshakeType handshake_type, SessionCryptoMode session_mode, log4cpp::Logger rlogger, log4cpp::Logger ilogger, std::shared_ptr<exe4cpp::IExecutor> exe);
+    static Stacks get_stacks(HandshakeType handshake_type, SessionCryptoMode session_mode, SessionCompressionMode compression_mode, const ResponderConfig& responder_config, log4cpp::Logger rlogger, log4cpp::Logger ilogger, std::shared_ptr<exe4cpp::IExecutor> exe);
 
-    static Stacks preshared_key_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, std::shared_ptr<exe4cpp::IExecutor> exe);
+    static Stacks preshared_key_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, const ResponderConfig& responder_config, std::shared_ptr<exe4cpp::IExecutor> exe);
 
-    static Stacks qkd_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, std::shared_ptr<exe4cpp::IExecutor> exe);
+    static Stacks qkd_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, const ResponderConfig& responder_config, std::shared_ptr<exe4cpp::IExecutor> exe);
 
-    static Stacks certificate_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, std::shared_ptr<exe4cpp::IExecutor> exe);
+    static Stacks certificate_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, const ResponderConfig& responder_config, std::shared_ptr<exe4cpp::IExecutor> exe);
 
-    static Stacks shared_secret_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, std::shared_ptr<exe4cpp::IExecutor> exe);
+    static Stacks shared_secret_stacks(log4cpp::Logger rlogger, log4cpp::Logger ilogger, CryptoSuite suite, const ResponderConfig& responder_config, std::shared_ptr<exe4cpp::IExecutor> exe);
 
     static EndpointKeys generate_random_keys();
 
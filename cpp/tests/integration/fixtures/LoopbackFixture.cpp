@@ -0,0 +1,35 @@
+#include "LoopbackFixture.h"
+
+namespace ssp21 {
+
+LoopbackFixture::LoopbackFixture(StackType stack_type, SessionCryptoMode session_mode)
+    : exe(std::make_shared<exe4cpp::MockExecutor>())
+    , stacks(SessionStacks::create(stack_type, session_mode, exe))
+{
+    initiator_lower.configure(*stacks.initiator, responder_lower);
+    responder_lower.configure(*stacks.responder, initiator_lower);
+
+    initiator_upper.configure(*stacks.initiator);
+    responder_upper.configure(*stacks.responder);
+
+    stacks.initiator->bind(initiator_lower, initiator_upper);
+    stacks.responder->bind(responder_lower, responder_upper);
+}
+
+uint32_t LoopbackFixture::run()
+{
+    uint32_t count = 0;
+
+    while (true) {
+        const bool initiator_processed = initiator_lower.process();
+        const bool responder_processed = responder_lower.process();
+
+        if (!(initiator_processed || responder_processed)) {
+            return count;
+        }
+
+        ++count;
+    }
+}
+
+}
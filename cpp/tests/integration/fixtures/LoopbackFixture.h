@@ -0,0 +1,37 @@
+#ifndef SSP21_LOOPBACK_FIXTURE_H
+#define SSP21_LOOPBACK_FIXTURE_H
+
+#include "SessionStacks.h"
+
+#include "mocks/LoopbackLowerLayer.h"
+#include "mocks/UpperLayer.h"
+
+#include "exe4cpp/MockExecutor.h"
+
+namespace ssp21 {
+
+/**
+ * Shared secret initiator and responder joined by non-allocating loopback lower layers
+ */
+class LoopbackFixture {
+
+public:
+    LoopbackFixture(StackType stack_type, SessionCryptoMode session_mode);
+
+    // deliver events between the two sides until there is no more work, returns the number of events processed
+    uint32_t run();
+
+    const std::shared_ptr<exe4cpp::MockExecutor> exe;
+
+    LoopbackLowerLayer initiator_lower;
+    LoopbackLowerLayer responder_lower;
+
+    UpperLayer initiator_upper;
+    UpperLayer responder_upper;
+
+    SessionStacks stacks;
+};
+
+}
+
+#endif
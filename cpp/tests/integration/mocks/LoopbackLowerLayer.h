@@ -0,0 +1,126 @@
+#ifndef SSP21_LOOPBACKLOWERLAYER_H
+#define SSP21_LOOPBACKLOWERLAYER_H
+
+#include "ssp21/link/LinkConstants.h"
+#include "ssp21/stack/ILowerLayer.h"
+#include "ssp21/stack/IUpperLayer.h"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace ssp21 {
+
+/**
+ * Lower layer that copies transmitted frames into a fixed ring owned by its sibling.
+ *
+ * Unlike LowerLayer, it never allocates and it doesn't use the executor. Events are
+ * delivered when the test calls process(), which keeps the stacks from re-entering each other.
+ */
+class LoopbackLowerLayer final : public ILowerLayer {
+
+    static const uint32_t num_slots = 4;
+
+    struct Slot {
+        uint8_t data[consts::link::max_frame_size];
+        uint32_t length = 0;
+    };
+
+public:
+    bool start_tx_from_upper(const seq32_t& data) override
+    {
+        if (this->tx_pending) {
+            return false;
+        }
+
+        this->sibling->push(data);
+        this->tx_pending = true;
+
+        return true;
+    }
+
+    seq32_t start_rx_from_upper_impl() override
+    {
+        if (this->count == 0) {
+            return seq32_t::empty();
+        }
+
+        const auto& slot = this->slots[this->head];
+        return seq32_t(slot.data, slot.length);
+    }
+
+    bool is_tx_ready() const override
+    {
+        return !this->tx_pending;
+    }
+
+    void configure(IUpperLayer& upper, LoopbackLowerLayer& sibling)
+    {
+        this->upper = &upper;
+        this->sibling = &sibling;
+    }
+
+    // deliver any pending events to the upper layer, returns true if anything happened
+    bool process()
+    {
+        bool processed = false;
+
+        if (this->tx_pending) {
+            this->tx_pending = false;
+            this->upper->on_lower_tx_ready();
+            processed = true;
+        }
+
+        if (this->rx_pending) {
+            this->rx_pending = false;
+            this->upper->on_lower_rx_ready();
+            processed = true;
+        }
+
+        return processed;
+    }
+
+private:
+    void discard_rx_data() override
+    {
+        if (this->count == 0) {
+            throw std::logic_error("no messages to discard");
+        }
+
+        this->head = (this->head + 1) % num_slots;
+        --this->count;
+    }
+
+    void push(const seq32_t& data)
+    {
+        if (this->count == num_slots) {
+            throw std::logic_error("loopback ring is full");
+        }
+
+        if (data.length() > consts::link::max_frame_size) {
+            throw std::logic_error("frame exceeds loopback slot size");
+        }
+
+        auto& slot = this->slots[(this->head + this->count) % num_slots];
+        memcpy(slot.data, data, data.length());
+        slot.length = data.length();
+        ++this->count;
+
+        this->rx_pending = true;
+    }
+
+    std::array<Slot, num_slots> slots;
+    uint32_t head = 0;
+    uint32_t count = 0;
+
+    bool tx_pending = false;
+    bool rx_pending = false;
+
+    // set during configure step
+    LoopbackLowerLayer* sibling = nullptr;
+    IUpperLayer* upper = nullptr;
+};
+
+}
+
+#endif
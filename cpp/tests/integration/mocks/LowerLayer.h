@@ -55,6 +55,9 @@ public:
         this->sibling = &sibling;
     }
 
+    // messages that arrived from the sibling
+    uint32_t num_rx = 0;
+
 private:
     void discard_rx_data() override
     {
@@ -68,6 +71,7 @@ private:
     // sibling layer notification that data has been placed in queue
     void on_new_data()
     {
+        ++this->num_rx;
         this->upper->on_lower_rx_ready();
     }
 